@@ -12,6 +12,7 @@
 
 #include "_QCustomPlot.hpp"
 #include <SciQLopPlots/DataProducer/DataProducer.hpp>
+#include <SciQLopPlots/DataProducer/SharedMemoryRing.hpp>
 #include <SciQLopPlots/DragNDrop/PlotDragNDropCallback.hpp>
 #include <SciQLopPlots/Inspector/Model/DelegateRegistry.hpp>
 #include <SciQLopPlots/Inspector/Model/TypeDescriptor.hpp>
@@ -34,6 +35,7 @@
 #include <SciQLopPlots/MultiPlots/SciQLopMultiPlotObject.hpp>
 #include <SciQLopPlots/MultiPlots/SciQLopMultiPlotPanel.hpp>
 #include <SciQLopPlots/MultiPlots/SciQLopPlotContainer.hpp>
+#include <SciQLopPlots/MultiPlots/RenderScheduler.hpp>
 #include <SciQLopPlots/MultiPlots/VPlotsAlign.hpp>
 #include <SciQLopPlots/MultiPlots/XAxisSynchronizer.hpp>
 #include <SciQLopPlots/Plotables/QCPAbstractPlottableWrapper.hpp>
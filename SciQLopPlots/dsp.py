@@ -13,10 +13,20 @@ from ._sciqlop_dsp import (
     sosfiltfilt,
     fft,
     spectrogram,
+    welch,
+    multitaper,
+    csd,
+    coherence,
     rolling_mean,
     rolling_std,
     reduce,
     reduce_axes,
+    pipeline,
+    StreamingFilter,
+    fft_cache_stats,
+    clear_fft_cache,
+    set_fft_cache_capacity,
+    _set_counter_sink,
 )
 
 __all__ = [
@@ -29,8 +39,29 @@ __all__ = [
     "sosfiltfilt",
     "fft",
     "spectrogram",
+    "welch",
+    "multitaper",
+    "csd",
+    "coherence",
     "rolling_mean",
     "rolling_std",
     "reduce",
     "reduce_axes",
+    "pipeline",
+    "StreamingFilter",
+    "fft_cache_stats",
+    "clear_fft_cache",
+    "set_fft_cache_capacity",
 ]
+
+
+def _install_tracing_counters():
+    """Report FFT cache hits/misses as tracing counters (no-op while tracing is off)."""
+    try:
+        from . import tracing
+    except ImportError:  # DSP used without the Qt bindings
+        return
+    _set_counter_sink(tracing.counter)
+
+
+_install_tracing_counters()
@@ -24,6 +24,7 @@
 // Convenience header: includes the full DSP module.
 
 #include "FFT.hpp"
+#include "FFTCache.hpp"
 #include "Filter.hpp"
 #include "NaNHandler.hpp"
 #include "Parallel.hpp"
@@ -31,6 +32,8 @@
 #include "Reduce.hpp"
 #include "Resample.hpp"
 #include "Segments.hpp"
+#include "Spectral.hpp"
 #include "Spectrogram.hpp"
 #include "Stats.hpp"
+#include "Streaming.hpp"
 #include "Window.hpp"
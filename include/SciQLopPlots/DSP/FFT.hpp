@@ -21,17 +21,17 @@
 ----------------------------------------------------------------------------*/
 #pragma once
 
+#include "FFTCache.hpp"
 #include "Parallel.hpp"
 #include "Pipeline.hpp"
 #include "Segments.hpp"
 #include "Window.hpp"
 
-#include <pocketfft_hdronly.h>
-
 #include <cmath>
 #include <complex>
 #include <cstddef>
-#include <numbers>
+#include <memory>
+#include <span>
 #include <vector>
 
 namespace sqp::dsp
@@ -48,65 +48,65 @@ struct FFTResult
 
 namespace detail
 {
-    // Compute real-to-complex FFT of a single column, return magnitude.
+    // Real-to-complex FFT of a single column; writes the magnitude of bin i
+    // to mag[i * mag_stride].
     template <typename T>
-    auto fft_column(const T* data, std::size_t n_rows, std::size_t n_cols, std::size_t col,
-                    const T* window) -> std::vector<T>
+    void fft_column(const T* data, std::size_t n_rows, std::size_t n_cols, std::size_t col,
+        const FFTSetup& setup, T* mag, std::size_t mag_stride)
     {
-        // Apply window and copy to contiguous buffer
-        std::vector<double> windowed(n_rows);
+        // Apply window and copy to the thread's transform buffer
+        auto& windowed = fft_scratch(n_rows);
         for (std::size_t i = 0; i < n_rows; ++i)
-            windowed[i] = static_cast<double>(data[i * n_cols + col])
-                        * static_cast<double>(window[i]);
-
-        // Real-to-complex FFT
-        const pocketfft::shape_t shape { n_rows };
-        const pocketfft::stride_t stride_in { sizeof(double) };
-        const pocketfft::stride_t stride_out { sizeof(std::complex<double>) };
-        const std::size_t n_freq = n_rows / 2 + 1;
-        std::vector<std::complex<double>> spectrum(n_freq);
+            windowed[i] = static_cast<double>(data[i * n_cols + col]) * setup.window[i];
 
-        pocketfft::r2c(shape, stride_in, stride_out, /*axes=*/ { 0 },
-                        pocketfft::FORWARD, windowed.data(), spectrum.data(), 1.0);
+        setup.plan.exec(windowed.data(), 1.0, true);
 
         // Magnitude (normalized by N)
+        const std::size_t n_freq = n_rows / 2 + 1;
         const double inv_n = 1.0 / static_cast<double>(n_rows);
-        std::vector<T> mag(n_freq);
         for (std::size_t i = 0; i < n_freq; ++i)
-            mag[i] = static_cast<T>(std::abs(spectrum[i]) * inv_n);
-
-        return mag;
+            mag[i * mag_stride]
+                = static_cast<T>(std::abs(halfcomplex_bin(windowed.data(), n_rows, i)) * inv_n);
     }
 
+    // Frequency axis and output buffer of a segment's FFT; magnitudes are
+    // filled per column by fft_fill_columns. Returns false (and leaves result
+    // empty) for segments too short or without a sampling interval.
     template <typename T>
-    auto fft_segment(const Segment<T>& seg, WindowType win_type) -> FFTResult<T>
+    bool fft_prepare(const Segment<T>& seg, FFTResult<T>& result)
     {
         if (seg.x.size() < 2 || seg.median_dt <= 0.0)
-            return {};
+            return false;
 
         const auto n_rows = seg.x.size();
         const auto n_freq = n_rows / 2 + 1;
         const double fs = 1.0 / seg.median_dt;
 
-        auto window = make_window<T>(n_rows, win_type);
-
-        FFTResult<T> result;
         result.n_cols = seg.n_cols;
-
-        // Frequency axis
         result.frequencies.resize(n_freq);
         for (std::size_t i = 0; i < n_freq; ++i)
             result.frequencies[i] = static_cast<double>(i) * fs / static_cast<double>(n_rows);
-
-        // FFT each column
         result.magnitude.resize(n_freq * seg.n_cols);
-        for (std::size_t col = 0; col < seg.n_cols; ++col)
-        {
-            auto mag = fft_column(seg.y.data(), n_rows, seg.n_cols, col, window.data());
-            for (std::size_t i = 0; i < n_freq; ++i)
-                result.magnitude[i * seg.n_cols + col] = mag[i];
-        }
+        return true;
+    }
+
+    template <typename T>
+    void fft_fill_columns(const Segment<T>& seg, const FFTSetup& setup, std::size_t col_begin,
+        std::size_t col_end, FFTResult<T>& result)
+    {
+        for (std::size_t col = col_begin; col < col_end; ++col)
+            fft_column(seg.y.data(), seg.x.size(), seg.n_cols, col, setup,
+                result.magnitude.data() + col, seg.n_cols);
+    }
 
+    template <typename T>
+    auto fft_segment(const Segment<T>& seg, WindowType win_type) -> FFTResult<T>
+    {
+        FFTResult<T> result;
+        if (!fft_prepare(seg, result))
+            return {};
+        const auto setup = fft_setup<T>(seg.x.size(), win_type);
+        fft_fill_columns(seg, *setup, 0, seg.n_cols, result);
         return result;
     }
 
@@ -119,9 +119,24 @@ auto fft(const std::vector<Segment<T>>& segments, WindowType window = WindowType
     -> std::vector<FFTResult<T>>
 {
     std::vector<FFTResult<T>> results(segments.size());
+    std::vector<std::shared_ptr<const detail::FFTSetup>> setups(segments.size());
+    std::vector<TileExtent> extents(segments.size());
     parallel_for(segments.size(), [&](std::size_t i) {
-        results[i] = detail::fft_segment(segments[i], window);
+        if (detail::fft_prepare(segments[i], results[i]))
+        {
+            // Segments of the same length share one cached plan and window
+            setups[i] = detail::fft_setup<T>(segments[i].x.size(), window);
+            extents[i] = { segments[i].x.size(), segments[i].n_cols };
+        }
     });
+    // One transform per column: a long multi-column segment spreads its
+    // columns across the pool instead of running them on one thread.
+    // Cost ~ log2(n) butterfly passes per sample for typical segment lengths.
+    parallel_for_tiles(std::span<const TileExtent>(extents), TileSplit::Columns, 16,
+        [&](const Tile& tile) {
+            detail::fft_fill_columns(segments[tile.segment], *setups[tile.segment],
+                tile.col_begin, tile.col_end, results[tile.segment]);
+        });
     return results;
 }
 
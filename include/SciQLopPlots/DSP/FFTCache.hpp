@@ -0,0 +1,299 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2026, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+
+#include "Window.hpp"
+
+#include <pocketfft_hdronly.h>
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sqp::dsp
+{
+
+// Lookup totals of the FFT setup cache since start or the last clear_fft_cache().
+struct FFTCacheStats
+{
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::size_t entries = 0;
+    std::size_t capacity = 0;
+};
+
+namespace detail
+{
+    using RealFFTPlan = pocketfft::detail::pocketfft_r<double>;
+
+    // What a transform of one length needs besides the data: the pocketfft
+    // plan (factorisation and twiddles) and the window. The window is built as
+    // make_window<T> and widened to double, so cached and uncached transforms
+    // multiply by the same values. Multitaper setups hold n_tapers DPSS tapers
+    // back to back in window.
+    struct FFTSetup
+    {
+        RealFFTPlan plan;
+        std::vector<double> window;
+        std::size_t n_tapers = 1;
+    };
+
+    template <typename T>
+    constexpr int dtype_tag()
+    {
+        if constexpr (std::is_same_v<T, double>)
+            return 0;
+        else if constexpr (std::is_same_v<T, float>)
+            return 1;
+        else
+            return 2 + static_cast<int>(sizeof(T));
+    }
+
+    // Thread-safe LRU of FFT setups keyed by (size, window type, dtype), or by
+    // (size, nw, n_tapers) for DPSS tapers. Entries are shared and immutable,
+    // so an evicted setup stays valid for callers that still hold it.
+    class FFTSetupCache
+    {
+    public:
+        explicit FFTSetupCache(std::size_t capacity) : m_capacity(capacity) { }
+
+        template <typename T>
+        std::shared_ptr<const FFTSetup> get(std::size_t size, WindowType window)
+        {
+            return get_or_build({ size, window, dtype_tag<T>(), 0.0, 1 }, [&] {
+                const auto w = make_window<T>(size, window);
+                return FFTSetup { RealFFTPlan(size), std::vector<double>(w.begin(), w.end()) };
+            });
+        }
+
+        std::shared_ptr<const FFTSetup> get_dpss(
+            std::size_t size, double nw, std::size_t n_tapers)
+        {
+            return get_or_build({ size, WindowType::Rectangular, -1, nw, n_tapers }, [&] {
+                return FFTSetup { RealFFTPlan(size), make_dpss(size, nw, n_tapers), n_tapers };
+            });
+        }
+
+        FFTCacheStats stats() const
+        {
+            std::lock_guard lock(m_mutex);
+            return { m_hits, m_misses, m_lru.size(), m_capacity };
+        }
+
+        void clear()
+        {
+            std::lock_guard lock(m_mutex);
+            m_lru.clear();
+            m_index.clear();
+            m_hits = 0;
+            m_misses = 0;
+        }
+
+        void set_capacity(std::size_t capacity)
+        {
+            std::lock_guard lock(m_mutex);
+            m_capacity = capacity;
+            trim();
+        }
+
+    private:
+        // (size, window, dtype tag or -1 for DPSS, nw, n_tapers)
+        using Key = std::tuple<std::size_t, WindowType, int, double, std::size_t>;
+        using Entry = std::pair<Key, std::shared_ptr<const FFTSetup>>;
+
+        template <typename Build>
+        std::shared_ptr<const FFTSetup> get_or_build(const Key& key, Build&& build)
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                if (auto hit = find(key))
+                {
+                    ++m_hits;
+                    return hit;
+                }
+                ++m_misses;
+            }
+            // Built outside the lock so a long plan does not stall other lookups.
+            auto setup = std::make_shared<const FFTSetup>(build());
+
+            std::lock_guard lock(m_mutex);
+            if (auto raced = find(key)) // another thread built it meanwhile
+                return raced;
+            m_lru.emplace_front(key, setup);
+            m_index.emplace(key, m_lru.begin());
+            trim();
+            return setup;
+        }
+
+        // Caller holds m_mutex.
+        std::shared_ptr<const FFTSetup> find(const Key& key)
+        {
+            const auto it = m_index.find(key);
+            if (it == m_index.end())
+                return nullptr;
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return it->second->second;
+        }
+
+        // Caller holds m_mutex.
+        void trim()
+        {
+            while (m_lru.size() > m_capacity)
+            {
+                m_index.erase(m_lru.back().first);
+                m_lru.pop_back();
+            }
+        }
+
+        mutable std::mutex m_mutex;
+        std::size_t m_capacity;
+        std::list<Entry> m_lru;
+        std::map<Key, std::list<Entry>::iterator> m_index;
+        std::uint64_t m_hits = 0;
+        std::uint64_t m_misses = 0;
+    };
+
+    inline FFTSetupCache& fft_setup_cache()
+    {
+        static FFTSetupCache cache(64);
+        return cache;
+    }
+
+    template <typename T>
+    std::shared_ptr<const FFTSetup> fft_setup(std::size_t size, WindowType window)
+    {
+        return fft_setup_cache().get<T>(size, window);
+    }
+
+    inline std::shared_ptr<const FFTSetup> dpss_setup(
+        std::size_t size, double nw, std::size_t n_tapers)
+    {
+        return fft_setup_cache().get_dpss(size, nw, n_tapers);
+    }
+
+    // Per-thread transform buffer, grown to the largest length seen.
+    inline std::vector<double>& fft_scratch(std::size_t n)
+    {
+        thread_local std::vector<double> buffer;
+        if (buffer.size() < n)
+            buffer.resize(n);
+        return buffer;
+    }
+
+    // Bin k of an n-point real transform in FFTPACK half-complex order
+    // (r0, r1, i1, r2, i2, ..., [r_n/2 when n is even]).
+    inline std::complex<double> halfcomplex_bin(const double* hc, std::size_t n, std::size_t k)
+    {
+        if (k == 0)
+            return { hc[0], 0.0 };
+        if (2 * k == n)
+            return { hc[n - 1], 0.0 };
+        return { hc[2 * k - 1], hc[2 * k] };
+    }
+
+    // Forward transforms of n_frames contiguous frames of plan.length()
+    // samples, scaled by fct, into n / 2 + 1 bins each. Frames go through the
+    // cached plan a SIMD vector at a time (pocketfft's vector width of frames
+    // interleaved per exec, as its own batched r2c does), so repeated calls
+    // neither look up nor rebuild a plan.
+    inline void real_forward_batch(const RealFFTPlan& plan, const double* frames,
+        std::size_t n_frames, std::complex<double>* spectra, double fct)
+    {
+        const std::size_t n = plan.length();
+        const std::size_t n_freq = n / 2 + 1;
+        std::size_t f = 0;
+#ifndef POCKETFFT_NO_VECTORS
+        using vec_t = pocketfft::detail::vtype_t<double>;
+        constexpr std::size_t vlen = pocketfft::detail::VLEN<double>::val;
+        thread_local std::vector<vec_t> lanes;
+        lanes.resize(n);
+        for (; f + vlen <= n_frames; f += vlen)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                for (std::size_t j = 0; j < vlen; ++j)
+                    lanes[i][j] = frames[(f + j) * n + i];
+            plan.exec(lanes.data(), fct, true);
+            for (std::size_t j = 0; j < vlen; ++j)
+            {
+                auto* out = spectra + (f + j) * n_freq;
+                out[0] = { lanes[0][j], 0.0 };
+                std::size_t i = 1, k = 1;
+                for (; i + 1 < n; i += 2, ++k)
+                    out[k] = { lanes[i][j], lanes[i + 1][j] };
+                if (i < n)
+                    out[k] = { lanes[i][j], 0.0 };
+            }
+        }
+#endif
+        auto& hc = fft_scratch(n);
+        for (; f < n_frames; ++f)
+        {
+            std::copy_n(frames + f * n, n, hc.begin());
+            plan.exec(hc.data(), fct, true);
+            for (std::size_t k = 0; k < n_freq; ++k)
+                spectra[f * n_freq + k] = halfcomplex_bin(hc.data(), n, k);
+        }
+    }
+
+    // In-place product of two half-complex spectra of length n.
+    inline void halfcomplex_multiply(double* a, const double* b, std::size_t n)
+    {
+        a[0] *= b[0];
+        for (std::size_t k = 1; k + 1 < n; k += 2)
+        {
+            const double re = a[k] * b[k] - a[k + 1] * b[k + 1];
+            const double im = a[k] * b[k + 1] + a[k + 1] * b[k];
+            a[k] = re;
+            a[k + 1] = im;
+        }
+        if (n % 2 == 0)
+            a[n - 1] *= b[n - 1];
+    }
+
+} // namespace detail
+
+inline FFTCacheStats fft_cache_stats()
+{
+    return detail::fft_setup_cache().stats();
+}
+
+// Drops every cached setup and resets the hit/miss totals.
+inline void clear_fft_cache()
+{
+    detail::fft_setup_cache().clear();
+}
+
+inline void set_fft_cache_capacity(std::size_t capacity)
+{
+    detail::fft_setup_cache().set_capacity(capacity);
+}
+
+} // namespace sqp::dsp
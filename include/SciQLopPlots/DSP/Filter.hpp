@@ -21,6 +21,7 @@
 ----------------------------------------------------------------------------*/
 #pragma once
 
+#include "FFTCache.hpp"
 #include "Parallel.hpp"
 #include "Pipeline.hpp"
 #include "Segments.hpp"
@@ -29,7 +30,10 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <iterator>
+#include <memory>
 #include <span>
+#include <type_traits>
 #include <vector>
 
 namespace sqp::dsp
@@ -44,80 +48,291 @@ namespace simd
 } // namespace simd
 #endif
 
+// How fir_filter/filtfilt convolve. Direct is the O(N·taps) time-domain loop;
+// FFT is overlap-add through pocketfft, O(N·log taps). Auto picks FFT from
+// fir_fft_min_taps taps on. int32 data always uses Direct (exact arithmetic).
+//
+// The FFT path computes in double. It matches Direct to within
+// ~1e-12 · sum|h| · max|x| for float64 data; float32 results are rounded
+// once from double, so they differ from the float-accumulated direct path by
+// float rounding (~1e-6 · sum|h| · max|x|).
+enum class FirMethod
+{
+    Auto,
+    Direct,
+    FFT,
+};
+
+// Direct/FFT crossover, from the tap sweep of tests/perf/bench_dsp.py
+// (best of 3 runs, ns per output sample, AVX2, 1M samples):
+//
+//   taps         32    48    64    96   128   256  1001
+//   direct      8.0  11.8  17.1  24.8  34.3  78.1   355
+//   fft         6.6   8.0   6.9   7.5   8.0  13.1  13.8
+//
+// The curves cross between 32 and 48 taps, but below 96 the FFT lead was
+// within run-to-run noise (1.2x at 64 taps in the worst run) and does not
+// count the overlap-add copies, so Auto switches at 96. Re-run the sweep
+// when the SIMD dot product or fir_fft_size change.
+inline constexpr std::size_t fir_fft_min_taps = 96;
+
 namespace detail
 {
 
-    // Apply causal FIR filter to a single column of a segment.
-    // Equivalent to scipy.signal.lfilter(coeffs, 1.0, x).
-    // For contiguous data (n_cols==1), uses SIMD dot product on the steady-state region.
-    template <typename T>
-    void fir_apply_column(
-        const T* in, std::size_t n_rows, std::size_t n_cols, std::size_t col,
-        const T* coeffs, std::size_t n_taps,
-        T* out)
+    // Per-thread overlap-add buffers, grown to the largest transform seen.
+    struct FirFftScratch
     {
-        if (n_cols == 1)
+        std::vector<double> block;
+        std::vector<double> tail;
+    };
+
+    inline FirFftScratch& fir_fft_scratch()
+    {
+        thread_local FirFftScratch scratch;
+        return scratch;
+    }
+
+    // Overlap-add transform length for n_taps: the power of two that
+    // minimises FFT work per output sample, L·log2(L) / (L - n_taps + 1).
+    inline std::size_t fir_fft_size(std::size_t n_taps)
+    {
+        std::size_t size = 64;
+        while (size < 2 * n_taps)
+            size *= 2;
+        std::size_t best = size;
+        double best_cost = 0.0;
+        for (int i = 0; i < 4; ++i, size *= 2)
         {
-            // Ramp-up: i < n_taps, partial overlap with coefficients
-            const auto ramp = std::min(n_taps, n_rows);
-            for (std::size_t i = 0; i < ramp; ++i)
+            const double cost = static_cast<double>(size) * std::log2(static_cast<double>(size))
+                / static_cast<double>(size - n_taps + 1);
+            if (i == 0 || cost < best_cost)
             {
-                T acc = T(0);
-                for (std::size_t k = 0; k <= i; ++k)
-                    acc += in[i - k] * coeffs[k];
-                out[i] = acc;
+                best = size;
+                best_cost = cost;
             }
+        }
+        return best;
+    }
+
+    template <typename T>
+    auto reversed_taps(const T* coeffs, std::size_t n_taps) -> std::vector<T>
+    {
+        return std::vector<T>(std::make_reverse_iterator(coeffs + n_taps),
+            std::make_reverse_iterator(coeffs));
+    }
 
-            // Steady state: full n_taps overlap — use SIMD dot product.
-            // in[i-k] for k=0..n_taps-1 is a reversed slice starting at in[i].
-            // dot_product(coeffs, &in[i - n_taps + 1], n_taps) gives the same
-            // result when coeffs are pre-reversed. Since lfilter convention has
-            // coeffs[0] multiply in[i], coeffs[1] multiply in[i-1], etc.,
-            // we need dot_product(&in[i - n_taps + 1], reversed_coeffs, n_taps).
-            // Instead, just reverse the pointer arithmetic:
-            // sum(in[i-k] * coeffs[k]) = sum(in[i-n_taps+1+j] * coeffs[n_taps-1-j])
-            // which is dot_product(&in[i-n_taps+1], reversed_coeffs, n_taps).
-            //
-            // To avoid reversing coefficients, note that for the scalar inner loop
-            // the compiler can auto-vectorize well enough. But the SIMD dot_product
-            // needs contiguous a[] and b[] arrays. We can prepare reversed coefficients.
+    // One FIR output sample at row i < n_taps (partial overlap with the taps).
+    // in_i points at row i; rows down to 0 must be addressable.
+    template <typename T>
+    T fir_ramp_sample(const T* in_i, std::size_t i, const T* coeffs)
+    {
+        T acc = T(0);
+        for (std::size_t k = 0; k <= i; ++k)
+            acc += *(in_i - k) * coeffs[k];
+        return acc;
+    }
 
+    // One FIR output sample with full overlap. in_i points at row i; the
+    // n_taps - 1 rows before it must be addressable.
+    // sum(in[i-k] * coeffs[k]) == dot(&in[i-n_taps+1], reversed coeffs), which
+    // is the contiguous form the SIMD dot product needs.
+    template <typename T>
+    T fir_steady_sample(
+        const T* in_i, const T* coeffs, [[maybe_unused]] const T* rcoeffs, std::size_t n_taps)
+    {
 #ifndef SQP_DSP_NO_SIMD
-            if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
-            {
-                // Reverse coefficients once for SIMD dot product
-                std::vector<T> rcoeffs(n_taps);
-                for (std::size_t k = 0; k < n_taps; ++k)
-                    rcoeffs[k] = coeffs[n_taps - 1 - k];
-
-                for (std::size_t i = ramp; i < n_rows; ++i)
-                    out[i] = static_cast<T>(
-                        simd::dispatched_dot_product(&in[i - n_taps + 1], rcoeffs.data(), n_taps));
-            }
-            else
+        if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
+            return static_cast<T>(
+                simd::dispatched_dot_product(in_i - (n_taps - 1), rcoeffs, n_taps));
+        else
 #endif
+        {
+            T acc = T(0);
+            for (std::size_t k = 0; k < n_taps; ++k)
+                acc += *(in_i - k) * coeffs[k];
+            return acc;
+        }
+    }
+
+    // FIR outputs for rows [first_row, first_row + n) of a contiguous column.
+    // in points at row first_row and must have the history rows before it.
+    template <typename T>
+    void fir_rows(const T* in, std::size_t first_row, std::size_t n,
+        const T* coeffs, const T* rcoeffs, std::size_t n_taps, T* out)
+    {
+        std::size_t r = 0;
+        for (; r < n && first_row + r < n_taps; ++r)
+            out[r] = fir_ramp_sample(in + r, first_row + r, coeffs);
+        for (; r < n; ++r)
+            out[r] = fir_steady_sample(in + r, coeffs, rcoeffs, n_taps);
+    }
+
+    // FIR taps prepared once per filter: reversed copy for the SIMD dot
+    // product and, when the FFT path is chosen, the zero-padded spectrum.
+    template <typename T>
+    struct FirTaps
+    {
+        std::vector<T> coeffs;
+        std::vector<T> rcoeffs;
+        std::size_t fft_size = 0; // overlap-add transform length, 0 = direct
+        std::shared_ptr<const FFTSetup> fft; // cached plan; its window is unused
+        std::vector<double> spectrum; // half-complex rfft of coeffs padded to fft_size
+
+        FirTaps(const T* taps, std::size_t n_taps, FirMethod method = FirMethod::Auto)
+                : coeffs(taps, taps + n_taps), rcoeffs(reversed_taps(taps, n_taps))
+        {
+            if constexpr (std::is_floating_point_v<T>)
             {
-                for (std::size_t i = ramp; i < n_rows; ++i)
+                if (method == FirMethod::FFT
+                    || (method == FirMethod::Auto && n_taps >= fir_fft_min_taps))
                 {
-                    T acc = T(0);
-                    for (std::size_t k = 0; k < n_taps; ++k)
-                        acc += in[i - k] * coeffs[k];
-                    out[i] = acc;
+                    fft_size = fir_fft_size(n_taps);
+                    fft = fft_setup<double>(fft_size, WindowType::Rectangular);
+                    spectrum.assign(fft_size, 0.0);
+                    std::copy(taps, taps + n_taps, spectrum.begin());
+                    fft->plan.exec(spectrum.data(), 1.0, true);
                 }
             }
         }
-        else
+
+        std::size_t size() const { return coeffs.size(); }
+        bool use_fft() const { return fft_size != 0; }
+
+        // Relative work per output row, for tile sizing.
+        std::size_t cost() const
         {
-            // Extract column to contiguous buffer, run single-col path, scatter back.
-            std::vector<T> col_in(n_rows), col_out(n_rows);
-            for (std::size_t i = 0; i < n_rows; ++i)
-                col_in[i] = in[i * n_cols + col];
+            return use_fft() ? 4 * static_cast<std::size_t>(std::log2(fft_size)) : size();
+        }
+    };
 
-            fir_apply_column(col_in.data(), n_rows, 1, 0, coeffs, n_taps, col_out.data());
+    // Overlap-add convolution of a contiguous line u[0, m) with zero history
+    // before u[0]. Writes the outputs for rows [skip, m) to out[0, m - skip).
+    template <typename T>
+    void fir_fft_rows(const T* u, std::size_t m, std::size_t skip, const FirTaps<T>& taps, T* out)
+    {
+        const auto L = taps.fft_size;
+        const auto n_taps = taps.size();
+        const auto block_len = L - n_taps + 1;
+        const auto& plan = taps.fft->plan;
+        auto& scratch = fir_fft_scratch();
+        scratch.block.resize(L);
+        scratch.tail.assign(n_taps - 1, 0.0);
+        auto& block = scratch.block;
+        auto& tail = scratch.tail;
+
+        for (std::size_t b0 = 0; b0 < m; b0 += block_len)
+        {
+            const auto len = std::min(block_len, m - b0);
+            std::copy(u + b0, u + b0 + len, block.begin());
+            std::fill(block.begin() + static_cast<std::ptrdiff_t>(len), block.end(), 0.0);
+            plan.exec(block.data(), 1.0, true);
+            halfcomplex_multiply(block.data(), taps.spectrum.data(), L);
+            plan.exec(block.data(), 1.0 / static_cast<double>(L), false);
+
+            // The previous block's convolution tail overlaps this block's head.
+            for (std::size_t k = 0; k < n_taps - 1; ++k)
+                block[k] += tail[k];
+            for (std::size_t r = (b0 < skip) ? std::min(skip - b0, len) : 0; r < len; ++r)
+                out[b0 + r - skip] = static_cast<T>(block[r]);
+            std::copy_n(block.begin() + static_cast<std::ptrdiff_t>(len), n_taps - 1,
+                tail.begin());
+        }
+    }
 
-            for (std::size_t i = 0; i < n_rows; ++i)
-                out[i * n_cols + col] = col_out[i];
+    // FIR outputs for rows [row_begin, row_end) of one column. The rows before
+    // row_begin are read as history, so row blocks can be filtered independently
+    // and still match the whole-column result (bit for bit on the direct path).
+    template <typename T>
+    void fir_apply_column_rows(const T* in, std::size_t n_cols, std::size_t col,
+        std::size_t row_begin, std::size_t row_end, const FirTaps<T>& taps, T* out)
+    {
+        const auto n = row_end - row_begin;
+        const auto n_taps = taps.size();
+        const auto first = row_begin - std::min(row_begin, n_taps - 1);
+        if (n_cols == 1)
+        {
+            if (taps.use_fft())
+                fir_fft_rows(in + first, row_end - first, row_begin - first, taps,
+                    out + row_begin);
+            else
+                fir_rows(in + row_begin, row_begin, n, taps.coeffs.data(), taps.rcoeffs.data(),
+                    n_taps, out + row_begin);
+            return;
+        }
+        // Gather the column (plus history) to a contiguous buffer, filter, scatter back.
+        std::vector<T> col_in(row_end - first), col_out(n);
+        for (std::size_t i = first; i < row_end; ++i)
+            col_in[i - first] = in[i * n_cols + col];
+
+        if (taps.use_fft())
+            fir_fft_rows(col_in.data(), col_in.size(), row_begin - first, taps, col_out.data());
+        else
+            fir_rows(col_in.data() + (row_begin - first), row_begin, n, taps.coeffs.data(),
+                taps.rcoeffs.data(), n_taps, col_out.data());
+
+        for (std::size_t i = 0; i < n; ++i)
+            out[(row_begin + i) * n_cols + col] = col_out[i];
+    }
+
+    // Apply causal FIR filter to a single column of a segment.
+    // Equivalent to scipy.signal.lfilter(coeffs, 1.0, x).
+    // For contiguous data (n_cols==1), uses SIMD dot product on the steady-state region.
+    template <typename T>
+    void fir_apply_column(const T* in, std::size_t n_rows, std::size_t n_cols, std::size_t col,
+        const FirTaps<T>& taps, T* out)
+    {
+        fir_apply_column_rows(in, n_cols, col, 0, n_rows, taps, out);
+    }
+
+    template <typename T>
+    void fir_apply_column(
+        const T* in, std::size_t n_rows, std::size_t n_cols, std::size_t col,
+        const T* coeffs, std::size_t n_taps,
+        T* out)
+    {
+        fir_apply_column(in, n_rows, n_cols, col, FirTaps<T>(coeffs, n_taps, FirMethod::Direct),
+            out);
+    }
+
+    // Biquad section with coefficients normalised by a0.
+    template <typename T>
+    struct SosSection
+    {
+        T b0, b1, b2, a1, a2;
+        bool active; // false when a0 == 0: the section is skipped
+
+        T step(T x, T& z1, T& z2) const
+        {
+            const T y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    template <typename T>
+    auto normalize_sos(const T* sos, std::size_t n_sections) -> std::vector<SosSection<T>>
+    {
+        std::vector<SosSection<T>> sections(n_sections);
+        for (std::size_t s = 0; s < n_sections; ++s)
+        {
+            const T a0 = sos[s * 6 + 3];
+            if (a0 == T(0))
+            {
+                sections[s] = { T(0), T(0), T(0), T(0), T(0), false };
+                continue;
+            }
+            const T inv_a0 = T(1) / a0;
+            sections[s] = {
+                sos[s * 6 + 0] * inv_a0,
+                sos[s * 6 + 1] * inv_a0,
+                sos[s * 6 + 2] * inv_a0,
+                sos[s * 6 + 4] * inv_a0,
+                sos[s * 6 + 5] * inv_a0,
+                true,
+            };
         }
+        return sections;
     }
 
     // Apply a cascade of biquad sections (SOS) to a single column.
@@ -146,33 +361,13 @@ namespace detail
         for (std::size_t i = 0; i < n_rows; ++i)
             out[i] = in[i];
 
-        for (std::size_t s = 0; s < n_sections; ++s)
+        for (const auto& section : normalize_sos(sos, n_sections))
         {
-            const T b0 = sos[s * 6 + 0];
-            const T b1 = sos[s * 6 + 1];
-            const T b2 = sos[s * 6 + 2];
-            const T a0 = sos[s * 6 + 3];
-            const T a1 = sos[s * 6 + 4];
-            const T a2 = sos[s * 6 + 5];
-
-            if (a0 == T(0))
+            if (!section.active)
                 continue;
-            const T inv_a0 = T(1) / a0;
-            const T nb0 = b0 * inv_a0;
-            const T nb1 = b1 * inv_a0;
-            const T nb2 = b2 * inv_a0;
-            const T na1 = a1 * inv_a0;
-            const T na2 = a2 * inv_a0;
-
             T z1 = T(0), z2 = T(0);
             for (std::size_t i = 0; i < n_rows; ++i)
-            {
-                const T x = out[i];
-                const T y = nb0 * x + z1;
-                z1 = nb1 * x - na1 * y + z2;
-                z2 = nb2 * x - na2 * y;
-                out[i] = y;
-            }
+                out[i] = section.step(out[i], z1, z2);
         }
     }
 
@@ -193,9 +388,8 @@ namespace detail
     // Zero-phase FIR: forward-backward causal filter with odd-extension padding.
     // Equivalent to scipy.signal.filtfilt(coeffs, 1.0, x).
     template <typename T>
-    void filtfilt_column(
-        const T* in, std::size_t n_rows, std::size_t n_cols, std::size_t col,
-        const T* coeffs, std::size_t n_taps, T* out)
+    void filtfilt_column(const T* in, std::size_t n_rows, std::size_t n_cols, std::size_t col,
+        const FirTaps<T>& taps, T* out)
     {
         if (n_cols > 1)
         {
@@ -203,28 +397,28 @@ namespace detail
             for (std::size_t i = 0; i < n_rows; ++i)
                 col_in[i] = in[i * n_cols + col];
 
-            filtfilt_column(col_in.data(), n_rows, 1, 0, coeffs, n_taps, col_out.data());
+            filtfilt_column(col_in.data(), n_rows, 1, 0, taps, col_out.data());
 
             for (std::size_t i = 0; i < n_rows; ++i)
                 out[i * n_cols + col] = col_out[i];
             return;
         }
 
-        const auto padlen = std::min(3 * n_taps, n_rows - 1);
+        const auto padlen = std::min(3 * taps.size(), n_rows - 1);
         std::vector<T> padded;
         odd_extend(in, n_rows, padlen, padded);
         const auto plen = padded.size();
 
         // Forward pass
         std::vector<T> fwd(plen);
-        fir_apply_column(padded.data(), plen, 1, 0, coeffs, n_taps, fwd.data());
+        fir_apply_column(padded.data(), plen, 1, 0, taps, fwd.data());
 
         // Reverse
         std::reverse(fwd.begin(), fwd.end());
 
         // Backward pass
         std::vector<T> bwd(plen);
-        fir_apply_column(fwd.data(), plen, 1, 0, coeffs, n_taps, bwd.data());
+        fir_apply_column(fwd.data(), plen, 1, 0, taps, bwd.data());
 
         // Reverse and extract
         std::reverse(bwd.begin(), bwd.end());
@@ -232,6 +426,15 @@ namespace detail
             out[i] = bwd[padlen + i];
     }
 
+    template <typename T>
+    void filtfilt_column(
+        const T* in, std::size_t n_rows, std::size_t n_cols, std::size_t col,
+        const T* coeffs, std::size_t n_taps, T* out)
+    {
+        filtfilt_column(in, n_rows, n_cols, col, FirTaps<T>(coeffs, n_taps, FirMethod::Direct),
+            out);
+    }
+
     // Compute steady-state initial conditions for SOS cascade (unit step response).
     // Returns {z1, z2} per section, pre-scaled for cascade DC gain.
     // Equivalent to scipy.signal.sosfilt_zi.
@@ -344,34 +547,138 @@ namespace detail
             out[i] = bwd[padlen + i];
     }
 
+    // Streaming causal FIR: keeps the last n_taps - 1 input rows per column as
+    // a delay line so each block sees the same history as a whole-segment run.
+    template <typename T>
+    class FirKernel final : public BlockKernel<T>
+    {
+    public:
+        FirKernel(const std::vector<T>& coeffs, std::size_t n_cols)
+                : m_coeffs(coeffs)
+                , m_rcoeffs(reversed_taps(coeffs.data(), coeffs.size()))
+                , m_n_cols(n_cols)
+                , m_history(n_cols)
+        {
+        }
+
+        Halo halo() const override { return { .before = m_coeffs.size() - 1, .after = 0 }; }
+
+        std::size_t out_cols() const override { return m_n_cols; }
+
+        std::size_t push(const T* in, std::size_t n, T* out) override
+        {
+            const auto n_taps = m_coeffs.size();
+            for (std::size_t col = 0; col < m_n_cols; ++col)
+            {
+                auto& history = m_history[col];
+                const auto h = history.size();
+                m_line.resize(h + n);
+                m_col_out.resize(n);
+                std::copy(history.begin(), history.end(), m_line.begin());
+                for (std::size_t r = 0; r < n; ++r)
+                    m_line[h + r] = in[r * m_n_cols + col];
+
+                fir_rows(m_line.data() + h, m_row, n, m_coeffs.data(), m_rcoeffs.data(), n_taps,
+                    m_col_out.data());
+
+                for (std::size_t r = 0; r < n; ++r)
+                    out[r * m_n_cols + col] = m_col_out[r];
+
+                const auto keep = std::min(n_taps - 1, h + n);
+                history.assign(m_line.end() - static_cast<std::ptrdiff_t>(keep), m_line.end());
+            }
+            m_row += n;
+            return n;
+        }
+
+        std::size_t finish(T*) override { return 0; }
+
+    private:
+        std::vector<T> m_coeffs;
+        std::vector<T> m_rcoeffs;
+        std::size_t m_n_cols;
+        std::size_t m_row = 0;
+        std::vector<std::vector<T>> m_history;
+        std::vector<T> m_line;
+        std::vector<T> m_col_out;
+    };
+
+    // Streaming biquad cascade: per-column (z1, z2) per section carried
+    // across blocks. Sections are applied sample by sample instead of section
+    // by section, which performs the same operations per sample.
+    template <typename T>
+    class SosKernel final : public BlockKernel<T>
+    {
+    public:
+        SosKernel(const std::vector<SosSection<T>>& sections, std::size_t n_cols)
+                : m_sections(sections)
+                , m_n_cols(n_cols)
+                , m_state(n_cols * sections.size() * 2, T(0))
+        {
+        }
+
+        Halo halo() const override { return {}; }
+
+        std::size_t out_cols() const override { return m_n_cols; }
+
+        std::size_t push(const T* in, std::size_t n, T* out) override
+        {
+            const auto n_sections = m_sections.size();
+            for (std::size_t r = 0; r < n; ++r)
+            {
+                for (std::size_t col = 0; col < m_n_cols; ++col)
+                {
+                    T v = in[r * m_n_cols + col];
+                    T* z = &m_state[col * n_sections * 2];
+                    for (std::size_t s = 0; s < n_sections; ++s)
+                    {
+                        if (m_sections[s].active)
+                            v = m_sections[s].step(v, z[2 * s], z[2 * s + 1]);
+                    }
+                    out[r * m_n_cols + col] = v;
+                }
+            }
+            return n;
+        }
+
+        std::size_t finish(T*) override { return 0; }
+
+    private:
+        std::vector<SosSection<T>> m_sections;
+        std::size_t m_n_cols;
+        std::vector<T> m_state;
+    };
+
 } // namespace detail
 
 // Pipeline stage: FIR filter with user-provided coefficients.
 // coeffs: filter taps (designed externally, e.g. scipy.signal.firwin).
+// Only the direct path streams; an FFT stage runs unfused on whole segments,
+// so fused and unfused pipelines still agree bit for bit.
 template <typename T = double>
-auto fir_filter(std::span<const T> coeffs) -> Stage<T>
+auto fir_filter(std::span<const T> coeffs, FirMethod method = FirMethod::Auto) -> Stage<T>
 {
-    auto coeffs_vec = std::vector<T>(coeffs.begin(), coeffs.end());
+    auto taps = std::make_shared<const detail::FirTaps<T>>(coeffs.data(), coeffs.size(), method);
 
-    return [coeffs_vec](const std::vector<Segment<T>>& segments) -> std::vector<TimeSeries<T>>
+    auto apply = [taps](const std::vector<Segment<T>>& segments) -> std::vector<TimeSeries<T>>
     {
-        std::vector<TimeSeries<T>> results(segments.size());
-        parallel_for(segments.size(), [&](std::size_t i) {
-            const auto& seg = segments[i];
-            auto& out = results[i];
-            out.x.assign(seg.x.begin(), seg.x.end());
-            out.y.resize(seg.y.size());
-            out.n_cols = seg.n_cols;
-
-            for (std::size_t col = 0; col < seg.n_cols; ++col)
-            {
-                detail::fir_apply_column(
-                    seg.y.data(), seg.x.size(), seg.n_cols, col,
-                    coeffs_vec.data(), coeffs_vec.size(), out.y.data());
-            }
-        });
+        auto results = detail::alloc_outputs(segments);
+        // Output rows only read input rows: tiles may cut rows as well as columns
+        detail::for_each_tile(segments, TileSplit::Both, taps->cost(),
+            [&](const Tile& tile) {
+                const auto& seg = segments[tile.segment];
+                for (std::size_t col = tile.col_begin; col < tile.col_end; ++col)
+                    detail::fir_apply_column_rows(seg.y.data(), seg.n_cols, col, tile.row_begin,
+                        tile.row_end, *taps, results[tile.segment].y.data());
+            });
         return results;
     };
+    if (taps->use_fft())
+        return apply;
+    auto kernel = [coeffs_vec = taps->coeffs](std::size_t n_cols)
+        -> std::unique_ptr<BlockKernel<T>>
+    { return std::make_unique<detail::FirKernel<T>>(coeffs_vec, n_cols); };
+    return Stage<T>(std::move(apply), std::move(kernel));
 }
 
 // Pipeline stage: IIR filter with user-provided SOS (second-order sections) matrix.
@@ -382,23 +689,61 @@ auto iir_sos(std::span<const T> sos, std::size_t n_sections) -> Stage<T>
 {
     auto sos_vec = std::vector<T>(sos.begin(), sos.end());
 
+    auto apply = [sos_vec, n_sections](
+                     const std::vector<Segment<T>>& segments) -> std::vector<TimeSeries<T>>
+    {
+        auto results = detail::alloc_outputs(segments);
+        detail::for_each_tile(segments, TileSplit::Columns, n_sections, [&](const Tile& tile) {
+            const auto& seg = segments[tile.segment];
+            for (std::size_t col = tile.col_begin; col < tile.col_end; ++col)
+                detail::sos_apply_column(seg.y.data(), seg.x.size(), seg.n_cols, col,
+                    sos_vec.data(), n_sections, results[tile.segment].y.data());
+        });
+        return results;
+    };
+    auto kernel = [sections = detail::normalize_sos(sos_vec.data(), n_sections)](
+                      std::size_t n_cols) -> std::unique_ptr<BlockKernel<T>>
+    { return std::make_unique<detail::SosKernel<T>>(sections, n_cols); };
+    return Stage<T>(std::move(apply), std::move(kernel));
+}
+
+// Pipeline stage: zero-phase FIR (forward-backward), see detail::filtfilt_column.
+// Needs the whole segment for the backward pass, so it is never fused.
+template <typename T = double>
+auto filtfilt(std::span<const T> coeffs, FirMethod method = FirMethod::Auto) -> Stage<T>
+{
+    auto taps = std::make_shared<const detail::FirTaps<T>>(coeffs.data(), coeffs.size(), method);
+
+    return [taps](const std::vector<Segment<T>>& segments) -> std::vector<TimeSeries<T>>
+    {
+        auto results = detail::alloc_outputs(segments);
+        detail::for_each_tile(segments, TileSplit::Columns, 2 * taps->cost(),
+            [&](const Tile& tile) {
+                const auto& seg = segments[tile.segment];
+                for (std::size_t col = tile.col_begin; col < tile.col_end; ++col)
+                    detail::filtfilt_column(seg.y.data(), seg.x.size(), seg.n_cols, col, *taps,
+                        results[tile.segment].y.data());
+            });
+        return results;
+    };
+}
+
+// Pipeline stage: zero-phase IIR (forward-backward SOS), see detail::sosfiltfilt_column.
+// Needs the whole segment for the backward pass, so it is never fused.
+template <typename T = double>
+auto sosfiltfilt(std::span<const T> sos, std::size_t n_sections) -> Stage<T>
+{
+    auto sos_vec = std::vector<T>(sos.begin(), sos.end());
+
     return [sos_vec, n_sections](
                const std::vector<Segment<T>>& segments) -> std::vector<TimeSeries<T>>
     {
-        std::vector<TimeSeries<T>> results(segments.size());
-        parallel_for(segments.size(), [&](std::size_t i) {
-            const auto& seg = segments[i];
-            auto& out = results[i];
-            out.x.assign(seg.x.begin(), seg.x.end());
-            out.y.resize(seg.y.size());
-            out.n_cols = seg.n_cols;
-
-            for (std::size_t col = 0; col < seg.n_cols; ++col)
-            {
-                detail::sos_apply_column(
-                    seg.y.data(), seg.x.size(), seg.n_cols, col,
-                    sos_vec.data(), n_sections, out.y.data());
-            }
+        auto results = detail::alloc_outputs(segments);
+        detail::for_each_tile(segments, TileSplit::Columns, 2 * n_sections, [&](const Tile& tile) {
+            const auto& seg = segments[tile.segment];
+            for (std::size_t col = tile.col_begin; col < tile.col_end; ++col)
+                detail::sosfiltfilt_column(seg.y.data(), seg.x.size(), seg.n_cols, col,
+                    sos_vec.data(), n_sections, results[tile.segment].y.data());
         });
         return results;
     };
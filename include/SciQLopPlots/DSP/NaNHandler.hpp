@@ -21,8 +21,13 @@
 ----------------------------------------------------------------------------*/
 #pragma once
 
+#include "Parallel.hpp"
+#include "Pipeline.hpp"
+#include "Segments.hpp"
+
 #include <cmath>
 #include <cstddef>
+#include <span>
 #include <type_traits>
 #include <vector>
 
@@ -114,9 +119,39 @@ auto interpolate_nan(
     std::size_t max_consecutive = 1) -> std::vector<T>
 {
     std::vector<T> result(y_data, y_data + n_rows * n_cols);
-    for (std::size_t col = 0; col < n_cols; ++col)
-        detail::interpolate_nan_column(result.data(), n_rows, n_cols, col, x_data, max_consecutive);
+    const TileExtent extent { n_rows, n_cols };
+    parallel_for_tiles(std::span<const TileExtent>(&extent, 1), TileSplit::Columns, 1,
+        [&](const Tile& tile) {
+            for (std::size_t col = tile.col_begin; col < tile.col_end; ++col)
+                detail::interpolate_nan_column(
+                    result.data(), n_rows, n_cols, col, x_data, max_consecutive);
+        });
     return result;
 }
 
+// Pipeline stage: interpolate_nan applied per segment, so NaN runs are never
+// bridged across a data gap.
+template <typename T = double>
+auto interpolate_nan_stage(std::size_t max_consecutive = 1) -> Stage<T>
+{
+    return [max_consecutive](const std::vector<Segment<T>>& segments) -> std::vector<TimeSeries<T>>
+    {
+        std::vector<TimeSeries<T>> results(segments.size());
+        parallel_for(segments.size(), [&](std::size_t i) {
+            const auto& seg = segments[i];
+            auto& out = results[i];
+            out.x.assign(seg.x.begin(), seg.x.end());
+            out.y.assign(seg.y.begin(), seg.y.end());
+            out.n_cols = seg.n_cols;
+        });
+        detail::for_each_tile(segments, TileSplit::Columns, 1, [&](const Tile& tile) {
+            const auto& seg = segments[tile.segment];
+            for (std::size_t col = tile.col_begin; col < tile.col_end; ++col)
+                detail::interpolate_nan_column(results[tile.segment].y.data(), seg.x.size(),
+                    seg.n_cols, col, seg.x.data(), max_consecutive);
+        });
+        return results;
+    };
+}
+
 } // namespace sqp::dsp
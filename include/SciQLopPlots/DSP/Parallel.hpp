@@ -21,10 +21,14 @@
 ----------------------------------------------------------------------------*/
 #pragma once
 
-#include <BS_thread_pool.hpp>
+#include "TaskPool.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <span>
 #include <string>
+#include <vector>
 
 #ifdef __linux__
 #  include <pthread.h>
@@ -43,18 +47,28 @@ namespace detail
         ::pthread_setname_np(::pthread_self(), ("dsp" + std::to_string(index)).c_str());
 #endif
     }
+
+    // Below this many (element x cost) operations in total, tiled work runs
+    // inline: a pool round-trip costs more than it saves.
+    inline constexpr std::size_t min_tile_work = std::size_t { 1 } << 15;
+
+    // Tiles handed to each pool thread, so uneven segments still balance.
+    inline constexpr std::size_t tiles_per_thread = 4;
 }
 
 // Process-wide thread pool for DSP work. Lazy-initialized on first use.
 // Thread count matches hardware_concurrency.
-inline BS::light_thread_pool& pool()
+inline TaskPool& pool()
 {
-    static BS::light_thread_pool instance { &detail::name_dsp_pool_thread };
+    static TaskPool instance { 0, &detail::name_dsp_pool_thread };
     return instance;
 }
 
 // Apply f(index) for index in [0, count), distributed across the thread pool.
-// Blocks until all tasks complete. For count <= 1, runs inline.
+// Blocks until all indices are done; only this call's work is waited for, and
+// the calling thread takes part. Safe to nest (a parallel_for inside f) and to
+// call from several threads at once. For count <= 1, runs inline.
+// Rethrows the first exception thrown by f.
 template <typename F>
 void parallel_for(std::size_t count, F&& f)
 {
@@ -65,8 +79,16 @@ void parallel_for(std::size_t count, F&& f)
         f(std::size_t { 0 });
         return;
     }
-    pool().detach_sequence(std::size_t { 0 }, count, std::forward<F>(f));
-    pool().wait();
+    // Self-scheduling: every runner claims the next index until none is left,
+    // so uneven items balance without one task per index.
+    std::atomic<std::size_t> next { 0 };
+    auto runner = [&] {
+        for (auto i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+            f(i);
+    };
+    TaskGroup group { pool() };
+    group.run_copies(std::min(count, pool().thread_count() + 1), runner);
+    group.wait();
 }
 
 // Convenience: parallel_for over a container with element access.
@@ -76,4 +98,132 @@ void parallel_for_each(Container& items, F&& f)
     parallel_for(items.size(), [&](std::size_t i) { f(items[i]); });
 }
 
+// Apply f(begin, end) over [0, count) cut into contiguous blocks of at least
+// min_block indices, one pool task per block. Runs inline for a single block.
+template <typename F>
+void parallel_for_blocks(std::size_t count, std::size_t min_block, F&& f)
+{
+    if (count == 0)
+        return;
+    const auto max_blocks = pool().thread_count() * detail::tiles_per_thread;
+    const auto n_blocks
+        = std::clamp<std::size_t>(count / std::max<std::size_t>(min_block, 1), 1, max_blocks);
+    if (n_blocks == 1)
+    {
+        f(std::size_t { 0 }, count);
+        return;
+    }
+    parallel_for(n_blocks,
+        [&](std::size_t b) { f(b * count / n_blocks, (b + 1) * count / n_blocks); });
+}
+
+// Rows x columns of one segment, as seen by the tile scheduler.
+struct TileExtent
+{
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+};
+
+// A rectangular piece of one segment: rows [row_begin, row_end) of columns
+// [col_begin, col_end).
+struct Tile
+{
+    std::size_t segment = 0;
+    std::size_t col_begin = 0;
+    std::size_t col_end = 0;
+    std::size_t row_begin = 0;
+    std::size_t row_end = 0;
+};
+
+// Which axes of a segment a stage may cut independently.
+// Columns: every column is processed on its own (filters, rolling windows).
+// Rows: every output row depends only on input rows (FIR, reduce).
+// Rows are preferred when both are allowed: row blocks of a row-major output
+// do not share cache lines between threads.
+enum class TileSplit
+{
+    Columns,
+    Rows,
+    Both,
+};
+
+namespace detail
+{
+    inline double tile_work(std::span<const TileExtent> extents, std::size_t cost)
+    {
+        double total = 0.0;
+        for (const auto& e : extents)
+            total += static_cast<double>(e.rows) * static_cast<double>(e.cols);
+        return total * static_cast<double>(std::max<std::size_t>(cost, 1));
+    }
+}
+
+// Cut every segment into tiles proportional to its share of the total work
+// (rows x cols x cost), aiming at tiles_per_thread tiles per pool thread and
+// never below min_tile_work per tile. Empty segments get no tile.
+inline auto make_tiles(std::span<const TileExtent> extents, TileSplit split, std::size_t cost = 1)
+    -> std::vector<Tile>
+{
+    const double total = detail::tile_work(extents, cost);
+    const auto max_tiles
+        = static_cast<double>(pool().thread_count() * detail::tiles_per_thread);
+    const double target = std::clamp(total / detail::min_tile_work, 1.0, max_tiles);
+
+    const bool rows_ok = split != TileSplit::Columns;
+    const bool cols_ok = split != TileSplit::Rows;
+
+    std::vector<Tile> tiles;
+    for (std::size_t s = 0; s < extents.size(); ++s)
+    {
+        const auto [rows, cols] = extents[s];
+        if (rows == 0 || cols == 0)
+            continue;
+        const double share = static_cast<double>(rows) * static_cast<double>(cols)
+            * static_cast<double>(std::max<std::size_t>(cost, 1)) / total;
+        const auto pieces
+            = std::max<std::size_t>(1, static_cast<std::size_t>(share * target + 0.5));
+
+        const auto row_pieces = rows_ok ? std::min(rows, pieces) : std::size_t { 1 };
+        const auto col_pieces = cols_ok
+            ? std::min(cols, (pieces + row_pieces - 1) / row_pieces)
+            : std::size_t { 1 };
+
+        for (std::size_t r = 0; r < row_pieces; ++r)
+            for (std::size_t c = 0; c < col_pieces; ++c)
+                tiles.push_back({
+                    .segment = s,
+                    .col_begin = c * cols / col_pieces,
+                    .col_end = (c + 1) * cols / col_pieces,
+                    .row_begin = r * rows / row_pieces,
+                    .row_end = (r + 1) * rows / row_pieces,
+                });
+    }
+    return tiles;
+}
+
+// Apply f(tile) over the tiles of make_tiles(extents, split, cost). Tiles never
+// overlap, so f may write its tile of a shared output without locking.
+// Inputs below min_tile_work run inline on the calling thread.
+template <typename F>
+void parallel_for_tiles(
+    std::span<const TileExtent> extents, TileSplit split, std::size_t cost, F&& f)
+{
+    if (detail::tile_work(extents, cost) < detail::min_tile_work)
+    {
+        for (std::size_t s = 0; s < extents.size(); ++s)
+        {
+            if (extents[s].rows != 0 && extents[s].cols != 0)
+                f(Tile { s, 0, extents[s].cols, 0, extents[s].rows });
+        }
+        return;
+    }
+    const auto tiles = make_tiles(extents, split, cost);
+    if (tiles.size() == 1)
+    {
+        f(tiles.front());
+        return;
+    }
+    parallel_for(tiles.size(), [&](std::size_t i) { f(tiles[i]); });
+}
+
 } // namespace sqp::dsp
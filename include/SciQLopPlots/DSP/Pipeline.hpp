@@ -21,12 +21,18 @@
 ----------------------------------------------------------------------------*/
 #pragma once
 
+#include "Parallel.hpp"
 #include "Segments.hpp"
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <functional>
+#include <limits>
+#include <memory>
 #include <span>
+#include <type_traits>
 #include <vector>
 
 namespace sqp::dsp
@@ -38,28 +44,140 @@ struct TimeSeries
     std::vector<double> x;
     std::vector<T> y; // row-major, n_cols columns
     std::size_t n_cols = 1;
+    double median_dt = 0.0; // cadence of x once known; 0 = not computed yet
 
     std::size_t n_rows() const { return x.size(); }
 
-    Segment<T> as_segment() const
+    // Computes and caches the cadence on first use; whoever changes x resets it.
+    Segment<T> as_segment()
     {
+        if (median_dt <= 0.0)
+            median_dt = detail::compute_median_dt(std::span<const double>(x));
         return Segment<T> {
             .x = std::span<const double>(x),
             .y = std::span<const T>(y),
             .n_cols = n_cols,
-            .median_dt = detail::compute_median_dt(std::span<const double>(x)),
+            .median_dt = median_dt,
         };
     }
 };
 
+// Rows of context a streaming kernel keeps around the row it is computing:
+// `before` rows of input history and `after` rows of look-ahead. Look-ahead
+// shows up as output latency: a kernel emits row i once row i + after is in.
+struct Halo
+{
+    std::size_t before = 0;
+    std::size_t after = 0;
+};
+
+// Row-block streaming form of a stage, used by the fused executor.
+// A kernel is created per segment, consumes that segment's rows in order and
+// emits output rows in order. Whatever state it needs (filter memory, sliding
+// sums, delay lines) is carried across blocks, so the concatenated output is
+// bit-identical to the whole-segment form of the stage. Kernels preserve the
+// row count and x axis; only the column count may change (see out_cols()).
+template <typename T>
+class BlockKernel
+{
+public:
+    virtual ~BlockKernel() = default;
+
+    virtual Halo halo() const = 0;
+
+    virtual std::size_t out_cols() const = 0;
+
+    // Consume n row-major input rows and write the rows that became ready to
+    // out. Returns the number of rows written (never more than n).
+    virtual std::size_t push(const T* in, std::size_t n, T* out) = 0;
+
+    // End of segment: write the rows still held back by the look-ahead
+    // (at most halo().after). Returns the number of rows written.
+    virtual std::size_t finish(T* out) = 0;
+};
+
+template <typename T>
+using KernelFactory = std::function<std::unique_ptr<BlockKernel<T>>(std::size_t n_cols)>;
+
+template <typename T = double>
+using StageFn = std::function<std::vector<TimeSeries<T>>(const std::vector<Segment<T>>&)>;
+
 // A stage transforms segments into time series (one per input segment).
 // Stages may change length (resampling), but typically preserve n_cols.
 // Stages that change dimensionality (FFT) use a different signature.
+//
+// Any callable with the StageFn signature converts to a Stage. Stages that can
+// run on row blocks additionally carry a kernel factory; consecutive streamable
+// stages are fused by run_pipeline so no intermediate series is materialised.
 template <typename T = double>
-using Stage = std::function<std::vector<TimeSeries<T>>(const std::vector<Segment<T>>&)>;
+struct Stage
+{
+    StageFn<T> apply;
+    KernelFactory<T> make_kernel; // empty: the stage needs whole segments
+
+    Stage() = default;
+
+    template <typename F>
+        requires(!std::is_same_v<std::remove_cvref_t<F>, Stage>
+                 && std::is_invocable_r_v<std::vector<TimeSeries<T>>, F&,
+                     const std::vector<Segment<T>>&>)
+    Stage(F&& f) : apply(std::forward<F>(f))
+    {
+    }
+
+    Stage(StageFn<T> fn, KernelFactory<T> kernel)
+            : apply(std::move(fn)), make_kernel(std::move(kernel))
+    {
+    }
+
+    std::vector<TimeSeries<T>> operator()(const std::vector<Segment<T>>& segments) const
+    {
+        return apply(segments);
+    }
+
+    bool streamable() const { return static_cast<bool>(make_kernel); }
+};
 
 namespace detail
 {
+    template <typename T>
+    constexpr T gap_fill_value()
+    {
+        if constexpr (std::is_floating_point_v<T>)
+            return std::numeric_limits<T>::quiet_NaN();
+        else
+            return T { 0 };
+    }
+
+    // Outputs for a stage that keeps the x axis: x copied, y sized for
+    // out_cols columns (0: same as the input).
+    template <typename T>
+    auto alloc_outputs(const std::vector<Segment<T>>& segments, std::size_t out_cols = 0)
+        -> std::vector<TimeSeries<T>>
+    {
+        std::vector<TimeSeries<T>> results(segments.size());
+        parallel_for(segments.size(), [&](std::size_t i) {
+            const auto& seg = segments[i];
+            auto& out = results[i];
+            out.n_cols = out_cols ? out_cols : seg.n_cols;
+            out.x.assign(seg.x.begin(), seg.x.end());
+            out.y.resize(seg.x.size() * out.n_cols);
+        });
+        return results;
+    }
+
+    // Run f(tile) over (segment x column x row block) tiles of segments,
+    // see parallel_for_tiles. cost is the relative work per element.
+    template <typename T, typename F>
+    void for_each_tile(
+        const std::vector<Segment<T>>& segments, TileSplit split, std::size_t cost, F&& f)
+    {
+        std::vector<TileExtent> extents(segments.size());
+        for (std::size_t s = 0; s < segments.size(); ++s)
+            extents[s] = { segments[s].x.size(), segments[s].n_cols };
+        parallel_for_tiles(std::span<const TileExtent>(extents), split, cost, std::forward<F>(f));
+    }
+
     // Reassemble segments into a single TimeSeries, inserting NaN at gap boundaries
     template <typename T>
     auto reassemble(const std::vector<TimeSeries<T>>& segments) -> TimeSeries<T>
@@ -94,12 +212,7 @@ namespace detail
                     = (segments[s - 1].x.back() + segments[s].x.front()) * 0.5;
                 result.x.push_back(gap_t);
                 for (std::size_t c = 0; c < n_cols; ++c)
-                {
-                    if constexpr (std::is_floating_point_v<T>)
-                        result.y.push_back(std::numeric_limits<T>::quiet_NaN());
-                    else
-                        result.y.push_back(T { 0 });
-                }
+                    result.y.push_back(gap_fill_value<T>());
             }
             result.x.insert(result.x.end(), segments[s].x.begin(), segments[s].x.end());
             result.y.insert(result.y.end(), segments[s].y.begin(), segments[s].y.end());
@@ -108,9 +221,192 @@ namespace detail
         return result;
     }
 
+    // Per-thread scratch reused by the fused executor. Buffers only grow, so
+    // after the first redraw a pipeline run does no allocation for its
+    // intermediate blocks.
+    template <typename T>
+    struct ScratchArena
+    {
+        std::vector<T> ping;
+        std::vector<T> pong;
+
+        void reserve(std::size_t n)
+        {
+            if (ping.size() < n)
+                ping.resize(n);
+            if (pong.size() < n)
+                pong.resize(n);
+        }
+    };
+
+    template <typename T>
+    ScratchArena<T>& scratch_arena()
+    {
+        thread_local ScratchArena<T> arena;
+        return arena;
+    }
+
+    // Rows per block: keep each intermediate block around 64 KiB so the
+    // ping-pong pair stays in L2 while it flows through all fused stages.
+    inline std::size_t fused_block_rows(std::size_t n_cols, std::size_t elem_size)
+    {
+        constexpr std::size_t kBlockBytes = 64 * 1024;
+        constexpr std::size_t kMinRows = 256;
+        const auto row_bytes = std::max<std::size_t>(1, n_cols * elem_size);
+        return std::max(kMinRows, kBlockBytes / row_bytes);
+    }
+
+    template <typename T>
+    using KernelChain = std::vector<std::unique_ptr<BlockKernel<T>>>;
+
+    template <typename T>
+    auto make_kernel_chain(std::span<const Stage<T>> stages, std::size_t n_cols) -> KernelChain<T>
+    {
+        KernelChain<T> chain;
+        chain.reserve(stages.size());
+        for (const auto& stage : stages)
+        {
+            chain.push_back(stage.make_kernel(n_cols));
+            n_cols = chain.back()->out_cols();
+        }
+        return chain;
+    }
+
+    // Stream one segment through a chain of kernels, writing the final rows
+    // to out (seg.x.size() rows of the last kernel's out_cols()).
+    template <typename T>
+    void run_fused_segment(const Segment<T>& seg, KernelChain<T>& chain, T* out)
+    {
+        const auto n_rows = seg.x.size();
+        const auto n_stages = chain.size();
+        std::size_t max_cols = seg.n_cols;
+        std::size_t total_after = 0;
+        for (const auto& k : chain)
+        {
+            max_cols = std::max(max_cols, k->out_cols());
+            total_after += k->halo().after;
+        }
+        const auto out_cols = chain.back()->out_cols();
+        const auto block_rows = fused_block_rows(max_cols, sizeof(T));
+
+        auto& arena = scratch_arena<T>();
+        arena.reserve((block_rows + total_after) * max_cols);
+        T* buffers[2] = { arena.ping.data(), arena.pong.data() };
+
+        std::size_t written = 0;
+
+        // Push n rows into stage `first` and carry whatever comes out through
+        // the remaining stages; the last stage writes straight into out.
+        auto feed = [&](std::size_t first, const T* in, std::size_t n)
+        {
+            for (std::size_t s = first; s < n_stages && n > 0; ++s)
+            {
+                T* dst = (s + 1 == n_stages) ? out + written * out_cols : buffers[s & 1];
+                n = chain[s]->push(in, n, dst);
+                in = dst;
+            }
+            if (first < n_stages)
+                written += n;
+        };
+
+        for (std::size_t row = 0; row < n_rows; row += block_rows)
+        {
+            const auto n = std::min(block_rows, n_rows - row);
+            feed(0, seg.y.data() + row * seg.n_cols, n);
+        }
+
+        // Drain look-ahead tails front to back so every stage sees its
+        // upstream rows before it is finished itself.
+        for (std::size_t s = 0; s < n_stages; ++s)
+        {
+            const bool last = (s + 1 == n_stages);
+            T* dst = last ? out + written * out_cols : buffers[s & 1];
+            const auto n = chain[s]->finish(dst);
+            if (last)
+                written += n;
+            else
+                feed(s + 1, dst, n);
+        }
+        assert(written == n_rows);
+    }
+
+    // Run a run of streamable stages over every segment, one output series
+    // per segment.
+    template <typename T>
+    auto run_fused(const std::vector<Segment<T>>& segments, std::span<const Stage<T>> stages)
+        -> std::vector<TimeSeries<T>>
+    {
+        std::vector<TimeSeries<T>> results(segments.size());
+        parallel_for(segments.size(), [&](std::size_t i) {
+            const auto& seg = segments[i];
+            auto chain = make_kernel_chain(stages, seg.n_cols);
+            auto& out = results[i];
+            out.x.assign(seg.x.begin(), seg.x.end());
+            out.n_cols = chain.back()->out_cols();
+            out.y.resize(seg.x.size() * out.n_cols);
+            run_fused_segment(seg, chain, out.y.data());
+        });
+        return results;
+    }
+
+    // Same as reassemble(run_fused(...)) without the per-segment copies:
+    // segments are streamed straight into their slot of the final series.
+    template <typename T>
+    auto run_fused_reassembled(
+        const std::vector<Segment<T>>& segments, std::span<const Stage<T>> stages)
+        -> TimeSeries<T>
+    {
+        std::vector<KernelChain<T>> chains(segments.size());
+        for (std::size_t i = 0; i < segments.size(); ++i)
+            chains[i] = make_kernel_chain(stages, segments[i].n_cols);
+
+        const std::size_t n_cols = chains.front().back()->out_cols();
+        std::size_t out_rows = segments.size() - 1;
+        for (const auto& seg : segments)
+            out_rows += seg.x.size();
+
+        TimeSeries<T> result;
+        result.n_cols = n_cols;
+        result.x.reserve(out_rows);
+        result.y.resize(out_rows * n_cols);
+
+        std::vector<std::size_t> offsets(segments.size());
+        for (std::size_t s = 0; s < segments.size(); ++s)
+        {
+            if (s > 0)
+            {
+                const double gap_t = (segments[s - 1].x.back() + segments[s].x.front()) * 0.5;
+                const auto row = static_cast<std::ptrdiff_t>(result.x.size() * n_cols);
+                std::fill_n(result.y.begin() + row, n_cols, gap_fill_value<T>());
+                result.x.push_back(gap_t);
+            }
+            offsets[s] = result.x.size();
+            result.x.insert(result.x.end(), segments[s].x.begin(), segments[s].x.end());
+        }
+
+        parallel_for(segments.size(), [&](std::size_t i) {
+            run_fused_segment(segments[i], chains[i], result.y.data() + offsets[i] * n_cols);
+        });
+        return result;
+    }
+
+    // View a stage's output as the next stage's input. Each series computes
+    // its median_dt once and keeps it for as long as x is unchanged.
+    template <typename T>
+    auto as_segments(std::vector<TimeSeries<T>>& series) -> std::vector<Segment<T>>
+    {
+        std::vector<Segment<T>> segments(series.size());
+        parallel_for(series.size(), [&](std::size_t i) { segments[i] = series[i].as_segment(); });
+        return segments;
+    }
+
 } // namespace detail
 
-// Run a pipeline: split data at gaps, apply stages sequentially, reassemble
+// Run a pipeline: split data at gaps, apply stages sequentially, reassemble.
+// Consecutive streamable stages are fused: each segment flows through them in
+// cache-sized blocks with ping-pong scratch from a per-thread arena, instead
+// of materialising a full series after every stage. Results are bit-identical
+// to running the stages one after the other.
 template <typename T = double>
 auto run_pipeline(
     std::span<const double> x,
@@ -124,31 +420,10 @@ auto run_pipeline(
     if (segments.empty())
         return {};
 
-    // For the first stage, feed the original segments
-    // For subsequent stages, convert previous output back to segments
-    std::vector<TimeSeries<T>> current;
-
-    for (const auto& stage : stages)
-    {
-        if (current.empty())
-        {
-            // First stage: use original segments
-            current = stage(segments);
-        }
-        else
-        {
-            // Subsequent stages: convert TimeSeries back to segments
-            std::vector<Segment<T>> intermediate;
-            intermediate.reserve(current.size());
-            for (const auto& ts : current)
-                intermediate.push_back(ts.as_segment());
-            current = stage(intermediate);
-        }
-    }
-
-    if (current.empty())
+    if (stages.empty())
     {
         // No stages — just copy segments as-is
+        std::vector<TimeSeries<T>> current;
         for (const auto& seg : segments)
         {
             current.push_back(TimeSeries<T> {
@@ -157,6 +432,42 @@ auto run_pipeline(
                 .n_cols = seg.n_cols,
             });
         }
+        return detail::reassemble(current);
+    }
+
+    // The first stage sees the original segments (global median_dt); later
+    // stages see the previous output with a per-series median_dt.
+    std::vector<TimeSeries<T>> current;
+    bool first = true;
+
+    std::size_t i = 0;
+    while (i < stages.size())
+    {
+        auto inputs = first ? std::move(segments) : detail::as_segments(current);
+
+        std::size_t j = i;
+        while (j < stages.size() && stages[j].streamable())
+            ++j;
+
+        if (j > i)
+        {
+            const auto run = stages.subspan(i, j - i);
+            if (j == stages.size())
+                return detail::run_fused_reassembled(inputs, run);
+            current = detail::run_fused(inputs, run);
+            // Kernels keep x, so the inputs' cadence carries over — except for
+            // the original segments, whose median_dt is the global one.
+            if (!first)
+                for (std::size_t s = 0; s < current.size(); ++s)
+                    current[s].median_dt = inputs[s].median_dt;
+            i = j;
+        }
+        else
+        {
+            current = stages[i](inputs);
+            ++i;
+        }
+        first = false;
     }
 
     return detail::reassemble(current);
@@ -28,6 +28,7 @@
 #include <cmath>
 #include <cstddef>
 #include <limits>
+#include <memory>
 #include <vector>
 
 namespace sqp::dsp
@@ -312,28 +313,51 @@ namespace detail
             reduce_axes_general(row, spec, op, out);
     }
 
+    // Streaming form of the reduce stage: row-local, no halo.
+    template <typename T>
+    class ReduceKernel final : public BlockKernel<T>
+    {
+    public:
+        ReduceKernel(ReduceOp op, std::size_t n_cols) : m_op(op), m_n_cols(n_cols) { }
+
+        Halo halo() const override { return {}; }
+
+        std::size_t out_cols() const override { return 1; }
+
+        std::size_t push(const T* in, std::size_t n, T* out) override
+        {
+            for (std::size_t row = 0; row < n; ++row)
+                out[row] = reduce_row(&in[row * m_n_cols], m_n_cols, m_op);
+            return n;
+        }
+
+        std::size_t finish(T*) override { return 0; }
+
+    private:
+        ReduceOp m_op;
+        std::size_t m_n_cols;
+    };
+
 } // namespace detail
 
 // Pipeline stage: reduce n_cols → 1 column per row.
 template <typename T = double>
 auto reduce(ReduceOp op) -> Stage<T>
 {
-    return [op](const std::vector<Segment<T>>& segments) -> std::vector<TimeSeries<T>>
+    auto apply = [op](const std::vector<Segment<T>>& segments) -> std::vector<TimeSeries<T>>
     {
-        std::vector<TimeSeries<T>> results(segments.size());
-        parallel_for(segments.size(), [&](std::size_t i) {
-            const auto& seg = segments[i];
-            const auto n_rows = seg.x.size();
-            auto& out = results[i];
-            out.x.assign(seg.x.begin(), seg.x.end());
-            out.y.resize(n_rows);
-            out.n_cols = 1;
-
-            for (std::size_t row = 0; row < n_rows; ++row)
+        auto results = detail::alloc_outputs(segments, 1);
+        detail::for_each_tile(segments, TileSplit::Rows, 1, [&](const Tile& tile) {
+            const auto& seg = segments[tile.segment];
+            auto& out = results[tile.segment];
+            for (std::size_t row = tile.row_begin; row < tile.row_end; ++row)
                 out.y[row] = detail::reduce_row(&seg.y[row * seg.n_cols], seg.n_cols, op);
         });
         return results;
     };
+    auto kernel = [op](std::size_t n_cols) -> std::unique_ptr<BlockKernel<T>>
+    { return std::make_unique<detail::ReduceKernel<T>>(op, n_cols); };
+    return Stage<T>(std::move(apply), std::move(kernel));
 }
 
 } // namespace sqp::dsp
@@ -25,8 +25,11 @@
 #include "Pipeline.hpp"
 #include "Segments.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <limits>
+#include <span>
 #include <vector>
 
 namespace sqp::dsp
@@ -36,13 +39,23 @@ namespace detail
 {
     // Linear interpolation of a single column from irregular to uniform grid.
     // src_x must be sorted. Output written to dst_y.
+    // Only rows [row_begin, row_end) of the destination are written (whole
+    // column by default), so row blocks can be interpolated independently.
     template <typename T>
     void interp_column(
         const double* src_x, const T* src_y, std::size_t src_rows, std::size_t src_cols,
-        std::size_t col, const double* dst_x, T* dst_y, std::size_t dst_rows, std::size_t dst_cols)
+        std::size_t col, const double* dst_x, T* dst_y, std::size_t dst_rows, std::size_t dst_cols,
+        std::size_t row_begin = 0, std::size_t row_end = std::numeric_limits<std::size_t>::max())
     {
+        row_end = std::min(row_end, dst_rows);
+        // Resume where a sequential scan from row 0 would be: last src_x <= t
         std::size_t j = 0; // index into source
-        for (std::size_t i = 0; i < dst_rows; ++i)
+        if (row_begin > 0 && row_begin < row_end && src_rows > 1)
+        {
+            const auto* it = std::upper_bound(src_x + 1, src_x + src_rows, dst_x[row_begin]);
+            j = static_cast<std::size_t>(it - src_x) - 1;
+        }
+        for (std::size_t i = row_begin; i < row_end; ++i)
         {
             const double t = dst_x[i];
 
@@ -77,55 +90,46 @@ namespace detail
         }
     }
 
+    // Set up the uniform grid of a resampled segment: out.x filled, out.y sized.
+    // Returns false when the segment cannot be resampled (fewer than 2 rows, no
+    // usable dt, or too many output rows); out is then a copy of seg.
     template <typename T>
-    auto resample_segment_uniform(const Segment<T>& seg, double target_dt) -> TimeSeries<T>
+    bool resample_grid(const Segment<T>& seg, double target_dt, TimeSeries<T>& out)
     {
-        if (seg.x.size() < 2)
-        {
-            return TimeSeries<T> {
-                .x = std::vector<double>(seg.x.begin(), seg.x.end()),
-                .y = std::vector<T>(seg.y.begin(), seg.y.end()),
-                .n_cols = seg.n_cols,
-            };
-        }
-
+        out.n_cols = seg.n_cols;
         const double dt = (target_dt > 0.0) ? target_dt : seg.median_dt;
-        if (dt <= 0.0)
-        {
-            return TimeSeries<T> {
-                .x = std::vector<double>(seg.x.begin(), seg.x.end()),
-                .y = std::vector<T>(seg.y.begin(), seg.y.end()),
-                .n_cols = seg.n_cols,
-            };
-        }
-
-        const double x_start = seg.x.front();
-        const double x_end = seg.x.back();
-        const double n_out_f = std::floor((x_end - x_start) / dt) + 1.0;
+        const double n_out_f = (seg.x.size() < 2 || dt <= 0.0)
+            ? 0.0
+            : std::floor((seg.x.back() - seg.x.front()) / dt) + 1.0;
         constexpr double kMaxOut = 100'000'000.0;
         if (n_out_f <= 0.0 || n_out_f > kMaxOut)
         {
-            return TimeSeries<T> {
-                .x = std::vector<double>(seg.x.begin(), seg.x.end()),
-                .y = std::vector<T>(seg.y.begin(), seg.y.end()),
-                .n_cols = seg.n_cols,
-            };
+            out.x.assign(seg.x.begin(), seg.x.end());
+            out.y.assign(seg.y.begin(), seg.y.end());
+            return false;
         }
         const auto n_out = static_cast<std::size_t>(n_out_f);
+        const double x_start = seg.x.front();
 
-        TimeSeries<T> out;
-        out.n_cols = seg.n_cols;
         out.x.resize(n_out);
         out.y.resize(n_out * seg.n_cols);
-
         for (std::size_t i = 0; i < n_out; ++i)
             out.x[i] = x_start + static_cast<double>(i) * dt;
+        return true;
+    }
+
+    template <typename T>
+    auto resample_segment_uniform(const Segment<T>& seg, double target_dt) -> TimeSeries<T>
+    {
+        TimeSeries<T> out;
+        if (!resample_grid(seg, target_dt, out))
+            return out;
 
         for (std::size_t col = 0; col < seg.n_cols; ++col)
         {
             interp_column(
                 seg.x.data(), seg.y.data(), seg.x.size(), seg.n_cols, col,
-                out.x.data(), out.y.data(), n_out, out.n_cols);
+                out.x.data(), out.y.data(), out.x.size(), out.n_cols);
         }
 
         return out;
@@ -141,9 +145,20 @@ auto resample_uniform(double target_dt = 0.0) -> Stage<T>
     return [target_dt](const std::vector<Segment<T>>& segments) -> std::vector<TimeSeries<T>>
     {
         std::vector<TimeSeries<T>> results(segments.size());
+        std::vector<TileExtent> extents(segments.size());
         parallel_for(segments.size(), [&](std::size_t i) {
-            results[i] = detail::resample_segment_uniform(segments[i], target_dt);
+            if (detail::resample_grid(segments[i], target_dt, results[i]))
+                extents[i] = { results[i].x.size(), segments[i].n_cols };
         });
+        parallel_for_tiles(std::span<const TileExtent>(extents), TileSplit::Both, 2,
+            [&](const Tile& tile) {
+                const auto& seg = segments[tile.segment];
+                auto& out = results[tile.segment];
+                for (std::size_t col = tile.col_begin; col < tile.col_end; ++col)
+                    detail::interp_column(seg.x.data(), seg.y.data(), seg.x.size(), seg.n_cols,
+                        col, out.x.data(), out.y.data(), out.x.size(), out.n_cols,
+                        tile.row_begin, tile.row_end);
+            });
         return results;
     };
 }
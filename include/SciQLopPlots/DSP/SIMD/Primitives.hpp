@@ -30,7 +30,9 @@
 
 #include "Dispatch.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <complex>
 #include <cstddef>
 #include <limits>
 #include <utility>
@@ -38,6 +40,46 @@
 namespace sqp::dsp::simd
 {
 
+// Range and count of a set of finite adjacent differences of a time axis.
+struct DiffRange
+{
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -std::numeric_limits<double>::infinity();
+    std::size_t count = 0;
+
+    void merge(const DiffRange& other)
+    {
+        lo = std::min(lo, other.lo);
+        hi = std::max(hi, other.hi);
+        count += other.count;
+    }
+};
+
+// One pass of the cadence estimator: all finite differences, how many fall
+// below a window [w_lo, w_hi], and the ones inside it.
+struct DiffCounts
+{
+    DiffRange all;
+    std::size_t below = 0;
+    DiffRange inside;
+
+    void merge(const DiffCounts& other)
+    {
+        all.merge(other.all);
+        below += other.below;
+        inside.merge(other.inside);
+    }
+};
+
+// Moment accumulators of `width` lanes are stored field-major (SoA): field f
+// of lane l is state[f * width + l]. Sums are compensated (TwoSum) and taken
+// over x - shift[l], which keeps the x^2 sums clear of the mean's magnitude.
+// Sliding moments: sum, its compensation, sum of squares, its compensation,
+// sample count (the x^2 sums stay 0 for means only).
+inline constexpr std::size_t rolling_state_fields = 5;
+// Block moments: the sliding fields, then min and max of the unshifted x.
+inline constexpr std::size_t column_state_fields = 7;
+
 // ── Scalar fallbacks ────────────────────────────────────────────────────────
 // Used on architectures without SIMD or as tail-loop handlers.
 
@@ -128,6 +170,215 @@ std::size_t nan_count(const T* data, std::size_t n)
     return count;
 }
 
+// Copies the finite data[i] to out, in order; returns how many.
+template <typename T>
+std::size_t copy_finite(const T* data, std::size_t n, T* out)
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            if (!std::isfinite(data[i]))
+                continue;
+        }
+        out[count++] = data[i];
+    }
+    return count;
+}
+
+// Counts of the finite d = x[i+1] - x[i], i in [0, n) (x has n+1 elements),
+// against the window [w_lo, w_hi].
+inline DiffCounts diff_counts(const double* x, std::size_t n, double w_lo, double w_hi)
+{
+    DiffCounts c;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const double d = x[i + 1] - x[i];
+        if (!std::isfinite(d))
+            continue;
+        c.all.lo = std::min(c.all.lo, d);
+        c.all.hi = std::max(c.all.hi, d);
+        ++c.all.count;
+        if (d < w_lo)
+            ++c.below;
+        else if (d <= w_hi)
+        {
+            c.inside.lo = std::min(c.inside.lo, d);
+            c.inside.hi = std::max(c.inside.hi, d);
+            ++c.inside.count;
+        }
+    }
+    return c;
+}
+
+// First i in [0, n) with x[i+1] - x[i] > threshold, or n.
+inline std::size_t first_diff_above(const double* x, std::size_t n, double threshold)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (x[i + 1] - x[i] > threshold)
+            return i;
+    }
+    return n;
+}
+
+// Compensated step (TwoSum): comp collects the exact rounding error of each
+// addition, so sum + comp tracks the exact sum. Branch-free, unlike Neumaier.
+inline void compensated_add(double& sum, double& comp, double x)
+{
+    const double t = sum + x;
+    const double z = t - sum;
+    comp += (sum - (t - z)) + (x - z);
+    sum = t;
+}
+
+// Window mean and sample standard deviation from compensated moments
+// (s, q: sums of x - shift and of its square). Empty windows give 0.
+// inv is 1 / count for the mean and 1 / (count * (count - 1)) for the
+// standard deviation: it only changes with the count, so the SIMD loop
+// divides only on the rows where some lane's count moved.
+inline double window_mean(double shift, double s, double count, double inv)
+{
+    return (count > 0.0) ? shift + s * inv : 0.0;
+}
+
+inline double window_std(double s, double q, double count, double inv)
+{
+    const double var = (q * count - s * s) * inv;
+    return (count > 1.0 && var > 0.0) ? std::sqrt(var) : 0.0;
+}
+
+// Sliding-window moments over lanes [lane_begin, lane_end) of `width`
+// interleaved lanes (row r of lane l at r * width + l). Row r adds enter[r],
+// then drops leave[r], then writes the window's mean, or its sample standard
+// deviation when with_std; NaN stands for "no sample" on either side.
+// Written branch-free so the SIMD form performs the same operations per lane,
+// bit for bit.
+inline void rolling_moments_lanes(const double* enter, const double* leave, std::size_t n_rows,
+    std::size_t width, std::size_t lane_begin, std::size_t lane_end, const double* shift,
+    double* state, double* out, bool with_std)
+{
+    for (std::size_t l = lane_begin; l < lane_end; ++l)
+    {
+        double sum = state[l], sum_c = state[width + l];
+        double sq = state[2 * width + l], sq_c = state[3 * width + l];
+        double count = state[4 * width + l];
+        for (std::size_t r = 0; r < n_rows; ++r)
+        {
+            const double a = enter[r * width + l];
+            const double d = leave[r * width + l];
+            const double in = std::isnan(a) ? 0.0 : a;
+            const double gone = std::isnan(d) ? 0.0 : d;
+            compensated_add(sum, sum_c, in);
+            compensated_add(sum, sum_c, -gone);
+            count += (std::isnan(a) ? 0.0 : 1.0) - (std::isnan(d) ? 0.0 : 1.0);
+            if (with_std)
+            {
+                compensated_add(sq, sq_c, in * in);
+                compensated_add(sq, sq_c, -(gone * gone));
+                out[r * width + l] = window_std(
+                    sum + sum_c, sq + sq_c, count, 1.0 / (count * (count - 1.0)));
+            }
+            else
+            {
+                out[r * width + l] = window_mean(shift[l], sum + sum_c, count, 1.0 / count);
+            }
+        }
+        state[l] = sum;
+        state[width + l] = sum_c;
+        state[2 * width + l] = sq;
+        state[3 * width + l] = sq_c;
+        state[4 * width + l] = count;
+    }
+}
+
+inline void rolling_moments(const double* enter, const double* leave, std::size_t n_rows,
+    std::size_t width, const double* shift, double* state, double* out, bool with_std)
+{
+    rolling_moments_lanes(enter, leave, n_rows, width, 0, width, shift, state, out, with_std);
+}
+
+// Lanes of rows [r_begin, r_end) spaced lane_stride apart, interleaved
+// into the rolling_moments layout: dst[r * width + l] = src[l * lane_stride
+// + r] - shift[l].
+inline void gather_lanes_rows(const double* src, std::size_t lane_stride, std::size_t r_begin,
+    std::size_t r_end, std::size_t width, const double* shift, double* dst)
+{
+    for (std::size_t r = r_begin; r < r_end; ++r)
+        for (std::size_t l = 0; l < width; ++l)
+            dst[r * width + l] = src[l * lane_stride + r] - shift[l];
+}
+
+inline void gather_lanes(const double* src, std::size_t lane_stride, std::size_t n_rows,
+    std::size_t width, const double* shift, double* dst)
+{
+    gather_lanes_rows(src, lane_stride, 0, n_rows, width, shift, dst);
+}
+
+// The reverse: dst[l * lane_stride + r] = src[r * width + l].
+inline void scatter_lanes_rows(const double* src, std::size_t r_begin, std::size_t r_end,
+    std::size_t width, double* dst, std::size_t lane_stride)
+{
+    for (std::size_t l = 0; l < width; ++l)
+        for (std::size_t r = r_begin; r < r_end; ++r)
+            dst[l * lane_stride + r] = src[r * width + l];
+}
+
+inline void scatter_lanes(const double* src, std::size_t n_rows, std::size_t width, double* dst,
+    std::size_t lane_stride)
+{
+    scatter_lanes_rows(src, 0, n_rows, width, dst, lane_stride);
+}
+
+// Block moments of columns [lane_begin, lane_end) of n_rows rows spaced
+// `stride` apart, accumulated into a column_state_fields state of `width`
+// lanes. NaN samples are skipped.
+inline void column_moments_lanes(const double* data, std::size_t n_rows, std::size_t stride,
+    std::size_t width, std::size_t lane_begin, std::size_t lane_end, const double* shift,
+    double* state)
+{
+    for (std::size_t l = lane_begin; l < lane_end; ++l)
+    {
+        double sum = state[l], sum_c = state[width + l];
+        double sq = state[2 * width + l], sq_c = state[3 * width + l];
+        double count = state[4 * width + l];
+        double lo = state[5 * width + l], hi = state[6 * width + l];
+        for (std::size_t r = 0; r < n_rows; ++r)
+        {
+            const double x = data[r * stride + l];
+            if (std::isnan(x))
+                continue;
+            const double v = x - shift[l];
+            compensated_add(sum, sum_c, v);
+            compensated_add(sq, sq_c, v * v);
+            count += 1.0;
+            lo = std::min(lo, x);
+            hi = std::max(hi, x);
+        }
+        state[l] = sum;
+        state[width + l] = sum_c;
+        state[2 * width + l] = sq;
+        state[3 * width + l] = sq_c;
+        state[4 * width + l] = count;
+        state[5 * width + l] = lo;
+        state[6 * width + l] = hi;
+    }
+}
+
+inline void column_moments(const double* data, std::size_t n_rows, std::size_t stride,
+    std::size_t width, const double* shift, double* state)
+{
+    column_moments_lanes(data, n_rows, stride, width, 0, width, shift, state);
+}
+
+// Power of complex bins: out[i] = re^2 + im^2
+inline void complex_power(const std::complex<double>* z, double* out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = z[i].real() * z[i].real() + z[i].imag() * z[i].imag();
+}
+
 // Welford online: accumulate a block into running (mean, M2, count)
 template <typename T>
 void welford_accumulate(const T* data, std::size_t n, double& mean, double& m2, std::size_t& count)
@@ -387,6 +638,79 @@ float nan_reduce_sum_t::operator()(Arch, const float* data, std::size_t n)
     return result;
 }
 
+// Finite compress-store: out receives the finite data[i] in order — the
+// gather of percentile autoscale. Batches without NaN or inf (the common
+// case) are stored whole; the others go lane by lane.
+struct copy_finite_t
+{
+    template <class Arch>
+    std::size_t operator()(Arch, const double* data, std::size_t n, double* out);
+
+    template <class Arch>
+    std::size_t operator()(Arch, const float* data, std::size_t n, float* out);
+};
+
+template <class Arch>
+std::size_t copy_finite_t::operator()(Arch, const double* data, std::size_t n, double* out)
+{
+    using batch_t = xsimd::batch<double, Arch>;
+    constexpr auto simd_size = batch_t::size;
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + simd_size <= n; i += simd_size)
+    {
+        const auto v = batch_t::load_unaligned(data + i);
+        // v - v is 0 on finite lanes and NaN on NaN and +-inf ones.
+        if (xsimd::all((v - v) == batch_t(0.0)))
+        {
+            v.store_unaligned(out + count);
+            count += simd_size;
+            continue;
+        }
+        for (std::size_t lane = 0; lane < simd_size; ++lane)
+        {
+            if (std::isfinite(data[i + lane]))
+                out[count++] = data[i + lane];
+        }
+    }
+    for (; i < n; ++i)
+    {
+        if (std::isfinite(data[i]))
+            out[count++] = data[i];
+    }
+    return count;
+}
+
+template <class Arch>
+std::size_t copy_finite_t::operator()(Arch, const float* data, std::size_t n, float* out)
+{
+    using batch_t = xsimd::batch<float, Arch>;
+    constexpr auto simd_size = batch_t::size;
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + simd_size <= n; i += simd_size)
+    {
+        const auto v = batch_t::load_unaligned(data + i);
+        if (xsimd::all((v - v) == batch_t(0.0f)))
+        {
+            v.store_unaligned(out + count);
+            count += simd_size;
+            continue;
+        }
+        for (std::size_t lane = 0; lane < simd_size; ++lane)
+        {
+            if (std::isfinite(data[i + lane]))
+                out[count++] = data[i + lane];
+        }
+    }
+    for (; i < n; ++i)
+    {
+        if (std::isfinite(data[i]))
+            out[count++] = data[i];
+    }
+    return count;
+}
+
 // Adjacent difference: out[i] = data[i+1] - data[i], n = output length (input has n+1 elements).
 struct adjacent_diff_t
 {
@@ -410,6 +734,365 @@ void adjacent_diff_t::operator()(Arch, const double* data, double* out, std::siz
         out[i] = data[i + 1] - data[i];
 }
 
+// Window counts of a time axis — the cadence estimator's main pass. Masks
+// replace the scalar branches; non-finite differences match no mask.
+struct diff_counts_t
+{
+    template <class Arch>
+    DiffCounts operator()(Arch, const double* x, std::size_t n, double w_lo, double w_hi);
+};
+
+template <class Arch>
+DiffCounts diff_counts_t::operator()(Arch, const double* x, std::size_t n, double w_lo,
+    double w_hi)
+{
+    using batch_t = xsimd::batch<double, Arch>;
+    constexpr auto simd_size = batch_t::size;
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    const auto vw_lo = batch_t(w_lo);
+    const auto vw_hi = batch_t(w_hi);
+    const auto one = batch_t(1.0);
+    const auto zero = batch_t(0.0);
+    auto all_lo = batch_t(inf), all_hi = batch_t(-inf), all_n = zero;
+    auto in_lo = batch_t(inf), in_hi = batch_t(-inf), in_n = zero;
+    auto below_n = zero;
+    std::size_t i = 0;
+    for (; i + simd_size <= n; i += simd_size)
+    {
+        const auto d = batch_t::load_unaligned(x + i + 1) - batch_t::load_unaligned(x + i);
+        const auto finite = xsimd::isfinite(d);
+        all_lo = xsimd::min(all_lo, xsimd::select(finite, d, batch_t(inf)));
+        all_hi = xsimd::max(all_hi, xsimd::select(finite, d, batch_t(-inf)));
+        all_n += xsimd::select(finite, one, zero);
+        below_n += xsimd::select(finite & (d < vw_lo), one, zero);
+        const auto inside = (d >= vw_lo) & (d <= vw_hi) & finite;
+        in_lo = xsimd::min(in_lo, xsimd::select(inside, d, batch_t(inf)));
+        in_hi = xsimd::max(in_hi, xsimd::select(inside, d, batch_t(-inf)));
+        in_n += xsimd::select(inside, one, zero);
+    }
+    DiffCounts c;
+    c.all = { xsimd::reduce_min(all_lo), xsimd::reduce_max(all_hi),
+        static_cast<std::size_t>(xsimd::reduce_add(all_n)) };
+    c.below = static_cast<std::size_t>(xsimd::reduce_add(below_n));
+    c.inside = { xsimd::reduce_min(in_lo), xsimd::reduce_max(in_hi),
+        static_cast<std::size_t>(xsimd::reduce_add(in_n)) };
+    c.merge(scalar::diff_counts(x + i, n - i, w_lo, w_hi));
+    return c;
+}
+
+// Gap scan: first i with x[i+1] - x[i] > threshold, or n. Whole batches are
+// tested with one any(); the hit is located by the scalar tail.
+struct first_diff_above_t
+{
+    template <class Arch>
+    std::size_t operator()(Arch, const double* x, std::size_t n, double threshold);
+};
+
+template <class Arch>
+std::size_t first_diff_above_t::operator()(Arch, const double* x, std::size_t n, double threshold)
+{
+    using batch_t = xsimd::batch<double, Arch>;
+    constexpr auto simd_size = batch_t::size;
+    const auto thr = batch_t(threshold);
+    std::size_t i = 0;
+    for (; i + simd_size <= n; i += simd_size)
+    {
+        const auto d = batch_t::load_unaligned(x + i + 1) - batch_t::load_unaligned(x + i);
+        if (xsimd::any(d > thr))
+            break;
+    }
+    return i + scalar::first_diff_above(x + i, n - i, threshold);
+}
+
+// Sliding-window moments, one lane per SIMD slot: the rolling_mean /
+// rolling_std inner loop. Lanes are independent windows (columns, or row
+// chunks of one column) advanced in lockstep, so the sums' dependency chains
+// run side by side instead of one after the other. `dense` promises no NaN
+// in enter and leave: the counts then stay put and the NaN masking is
+// skipped, with the same result as the masked form.
+struct rolling_moments_t
+{
+    template <class Arch>
+    void operator()(Arch, const double* enter, const double* leave, std::size_t n_rows,
+        std::size_t width, const double* shift, double* state, double* out, bool with_std,
+        bool dense);
+};
+
+// Sliding moments of one batch of lanes, held in registers across rows.
+template <class Arch, bool WithStd, bool Dense>
+struct RollingBatch
+{
+    using batch_t = xsimd::batch<double, Arch>;
+
+    batch_t sum, sum_c, sq, sq_c, count, shift, inv;
+
+    static batch_t inverse(batch_t c)
+    {
+        const auto one = batch_t(1.0);
+        return one / (WithStd ? c * (c - one) : c);
+    }
+
+    static void compensated(batch_t& total, batch_t& comp, batch_t x)
+    {
+        const auto t = total + x;
+        const auto z = t - total;
+        comp += (total - (t - z)) + (x - z);
+        total = t;
+    }
+
+    void load(const double* state, std::size_t width, const double* shifts, std::size_t at)
+    {
+        sum = batch_t::load_unaligned(state + at);
+        sum_c = batch_t::load_unaligned(state + width + at);
+        sq = batch_t::load_unaligned(state + 2 * width + at);
+        sq_c = batch_t::load_unaligned(state + 3 * width + at);
+        count = batch_t::load_unaligned(state + 4 * width + at);
+        shift = batch_t::load_unaligned(shifts + at);
+        inv = inverse(count);
+    }
+
+    void store(double* state, std::size_t width, std::size_t at) const
+    {
+        sum.store_unaligned(state + at);
+        sum_c.store_unaligned(state + width + at);
+        sq.store_unaligned(state + 2 * width + at);
+        sq_c.store_unaligned(state + 3 * width + at);
+        count.store_unaligned(state + 4 * width + at);
+    }
+
+    void step(const double* enter, const double* leave, double* out)
+    {
+        const auto zero = batch_t(0.0);
+        const auto one = batch_t(1.0);
+        auto in = batch_t::load_unaligned(enter);
+        auto gone = batch_t::load_unaligned(leave);
+        if constexpr (!Dense)
+        {
+            const auto a_nan = xsimd::isnan(in);
+            const auto d_nan = xsimd::isnan(gone);
+            in = xsimd::select(a_nan, zero, in);
+            gone = xsimd::select(d_nan, zero, gone);
+            const auto moved = xsimd::select(a_nan, zero, one) - xsimd::select(d_nan, zero, one);
+            count += moved;
+            if (xsimd::any(moved != zero))
+                inv = inverse(count);
+        }
+        compensated(sum, sum_c, in);
+        compensated(sum, sum_c, -gone);
+        if constexpr (WithStd)
+        {
+            compensated(sq, sq_c, in * in);
+            compensated(sq, sq_c, -(gone * gone));
+            const auto s = sum + sum_c;
+            const auto var = ((sq + sq_c) * count - s * s) * inv;
+            xsimd::select((count > one) & (var > zero), xsimd::sqrt(var), zero)
+                .store_unaligned(out);
+        }
+        else
+        {
+            xsimd::select(count > zero, shift + (sum + sum_c) * inv, zero).store_unaligned(out);
+        }
+    }
+};
+
+// Lanes [lane, lane + N batches): N = 2 gives the out-of-order core two
+// independent dependency chains to overlap.
+template <class Arch, bool WithStd, bool Dense, std::size_t N>
+void rolling_moments_batches(const double* enter, const double* leave, std::size_t n_rows,
+    std::size_t width, std::size_t lane, const double* shift, double* state, double* out)
+{
+    constexpr auto simd_size = xsimd::batch<double, Arch>::size;
+    const auto next = lane + simd_size;
+    RollingBatch<Arch, WithStd, Dense> first, second;
+    first.load(state, width, shift, lane);
+    if constexpr (N == 2)
+        second.load(state, width, shift, next);
+    for (std::size_t r = 0; r < n_rows; ++r)
+    {
+        const auto row = r * width;
+        first.step(enter + row + lane, leave + row + lane, out + row + lane);
+        if constexpr (N == 2)
+            second.step(enter + row + next, leave + row + next, out + row + next);
+    }
+    first.store(state, width, lane);
+    if constexpr (N == 2)
+        second.store(state, width, next);
+}
+
+template <class Arch>
+void rolling_moments_t::operator()(Arch, const double* enter, const double* leave,
+    std::size_t n_rows, std::size_t width, const double* shift, double* state, double* out,
+    bool with_std, bool dense)
+{
+    constexpr auto simd_size = xsimd::batch<double, Arch>::size;
+    auto run = [&]<std::size_t N>(std::size_t lane)
+    {
+        auto batches = [&]<bool WithStd, bool Dense>()
+        {
+            rolling_moments_batches<Arch, WithStd, Dense, N>(
+                enter, leave, n_rows, width, lane, shift, state, out);
+        };
+        if (with_std)
+            dense ? batches.template operator()<true, true>()
+                  : batches.template operator()<true, false>();
+        else
+            dense ? batches.template operator()<false, true>()
+                  : batches.template operator()<false, false>();
+    };
+    std::size_t l = 0;
+    for (; l + 2 * simd_size <= width; l += 2 * simd_size)
+        run.template operator()<2>(l);
+    for (; l + simd_size <= width; l += simd_size)
+        run.template operator()<1>(l);
+    scalar::rolling_moments_lanes(
+        enter, leave, n_rows, width, l, width, shift, state, out, with_std);
+}
+
+// Lanes <-> rolling_moments layout (see scalar::gather_lanes), one square
+// tile of batch_t::size lanes by as many rows at a time, transposed in
+// registers. width must be a multiple of the batch size for the tiles.
+struct gather_lanes_t
+{
+    template <class Arch>
+    void operator()(Arch, const double* src, std::size_t lane_stride, std::size_t n_rows,
+        std::size_t width, const double* shift, double* dst);
+};
+
+struct scatter_lanes_t
+{
+    template <class Arch>
+    void operator()(Arch, const double* src, std::size_t n_rows, std::size_t width, double* dst,
+        std::size_t lane_stride);
+};
+
+template <class Arch>
+void gather_lanes_t::operator()(Arch, const double* src, std::size_t lane_stride,
+    std::size_t n_rows, std::size_t width, const double* shift, double* dst)
+{
+    using batch_t = xsimd::batch<double, Arch>;
+    constexpr auto simd_size = batch_t::size;
+    std::size_t r = 0;
+    if (width % simd_size == 0)
+    {
+        for (; r + simd_size <= n_rows; r += simd_size)
+            for (std::size_t l = 0; l < width; l += simd_size)
+            {
+                batch_t tile[simd_size];
+                for (std::size_t k = 0; k < simd_size; ++k)
+                    tile[k] = batch_t::load_unaligned(src + (l + k) * lane_stride + r)
+                        - batch_t(shift[l + k]);
+                xsimd::transpose(tile, tile + simd_size);
+                for (std::size_t k = 0; k < simd_size; ++k)
+                    tile[k].store_unaligned(dst + (r + k) * width + l);
+            }
+    }
+    scalar::gather_lanes_rows(src, lane_stride, r, n_rows, width, shift, dst);
+}
+
+template <class Arch>
+void scatter_lanes_t::operator()(Arch, const double* src, std::size_t n_rows, std::size_t width,
+    double* dst, std::size_t lane_stride)
+{
+    using batch_t = xsimd::batch<double, Arch>;
+    constexpr auto simd_size = batch_t::size;
+    std::size_t r = 0;
+    if (width % simd_size == 0)
+    {
+        for (; r + simd_size <= n_rows; r += simd_size)
+            for (std::size_t l = 0; l < width; l += simd_size)
+            {
+                batch_t tile[simd_size];
+                for (std::size_t k = 0; k < simd_size; ++k)
+                    tile[k] = batch_t::load_unaligned(src + (r + k) * width + l);
+                xsimd::transpose(tile, tile + simd_size);
+                for (std::size_t k = 0; k < simd_size; ++k)
+                    tile[k].store_unaligned(dst + (l + k) * lane_stride + r);
+            }
+    }
+    scalar::scatter_lanes_rows(src, r, n_rows, width, dst, lane_stride);
+}
+
+// Block moments of `width` adjacent columns (block_stats): one column per
+// SIMD slot, NaN samples masked out of the sums, the count and min/max.
+struct column_moments_t
+{
+    template <class Arch>
+    void operator()(Arch, const double* data, std::size_t n_rows, std::size_t stride,
+        std::size_t width, const double* shift, double* state);
+};
+
+template <class Arch>
+void column_moments_t::operator()(Arch, const double* data, std::size_t n_rows,
+    std::size_t stride, std::size_t width, const double* shift, double* state)
+{
+    using batch_t = xsimd::batch<double, Arch>;
+    constexpr auto simd_size = batch_t::size;
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    const auto zero = batch_t(0.0);
+    const auto one = batch_t(1.0);
+    auto compensated = [](batch_t& sum, batch_t& comp, batch_t x)
+    {
+        const auto t = sum + x;
+        const auto z = t - sum;
+        comp += (sum - (t - z)) + (x - z);
+        sum = t;
+    };
+    std::size_t l = 0;
+    for (; l + simd_size <= width; l += simd_size)
+    {
+        auto sum = batch_t::load_unaligned(state + l);
+        auto sum_c = batch_t::load_unaligned(state + width + l);
+        auto sq = batch_t::load_unaligned(state + 2 * width + l);
+        auto sq_c = batch_t::load_unaligned(state + 3 * width + l);
+        auto count = batch_t::load_unaligned(state + 4 * width + l);
+        auto lo = batch_t::load_unaligned(state + 5 * width + l);
+        auto hi = batch_t::load_unaligned(state + 6 * width + l);
+        const auto k = batch_t::load_unaligned(shift + l);
+        for (std::size_t r = 0; r < n_rows; ++r)
+        {
+            const auto x = batch_t::load_unaligned(data + r * stride + l);
+            const auto valid = !xsimd::isnan(x);
+            const auto v = xsimd::select(valid, x - k, zero);
+            compensated(sum, sum_c, v);
+            compensated(sq, sq_c, v * v);
+            count += xsimd::select(valid, one, zero);
+            lo = xsimd::min(lo, xsimd::select(valid, x, batch_t(inf)));
+            hi = xsimd::max(hi, xsimd::select(valid, x, batch_t(-inf)));
+        }
+        sum.store_unaligned(state + l);
+        sum_c.store_unaligned(state + width + l);
+        sq.store_unaligned(state + 2 * width + l);
+        sq_c.store_unaligned(state + 3 * width + l);
+        count.store_unaligned(state + 4 * width + l);
+        lo.store_unaligned(state + 5 * width + l);
+        hi.store_unaligned(state + 6 * width + l);
+    }
+    scalar::column_moments_lanes(data, n_rows, stride, width, l, width, shift, state);
+}
+
+// Power of complex bins: out[i] = re^2 + im^2 — spectrogram |X|^2 loop.
+// The complex batch load deinterleaves (re, im) pairs into two registers.
+struct complex_power_t
+{
+    template <class Arch>
+    void operator()(Arch, const std::complex<double>* z, double* out, std::size_t n);
+};
+
+template <class Arch>
+void complex_power_t::operator()(Arch, const std::complex<double>* z, double* out, std::size_t n)
+{
+    using batch_t = xsimd::batch<std::complex<double>, Arch>;
+    constexpr auto simd_size = batch_t::size;
+    std::size_t i = 0;
+    for (; i + simd_size <= n; i += simd_size)
+    {
+        const auto v = batch_t::load_unaligned(z + i);
+        (v.real() * v.real() + v.imag() * v.imag()).store_unaligned(out + i);
+    }
+    for (; i < n; ++i)
+        out[i] = z[i].real() * z[i].real() + z[i].imag() * z[i].imag();
+}
+
 
 // ── Extern template declarations per arch ───────────────────────────────────
 
@@ -430,8 +1113,30 @@ void adjacent_diff_t::operator()(Arch, const double* data, double* out, std::siz
         ARCH, const float*, std::size_t);                                                            \
     extern template double nan_reduce_sum_t::operator()<ARCH>(ARCH, const double*, std::size_t);    \
     extern template float nan_reduce_sum_t::operator()<ARCH>(ARCH, const float*, std::size_t);      \
+    extern template std::size_t copy_finite_t::operator()<ARCH>(ARCH, const double*, std::size_t,   \
+                                                                double*);                            \
+    extern template std::size_t copy_finite_t::operator()<ARCH>(ARCH, const float*, std::size_t,    \
+                                                                float*);                             \
     extern template void adjacent_diff_t::operator()<ARCH>(ARCH, const double*, double*,            \
-                                                           std::size_t);
+                                                           std::size_t);                             \
+    extern template void complex_power_t::operator()<ARCH>(ARCH, const std::complex<double>*,       \
+                                                           double*, std::size_t);                    \
+    extern template DiffCounts diff_counts_t::operator()<ARCH>(ARCH, const double*, std::size_t,    \
+                                                               double, double);                      \
+    extern template std::size_t first_diff_above_t::operator()<ARCH>(ARCH, const double*,           \
+                                                                     std::size_t, double);          \
+    extern template void rolling_moments_t::operator()<ARCH>(ARCH, const double*, const double*,    \
+                                                             std::size_t, std::size_t,              \
+                                                             const double*, double*, double*,       \
+                                                             bool, bool);                            \
+    extern template void column_moments_t::operator()<ARCH>(ARCH, const double*, std::size_t,       \
+                                                            std::size_t, std::size_t, const double*, \
+                                                            double*);                                \
+    extern template void gather_lanes_t::operator()<ARCH>(ARCH, const double*, std::size_t,         \
+                                                          std::size_t, std::size_t, const double*,   \
+                                                          double*);                                  \
+    extern template void scatter_lanes_t::operator()<ARCH>(ARCH, const double*, std::size_t,        \
+                                                           std::size_t, double*, std::size_t);
 
 #ifdef SQP_DSP_ENABLE_SSE2_ARCH
 SQP_DSP_EXTERN_PRIMITIVES(xsimd::sse2)
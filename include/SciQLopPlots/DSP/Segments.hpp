@@ -21,14 +21,17 @@
 ----------------------------------------------------------------------------*/
 #pragma once
 
-#ifndef SQP_DSP_NO_SIMD
+#include "Parallel.hpp"
 #include "SIMD/Primitives.hpp"
-#endif
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
+#include <limits>
+#include <mutex>
 #include <span>
+#include <utility>
 #include <vector>
 
 namespace sqp::dsp
@@ -37,8 +40,10 @@ namespace sqp::dsp
 #ifndef SQP_DSP_NO_SIMD
 namespace simd
 {
-    extern decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(adjacent_diff_t {}))
-        dispatched_adjacent_diff;
+    extern decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(diff_counts_t {}))
+        dispatched_diff_counts;
+    extern decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(first_diff_above_t {}))
+        dispatched_first_diff_above;
 } // namespace simd
 #endif
 
@@ -51,70 +56,250 @@ struct Segment
     double median_dt;
 };
 
+// Cadence and gap detection read dt = x[i+1] - x[i] straight from x and never
+// materialise the differences, so memory stays O(1) in the series length.
+//
+// The median dt is found by narrowing: a strided sample of the differences
+// gives a window [q1, q3] that holds the median of any regular cadence; one
+// SIMD pass counts the differences below and inside it, and collects the
+// steps that could be gaps for any median in the window. If the median does
+// fall inside, histogram passes over the window's exact extent (a few ulps of
+// dt for a regular cadence) finish the search; otherwise they start from the
+// full range. The result is the exact upper median, as a sort would give.
 namespace detail
 {
-    inline void compute_diffs(const double* x, double* dts, std::size_t n)
+    // Parallel block of the scans, and the chunk each block is scanned in so
+    // the gap scan re-reads the differences from cache.
+    inline constexpr std::size_t cadence_block = std::size_t { 1 } << 18;
+    inline constexpr std::size_t cadence_chunk = std::size_t { 1 } << 12;
+
+    inline constexpr std::size_t cadence_sample = 1024;
+    inline constexpr std::size_t cadence_bins = 1024;
+
+    // Below this many candidates left, the median search copies them and
+    // finishes with nth_element.
+    inline constexpr std::size_t cadence_gather = 4096;
+
+    inline simd::DiffCounts diff_counts(const double* x, std::size_t n, double w_lo, double w_hi)
     {
 #ifndef SQP_DSP_NO_SIMD
-        simd::dispatched_adjacent_diff(x, dts, n);
+        return simd::dispatched_diff_counts(x, n, w_lo, w_hi);
 #else
-        for (std::size_t i = 0; i < n; ++i)
-            dts[i] = x[i + 1] - x[i];
+        return simd::scalar::diff_counts(x, n, w_lo, w_hi);
 #endif
     }
 
-    inline double compute_median_dt(std::span<const double> x)
+    inline std::size_t first_diff_above(const double* x, std::size_t n, double threshold)
     {
-        if (x.size() < 2)
-            return 0.0;
+#ifndef SQP_DSP_NO_SIMD
+        return simd::dispatched_first_diff_above(x, n, threshold);
+#else
+        return simd::scalar::first_diff_above(x, n, threshold);
+#endif
+    }
 
-        const auto n = x.size() - 1;
-        std::vector<double> dts(n);
-        compute_diffs(x.data(), dts.data(), n);
-
-        // Remove NaN/Inf diffs before nth_element (NaN breaks comparison-based algorithms)
-        auto valid_end = std::remove_if(dts.begin(), dts.end(),
-            [](double v) { return !std::isfinite(v); });
-        if (valid_end == dts.begin())
-            return 0.0;
-        const auto valid_n = static_cast<std::size_t>(valid_end - dts.begin());
-        auto mid = dts.begin() + static_cast<std::ptrdiff_t>(valid_n / 2);
-        std::nth_element(dts.begin(), mid, valid_end);
+    // Indices i + 1 in [begin + 1, end] with x[i+1] - x[i] > threshold.
+    inline void collect_steps(const double* x, std::size_t begin, std::size_t end,
+        double threshold, std::vector<std::size_t>& out)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            i += first_diff_above(x + i, end - i, threshold);
+            if (i < end)
+                out.push_back(i + 1);
+        }
+    }
+
+    // Interquartile window of a strided sample of the finite differences.
+    inline std::pair<double, double> sample_window(const double* x, std::size_t n)
+    {
+        std::vector<double> sample;
+        sample.reserve(cadence_sample);
+        const std::size_t stride = std::max<std::size_t>(1, n / cadence_sample);
+        for (std::size_t i = 0; i < n; i += stride)
+        {
+            const double d = x[i + 1] - x[i];
+            if (std::isfinite(d))
+                sample.push_back(d);
+        }
+        if (sample.empty())
+            return { std::numeric_limits<double>::infinity(),
+                -std::numeric_limits<double>::infinity() };
+        const auto q1 = sample.begin() + static_cast<std::ptrdiff_t>(sample.size() / 4);
+        const auto q3 = sample.begin() + static_cast<std::ptrdiff_t>(3 * sample.size() / 4);
+        std::nth_element(sample.begin(), q1, sample.end());
+        const double lo = *q1;
+        std::nth_element(q1, q3, sample.end());
+        return { lo, *q3 };
+    }
+
+    // Result of the main pass. steps holds every i + 1 with a step above
+    // step_threshold, unless more than step_limit were seen (steps_complete
+    // is then false and the caller scans again once the threshold is known).
+    struct CadenceScan
+    {
+        simd::DiffCounts counts;
+        std::vector<std::size_t> steps;
+        bool steps_complete = true;
+    };
+
+    inline CadenceScan cadence_scan(const double* x, std::size_t n, double w_lo, double w_hi,
+        double step_threshold)
+    {
+        const std::size_t step_limit = n / 64 + 1024;
+        CadenceScan scan;
+        std::vector<std::pair<std::size_t, std::vector<std::size_t>>> blocks;
+        std::mutex mutex;
+        parallel_for_blocks(n, cadence_block, [&](std::size_t begin, std::size_t end) {
+            simd::DiffCounts counts;
+            std::vector<std::size_t> steps;
+            bool complete = step_threshold < std::numeric_limits<double>::infinity();
+            for (std::size_t c = begin; c < end; c += cadence_chunk)
+            {
+                const std::size_t c_end = std::min(end, c + cadence_chunk);
+                counts.merge(diff_counts(x + c, c_end - c, w_lo, w_hi));
+                if (complete)
+                {
+                    collect_steps(x, c, c_end, step_threshold, steps);
+                    complete = steps.size() <= step_limit;
+                }
+            }
+            std::lock_guard lock(mutex);
+            scan.counts.merge(counts);
+            scan.steps_complete = scan.steps_complete && complete;
+            if (complete && !steps.empty())
+                blocks.emplace_back(begin, std::move(steps));
+        });
+        if (scan.steps_complete)
+        {
+            std::sort(blocks.begin(), blocks.end());
+            for (const auto& [begin, steps] : blocks)
+                scan.steps.insert(scan.steps.end(), steps.begin(), steps.end());
+        }
+        return scan;
+    }
+
+    // rank-th smallest (0-based) finite difference of x among those in
+    // [lo, hi], of which there are in_range. Each pass bins them and keeps the
+    // bin holding the rank; since binning is monotonic, the bin's exact min
+    // and max bound exactly its members and become the next range.
+    inline double kth_diff_in_range(const double* x, std::size_t n, std::size_t rank,
+        double lo, double hi, std::size_t in_range)
+    {
+        struct Histogram
+        {
+            std::array<std::size_t, cadence_bins> count {};
+            std::array<double, cadence_bins> lo;
+            std::array<double, cadence_bins> hi;
+
+            Histogram()
+            {
+                lo.fill(std::numeric_limits<double>::infinity());
+                hi.fill(-std::numeric_limits<double>::infinity());
+            }
+        };
+
+        while (lo < hi && in_range > cadence_gather)
+        {
+            const double scale = static_cast<double>(cadence_bins) / (hi - lo);
+            if (!std::isfinite(scale) || scale == 0.0)
+                break;
+            Histogram hist;
+            std::mutex mutex;
+            parallel_for_blocks(n, cadence_block, [&](std::size_t begin, std::size_t end) {
+                Histogram local;
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    const double d = x[i + 1] - x[i];
+                    if (!(d >= lo && d <= hi))
+                        continue;
+                    const auto b = std::min(
+                        cadence_bins - 1, static_cast<std::size_t>((d - lo) * scale));
+                    ++local.count[b];
+                    local.lo[b] = std::min(local.lo[b], d);
+                    local.hi[b] = std::max(local.hi[b], d);
+                }
+                std::lock_guard lock(mutex);
+                for (std::size_t b = 0; b < cadence_bins; ++b)
+                {
+                    hist.count[b] += local.count[b];
+                    hist.lo[b] = std::min(hist.lo[b], local.lo[b]);
+                    hist.hi[b] = std::max(hist.hi[b], local.hi[b]);
+                }
+            });
+
+            std::size_t b = 0;
+            while (rank >= hist.count[b])
+                rank -= hist.count[b++];
+            if (hist.count[b] == in_range) // no progress
+                break;
+            lo = hist.lo[b];
+            hi = hist.hi[b];
+            in_range = hist.count[b];
+        }
+        if (lo == hi)
+            return lo;
+
+        std::vector<double> candidates;
+        candidates.reserve(in_range);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double d = x[i + 1] - x[i];
+            if (d >= lo && d <= hi)
+                candidates.push_back(d);
+        }
+        const auto mid = candidates.begin() + static_cast<std::ptrdiff_t>(rank);
+        std::nth_element(candidates.begin(), mid, candidates.end());
         return *mid;
     }
 
+    // Upper median of the finite differences of x (0 when there is none) and
+    // the indices where x steps by more than gap_factor times it. A
+    // gap_factor of 0 skips gap detection.
     inline std::pair<std::vector<std::size_t>, double> find_gaps_and_median(
         std::span<const double> x, double gap_factor)
     {
         if (x.size() < 2)
             return { {}, 0.0 };
-
         const auto n = x.size() - 1;
-        std::vector<double> dts(n);
-        compute_diffs(x.data(), dts.data(), n);
+        const auto [w_lo, w_hi] = sample_window(x.data(), n);
+        const bool want_gaps = gap_factor > 0.0;
+        const double step_threshold = (want_gaps && w_lo > 0.0)
+            ? gap_factor * w_lo
+            : std::numeric_limits<double>::infinity();
+        auto scan = cadence_scan(x.data(), n, w_lo, w_hi, step_threshold);
 
-        auto valid_end = std::remove_if(dts.begin(), dts.end(),
-            [](double v) { return !std::isfinite(v); });
-        if (valid_end == dts.begin())
+        const auto& c = scan.counts;
+        if (c.all.count == 0)
             return { {}, 0.0 };
-        const auto valid_n = static_cast<std::size_t>(valid_end - dts.begin());
-        auto mid = dts.begin() + static_cast<std::ptrdiff_t>(valid_n / 2);
-        std::nth_element(dts.begin(), mid, valid_end);
-        const double median_dt = *mid;
+        const std::size_t rank = c.all.count / 2;
+        const bool in_window = rank >= c.below && rank - c.below < c.inside.count;
+        const double median_dt = in_window
+            ? kth_diff_in_range(x.data(), n, rank - c.below, c.inside.lo, c.inside.hi,
+                c.inside.count)
+            : kth_diff_in_range(x.data(), n, rank, c.all.lo, c.all.hi, c.all.count);
 
-        if (median_dt <= 0.0)
+        if (!want_gaps || median_dt <= 0.0)
             return { {}, median_dt };
-
         const double threshold = gap_factor * median_dt;
         std::vector<std::size_t> gaps;
-        for (std::size_t i = 0; i < n; ++i)
+        if (in_window && scan.steps_complete && step_threshold <= threshold)
         {
-            if ((x[i + 1] - x[i]) > threshold)
-                gaps.push_back(i + 1);
+            // Candidates were collected with a threshold at most this one.
+            for (const auto i : scan.steps)
+                if (x[i] - x[i - 1] > threshold)
+                    gaps.push_back(i);
         }
+        else
+            collect_steps(x.data(), 0, n, threshold, gaps);
         return { std::move(gaps), median_dt };
     }
 
+    inline double compute_median_dt(std::span<const double> x)
+    {
+        return find_gaps_and_median(x, 0.0).second;
+    }
+
     // Find gap boundaries: indices where dt > gap_factor * median_dt
     inline std::vector<std::size_t> find_gap_indices(
         std::span<const double> x, double gap_factor)
@@ -0,0 +1,276 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2026, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+
+#include "Parallel.hpp"
+#include "SIMD/Primitives.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sqp::dsp
+{
+
+#ifndef SQP_DSP_NO_SIMD
+namespace simd
+{
+    extern decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(copy_finite_t {}))
+        dispatched_copy_finite;
+} // namespace simd
+#endif
+
+// Copies the finite data[i] to out, in order, and returns how many: SIMD
+// compress-store for float and double, a plain copy for integers.
+template <typename T>
+std::size_t copy_finite(const T* data, std::size_t n, T* out)
+{
+    if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
+    {
+#ifndef SQP_DSP_NO_SIMD
+        return simd::dispatched_copy_finite(data, n, out);
+#else
+        return simd::scalar::copy_finite(data, n, out);
+#endif
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+        return simd::scalar::copy_finite(data, n, out);
+    else
+    {
+        std::copy_n(data, n, out);
+        return n;
+    }
+}
+
+namespace detail
+{
+    // Below this many values, selection copies them and runs nth_element.
+    inline constexpr std::size_t select_inline = std::size_t { 1 } << 16;
+    inline constexpr std::size_t select_block = std::size_t { 1 } << 18;
+    inline constexpr unsigned select_radix_bits = 16;
+    // A bucket holding more than 1/select_refine of the values (clustered
+    // data sharing their top key bits) is split on the next radix digit
+    // before its values are gathered.
+    inline constexpr std::size_t select_refine = 32;
+
+    template <typename T>
+    using radix_key_t = std::conditional_t<
+        sizeof(T) == 1, std::uint8_t,
+        std::conditional_t<sizeof(T) == 2, std::uint16_t,
+                           std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+
+    // Unsigned key ordered like the (non-NaN) values: flip the sign bit of
+    // positive floats and signed integers, every bit of negative floats.
+    template <typename T>
+    inline radix_key_t<T> radix_key(T value) noexcept
+    {
+        using K = radix_key_t<T>;
+        constexpr unsigned bits = sizeof(K) * 8;
+        constexpr K sign = K { 1 } << (bits - 1);
+        K key;
+        std::memcpy(&key, &value, sizeof(K));
+        if constexpr (std::is_floating_point_v<T>)
+            return (key & sign) ? static_cast<K>(~key) : static_cast<K>(key | sign);
+        else if constexpr (std::is_signed_v<T>)
+            return static_cast<K>(key ^ sign);
+        else
+            return key;
+    }
+
+    // Contiguous parts [p * n / parts, (p + 1) * n / parts) of a selection
+    // pass: one per pool thread, each small enough for 32-bit counters.
+    inline std::size_t select_parts(std::size_t n)
+    {
+        const auto parts = std::clamp<std::size_t>(n / select_block, 1, pool().thread_count());
+        return std::max(parts, (n >> 31) + 1);
+    }
+
+    // Runs count(begin, end, partial) on every part with its own zeroed
+    // partial of `size` counters and returns their sum.
+    template <typename F>
+    std::vector<std::size_t> count_parts(std::size_t n, std::size_t size, F&& count)
+    {
+        const auto parts = select_parts(n);
+        std::vector<std::vector<std::uint32_t>> partials(parts);
+        parallel_for(parts, [&](std::size_t p) {
+            partials[p].assign(size, 0);
+            count(p * n / parts, (p + 1) * n / parts, partials[p].data());
+        });
+        std::vector<std::size_t> total(size, 0);
+        for (const auto& partial : partials)
+            for (std::size_t b = 0; b < size; ++b)
+                total[b] += partial[b];
+        return total;
+    }
+
+    // Bucket of counts[0, size) holding `rank`, and the rank within it.
+    inline std::pair<std::size_t, std::size_t> locate_rank(
+        const std::size_t* counts, std::size_t size, std::size_t rank)
+    {
+        std::size_t below = 0;
+        for (std::size_t b = 0; b < size; ++b)
+        {
+            if (rank < below + counts[b])
+                return { b, rank - below };
+            below += counts[b];
+        }
+        return { size - 1, counts[size - 1] - 1 };
+    }
+} // namespace detail
+
+// Order statistics of rank `lo` and `hi` (0-based, the values
+// std::nth_element would put there) of NaN-free `values`, without reordering
+// or copying them: one parallel pass builds a histogram of the top 16 bits of
+// an order-preserving key, a second gathers the values of the two buckets
+// holding the ranks, and nth_element finishes on those alone. A bucket too
+// large to gather cheaply is first split by a histogram of the next 16 bits.
+// Every pass counts or gathers into per-part buffers merged afterwards.
+template <typename T>
+std::pair<T, T> select_ranks(std::span<const T> values, std::size_t lo, std::size_t hi)
+{
+    const std::size_t n = values.size();
+    if (n <= detail::select_inline)
+    {
+        std::vector<T> copy(values.begin(), values.end());
+        std::nth_element(copy.begin(), copy.begin() + lo, copy.end());
+        const T lo_value = copy[lo];
+        std::nth_element(copy.begin(), copy.begin() + hi, copy.end());
+        return { lo_value, copy[hi] };
+    }
+
+    using K = detail::radix_key_t<T>;
+    constexpr unsigned key_bits = sizeof(K) * 8;
+    constexpr unsigned radix_bits = std::min(detail::select_radix_bits, key_bits);
+    constexpr unsigned shift = key_bits - radix_bits;
+    // The second digit: up to radix_bits bits right below the first.
+    constexpr unsigned shift2 = shift > radix_bits ? shift - radix_bits : 0;
+    constexpr std::size_t buckets = std::size_t { 1 } << radix_bits;
+    constexpr std::size_t buckets2 = std::size_t { 1 } << (shift - shift2);
+    const auto key_of = [&](std::size_t i) { return detail::radix_key(values[i]); };
+
+    const auto histogram = detail::count_parts(n, buckets,
+        [&](std::size_t b0, std::size_t b1, std::uint32_t* counts) {
+            for (std::size_t i = b0; i < b1; ++i)
+                ++counts[key_of(i) >> shift];
+        });
+
+    // Values of rank `rank` sit among the `count` keys equal to `prefix`
+    // on the bits selected by `mask`.
+    struct Target
+    {
+        std::size_t rank;
+        K mask;
+        K prefix;
+        std::size_t count;
+    };
+    const auto first_digit = [&](std::size_t rank) {
+        const auto [bucket, within] = detail::locate_rank(histogram.data(), buckets, rank);
+        return Target { within, static_cast<K>(~K { 0 } << shift),
+                        static_cast<K>(static_cast<K>(bucket) << shift), histogram[bucket] };
+    };
+    Target targets[2] = { first_digit(lo), first_digit(hi) };
+
+    if constexpr (shift > 0)
+    {
+        const auto refine = [&](const Target& t) { return t.count > n / detail::select_refine; };
+        const bool refine_lo = refine(targets[0]);
+        const bool refine_hi = refine(targets[1]);
+        if (refine_lo || refine_hi)
+        {
+            // One pass counts the next digit of both buckets; `split[1]` is
+            // unused when both ranks fall in the same bucket.
+            const K split[2] = { refine_lo ? targets[0].prefix : targets[1].prefix,
+                                 refine_hi ? targets[1].prefix : targets[0].prefix };
+            const auto counts = detail::count_parts(n, 2 * buckets2,
+                [&](std::size_t b0, std::size_t b1, std::uint32_t* partial) {
+                    for (std::size_t i = b0; i < b1; ++i)
+                    {
+                        const K key = key_of(i);
+                        const K top = static_cast<K>(key & targets[0].mask);
+                        const auto digit = static_cast<std::size_t>(key >> shift2) & (buckets2 - 1);
+                        if (top == split[0])
+                            ++partial[digit];
+                        else if (top == split[1])
+                            ++partial[buckets2 + digit];
+                    }
+                });
+            for (auto& t : targets)
+            {
+                if (!refine(t))
+                    continue;
+                const auto* sub = counts.data() + (t.prefix == split[0] ? 0 : buckets2);
+                const auto [digit, within] = detail::locate_rank(sub, buckets2, t.rank);
+                t = Target { within, static_cast<K>(~K { 0 } << shift2),
+                             static_cast<K>(t.prefix | (static_cast<K>(digit) << shift2)),
+                             sub[digit] };
+            }
+        }
+    }
+
+    const bool shared = targets[0].mask == targets[1].mask
+        && targets[0].prefix == targets[1].prefix;
+    const auto parts = detail::select_parts(n);
+    std::vector<std::vector<T>> gathered(2 * parts);
+    parallel_for(parts, [&](std::size_t p) {
+        const auto b0 = p * n / parts, b1 = (p + 1) * n / parts;
+        auto& local_lo = gathered[2 * p];
+        auto& local_hi = gathered[2 * p + 1];
+        // Expected share of the part, plus slack for uneven spread.
+        const auto share = [&](const Target& t) {
+            return t.count / parts + t.count / (8 * parts) + 16;
+        };
+        local_lo.reserve(share(targets[0]));
+        if (!shared)
+            local_hi.reserve(share(targets[1]));
+        for (std::size_t i = b0; i < b1; ++i)
+        {
+            const K key = key_of(i);
+            if ((key & targets[0].mask) == targets[0].prefix)
+                local_lo.push_back(values[i]);
+            else if (!shared && (key & targets[1].mask) == targets[1].prefix)
+                local_hi.push_back(values[i]);
+        }
+    });
+    std::vector<T> lo_values, hi_values;
+    lo_values.reserve(targets[0].count);
+    if (!shared)
+        hi_values.reserve(targets[1].count);
+    for (std::size_t p = 0; p < parts; ++p)
+    {
+        lo_values.insert(lo_values.end(), gathered[2 * p].begin(), gathered[2 * p].end());
+        hi_values.insert(hi_values.end(), gathered[2 * p + 1].begin(), gathered[2 * p + 1].end());
+    }
+
+    std::nth_element(lo_values.begin(), lo_values.begin() + targets[0].rank, lo_values.end());
+    const T lo_value = lo_values[targets[0].rank];
+    auto& hi_pool = shared ? lo_values : hi_values;
+    std::nth_element(hi_pool.begin(), hi_pool.begin() + targets[1].rank, hi_pool.end());
+    return { lo_value, hi_pool[targets[1].rank] };
+}
+
+} // namespace sqp::dsp
@@ -0,0 +1,374 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2026, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+
+#include "FFTCache.hpp"
+#include "Parallel.hpp"
+#include "Segments.hpp"
+#include "Spectrogram.hpp"
+#include "Window.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace sqp::dsp
+{
+
+// Averaged power spectral density of a gap-split series. Every full window of
+// every segment is averaged into one estimate, so a gap only costs the windows
+// it cuts. One-sided, in units²/Hz (scipy.signal.welch scaling='density').
+struct PowerSpectrum
+{
+    std::vector<double> f;   // frequency bins [n_freq]
+    std::vector<double> psd; // row-major [n_freq × n_cols]
+    std::size_t n_cols = 1;
+    std::size_t n_windows = 0; // windows averaged (per taper)
+};
+
+// Averaged auto and cross spectra of two columns, with the scaling of
+// scipy.signal.csd: pxy = mean(conj(X_a) * X_b).
+struct CrossSpectrum
+{
+    std::vector<double> f;
+    std::vector<double> pxx;
+    std::vector<double> pyy;
+    std::vector<std::complex<double>> pxy;
+    std::size_t n_windows = 0;
+};
+
+// Magnitude-squared coherence |Pxy|² / (Pxx Pyy) of a cross spectrum.
+inline auto coherence(const CrossSpectrum& cs) -> std::vector<double>
+{
+    std::vector<double> c(cs.f.size());
+    for (std::size_t k = 0; k < c.size(); ++k)
+    {
+        const double denom = cs.pxx[k] * cs.pyy[k];
+        c[k] = (denom > 0.0) ? std::norm(cs.pxy[k]) / denom : 0.0;
+    }
+    return c;
+}
+
+namespace detail
+{
+    // Per-thread buffers of one batch of tapered windows, grown to the largest
+    // batch seen. spectra_b holds the second column of a cross spectrum.
+    struct SpectralScratch
+    {
+        std::vector<double> frames;
+        std::vector<std::complex<double>> spectra;
+        std::vector<std::complex<double>> spectra_b;
+        std::vector<double> power;
+    };
+
+    inline SpectralScratch& spectral_scratch()
+    {
+        thread_local SpectralScratch scratch;
+        return scratch;
+    }
+
+    // Windows of every segment as rows of the tile scheduler, and the sampling
+    // interval of the pooled estimate (split_segments gives every segment the
+    // global median_dt).
+    struct WindowGrid
+    {
+        std::vector<TileExtent> extents;
+        std::size_t n_windows = 0;
+        double dt = 0.0;
+    };
+
+    template <typename T>
+    WindowGrid window_grid(
+        const std::vector<Segment<T>>& segments, std::size_t window_size, std::size_t hop)
+    {
+        WindowGrid grid;
+        grid.extents.resize(segments.size());
+        for (std::size_t i = 0; i < segments.size(); ++i)
+        {
+            const auto& seg = segments[i];
+            if (seg.median_dt <= 0.0)
+                continue;
+            const auto n = count_windows(seg.x.size(), window_size, hop);
+            if (n == 0)
+                continue;
+            grid.extents[i] = { n, 1 };
+            grid.n_windows += n;
+            if (grid.dt == 0.0)
+                grid.dt = seg.median_dt;
+        }
+        return grid;
+    }
+
+    // Spectra of windows [w_begin, w_begin + nb) of one column, one per taper:
+    // spectra[(w * n_tapers + t) * n_freq + k]. Each window is read in place
+    // (strided for multi-column data), optionally mean-removed, multiplied by
+    // every taper, and the nb * n_tapers frames go through the cached plan.
+    template <typename T>
+    void taper_spectra(const Segment<T>& seg, std::size_t col, const FFTSetup& setup,
+        std::size_t window_size, std::size_t hop, std::size_t w_begin, std::size_t nb,
+        bool detrend, double* frames, std::complex<double>* spectra)
+    {
+        const std::size_t stride = seg.n_cols;
+        const std::size_t n_tapers = setup.n_tapers;
+        for (std::size_t w = 0; w < nb; ++w)
+        {
+            const T* src = seg.y.data() + (w_begin + w) * hop * stride + col;
+            double mean = 0.0;
+            if (detrend)
+            {
+                for (std::size_t i = 0; i < window_size; ++i)
+                    mean += static_cast<double>(src[i * stride]);
+                mean /= static_cast<double>(window_size);
+            }
+            for (std::size_t t = 0; t < n_tapers; ++t)
+            {
+                const double* taper = setup.window.data() + t * window_size;
+                double* frame = frames + (w * n_tapers + t) * window_size;
+                if (stride == 1)
+                {
+                    for (std::size_t i = 0; i < window_size; ++i)
+                        frame[i] = (static_cast<double>(src[i]) - mean) * taper[i];
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < window_size; ++i)
+                        frame[i] = (static_cast<double>(src[i * stride]) - mean) * taper[i];
+                }
+            }
+        }
+
+        real_forward_batch(setup.plan, frames, nb * n_tapers, spectra, 1.0);
+    }
+
+    // Windows per batch: the spectrogram's batch, shared between the tapers.
+    inline std::size_t spectral_batch(std::size_t window_size, std::size_t n_tapers)
+    {
+        return std::max<std::size_t>(1, spectrogram_batch(window_size) / n_tapers);
+    }
+
+    // Runs accumulate(tile, partial) over window tiles of every segment, each
+    // tile summing into its own zeroed partial of n_acc values, and returns
+    // the partials added in tile order, so the result does not depend on
+    // thread timing.
+    template <typename F>
+    std::vector<double> accumulate_windows(
+        const WindowGrid& grid, std::size_t cost, std::size_t n_acc, F&& accumulate)
+    {
+        const auto tiles
+            = make_tiles(std::span<const TileExtent>(grid.extents), TileSplit::Rows, cost);
+        std::vector<std::vector<double>> partials(tiles.size());
+        parallel_for(tiles.size(), [&](std::size_t i) {
+            partials[i].assign(n_acc, 0.0);
+            accumulate(tiles[i], partials[i].data());
+        });
+        std::vector<double> total(n_acc, 0.0);
+        for (const auto& p : partials)
+            for (std::size_t k = 0; k < n_acc; ++k)
+                total[k] += p[k];
+        return total;
+    }
+
+    // Density scaling of bin k of an averaged one-sided spectrum: 1 / (fs * Σw²)
+    // per window, doubled except at DC and (even sizes) Nyquist.
+    inline std::vector<double> density_scale(
+        const FFTSetup& setup, std::size_t window_size, std::size_t n_windows, double dt)
+    {
+        double sum_sq = 0.0;
+        for (const double w : setup.window)
+            sum_sq += w * w;
+        const std::size_t n_freq = window_size / 2 + 1;
+        const double base = dt / (sum_sq * static_cast<double>(n_windows));
+        std::vector<double> scale(n_freq, 2.0 * base);
+        scale[0] = base;
+        if (window_size % 2 == 0)
+            scale[n_freq - 1] = base;
+        return scale;
+    }
+
+    inline std::vector<double> frequency_axis(std::size_t window_size, double dt)
+    {
+        std::vector<double> f(window_size / 2 + 1);
+        for (std::size_t k = 0; k < f.size(); ++k)
+            f[k] = static_cast<double>(k) / (static_cast<double>(window_size) * dt);
+        return f;
+    }
+
+    template <typename T>
+    auto averaged_psd(const std::vector<Segment<T>>& segments, const FFTSetup& setup,
+        std::size_t window_size, std::size_t hop, bool detrend) -> PowerSpectrum
+    {
+        const auto grid = window_grid(segments, window_size, hop);
+        if (grid.n_windows == 0)
+            return {};
+
+        const std::size_t n_cols = segments.front().n_cols;
+
+        const std::size_t n_freq = window_size / 2 + 1;
+        const std::size_t n_tapers = setup.n_tapers;
+        const std::size_t batch = spectral_batch(window_size, n_tapers);
+
+        // partial[col * n_freq + k]: Σ|X|² over the tile's windows and tapers
+        const auto sums = accumulate_windows(grid, window_size * n_tapers * n_cols,
+            n_cols * n_freq, [&](const Tile& tile, double* partial) {
+                const auto& seg = segments[tile.segment];
+                auto& scratch = spectral_scratch();
+                scratch.frames.resize(batch * n_tapers * window_size);
+                scratch.spectra.resize(batch * n_tapers * n_freq);
+                scratch.power.resize(n_freq);
+                for (std::size_t col = 0; col < n_cols; ++col)
+                {
+                    double* acc = partial + col * n_freq;
+                    for (std::size_t b0 = tile.row_begin; b0 < tile.row_end; b0 += batch)
+                    {
+                        const std::size_t nb = std::min(batch, tile.row_end - b0);
+                        taper_spectra(seg, col, setup, window_size, hop, b0, nb, detrend,
+                            scratch.frames.data(), scratch.spectra.data());
+                        for (std::size_t j = 0; j < nb * n_tapers; ++j)
+                        {
+                            complex_power(
+                                scratch.spectra.data() + j * n_freq, scratch.power.data(), n_freq);
+                            for (std::size_t k = 0; k < n_freq; ++k)
+                                acc[k] += scratch.power[k];
+                        }
+                    }
+                }
+            });
+
+        PowerSpectrum result;
+        result.f = frequency_axis(window_size, grid.dt);
+        result.n_cols = n_cols;
+        result.n_windows = grid.n_windows;
+        result.psd.resize(n_freq * n_cols);
+        const auto scale = density_scale(setup, window_size, grid.n_windows, grid.dt);
+        for (std::size_t col = 0; col < n_cols; ++col)
+            for (std::size_t k = 0; k < n_freq; ++k)
+                result.psd[k * n_cols + col] = sums[col * n_freq + k] * scale[k];
+        return result;
+    }
+
+    inline std::size_t hop_size(std::size_t window_size, std::size_t overlap)
+    {
+        return (overlap == 0) ? window_size / 2 : window_size - overlap;
+    }
+
+} // namespace detail
+
+// Welch PSD: mean of the periodograms of windows of window_size samples, hop
+// apart (overlap = 0 means window_size / 2), over all columns and segments.
+// detrend removes each window's mean first (scipy's detrend='constant').
+template <typename T = double>
+auto welch(const std::vector<Segment<T>>& segments, std::size_t window_size = 256,
+    std::size_t overlap = 0, WindowType window = WindowType::Hann, bool detrend = true)
+    -> PowerSpectrum
+{
+    const std::size_t hop = detail::hop_size(window_size, overlap);
+    if (window_size == 0 || hop == 0)
+        return {};
+    const auto setup = detail::fft_setup<T>(window_size, window);
+    return detail::averaged_psd(segments, *setup, window_size, hop, detrend);
+}
+
+// Multitaper PSD: every window is tapered by the n_tapers first DPSS sequences
+// of half-bandwidth nw (0 tapers means 2 * nw - 1) and the eigenspectra are
+// averaged with equal weights, trading a wider bandwidth (2 nw / window_size
+// bins) for a lower variance than a single taper. Windows as in welch().
+template <typename T = double>
+auto multitaper(const std::vector<Segment<T>>& segments, std::size_t window_size = 256,
+    std::size_t overlap = 0, double nw = 4.0, std::size_t n_tapers = 0, bool detrend = true)
+    -> PowerSpectrum
+{
+    const std::size_t hop = detail::hop_size(window_size, overlap);
+    if (n_tapers == 0)
+        n_tapers = static_cast<std::size_t>(std::max(1.0, std::floor(2.0 * nw - 1.0)));
+    if (window_size == 0 || hop == 0 || n_tapers > window_size)
+        return {};
+    const auto setup = detail::dpss_setup(window_size, nw, n_tapers);
+    return detail::averaged_psd(segments, *setup, window_size, hop, detrend);
+}
+
+// Welch cross-spectral density between columns col_a and col_b, with the two
+// auto spectra it is normalised by for coherence(). Windows as in welch().
+template <typename T = double>
+auto csd(const std::vector<Segment<T>>& segments, std::size_t col_a = 0, std::size_t col_b = 1,
+    std::size_t window_size = 256, std::size_t overlap = 0, WindowType window = WindowType::Hann,
+    bool detrend = true) -> CrossSpectrum
+{
+    const std::size_t hop = detail::hop_size(window_size, overlap);
+    if (window_size == 0 || hop == 0)
+        return {};
+    const auto grid = detail::window_grid(segments, window_size, hop);
+    if (grid.n_windows == 0)
+        return {};
+
+    const auto setup = detail::fft_setup<T>(window_size, window);
+    const std::size_t n_freq = window_size / 2 + 1;
+    const std::size_t batch = detail::spectral_batch(window_size, 1);
+
+    // partial: [Σ|A|², Σ|B|², Σ Re(conj(A) B), Σ Im(conj(A) B)], n_freq each
+    const auto sums = detail::accumulate_windows(grid, 2 * window_size, 4 * n_freq,
+        [&](const Tile& tile, double* partial) {
+            const auto& seg = segments[tile.segment];
+            auto& scratch = detail::spectral_scratch();
+            scratch.frames.resize(batch * window_size);
+            scratch.spectra.resize(batch * n_freq);
+            scratch.spectra_b.resize(batch * n_freq);
+            for (std::size_t b0 = tile.row_begin; b0 < tile.row_end; b0 += batch)
+            {
+                const std::size_t nb = std::min(batch, tile.row_end - b0);
+                detail::taper_spectra(seg, col_a, *setup, window_size, hop, b0, nb, detrend,
+                    scratch.frames.data(), scratch.spectra.data());
+                detail::taper_spectra(seg, col_b, *setup, window_size, hop, b0, nb, detrend,
+                    scratch.frames.data(), scratch.spectra_b.data());
+                for (std::size_t j = 0; j < nb * n_freq; ++j)
+                {
+                    const auto a = scratch.spectra[j];
+                    const auto b = scratch.spectra_b[j];
+                    const auto ab = std::conj(a) * b;
+                    const std::size_t k = j % n_freq;
+                    partial[k] += std::norm(a);
+                    partial[n_freq + k] += std::norm(b);
+                    partial[2 * n_freq + k] += ab.real();
+                    partial[3 * n_freq + k] += ab.imag();
+                }
+            }
+        });
+
+    CrossSpectrum result;
+    result.f = detail::frequency_axis(window_size, grid.dt);
+    result.n_windows = grid.n_windows;
+    result.pxx.resize(n_freq);
+    result.pyy.resize(n_freq);
+    result.pxy.resize(n_freq);
+    const auto scale = detail::density_scale(*setup, window_size, grid.n_windows, grid.dt);
+    for (std::size_t k = 0; k < n_freq; ++k)
+    {
+        result.pxx[k] = sums[k] * scale[k];
+        result.pyy[k] = sums[n_freq + k] * scale[k];
+        result.pxy[k] = { sums[2 * n_freq + k] * scale[k], sums[3 * n_freq + k] * scale[k] };
+    }
+    return result;
+}
+
+} // namespace sqp::dsp
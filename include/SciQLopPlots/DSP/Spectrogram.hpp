@@ -21,21 +21,35 @@
 ----------------------------------------------------------------------------*/
 #pragma once
 
+#include "FFTCache.hpp"
 #include "Parallel.hpp"
 #include "Pipeline.hpp"
 #include "Segments.hpp"
+#include "SIMD/Primitives.hpp"
 #include "Window.hpp"
 
-#include <pocketfft_hdronly.h>
-
+#include <algorithm>
 #include <cmath>
 #include <complex>
 #include <cstddef>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 namespace sqp::dsp
 {
 
+#ifndef SQP_DSP_NO_SIMD
+namespace simd
+{
+    // Defined in kernels_dispatch.cpp — runtime-dispatched windowing and |X|^2.
+    extern decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(elementwise_mul_t {}))
+        dispatched_elementwise_mul;
+    extern decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(complex_power_t {}))
+        dispatched_complex_power;
+} // namespace simd
+#endif
+
 template <typename T = double>
 struct SpectrogramResult
 {
@@ -47,97 +61,164 @@ struct SpectrogramResult
 
 namespace detail
 {
-    // Compute power spectrum of a single windowed chunk.
-    template <typename T>
-    auto power_spectrum(const T* data, std::size_t n, const T* window, double inv_n)
-        -> std::vector<T>
+    // Windows per batched transform: enough for pocketfft to vectorise across
+    // transforms, few enough that the frames stay in cache.
+    inline std::size_t spectrogram_batch(std::size_t window_size)
     {
-        std::vector<double> windowed(n);
-        for (std::size_t i = 0; i < n; ++i)
-            windowed[i] = static_cast<double>(data[i]) * static_cast<double>(window[i]);
+        return std::max<std::size_t>(8, min_tile_work / window_size);
+    }
 
-        const pocketfft::shape_t shape { n };
-        const pocketfft::stride_t stride_in { sizeof(double) };
-        const pocketfft::stride_t stride_out { sizeof(std::complex<double>) };
-        const std::size_t n_freq = n / 2 + 1;
-        std::vector<std::complex<double>> spectrum(n_freq);
+    // Per-thread batch buffers, grown to the largest batch seen.
+    struct SpectrogramScratch
+    {
+        std::vector<double> frames;                // [batch × window_size]
+        std::vector<std::complex<double>> spectra; // [batch × n_freq]
+        std::vector<double> power;                 // one row, for non-double output
+    };
 
-        pocketfft::r2c(shape, stride_in, stride_out, { 0 },
-                        pocketfft::FORWARD, windowed.data(), spectrum.data(), 1.0);
+    inline SpectrogramScratch& spectrogram_scratch()
+    {
+        thread_local SpectrogramScratch scratch;
+        return scratch;
+    }
 
-        std::vector<T> psd(n_freq);
-        for (std::size_t i = 0; i < n_freq; ++i)
+    // frame[i] = data[i] * window[i], widened to double.
+    template <typename T>
+    void window_frame(const T* data, const double* window, std::size_t n, double* frame)
+    {
+#ifndef SQP_DSP_NO_SIMD
+        if constexpr (std::is_same_v<T, double>)
         {
-            const double re = spectrum[i].real() * inv_n;
-            const double im = spectrum[i].imag() * inv_n;
-            psd[i] = static_cast<T>(re * re + im * im);
+            simd::dispatched_elementwise_mul(data, window, frame, n);
+            return;
         }
-        return psd;
+        else
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                frame[i] = static_cast<double>(data[i]);
+            simd::dispatched_elementwise_mul(frame, window, frame, n);
+        }
+#else
+        for (std::size_t i = 0; i < n; ++i)
+            frame[i] = static_cast<double>(data[i]) * window[i];
+#endif
     }
 
+    inline void complex_power(const std::complex<double>* z, double* out, std::size_t n)
+    {
+#ifndef SQP_DSP_NO_SIMD
+        simd::dispatched_complex_power(z, out, n);
+#else
+        simd::scalar::complex_power(z, out, n);
+#endif
+    }
+
+    // Number of full windows of window_size rows, hop rows apart.
+    inline std::size_t count_windows(std::size_t n_rows, std::size_t window_size, std::size_t hop)
+    {
+        return (n_rows < window_size) ? 0 : (n_rows - window_size) / hop + 1;
+    }
+
+    // Axes and output buffer of a segment's spectrogram. Returns the number of
+    // windows; 0 (result left empty) when the segment is too short or has no
+    // sampling interval.
     template <typename T>
-    auto spectrogram_segment(
-        const Segment<T>& seg, std::size_t col,
-        std::size_t window_size, std::size_t hop, WindowType win_type) -> SpectrogramResult<T>
+    std::size_t spectrogram_prepare(const Segment<T>& seg, std::size_t window_size,
+        std::size_t hop, SpectrogramResult<T>& result)
     {
         if (seg.x.size() < window_size || seg.median_dt <= 0.0)
-            return {};
+            return 0;
 
-        const auto n_rows = seg.x.size();
-        const double fs = 1.0 / seg.median_dt;
+        const std::size_t n_windows = count_windows(seg.x.size(), window_size, hop);
         const std::size_t n_freq = window_size / 2 + 1;
-        const double inv_n = 1.0 / static_cast<double>(window_size);
-
-        // Count windows
-        std::size_t n_windows = 0;
-        for (std::size_t pos = 0; pos + window_size <= n_rows; pos += hop)
-            ++n_windows;
-
-        if (n_windows == 0)
-            return {};
-
-        auto window = make_window<T>(window_size, win_type);
+        const double fs = 1.0 / seg.median_dt;
 
-        SpectrogramResult<T> result;
         result.n_freq = n_freq;
         result.t.resize(n_windows);
         result.f.resize(n_freq);
         result.power.resize(n_windows * n_freq);
 
-        // Frequency axis
         for (std::size_t i = 0; i < n_freq; ++i)
             result.f[i] = static_cast<double>(i) * fs / static_cast<double>(window_size);
+        for (std::size_t w = 0; w < n_windows; ++w)
+            result.t[w] = seg.x[w * hop + window_size / 2]; // window center time
+        return n_windows;
+    }
 
-        // Extract contiguous column data for single-column case or copy strided
-        std::vector<T> col_data;
-        const T* col_ptr = nullptr;
+    // Contiguous view of one column: the segment itself for single-column data,
+    // otherwise a copy gathered into storage.
+    template <typename T>
+    const T* column_data(const Segment<T>& seg, std::size_t col, std::vector<T>& storage)
+    {
         if (seg.n_cols == 1)
+            return seg.y.data();
+        storage.resize(seg.x.size());
+        for (std::size_t i = 0; i < seg.x.size(); ++i)
+            storage[i] = seg.y[i * seg.n_cols + col];
+        return storage.data();
+    }
+
+    // Power spectra of windows [w_begin, w_end) of one column. The hops are
+    // windowed into a contiguous batch and transformed through the cached
+    // plan, several windows per SIMD register; |X|^2 is written straight into
+    // the output rows.
+    template <typename T>
+    void spectrogram_hops(const T* col_ptr, const FFTSetup& setup, std::size_t window_size,
+        std::size_t hop, std::size_t w_begin, std::size_t w_end, SpectrogramResult<T>& result)
+    {
+        const std::size_t n_freq = result.n_freq;
+        const double inv_n = 1.0 / static_cast<double>(window_size);
+        const std::size_t batch = spectrogram_batch(window_size);
+        auto& scratch = spectrogram_scratch();
+        scratch.frames.resize(batch * window_size);
+        scratch.spectra.resize(batch * n_freq);
+        if constexpr (!std::is_same_v<T, double>)
+            scratch.power.resize(n_freq);
+
+        for (std::size_t b0 = w_begin; b0 < w_end; b0 += batch)
         {
-            col_ptr = seg.y.data();
-        }
-        else
-        {
-            col_data.resize(n_rows);
-            for (std::size_t i = 0; i < n_rows; ++i)
-                col_data[i] = seg.y[i * seg.n_cols + col];
-            col_ptr = col_data.data();
+            const std::size_t nb = std::min(batch, w_end - b0);
+            for (std::size_t w = 0; w < nb; ++w)
+                window_frame(col_ptr + (b0 + w) * hop, setup.window.data(), window_size,
+                    scratch.frames.data() + w * window_size);
+
+            // Scaling by 1/N inside the transform, as (re / N)^2 + (im / N)^2.
+            real_forward_batch(
+                setup.plan, scratch.frames.data(), nb, scratch.spectra.data(), inv_n);
+
+            for (std::size_t w = 0; w < nb; ++w)
+            {
+                const auto* spectrum = scratch.spectra.data() + w * n_freq;
+                T* row = result.power.data() + (b0 + w) * n_freq;
+                if constexpr (std::is_same_v<T, double>)
+                    complex_power(spectrum, row, n_freq);
+                else
+                {
+                    complex_power(spectrum, scratch.power.data(), n_freq);
+                    for (std::size_t k = 0; k < n_freq; ++k)
+                        row[k] = static_cast<T>(scratch.power[k]);
+                }
+            }
         }
+    }
 
-        // Compute each window — parallel over windows
-        // Capture result pointer and col_ptr for the lambda
-        auto* power_ptr = result.power.data();
-        auto* t_ptr = result.t.data();
-        const auto* x_ptr = seg.x.data();
-        const auto* win_ptr = window.data();
-
-        parallel_for(n_windows, [=](std::size_t w) {
-            const std::size_t pos = w * hop;
-            t_ptr[w] = x_ptr[pos + window_size / 2]; // window center time
-            auto psd = power_spectrum(col_ptr + pos, window_size, win_ptr, inv_n);
-            for (std::size_t f = 0; f < n_freq; ++f)
-                power_ptr[w * n_freq + f] = psd[f];
-        });
+    template <typename T>
+    auto spectrogram_segment(
+        const Segment<T>& seg, std::size_t col,
+        std::size_t window_size, std::size_t hop, WindowType win_type) -> SpectrogramResult<T>
+    {
+        SpectrogramResult<T> result;
+        const auto n_windows = spectrogram_prepare(seg, window_size, hop, result);
+        if (n_windows == 0)
+            return {};
 
+        const auto setup = fft_setup<T>(window_size, win_type);
+        std::vector<T> col_data;
+        const T* col_ptr = column_data(seg, col, col_data);
+        parallel_for_blocks(n_windows, detail::min_tile_work / window_size + 1,
+            [&](std::size_t w_begin, std::size_t w_end) {
+                spectrogram_hops(col_ptr, *setup, window_size, hop, w_begin, w_end, result);
+            });
         return result;
     }
 
@@ -157,11 +238,29 @@ auto spectrogram(
     const std::size_t hop = (overlap == 0) ? window_size / 2 : window_size - overlap;
 
     std::vector<SpectrogramResult<T>> results(segments.size());
-    // Segments are processed sequentially here because each segment's windows
-    // are already parallelized internally.
-    for (std::size_t i = 0; i < segments.size(); ++i)
-        results[i] = detail::spectrogram_segment(segments[i], col, window_size, hop, window);
+    if (window_size == 0 || hop == 0)
+        return results;
+
+    // Windows of every segment are scheduled together, so many short segments
+    // spread across the pool as well as one long one.
+    std::vector<std::vector<T>> col_storage(segments.size());
+    std::vector<const T*> col_ptrs(segments.size(), nullptr);
+    std::vector<TileExtent> extents(segments.size());
+    parallel_for(segments.size(), [&](std::size_t i) {
+        const auto n_windows
+            = detail::spectrogram_prepare(segments[i], window_size, hop, results[i]);
+        if (n_windows == 0)
+            return;
+        col_ptrs[i] = detail::column_data(segments[i], col, col_storage[i]);
+        extents[i] = { n_windows, 1 };
+    });
 
+    const auto setup = detail::fft_setup<T>(window_size, window);
+    parallel_for_tiles(std::span<const TileExtent>(extents), TileSplit::Rows, window_size,
+        [&](const Tile& tile) {
+            detail::spectrogram_hops(col_ptrs[tile.segment], *setup, window_size, hop,
+                tile.row_begin, tile.row_end, results[tile.segment]);
+        });
     return results;
 }
 
@@ -23,10 +23,18 @@
 
 #include "Parallel.hpp"
 #include "Pipeline.hpp"
+#include "SIMD/Primitives.hpp"
 #include "Segments.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 namespace sqp::dsp
@@ -44,255 +52,578 @@ struct BlockStats
     std::size_t count = 0;
 };
 
+#ifndef SQP_DSP_NO_SIMD
+namespace simd
+{
+    extern decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(rolling_moments_t {}))
+        dispatched_rolling_moments;
+    extern decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(column_moments_t {}))
+        dispatched_column_moments;
+    extern decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(reduce_sum_t {}))
+        dispatched_reduce_sum;
+    extern decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(gather_lanes_t {}))
+        dispatched_gather_lanes;
+    extern decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(scatter_lanes_t {}))
+        dispatched_scatter_lanes;
+} // namespace simd
+#endif
+
 namespace detail
 {
-    template <typename T>
-    auto block_stats_column(const T* data, std::size_t n_rows, std::size_t n_cols, std::size_t col)
-        -> BlockStats
+    // Rolling windows and block statistics run on groups of SIMD lanes: each
+    // lane is one column, or one row chunk of a column, so narrow data still
+    // fills the vector. Sums are compensated (TwoSum) and shifted by a
+    // sample of the data (see simd::rolling_state_fields). Blocks of rows
+    // without NaN take the unmasked form of the rolling step.
+    //
+    // Sliding sums are restarted from scratch every rolling_rebase_rows()
+    // output rows, at fixed multiples of that period counted from the start
+    // of the segment. Each chunk between two restarts is an independent lane,
+    // rounding cannot drift over long series, and the streaming kernel, which
+    // restarts at the same rows, stays bit-identical to the whole-segment form.
+    inline constexpr std::size_t stats_lanes = 16;
+    inline constexpr std::size_t rolling_block_rows = 128;
+    inline constexpr std::size_t column_block_elems = 4096;
+
+    // An odd number of cache lines of doubles: the row chunks of one column
+    // that share a group of lanes then fall in different cache sets.
+    inline std::size_t rolling_rebase_rows(std::size_t half)
     {
-        BlockStats s;
-        double mean = 0.0, m2 = 0.0;
-        std::size_t count = 0;
+        return std::max<std::size_t>(std::size_t { 1 } << 10, 32 * (half + 1)) | 8;
+    }
 
-        // Seeded from the first NON-NaN sample: a NaN seed never loses a
-        // comparison, so min/max would stay NaN even with valid data after it
-        // (instrument data routinely starts with fill values).
-        T lo {};
-        T hi {};
+    // dense: no NaN in enter and leave (see simd::rolling_moments_t).
+    inline void rolling_moments(const double* enter, const double* leave, std::size_t n_rows,
+        std::size_t width, const double* shift, double* state, double* out, bool with_std,
+        bool dense)
+    {
+#ifndef SQP_DSP_NO_SIMD
+        simd::dispatched_rolling_moments(
+            enter, leave, n_rows, width, shift, state, out, with_std, dense);
+#else
+        (void)dense;
+        simd::scalar::rolling_moments(enter, leave, n_rows, width, shift, state, out, with_std);
+#endif
+    }
 
-        for (std::size_t i = 0; i < n_rows; ++i)
-        {
-            const T val = data[i * n_cols + col];
-            if constexpr (std::is_floating_point_v<T>)
-            {
-                if (std::isnan(val))
-                    continue;
-            }
+    // Sum of staged samples, NaN when one of them is.
+    inline double stage_sum(const double* data, std::size_t n)
+    {
+#ifndef SQP_DSP_NO_SIMD
+        return simd::dispatched_reduce_sum(data, n);
+#else
+        return std::accumulate(data, data + n, 0.0);
+#endif
+    }
+
+    inline void column_moments(const double* data, std::size_t n_rows, std::size_t stride,
+        std::size_t width, const double* shift, double* state)
+    {
+#ifndef SQP_DSP_NO_SIMD
+        simd::dispatched_column_moments(data, n_rows, stride, width, shift, state);
+#else
+        simd::scalar::column_moments(data, n_rows, stride, width, shift, state);
+#endif
+    }
 
-            ++count;
-            const double d = static_cast<double>(val);
-            const double delta = d - mean;
-            mean += delta / static_cast<double>(count);
-            const double delta2 = d - mean;
-            m2 += delta * delta2;
+    inline void gather_lanes(const double* src, std::size_t lane_stride, std::size_t n_rows,
+        std::size_t width, const double* shift, double* dst)
+    {
+#ifndef SQP_DSP_NO_SIMD
+        simd::dispatched_gather_lanes(src, lane_stride, n_rows, width, shift, dst);
+#else
+        simd::scalar::gather_lanes(src, lane_stride, n_rows, width, shift, dst);
+#endif
+    }
 
-            if (count == 1)
-            {
-                lo = val;
-                hi = val;
-            }
-            else
-            {
-                if (val < lo)
-                    lo = val;
-                if (val > hi)
-                    hi = val;
-            }
-        }
+    inline void scatter_lanes(const double* src, std::size_t n_rows, std::size_t width,
+        double* dst, std::size_t lane_stride)
+    {
+#ifndef SQP_DSP_NO_SIMD
+        simd::dispatched_scatter_lanes(src, n_rows, width, dst, lane_stride);
+#else
+        simd::scalar::scatter_lanes(src, n_rows, width, dst, lane_stride);
+#endif
+    }
 
-        s.mean = mean;
-        s.count = count;
-        s.min = static_cast<double>(lo);
-        s.max = static_cast<double>(hi);
-        if (count > 1)
+    // Shift of a lane: the first finite sample of rows [begin, end) of col,
+    // 0 if there is none.
+    template <typename T>
+    double first_finite(const T* in, std::size_t n_cols, std::size_t col, std::size_t begin,
+        std::size_t end)
+    {
+        for (std::size_t row = begin; row < end; ++row)
         {
-            s.variance = m2 / static_cast<double>(count - 1);
-            s.std_dev = std::sqrt(s.variance);
+            const double v = static_cast<double>(in[row * n_cols + col]);
+            if (std::isfinite(v))
+                return v;
         }
-        return s;
+        return 0.0;
     }
 
-    // O(n) rolling mean using a sliding sum.
-    // NaN handling: for floating point, NaN values are excluded from the window.
+    // dst[r * stride] = in[row, col] - shift for row = first + r, r < n, when
+    // row is in [lo, hi); NaN ("no sample") elsewhere.
     template <typename T>
-    void rolling_mean_column(
-        const T* in, std::size_t n_rows, std::size_t n_cols, std::size_t col,
-        std::size_t window, T* out)
+    void stage_lane(const T* in, std::size_t n_cols, std::size_t col, double shift,
+        std::ptrdiff_t first, std::size_t n, std::ptrdiff_t lo, std::ptrdiff_t hi, double* dst,
+        std::size_t stride)
     {
-        if (n_cols > 1)
-        {
-            std::vector<T> col_in(n_rows), col_out(n_rows);
-            for (std::size_t i = 0; i < n_rows; ++i)
-                col_in[i] = in[i * n_cols + col];
-
-            rolling_mean_column(col_in.data(), n_rows, 1, 0, window, col_out.data());
+        constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+        const auto n_signed = static_cast<std::ptrdiff_t>(n);
+        const auto r_lo = std::clamp<std::ptrdiff_t>(lo - first, 0, n_signed);
+        const auto r_hi = std::clamp<std::ptrdiff_t>(hi - first, r_lo, n_signed);
+        std::ptrdiff_t r = 0;
+        for (; r < r_lo; ++r)
+            dst[r * stride] = nan;
+        const T* src = in + (first + r) * static_cast<std::ptrdiff_t>(n_cols) + col;
+        for (; r < r_hi; ++r, src += n_cols)
+            dst[r * stride] = static_cast<double>(*src) - shift;
+        for (; r < n_signed; ++r)
+            dst[r * stride] = nan;
+    }
 
-            for (std::size_t i = 0; i < n_rows; ++i)
-                out[i * n_cols + col] = col_out[i];
-            return;
-        }
+    // One gap-free series of a rolling_mean / rolling_std call.
+    template <typename T>
+    struct RollingSeries
+    {
+        const T* in = nullptr;
+        std::size_t n_rows = 0;
+        std::size_t n_cols = 0;
+        T* out = nullptr;
+    };
 
-        // Single-column (contiguous) path
+    // Rolling mean (or sample std) over a centred window of every column of
+    // every series, clipped at the series edges; NaN samples are left out of
+    // the window.
+    template <typename T>
+    void rolling_windows(std::span<const RollingSeries<T>> series, std::size_t window,
+        bool with_std)
+    {
         const auto half = window / 2;
+        const auto period = rolling_rebase_rows(half);
+        const auto warmup = 2 * half + 1;
+        const auto h = static_cast<std::ptrdiff_t>(half);
+        const auto w = static_cast<std::ptrdiff_t>(warmup);
 
-        double sum = 0.0;
-        std::size_t count = 0;
-        const auto init_hi = std::min(half + 1, n_rows);
-        for (std::size_t j = 0; j < init_hi; ++j)
+        struct Lane
         {
-            const T val = in[j];
-            if constexpr (std::is_floating_point_v<T>)
-            {
-                if (std::isnan(val))
-                    continue;
-            }
-            sum += static_cast<double>(val);
-            ++count;
-        }
-        out[0] = (count > 0) ? static_cast<T>(sum / static_cast<double>(count)) : T { 0 };
+            std::size_t series;
+            std::size_t col;
+            std::size_t anchor;
+        };
+        std::vector<Lane> lanes;
+        for (std::size_t s = 0; s < series.size(); ++s)
+            for (std::size_t anchor = 0; anchor < series[s].n_rows; anchor += period)
+                for (std::size_t col = 0; col < series[s].n_cols; ++col)
+                    lanes.push_back({ s, col, anchor });
+        if (lanes.empty())
+            return;
 
-        for (std::size_t i = 1; i < n_rows; ++i)
-        {
-            const auto new_hi = i + half;
-            if (new_hi < n_rows)
+        constexpr auto L = stats_lanes;
+        constexpr auto B = rolling_block_rows;
+        const auto n_groups = (lanes.size() + L - 1) / L;
+        const auto min_groups
+            = std::max<std::size_t>(1, min_tile_work / (L * (period + warmup)));
+        // Staged rows kept per lane: the window behind the current block plus
+        // room to run ahead before the history is moved back to the front.
+        const auto capacity = warmup + std::max(2 * warmup, 4 * B);
+
+        parallel_for_blocks(n_groups, min_groups, [&](std::size_t g_begin, std::size_t g_end) {
+            // Virtual row v of a lane is input row anchor - half - 1 + v: it
+            // enters the window at v and leaves it at v + warmup. Output row
+            // anchor + i is written at v = warmup + i. Staged row v sits at
+            // stage[(v - base) * L]; rows before v = 0 are "no sample".
+            std::vector<double> stage(capacity * L), result(B * L);
+            std::array<double, L> shift;
+            std::array<double, simd::rolling_state_fields * L> state;
+            std::array<std::size_t, L> end;
+            for (std::size_t g = g_begin; g < g_end; ++g)
             {
-                const T val = in[new_hi];
-                if constexpr (std::is_floating_point_v<T>)
+                const auto first_lane = g * L;
+                const auto n_lanes = std::min(L, lanes.size() - first_lane);
+                std::size_t n_virtual = 0;
+                for (std::size_t l = 0; l < L; ++l)
                 {
-                    if (!std::isnan(val))
-                    {
-                        sum += static_cast<double>(val);
-                        ++count;
-                    }
+                    shift[l] = 0.0;
+                    end[l] = 0;
+                    if (l >= n_lanes)
+                        continue;
+                    const auto& lane = lanes[first_lane + l];
+                    const auto& ser = series[lane.series];
+                    end[l] = std::min(lane.anchor + period, ser.n_rows);
+                    shift[l] = first_finite(ser.in, ser.n_cols, lane.col,
+                        lane.anchor > half ? lane.anchor - half - 1 : 0,
+                        std::min(ser.n_rows, lane.anchor + half + 1));
+                    n_virtual = std::max(n_virtual, warmup + end[l] - lane.anchor);
                 }
-                else
+                // L consecutive chunks of one double column: lane l reads and
+                // writes `period` rows after lane l - 1, so whole tiles of
+                // lanes are moved at once.
+                bool columnar = false;
+                if constexpr (std::is_same_v<T, double>)
                 {
-                    sum += static_cast<double>(val);
-                    ++count;
+                    const auto s0 = lanes[first_lane].series;
+                    columnar = n_lanes == L && series[s0].n_cols == 1
+                        && lanes[first_lane + L - 1].series == s0;
                 }
-            }
-
-            if (i > half)
-            {
-                const auto old_lo = i - half - 1;
-                const T val = in[old_lo];
-                if constexpr (std::is_floating_point_v<T>)
+                state.fill(0.0);
+                std::fill_n(stage.begin(), warmup * L, std::numeric_limits<double>::quiet_NaN());
+                std::ptrdiff_t base = -w;
+                std::ptrdiff_t staged = 0;
+                // Staged rows before nan_end may hold a NaN.
+                std::ptrdiff_t nan_end = 0;
+
+                for (std::size_t v0 = 0; v0 < n_virtual; v0 += B)
                 {
-                    if (!std::isnan(val))
+                    const auto nb = std::min(B, n_virtual - v0);
+                    const auto v = static_cast<std::ptrdiff_t>(v0);
+                    const auto v_end = v + static_cast<std::ptrdiff_t>(nb);
+                    if (v_end - base > static_cast<std::ptrdiff_t>(capacity))
                     {
-                        sum -= static_cast<double>(val);
-                        --count;
+                        std::copy(stage.begin() + (v - w - base) * L,
+                            stage.begin() + (staged - base) * L, stage.begin());
+                        base = v - w;
+                    }
+                    const auto n_new = static_cast<std::size_t>(v_end - staged);
+                    double* dst = stage.data() + (staged - base) * L;
+                    // Interior rows of a full group are copied row by row;
+                    // edges and partial groups go lane by lane with padding.
+                    bool interior = n_lanes == L;
+                    std::array<const T*, L> src;
+                    std::array<std::size_t, L> stride;
+                    for (std::size_t l = 0; l < n_lanes && interior; ++l)
+                    {
+                        const auto& lane = lanes[first_lane + l];
+                        const auto& ser = series[lane.series];
+                        const auto row = static_cast<std::ptrdiff_t>(lane.anchor) - h - 1 + staged;
+                        const auto hi = std::min(static_cast<std::ptrdiff_t>(ser.n_rows),
+                            static_cast<std::ptrdiff_t>(end[l]) + h);
+                        interior = row >= 0 && row + static_cast<std::ptrdiff_t>(n_new) <= hi;
+                        src[l] = ser.in + row * static_cast<std::ptrdiff_t>(ser.n_cols) + lane.col;
+                        stride[l] = ser.n_cols;
+                    }
+                    if (interior && columnar)
+                    {
+                        if constexpr (std::is_same_v<T, double>)
+                            gather_lanes(src[0], period, n_new, L, shift.data(), dst);
+                    }
+                    else if (interior
+                        && std::all_of(stride.begin(), stride.end(),
+                            [&](std::size_t st) { return st == stride[0]; }))
+                    {
+                        const auto st = stride[0];
+                        for (std::size_t r = 0; r < n_new; ++r)
+                            for (std::size_t l = 0; l < L; ++l)
+                                dst[r * L + l] = static_cast<double>(src[l][r * st]) - shift[l];
+                    }
+                    else if (interior)
+                    {
+                        for (std::size_t r = 0; r < n_new; ++r)
+                            for (std::size_t l = 0; l < L; ++l)
+                                dst[r * L + l] = static_cast<double>(src[l][r * stride[l]]) - shift[l];
+                    }
+                    else
+                    {
+                        for (std::size_t l = 0; l < L; ++l)
+                        {
+                            if (l >= n_lanes)
+                            {
+                                stage_lane<T>(nullptr, 0, 0, 0.0, 0, n_new, 0, 0, dst + l, L);
+                                continue;
+                            }
+                            const auto& lane = lanes[first_lane + l];
+                            const auto& ser = series[lane.series];
+                            const auto anchor = static_cast<std::ptrdiff_t>(lane.anchor);
+                            const auto stop = static_cast<std::ptrdiff_t>(end[l]);
+                            stage_lane(ser.in, ser.n_cols, lane.col, shift[l],
+                                anchor - h - 1 + staged, n_new, 0,
+                                std::min(static_cast<std::ptrdiff_t>(ser.n_rows), stop + h),
+                                dst + l, L);
+                        }
+                    }
+                    if (std::isnan(stage_sum(dst, n_new * L)))
+                        nan_end = v_end;
+                    staged = v_end;
+
+                    rolling_moments(stage.data() + (v - base) * L,
+                        stage.data() + (v - w - base) * L, nb, L, shift.data(), state.data(),
+                        result.data(), with_std, v - w >= nan_end);
+
+                    if (v_end <= w)
+                        continue;
+                    const auto r_lo = static_cast<std::size_t>(std::max<std::ptrdiff_t>(w - v, 0));
+                    if (columnar)
+                    {
+                        // Every lane but the last spans a whole period.
+                        const auto row_lo = lanes[first_lane].anchor + v0 + r_lo - warmup;
+                        const auto last_lo = lanes[first_lane + L - 1].anchor + v0 + r_lo - warmup;
+                        const auto r_hi = std::min(nb, r_lo + (end[0] - row_lo));
+                        if constexpr (std::is_same_v<T, double>)
+                            if (last_lo + (r_hi - r_lo) <= end[L - 1])
+                            {
+                                scatter_lanes(result.data() + r_lo * L, r_hi - r_lo, L,
+                                    series[lanes[first_lane].series].out + row_lo, period);
+                                continue;
+                            }
+                    }
+                    for (std::size_t l = 0; l < n_lanes; ++l)
+                    {
+                        const auto& lane = lanes[first_lane + l];
+                        const auto& ser = series[lane.series];
+                        const auto row_lo = lane.anchor + v0 + r_lo - warmup;
+                        if (row_lo >= end[l])
+                            continue;
+                        const auto r_hi = std::min(nb, r_lo + (end[l] - row_lo));
+                        const auto stride = ser.n_cols;
+                        T* dst = ser.out + row_lo * stride + lane.col;
+                        const double* src = result.data() + l;
+                        for (std::size_t r = r_lo; r < r_hi; ++r, dst += stride)
+                            *dst = static_cast<T>(src[r * L]);
                     }
-                }
-                else
-                {
-                    sum -= static_cast<double>(val);
-                    --count;
                 }
             }
-
-            out[i] = (count > 0) ? static_cast<T>(sum / static_cast<double>(count)) : T { 0 };
-        }
+        });
     }
 
-    // O(n) rolling std using sliding sum and sum-of-squares.
-    // std = sqrt((sum_sq/n - mean^2) * n/(n-1)) for sample std.
+    // Block statistics of columns [col_begin, col_end). When those are all
+    // the columns and fewer than stats_lanes, several consecutive rows share
+    // one vector (lane l holds column l % n_cols) and the lanes are merged.
     template <typename T>
-    void rolling_std_column(
-        const T* in, std::size_t n_rows, std::size_t n_cols, std::size_t col,
-        std::size_t window, T* out)
+    void block_stats_columns(const T* data, std::size_t n_rows, std::size_t n_cols,
+        std::size_t col_begin, std::size_t col_end, BlockStats* out)
     {
-        if (n_cols > 1)
+        const auto width = col_end - col_begin;
+        if (width == 0)
+            return;
+        const bool packed = col_begin == 0 && col_end == n_cols && n_cols < stats_lanes;
+        const auto rows_per_lane_row = packed ? stats_lanes / n_cols : std::size_t { 1 };
+        const auto lane_width = rows_per_lane_row * width;
+        const auto stride = rows_per_lane_row * n_cols;
+        const auto n_lane_rows = n_rows / rows_per_lane_row;
+        const auto tail_rows = n_rows - n_lane_rows * rows_per_lane_row;
+
+        std::vector<double> shift(lane_width);
+        for (std::size_t c = 0; c < width; ++c)
+            shift[c] = first_finite(data, n_cols, col_begin + c, 0, n_rows);
+        for (std::size_t l = width; l < lane_width; ++l)
+            shift[l] = shift[l % width];
+
+        constexpr double inf = std::numeric_limits<double>::infinity();
+        constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+        using simd::column_state_fields;
+        std::vector<double> state(column_state_fields * lane_width, 0.0);
+        std::fill_n(state.begin() + 5 * lane_width, lane_width, inf);
+        std::fill_n(state.begin() + 6 * lane_width, lane_width, -inf);
+
+        const auto block_rows = std::max<std::size_t>(16, column_block_elems / lane_width);
+        std::vector<double> staged;
+        if constexpr (!std::is_same_v<T, double>)
+            staged.resize(block_rows * lane_width);
+        for (std::size_t r0 = 0; r0 < n_lane_rows; r0 += block_rows)
         {
-            std::vector<T> col_in(n_rows), col_out(n_rows);
-            for (std::size_t i = 0; i < n_rows; ++i)
-                col_in[i] = in[i * n_cols + col];
+            const auto nb = std::min(block_rows, n_lane_rows - r0);
+            const T* src = data + r0 * stride + col_begin;
+            if constexpr (std::is_same_v<T, double>)
+            {
+                column_moments(src, nb, stride, lane_width, shift.data(), state.data());
+            }
+            else
+            {
+                for (std::size_t r = 0; r < nb; ++r)
+                    for (std::size_t l = 0; l < lane_width; ++l)
+                        staged[r * lane_width + l] = static_cast<double>(src[r * stride + l]);
+                column_moments(staged.data(), nb, lane_width, lane_width, shift.data(),
+                    state.data());
+            }
+        }
+        if (tail_rows > 0)
+        {
+            // Last rows that do not fill a lane row: pad with NaN samples
+            std::vector<double> tail(lane_width, nan);
+            const T* src = data + n_lane_rows * stride;
+            for (std::size_t i = 0; i < tail_rows * n_cols; ++i)
+                tail[i] = static_cast<double>(src[i]);
+            column_moments(tail.data(), 1, lane_width, lane_width, shift.data(), state.data());
+        }
+
+        for (std::size_t c = 0; c < width; ++c)
+        {
+            double s = 0.0, s_c = 0.0, q = 0.0, q_c = 0.0, count = 0.0;
+            double lo = inf, hi = -inf;
+            for (std::size_t l = c; l < lane_width; l += width)
+            {
+                simd::scalar::compensated_add(s, s_c, state[l]);
+                simd::scalar::compensated_add(s, s_c, state[lane_width + l]);
+                simd::scalar::compensated_add(q, q_c, state[2 * lane_width + l]);
+                simd::scalar::compensated_add(q, q_c, state[3 * lane_width + l]);
+                count += state[4 * lane_width + l];
+                lo = std::min(lo, state[5 * lane_width + l]);
+                hi = std::max(hi, state[6 * lane_width + l]);
+            }
+            s += s_c;
+            q += q_c;
+            auto& st = out[c];
+            st = BlockStats {};
+            st.count = static_cast<std::size_t>(count);
+            st.mean = (count > 0.0) ? shift[c] + s / count : 0.0;
+            if (st.count > 0)
+            {
+                st.min = lo;
+                st.max = hi;
+            }
+            if (st.count > 1)
+            {
+                st.variance = std::max(0.0, (q - s * s / count) / (count - 1.0));
+                st.std_dev = std::sqrt(st.variance);
+            }
+        }
+    }
 
-            rolling_std_column(col_in.data(), n_rows, 1, 0, window, col_out.data());
+    template <typename T>
+    auto block_stats_column(const T* data, std::size_t n_rows, std::size_t n_cols, std::size_t col)
+        -> BlockStats
+    {
+        BlockStats s;
+        block_stats_columns(data, n_rows, n_cols, col, col + 1, &s);
+        return s;
+    }
 
-            for (std::size_t i = 0; i < n_rows; ++i)
-                out[i * n_cols + col] = col_out[i];
-            return;
+    // Streaming form of rolling_windows: the same per-lane operations on one
+    // row at a time, restarted at the same rows, so the output is
+    // bit-identical; row i is emitted once row i + window/2 is in.
+    template <typename T, bool WithStd>
+    class RollingKernel final : public BlockKernel<T>
+    {
+    public:
+        RollingKernel(std::size_t window, std::size_t n_cols)
+                : m_half(window / 2)
+                , m_n_cols(n_cols)
+                , m_period(rolling_rebase_rows(window / 2))
+                , m_capacity(2 * (window / 2) + 2)
+                , m_ring(m_capacity * n_cols)
+                , m_shift(n_cols)
+                , m_state(simd::rolling_state_fields * n_cols)
+                , m_enter(n_cols)
+                , m_leave(n_cols)
+                , m_out(n_cols)
+        {
         }
 
-        // Single-column (contiguous) path
-        const auto half = window / 2;
+        Halo halo() const override { return { .before = m_half + 1, .after = m_half }; }
+
+        std::size_t out_cols() const override { return m_n_cols; }
 
-        double sum = 0.0, sum_sq = 0.0;
-        std::size_t count = 0;
-        const auto init_hi = std::min(half + 1, n_rows);
-        for (std::size_t j = 0; j < init_hi; ++j)
+        std::size_t push(const T* in, std::size_t n, T* out) override
         {
-            const T val = in[j];
-            if constexpr (std::is_floating_point_v<T>)
+            std::size_t produced = 0;
+            for (std::size_t r = 0; r < n; ++r)
             {
-                if (std::isnan(val))
+                const auto row = m_row++;
+                std::copy_n(in + r * m_n_cols, m_n_cols,
+                    m_ring.begin() + (row % m_capacity) * m_n_cols);
+                if (row < m_half)
                     continue;
+                emit(row - m_half, out + produced * m_n_cols);
+                ++produced;
             }
-            const double d = static_cast<double>(val);
-            sum += d;
-            sum_sq += d * d;
-            ++count;
+            return produced;
         }
 
-        auto write_std = [&](std::size_t i)
+        std::size_t finish(T* out) override
         {
-            if (count > 1)
-            {
-                const double mean = sum / static_cast<double>(count);
-                const double var
-                    = (sum_sq - static_cast<double>(count) * mean * mean)
-                    / static_cast<double>(count - 1);
-                out[i] = static_cast<T>(std::sqrt(std::max(0.0, var)));
-            }
-            else
+            std::size_t produced = 0;
+            for (std::size_t i = m_emitted; i < m_row; ++i)
             {
-                out[i] = T { 0 };
+                emit(i, out + produced * m_n_cols);
+                ++produced;
             }
-        };
+            return produced;
+        }
 
-        write_std(0);
+    private:
+        const T* ring_row(std::size_t row) const
+        {
+            return m_ring.data() + (row % m_capacity) * m_n_cols;
+        }
 
-        for (std::size_t i = 1; i < n_rows; ++i)
+        // Values of a held row, shifted, into dst; NaN when absent is true.
+        void stage_row(std::size_t row, bool absent, std::vector<double>& dst) const
         {
-            const auto new_hi = i + half;
-            if (new_hi < n_rows)
+            for (std::size_t col = 0; col < m_n_cols; ++col)
+                dst[col] = absent ? std::numeric_limits<double>::quiet_NaN()
+                                  : static_cast<double>(ring_row(row)[col]) - m_shift[col];
+        }
+
+        void step()
+        {
+            simd::scalar::rolling_moments(m_enter.data(), m_leave.data(), 1, m_n_cols,
+                m_shift.data(), m_state.data(), m_out.data(), WithStd);
+        }
+
+        // Start the sums of output row i over: shift from rows
+        // [i - half - 1, i + half], window of row i - 1 added row by row.
+        void restart(std::size_t i)
+        {
+            const auto lo = i > m_half ? i - m_half - 1 : 0;
+            for (std::size_t col = 0; col < m_n_cols; ++col)
             {
-                const T val = in[new_hi];
-                if constexpr (std::is_floating_point_v<T>)
+                m_shift[col] = 0.0;
+                for (std::size_t row = lo; row < std::min(m_row, i + m_half + 1); ++row)
                 {
-                    if (!std::isnan(val))
+                    const double v = static_cast<double>(ring_row(row)[col]);
+                    if (std::isfinite(v))
                     {
-                        const double d = static_cast<double>(val);
-                        sum += d;
-                        sum_sq += d * d;
-                        ++count;
+                        m_shift[col] = v;
+                        break;
                     }
                 }
-                else
-                {
-                    const double d = static_cast<double>(val);
-                    sum += d;
-                    sum_sq += d * d;
-                    ++count;
-                }
             }
-
-            if (i > half)
+            std::fill(m_state.begin(), m_state.end(), 0.0);
+            stage_row(0, true, m_leave);
+            for (std::size_t k = 0; k < 2 * m_half + 1; ++k)
             {
-                const auto old_lo = i - half - 1;
-                const T val = in[old_lo];
-                if constexpr (std::is_floating_point_v<T>)
-                {
-                    if (!std::isnan(val))
-                    {
-                        const double d = static_cast<double>(val);
-                        sum -= d;
-                        sum_sq -= d * d;
-                        --count;
-                    }
-                }
-                else
-                {
-                    const double d = static_cast<double>(val);
-                    sum -= d;
-                    sum_sq -= d * d;
-                    --count;
-                }
+                // Row i - half - 1 + k; out-of-range rows are NaN steps, as in
+                // the padded warm-up of rolling_windows
+                const auto row = i + k;
+                const bool absent = row < m_half + 1 || row - m_half - 1 >= m_row;
+                stage_row(row - m_half - 1, absent, m_enter);
+                step();
             }
+        }
 
-            write_std(i);
+        void emit(std::size_t i, T* out_row)
+        {
+            if (i % m_period == 0)
+                restart(i);
+            stage_row(i + m_half, i + m_half >= m_row, m_enter);
+            stage_row(i - m_half - 1, i <= m_half, m_leave);
+            step();
+            for (std::size_t col = 0; col < m_n_cols; ++col)
+                out_row[col] = static_cast<T>(m_out[col]);
+            m_emitted = i + 1;
         }
+
+        std::size_t m_half;
+        std::size_t m_n_cols;
+        std::size_t m_period;
+        std::size_t m_capacity;
+        std::vector<T> m_ring; // last m_capacity input rows, row-major
+        std::vector<double> m_shift;
+        std::vector<double> m_state;
+        std::vector<double> m_enter, m_leave, m_out;
+        std::size_t m_row = 0;
+        std::size_t m_emitted = 0;
+    };
+
+    template <typename T>
+    auto rolling_series(const std::vector<Segment<T>>& segments,
+        std::vector<TimeSeries<T>>& results) -> std::vector<RollingSeries<T>>
+    {
+        std::vector<RollingSeries<T>> series(segments.size());
+        for (std::size_t i = 0; i < segments.size(); ++i)
+            series[i] = { segments[i].y.data(), segments[i].x.size(), segments[i].n_cols,
+                results[i].y.data() };
+        return series;
     }
 
 } // namespace detail
@@ -303,12 +634,12 @@ auto block_stats(const std::vector<Segment<T>>& segments)
     -> std::vector<std::vector<BlockStats>>
 {
     std::vector<std::vector<BlockStats>> results(segments.size());
-    parallel_for(segments.size(), [&](std::size_t i) {
-        const auto& seg = segments[i];
-        results[i].resize(seg.n_cols);
-        for (std::size_t col = 0; col < seg.n_cols; ++col)
-            results[i][col]
-                = detail::block_stats_column(seg.y.data(), seg.x.size(), seg.n_cols, col);
+    for (std::size_t i = 0; i < segments.size(); ++i)
+        results[i].resize(segments[i].n_cols);
+    detail::for_each_tile(segments, TileSplit::Columns, 1, [&](const Tile& tile) {
+        const auto& seg = segments[tile.segment];
+        detail::block_stats_columns(seg.y.data(), seg.x.size(), seg.n_cols, tile.col_begin,
+            tile.col_end, results[tile.segment].data() + tile.col_begin);
     });
     return results;
 }
@@ -317,42 +648,30 @@ auto block_stats(const std::vector<Segment<T>>& segments)
 template <typename T = double>
 auto rolling_mean(std::size_t window) -> Stage<T>
 {
-    return [window](const std::vector<Segment<T>>& segments) -> std::vector<TimeSeries<T>>
+    auto apply = [window](const std::vector<Segment<T>>& segments) -> std::vector<TimeSeries<T>>
     {
-        std::vector<TimeSeries<T>> results(segments.size());
-        parallel_for(segments.size(), [&](std::size_t i) {
-            const auto& seg = segments[i];
-            auto& out = results[i];
-            out.x.assign(seg.x.begin(), seg.x.end());
-            out.y.resize(seg.y.size());
-            out.n_cols = seg.n_cols;
-            for (std::size_t col = 0; col < seg.n_cols; ++col)
-                detail::rolling_mean_column(
-                    seg.y.data(), seg.x.size(), seg.n_cols, col, window, out.y.data());
-        });
+        auto results = detail::alloc_outputs(segments);
+        detail::rolling_windows<T>(detail::rolling_series(segments, results), window, false);
         return results;
     };
+    auto kernel = [window](std::size_t n_cols) -> std::unique_ptr<BlockKernel<T>>
+    { return std::make_unique<detail::RollingKernel<T, false>>(window, n_cols); };
+    return Stage<T>(std::move(apply), std::move(kernel));
 }
 
 // Pipeline stage: rolling standard deviation.
 template <typename T = double>
 auto rolling_std(std::size_t window) -> Stage<T>
 {
-    return [window](const std::vector<Segment<T>>& segments) -> std::vector<TimeSeries<T>>
+    auto apply = [window](const std::vector<Segment<T>>& segments) -> std::vector<TimeSeries<T>>
     {
-        std::vector<TimeSeries<T>> results(segments.size());
-        parallel_for(segments.size(), [&](std::size_t i) {
-            const auto& seg = segments[i];
-            auto& out = results[i];
-            out.x.assign(seg.x.begin(), seg.x.end());
-            out.y.resize(seg.y.size());
-            out.n_cols = seg.n_cols;
-            for (std::size_t col = 0; col < seg.n_cols; ++col)
-                detail::rolling_std_column(
-                    seg.y.data(), seg.x.size(), seg.n_cols, col, window, out.y.data());
-        });
+        auto results = detail::alloc_outputs(segments);
+        detail::rolling_windows<T>(detail::rolling_series(segments, results), window, true);
         return results;
     };
+    auto kernel = [window](std::size_t n_cols) -> std::unique_ptr<BlockKernel<T>>
+    { return std::make_unique<detail::RollingKernel<T, true>>(window, n_cols); };
+    return Stage<T>(std::move(apply), std::move(kernel));
 }
 
 } // namespace sqp::dsp
@@ -0,0 +1,141 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2026, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+
+#include "Pipeline.hpp"
+#include "Segments.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace sqp::dsp
+{
+
+// A causal filter fed with successive chunks of one time series (live
+// telemetry, appended data). The kernel state — biquad z1/z2 for iir_sos, the
+// n_taps - 1 row delay line for fir_filter — is carried across push() calls,
+// so filtering N new rows costs O(N) whatever the history length.
+//
+// Gaps reset the state, as split_segments would: a step larger than
+// gap_factor x median_dt, inside a chunk or between the previous chunk and
+// this one, starts a new segment. median_dt is taken from the first push that
+// has two timestamps and kept afterwards, so the gap threshold does not drift
+// with chunk size.
+//
+// Output rows map 1:1 to input rows (no NaN separator rows at gaps).
+template <typename T = double>
+class StreamingFilter
+{
+public:
+    // stage must have a block kernel with no look-ahead (fir_filter, iir_sos,
+    // reduce); otherwise std::invalid_argument is thrown.
+    StreamingFilter(const Stage<T>& stage, std::size_t n_cols, double gap_factor = 3.0)
+            : m_make_kernel(stage.make_kernel), m_n_cols(n_cols), m_gap_factor(gap_factor)
+    {
+        if (!m_make_kernel)
+            throw std::invalid_argument("StreamingFilter: stage needs whole segments");
+        m_kernel = m_make_kernel(m_n_cols);
+        if (m_kernel->halo().after != 0)
+            throw std::invalid_argument("StreamingFilter: stage has look-ahead");
+        m_out_cols = m_kernel->out_cols();
+    }
+
+    std::size_t n_cols() const noexcept { return m_n_cols; }
+    std::size_t out_cols() const noexcept { return m_out_cols; }
+    double median_dt() const noexcept { return m_median_dt; }
+
+    // Forget all state, as if nothing had been pushed.
+    void reset()
+    {
+        m_kernel = m_make_kernel(m_n_cols);
+        m_median_dt = 0.0;
+        m_last_x = std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // Filter the rows that follow everything pushed so far. x has one
+    // timestamp per row, y is row-major with n_cols() columns. Returns
+    // x.size() rows of out_cols() columns; std::invalid_argument is thrown
+    // when y does not hold exactly x.size() rows.
+    std::vector<T> push(std::span<const double> x, std::span<const T> y)
+    {
+        const auto n = x.size();
+        if (y.size() != n * m_n_cols)
+            throw std::invalid_argument("StreamingFilter: y must have x.size() * n_cols() values");
+        std::vector<T> out(n * m_out_cols);
+        if (n == 0)
+            return out;
+
+        if (m_median_dt <= 0.0)
+            m_median_dt = establish_median_dt(x);
+        const double threshold = m_gap_factor * m_median_dt;
+        auto is_gap = [&](double from, double to)
+        { return m_median_dt > 0.0 && (to - from) > threshold; };
+
+        if (is_gap(m_last_x, x[0]))
+            m_kernel = m_make_kernel(m_n_cols);
+
+        std::size_t start = 0;
+        auto feed = [&](std::size_t end) {
+            m_kernel->push(&y[start * m_n_cols], end - start, &out[start * m_out_cols]);
+            start = end;
+        };
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            if (is_gap(x[i - 1], x[i]))
+            {
+                feed(i);
+                m_kernel = m_make_kernel(m_n_cols);
+            }
+        }
+        feed(n);
+        m_last_x = x[n - 1];
+        return out;
+    }
+
+private:
+    // Median step of this chunk, including the step from the previous chunk.
+    double establish_median_dt(std::span<const double> x) const
+    {
+        if (std::isnan(m_last_x))
+            return detail::compute_median_dt(x);
+        std::vector<double> joined;
+        joined.reserve(x.size() + 1);
+        joined.push_back(m_last_x);
+        joined.insert(joined.end(), x.begin(), x.end());
+        return detail::compute_median_dt(joined);
+    }
+
+    KernelFactory<T> m_make_kernel;
+    std::unique_ptr<BlockKernel<T>> m_kernel;
+    std::size_t m_n_cols;
+    std::size_t m_out_cols = 0;
+    double m_gap_factor;
+    double m_median_dt = 0.0;
+    double m_last_x = std::numeric_limits<double>::quiet_NaN();
+};
+
+} // namespace sqp::dsp
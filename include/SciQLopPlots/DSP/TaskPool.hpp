@@ -0,0 +1,299 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2026, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sqp::dsp
+{
+
+namespace detail
+{
+    // Completion tracking for one TaskGroup: the tasks it submitted that no
+    // thread has started yet, and how many are still unfinished.
+    struct TaskGroupState
+    {
+        std::mutex mutex;
+        std::condition_variable done;
+        std::deque<std::function<void()>> pending;
+        std::size_t unfinished = 0;
+        std::exception_ptr error; // first exception thrown by a task
+
+        // Run one pending task of this group. Returns false when none is left.
+        bool try_run_one()
+        {
+            std::function<void()> task;
+            {
+                std::lock_guard lock { mutex };
+                if (pending.empty())
+                    return false;
+                task = std::move(pending.front());
+                pending.pop_front();
+            }
+            std::exception_ptr thrown;
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                thrown = std::current_exception();
+            }
+            std::lock_guard lock { mutex };
+            if (thrown && !error)
+                error = thrown;
+            if (--unfinished == 0)
+                done.notify_all();
+            return true;
+        }
+    };
+}
+
+// Work-stealing thread pool. Each worker owns a deque of group tickets: it
+// pops its own deque from the back and steals from the others' fronts when
+// empty. A ticket only says "this group has work"; the worker that takes it
+// keeps running that group's tasks until the group has none left, so stale
+// tickets are simply dropped.
+//
+// Work is submitted and awaited through TaskGroup, never on the pool itself:
+// there is no pool-wide wait(), so independent callers never wait on each
+// other's tasks.
+class TaskPool
+{
+public:
+    using ThreadInit = std::function<void(std::size_t)>;
+
+    // n_threads == 0: one worker per hardware thread.
+    explicit TaskPool(std::size_t n_threads = 0, ThreadInit init = {})
+    {
+        if (n_threads == 0)
+            n_threads = std::max(1u, std::thread::hardware_concurrency());
+        m_queues.reserve(n_threads);
+        for (std::size_t i = 0; i < n_threads; ++i)
+            m_queues.push_back(std::make_unique<Queue>());
+        m_threads.reserve(n_threads);
+        for (std::size_t i = 0; i < n_threads; ++i)
+            m_threads.emplace_back([this, i, init] {
+                if (init)
+                    init(i);
+                worker_loop(i);
+            });
+    }
+
+    ~TaskPool()
+    {
+        {
+            std::lock_guard lock { m_sleep_mutex };
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& t : m_threads)
+            t.join();
+    }
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    std::size_t thread_count() const noexcept { return m_threads.size(); }
+
+private:
+    friend class TaskGroup;
+
+    using GroupPtr = std::shared_ptr<detail::TaskGroupState>;
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<GroupPtr> tickets;
+    };
+
+    // Worker index of the calling thread in this pool, or thread_count().
+    std::size_t current_worker() const noexcept
+    {
+        return (tl_pool == this) ? tl_index : m_queues.size();
+    }
+
+    // Announce n new tasks of group. A worker queues the tickets on its own
+    // deque (idle workers steal them); other threads spread them round-robin.
+    void post(const GroupPtr& group, std::size_t n)
+    {
+        n = std::min(n, m_queues.size());
+        if (n == 0)
+            return;
+        m_queued.fetch_add(static_cast<std::ptrdiff_t>(n));
+        const auto self = current_worker();
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            const auto q = (self < m_queues.size())
+                ? self
+                : m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+            std::lock_guard lock { m_queues[q]->mutex };
+            m_queues[q]->tickets.push_back(group);
+        }
+        {
+            std::lock_guard lock { m_sleep_mutex };
+        }
+        if (n == 1)
+            m_wake.notify_one();
+        else
+            m_wake.notify_all();
+    }
+
+    bool try_take(std::size_t index, GroupPtr& out)
+    {
+        const auto n = m_queues.size();
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            auto& q = *m_queues[(index + k) % n];
+            std::lock_guard lock { q.mutex };
+            if (q.tickets.empty())
+                continue;
+            if (k == 0)
+            {
+                out = std::move(q.tickets.back());
+                q.tickets.pop_back();
+            }
+            else
+            {
+                out = std::move(q.tickets.front());
+                q.tickets.pop_front();
+            }
+            m_queued.fetch_sub(1);
+            return true;
+        }
+        return false;
+    }
+
+    void worker_loop(std::size_t index)
+    {
+        tl_pool = this;
+        tl_index = index;
+        for (;;)
+        {
+            GroupPtr group;
+            if (try_take(index, group))
+            {
+                while (group->try_run_one())
+                {
+                }
+                continue;
+            }
+            std::unique_lock lock { m_sleep_mutex };
+            m_wake.wait(lock, [this] { return m_stop || m_queued.load() > 0; });
+            if (m_stop && m_queued.load() <= 0)
+                return;
+        }
+    }
+
+    static inline thread_local const TaskPool* tl_pool = nullptr;
+    static inline thread_local std::size_t tl_index = 0;
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<std::ptrdiff_t> m_queued { 0 }; // tickets in all deques
+    std::atomic<std::size_t> m_next { 0 };
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake;
+    bool m_stop = false;
+};
+
+// A set of tasks submitted by one caller, with its own completion tracking.
+// wait() runs the group's not-yet-started tasks on the calling thread while
+// the pool works on the others ("help while waiting"), then blocks only until
+// the group's own tasks are done. Waiting from inside a pool task is safe:
+// nested groups make progress on the waiting thread itself, and a waiter
+// never picks up another group's tasks.
+class TaskGroup
+{
+public:
+    explicit TaskGroup(TaskPool& pool)
+            : m_pool(pool), m_state(std::make_shared<detail::TaskGroupState>())
+    {
+    }
+
+    // Waits for the remaining tasks; their exceptions are dropped.
+    ~TaskGroup()
+    {
+        try
+        {
+            wait();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    template <typename F>
+    void run(F&& f)
+    {
+        run_copies(1, std::forward<F>(f));
+    }
+
+    // Submit n tasks that all run f. Used for self-scheduling loops where
+    // every copy claims work from a shared counter.
+    template <typename F>
+    void run_copies(std::size_t n, F&& f)
+    {
+        if (n == 0)
+            return;
+        {
+            std::lock_guard lock { m_state->mutex };
+            for (std::size_t i = 0; i < n; ++i)
+                m_state->pending.emplace_back(f);
+            m_state->unfinished += n;
+        }
+        m_pool.post(m_state, n);
+    }
+
+    // Help with this group's pending tasks, wait for the ones other threads
+    // started, then rethrow the first exception a task threw, if any.
+    void wait()
+    {
+        while (m_state->try_run_one())
+        {
+        }
+        std::unique_lock lock { m_state->mutex };
+        m_state->done.wait(lock, [this] { return m_state->unfinished == 0; });
+        if (auto error = std::exchange(m_state->error, nullptr))
+            std::rethrow_exception(error);
+    }
+
+private:
+    TaskPool& m_pool;
+    std::shared_ptr<detail::TaskGroupState> m_state;
+};
+
+} // namespace sqp::dsp
@@ -21,8 +21,10 @@
 ----------------------------------------------------------------------------*/
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <limits>
 #include <numbers>
 #include <vector>
 
@@ -94,6 +96,186 @@ auto make_window(std::size_t size, WindowType type) -> std::vector<T>
     return w;
 }
 
+namespace detail
+{
+    // Number of eigenvalues of the symmetric tridiagonal matrix (diag d, off-diagonal e)
+    // strictly below lambda (Sturm sequence count).
+    inline std::size_t tridiagonal_count_below(
+        const std::vector<double>& d, const std::vector<double>& e, double lambda)
+    {
+        const double tiny = std::numeric_limits<double>::min();
+        std::size_t count = 0;
+        double q = d[0] - lambda;
+        for (std::size_t i = 0;; ++i)
+        {
+            if (q < 0.0)
+                ++count;
+            if (i + 1 == d.size())
+                break;
+            if (std::abs(q) < tiny)
+                q = -tiny;
+            q = d[i + 1] - lambda - e[i] * e[i] / q;
+        }
+        return count;
+    }
+
+    // Eigenvector of the eigenvalue lambda by inverse iteration, using a
+    // tridiagonal LU with partial pivoting (LAPACK dgttrf/dgtts2).
+    inline std::vector<double> tridiagonal_eigenvector(
+        const std::vector<double>& d, const std::vector<double>& e, double lambda, double norm)
+    {
+        const std::size_t n = d.size();
+        std::vector<double> diag(n), lower(e), upper(e), upper2(n, 0.0);
+        std::vector<char> swapped(n, 0);
+        for (std::size_t i = 0; i < n; ++i)
+            diag[i] = d[i] - lambda;
+
+        for (std::size_t i = 0; i + 1 < n; ++i)
+        {
+            if (std::abs(diag[i]) >= std::abs(lower[i]))
+            {
+                if (diag[i] != 0.0)
+                {
+                    lower[i] /= diag[i];
+                    diag[i + 1] -= lower[i] * upper[i];
+                }
+            }
+            else
+            {
+                const double fact = diag[i] / lower[i];
+                diag[i] = lower[i];
+                lower[i] = fact;
+                const double temp = upper[i];
+                upper[i] = diag[i + 1];
+                diag[i + 1] = temp - fact * diag[i + 1];
+                if (i + 2 < n)
+                {
+                    upper2[i] = upper[i + 1];
+                    upper[i + 1] = -fact * upper[i + 1];
+                }
+                swapped[i] = 1;
+            }
+        }
+        // lambda is an eigenvalue: exact zero pivots are nudged, as in LAPACK dstein.
+        const double eps = std::numeric_limits<double>::epsilon() * std::max(norm, 1.0);
+        for (auto& v : diag)
+            if (std::abs(v) < eps)
+                v = std::copysign(eps, v);
+
+        // Deterministic start vector with components along every eigenvector,
+        // odd ones included.
+        std::vector<double> v(n);
+        for (std::size_t i = 0; i < n; ++i)
+            v[i] = 0.5 + std::fmod(0.6180339887498949 * static_cast<double>(i + 1), 1.0);
+
+        for (int iter = 0; iter < 3; ++iter)
+        {
+            for (std::size_t i = 0; i + 1 < n; ++i)
+            {
+                if (!swapped[i])
+                    v[i + 1] -= lower[i] * v[i];
+                else
+                {
+                    const double temp = v[i];
+                    v[i] = v[i + 1];
+                    v[i + 1] = temp - lower[i] * v[i];
+                }
+            }
+            v[n - 1] /= diag[n - 1];
+            if (n > 1)
+                v[n - 2] = (v[n - 2] - upper[n - 2] * v[n - 1]) / diag[n - 2];
+            for (std::size_t i = n - 2; i-- > 0;)
+                v[i] = (v[i] - upper[i] * v[i + 1] - upper2[i] * v[i + 2]) / diag[i];
+
+            double sum_sq = 0.0;
+            for (const double x : v)
+                sum_sq += x * x;
+            const double inv = 1.0 / std::sqrt(sum_sq);
+            for (auto& x : v)
+                x *= inv;
+        }
+        return v;
+    }
+} // namespace detail
+
+// Discrete prolate spheroidal (Slepian) sequences for multitaper estimation:
+// the n_tapers most concentrated tapers of length size for the time-half-bandwidth
+// product nw, each with unit energy. Row-major [n_tapers × size]; same sign
+// convention as scipy.signal.windows.dpss (even tapers sum positive, odd ones
+// start positive).
+inline auto make_dpss(std::size_t size, double nw, std::size_t n_tapers) -> std::vector<double>
+{
+    std::vector<double> tapers(size * n_tapers);
+    if (size == 0 || n_tapers == 0)
+        return tapers;
+    if (size == 1)
+    {
+        std::fill(tapers.begin(), tapers.end(), 1.0);
+        return tapers;
+    }
+
+    // Tridiagonal matrix commuting with the concentration problem (Slepian 1978);
+    // its largest eigenvalues give the best concentrated sequences.
+    const double n = static_cast<double>(size);
+    const double cos_w = std::cos(2.0 * std::numbers::pi * nw / n);
+    std::vector<double> d(size), e(size - 1);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const double c = (n - 1.0 - 2.0 * static_cast<double>(i)) / 2.0;
+        d[i] = c * c * cos_w;
+    }
+    for (std::size_t i = 0; i + 1 < size; ++i)
+        e[i] = static_cast<double>(i + 1) * (n - 1.0 - static_cast<double>(i)) / 2.0;
+
+    double lo = d[0], hi = d[0];
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const double radius
+            = (i > 0 ? std::abs(e[i - 1]) : 0.0) + (i + 1 < size ? std::abs(e[i]) : 0.0);
+        lo = std::min(lo, d[i] - radius);
+        hi = std::max(hi, d[i] + radius);
+    }
+    const double norm = std::max(std::abs(lo), std::abs(hi));
+
+    for (std::size_t k = 0; k < std::min(n_tapers, size); ++k)
+    {
+        // Bisection for the (k+1)-th largest eigenvalue.
+        const std::size_t rank = size - 1 - k;
+        double a = lo, b = hi;
+        const double tol = 4.0 * std::numeric_limits<double>::epsilon() * norm;
+        for (int iter = 0; iter < 200 && b - a > tol; ++iter)
+        {
+            const double mid = 0.5 * (a + b);
+            if (detail::tridiagonal_count_below(d, e, mid) > rank)
+                b = mid;
+            else
+                a = mid;
+        }
+        auto v = detail::tridiagonal_eigenvector(d, e, 0.5 * (a + b), norm);
+
+        if (k % 2 == 0)
+        {
+            double sum = 0.0;
+            for (const double x : v)
+                sum += x;
+            if (sum < 0.0)
+                for (auto& x : v)
+                    x = -x;
+        }
+        else
+        {
+            const double thresh = std::max(1e-7, 1.0 / n);
+            const auto first = std::find_if(
+                v.begin(), v.end(), [thresh](double x) { return x * x > thresh; });
+            if (first != v.end() && *first < 0.0)
+                for (auto& x : v)
+                    x = -x;
+        }
+        std::copy(v.begin(), v.end(), tapers.begin() + static_cast<std::ptrdiff_t>(k * size));
+    }
+    return tapers;
+}
+
 // Apply a pre-computed window to data in-place.
 // data and window must have the same size.
 // Uses SIMD elementwise_mul when available, otherwise scalar.
@@ -0,0 +1,86 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include <chrono>
+
+// Picks how long a provider waits before serving a range request.
+//
+// Panning sends a request per mouse move; serving each one wastes calls on
+// ranges nobody will look at, waiting for the user to stop leaves the plot
+// stale for as long as they scrub. The delay follows two measurements, both
+// exponential moving averages: how long the provider takes to answer and how
+// often requests come in.
+// - A request coming after a pause is probably the last of its gesture and
+//   is served almost at once.
+// - While requests come faster than that, each one restarts a quiet period
+//   of half the answer time, so a fast provider keeps up and a slow one
+//   isn't flooded.
+// - However fast they come, a request is served at most twice the answer
+//   time after the first one still waiting, so the plot keeps refreshing
+//   during a long scrub.
+// Until the first answer is timed, and with adaptation off, the delay is the
+// former fixed 20 ms.
+//
+// Not thread-safe: the provider calls it under its own mutex.
+class AdaptiveRateLimiter
+{
+public:
+    using clock = std::chrono::steady_clock;
+    using milliseconds = std::chrono::duration<double, std::milli>;
+
+    static constexpr double fixed_delay_ms = 20.;
+    static constexpr double min_delay_ms = 5.;
+    static constexpr double max_quiet_ms = 100.;
+    static constexpr double min_max_wait_ms = 20.;
+    static constexpr double max_max_wait_ms = 500.;
+    // A longer gap between requests ends the gesture.
+    static constexpr double gesture_gap_ms = 1000.;
+
+    // A range request arrived: the delay before serving it.
+    milliseconds on_request(clock::time_point now) noexcept;
+
+    // The waiting requests were taken by the worker.
+    inline void on_served() noexcept { m_waiting = false; }
+
+    // How long an answer took (cancelled requests are not timed).
+    void on_answer(milliseconds latency) noexcept;
+
+    inline void set_adaptive(bool adaptive) noexcept { m_adaptive = adaptive; }
+    inline bool adaptive() const noexcept { return m_adaptive; }
+
+    // Moving averages; negative while nothing has been measured.
+    inline double latency_ms() const noexcept { return m_latency_ms; }
+    inline double interval_ms() const noexcept { return m_interval_ms; }
+
+    // Longest a request waits during a scrub, so also how long a running call
+    // is given before a newer request supersedes it.
+    milliseconds max_wait() const noexcept;
+
+private:
+    bool m_adaptive = true;
+    bool m_waiting = false;
+    bool m_has_last_request = false;
+    double m_latency_ms = -1.;
+    double m_interval_ms = -1.;
+    clock::time_point m_last_request;
+    clock::time_point m_first_waiting;
+};
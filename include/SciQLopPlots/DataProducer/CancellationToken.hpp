@@ -0,0 +1,85 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+// Shared flag telling a running data request that its answer is no longer
+// wanted. Copies share the flag; cancel() may be called from any thread and
+// the one serving the request polls is_cancelled() at its own pace. A
+// default-constructed token is never cancelled. cancel_at() cancels once a
+// deadline passes, so the thread asking for it doesn't have to be around.
+class CancellationToken
+{
+    using clock = std::chrono::steady_clock;
+
+    struct State
+    {
+        std::atomic<bool> cancelled { false };
+        std::atomic<std::int64_t> deadline { std::numeric_limits<std::int64_t>::max() };
+    };
+
+    std::shared_ptr<State> m_state;
+
+public:
+    CancellationToken() = default;
+
+    static inline CancellationToken make()
+    {
+        CancellationToken token;
+        token.m_state = std::make_shared<State>();
+        return token;
+    }
+
+    inline void cancel() const noexcept
+    {
+        if (m_state)
+            m_state->cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    // Cancels at `when` (at once if it is past); an earlier deadline wins.
+    inline void cancel_at(clock::time_point when) const noexcept
+    {
+        if (!m_state)
+            return;
+        const auto t = when.time_since_epoch().count();
+        auto current = m_state->deadline.load(std::memory_order_relaxed);
+        while (t < current
+               && !m_state->deadline.compare_exchange_weak(current, t, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    inline bool is_cancelled() const noexcept
+    {
+        if (!m_state)
+            return false;
+        if (m_state->cancelled.load(std::memory_order_relaxed))
+            return true;
+        const auto deadline = m_state->deadline.load(std::memory_order_relaxed);
+        return deadline != std::numeric_limits<std::int64_t>::max()
+            && clock::now().time_since_epoch().count() >= deadline;
+    }
+};
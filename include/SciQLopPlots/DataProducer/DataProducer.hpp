@@ -20,6 +20,9 @@
 -- Mail : alexis.jeandet@member.fsf.org
 ----------------------------------------------------------------------------*/
 #pragma once
+#include "SciQLopPlots/DataProducer/AdaptiveRateLimiter.hpp"
+#include "SciQLopPlots/DataProducer/CancellationToken.hpp"
+#include "SciQLopPlots/DataProducer/RangeTileCache.hpp"
 #include "SciQLopPlots/Python/PythonInterface.hpp"
 #include "SciQLopPlots/SciQLopPlotRange.hpp"
 
@@ -30,6 +33,10 @@
 #include <QThread>
 #include <QTimer>
 #include <memory>
+#include <optional>
+#include <utility>
+
+class SharedMemoryRingReader;
 
 struct _2D_data
 {
@@ -55,37 +62,61 @@ class DataProviderInterface : public QObject
     // used to let the second caller clobber the first and suppress its wake-up.
     SciQLopPlotRange m_next_range;
     std::variant<std::monostate, _2D_data, _3D_data, _NDdata> m_next_data;
+    int m_next_data_level = 0;
     SciQLopPlotRange m_current_range;
     QTimer* m_rate_limit_timer;
     QMutex m_mutex;
     bool m_range_pending = false;
     bool m_data_pending = false;
     bool m_force_next_update = false;
+    // Requested under m_mutex from any thread, applied to m_tile_cache by the
+    // worker on its next range update (the cache itself is worker-only).
+    std::size_t m_cache_budget = 0;
+    bool m_prefetch_enabled = false;
+    RangeTileCache m_tile_cache;
+    // Worker-only: neighbouring ranges still to fetch ahead of the user, and
+    // a generation bumped by every range update so stale steps do nothing.
+    std::vector<RangeTileCache::Interval> m_prefetch_queue;
+    std::uint64_t m_prefetch_generation = 0;
+    // Under m_mutex: when to serve range requests, and the token of the range
+    // get_data() call running on the worker (no range for a prefetch call)
+    // with when it started, cancelled once a request makes its answer useless.
+    AdaptiveRateLimiter m_rate_limiter;
+    CancellationToken m_request_token;
+    std::optional<SciQLopPlotRange> m_request_range;
+    AdaptiveRateLimiter::clock::time_point m_request_started;
+    // Worker-only, for progressive answers (0 is full resolution, larger is
+    // coarser): the finest level notified since the last range request, the
+    // level of the data being served, and whether the running get_data() may
+    // publish previews (not when it only fetches a gap or a prefetch).
+    int m_shown_level = 0;
+    int m_serving_level = 0;
+    bool m_previews_allowed = false;
 
 #ifndef BINDINGS_H
     Q_SIGNAL void _state_changed();
 #endif
     Q_SLOT void _threaded_update();
 
-    void _notify_new_data(const QList<SciQLopPyBuffer>& data);
+    void _notify_new_data(const QList<SciQLopPyBuffer>& data, int level = 0);
 
     void _range_based_update(const SciQLopPlotRange& new_range);
-    void _data_based_update(const _2D_data& new_data);
-    void _data_based_update(const _3D_data& new_data);
-    void _data_based_update(const _NDdata& new_data);
+    QList<SciQLopPyBuffer> _cached_get_data(double lower, double upper,
+                                            const CancellationToken& token);
+    void _schedule_prefetch(const SciQLopPlotRange& range);
+    void _prefetch_step(std::uint64_t generation);
+    void _trace_cache_counters() const;
+    void _data_based_update(const _2D_data& new_data, int level);
+    void _data_based_update(const _3D_data& new_data, int level);
+    void _data_based_update(const _NDdata& new_data, int level);
 
 
-    inline Q_SLOT void _start_timer()
-    {
-        if (!m_rate_limit_timer->isActive())
-        {
-            m_rate_limit_timer->start(100);
-        }
-    }
+    CancellationToken _begin_request(std::optional<SciQLopPlotRange> range);
+    void _end_request();
 
 public:
     DataProviderInterface(QObject* parent = nullptr);
-    virtual ~DataProviderInterface() = default;
+    virtual ~DataProviderInterface();
 
     virtual QList<SciQLopPyBuffer> get_data(double lower, double upper);
     virtual QList<SciQLopPyBuffer> get_data(SciQLopPyBuffer x, SciQLopPyBuffer y);
@@ -94,6 +125,26 @@ public:
 
     void invalidate_cache();
 
+    // Byte budget of the range tile cache; 0 (the default) disables it. With
+    // a budget, range updates only call get_data() for the parts of the new
+    // range not fetched yet and stitch the rest from earlier answers. Only for
+    // providers whose answer for a range doesn't depend on anything else (or
+    // that call invalidate_cache() when it does).
+    void set_cache_budget(std::size_t bytes);
+    std::size_t cache_budget();
+
+    // Speculative prefetch into the tile cache (needs a cache budget): once
+    // a range is served and nothing else is pending, the worker fetches the
+    // range one zoom level out, then the full windows left and right of it,
+    // one chunk per event-loop turn. Any new request cancels what is left.
+    void set_prefetch_enabled(bool enabled);
+    bool prefetch_enabled();
+
+    // Range requests are served after a delay adapted to how long get_data()
+    // takes and how fast requests come in (see AdaptiveRateLimiter); off, it
+    // is a fixed 20 ms debounce.
+    void set_adaptive_rate_limit(bool enabled);
+    bool adaptive_rate_limit();
 
 
 #ifdef BINDINGS_H
@@ -103,29 +154,54 @@ signals:
     Q_SIGNAL void new_data_3d(SciQLopPyBuffer x, SciQLopPyBuffer y, SciQLopPyBuffer z);
     Q_SIGNAL void new_data_2d(SciQLopPyBuffer x, SciQLopPyBuffer y);
     Q_SIGNAL void new_data_nd(QList<SciQLopPyBuffer> values);
+    // Emitted right before each new_data_*: resolution level of that data.
+    Q_SIGNAL void new_data_level(int level);
     Q_SIGNAL void pipeline_idle();
 
 protected:
+    // Token of the range request being served, for get_data() overrides to
+    // poll while they work (and hand to whoever computes the answer). Only
+    // meaningful on the worker thread, inside get_data(lower, upper).
+    CancellationToken cancellation_token();
+
+    // A request for `new_range` (nullopt: a data request) arrived. The base
+    // cancels a running prefetch call at once. A running range call is kept
+    // while `new_range` overlaps it (a scrub still gets frames); otherwise it
+    // is cancelled once it is older than the rate limiter's max wait.
+    virtual void cancel_stale_requests(const std::optional<SciQLopPlotRange>& new_range);
+
+    // Notifies a coarse answer for the range being served, from inside
+    // get_data(lower, upper), ahead of the full-resolution one it returns.
+    // Dropped once the request is cancelled, when a level at least as fine
+    // was already notified for this range, and for calls that only fetch
+    // part of the range.
+    void publish_preview(int level, const QList<SciQLopPyBuffer>& data);
+
+    // Level of the data get_data(buffers...) is being called for: 0 for a
+    // full-resolution answer, larger for a preview. Worker thread only.
+    inline int serving_level() const noexcept { return m_serving_level; }
+
     void set_range(SciQLopPlotRange new_range) noexcept;
-    void set_data(_2D_data new_data) noexcept;
-    void set_data(_3D_data new_data) noexcept;
-    void set_data(_NDdata new_data) noexcept;
+    // `level` > 0 pushes a preview: it never replaces a finer answer still
+    // waiting to be served.
+    void set_data(_2D_data new_data, int level = 0) noexcept;
+    void set_data(_3D_data new_data, int level = 0) noexcept;
+    void set_data(_NDdata new_data, int level = 0) noexcept;
     friend class DataProviderWorker;
 };
 
+// Hands a provider to a DataProviderWorkerPool thread and back. The thread is
+// shared with other providers; destroying the worker releases its share and
+// deletes the provider on that thread once its current call returns, without
+// waiting for it.
 class DataProviderWorker : public QObject
 {
     Q_OBJECT
-    QThread* m_worker_thread;
-    DataProviderInterface* m_data_provider;
+    QThread* m_worker_thread = nullptr;
+    DataProviderInterface* m_data_provider = nullptr;
 
 public:
-    DataProviderWorker(QObject* parent = nullptr) : QObject(parent)
-    {
-        m_worker_thread = new QThread(this);
-        m_worker_thread->setObjectName(QStringLiteral("dataProv"));
-        m_worker_thread->start();
-    }
+    DataProviderWorker(QObject* parent = nullptr) : QObject(parent) { }
 
     virtual ~DataProviderWorker();
 
@@ -150,6 +226,22 @@ public:
     {
         m_data_provider->set_data(values);
     }
+
+    inline Q_SLOT virtual void set_preview(SciQLopPyBuffer x, SciQLopPyBuffer y, int level)
+    {
+        m_data_provider->set_data(_2D_data { x, y }, level);
+    }
+
+    inline Q_SLOT virtual void set_preview(SciQLopPyBuffer x, SciQLopPyBuffer y,
+                                           SciQLopPyBuffer z, int level)
+    {
+        m_data_provider->set_data(_3D_data { x, y, z }, level);
+    }
+
+    inline Q_SLOT virtual void set_preview(QList<SciQLopPyBuffer> values, int level)
+    {
+        m_data_provider->set_data(values, level);
+    }
 };
 
 
@@ -192,7 +284,15 @@ public:
     inline virtual QList<SciQLopPyBuffer> get_data(double lower, double upper) override
     {
         auto cb = _snapshot_callable();
-        return cb ? _to_qlist(cb->get_data(lower, upper)) : QList<SciQLopPyBuffer> {};
+        if (!cb)
+            return {};
+        return _to_qlist(cb->get_data(lower, upper, cancellation_token(),
+                                      [this](int level, const std::vector<SciQLopPyBuffer>& preview)
+                                      {
+                                          publish_preview(level,
+                                                          QList<SciQLopPyBuffer>(
+                                                              std::cbegin(preview), std::cend(preview)));
+                                      }));
     }
 
     inline virtual QList<SciQLopPyBuffer> get_data(SciQLopPyBuffer x, SciQLopPyBuffer y) override
@@ -231,32 +331,73 @@ public:
 // later via set_data). Buffer get_data overrides pass their inputs straight
 // through, so the existing _data_based_update push path turns an incoming
 // set_data(x,y) into new_data_2d(x,y) with no transformation.
+//
+// A token can't follow the request into another process, so cancellation is
+// a signal: request_cancelled(range) goes out when a request for another
+// range arrives before the answer to data_requested(range). Previews
+// (set_preview) may come before that answer; they don't end the request.
 class RemoteDataProvider : public DataProviderInterface
 {
     Q_OBJECT
+    QMutex m_outstanding_mutex;
+    std::optional<SciQLopPlotRange> m_outstanding;
+
+    inline void _answered()
+    {
+        QMutexLocker lock(&m_outstanding_mutex);
+        m_outstanding.reset();
+    }
+
+protected:
+    inline virtual void
+    cancel_stale_requests(const std::optional<SciQLopPlotRange>& new_range) override
+    {
+        DataProviderInterface::cancel_stale_requests(new_range);
+        if (!new_range)
+            return;
+        std::optional<SciQLopPlotRange> stale;
+        {
+            QMutexLocker lock(&m_outstanding_mutex);
+            if (m_outstanding && !(*m_outstanding == *new_range))
+                stale = std::exchange(m_outstanding, std::nullopt);
+        }
+        if (stale)
+            Q_EMIT request_cancelled(*stale);
+    }
+
 public:
     RemoteDataProvider(QObject* parent = nullptr) : DataProviderInterface(parent) { }
     virtual ~RemoteDataProvider() = default;
 
     inline virtual QList<SciQLopPyBuffer> get_data(double lower, double upper) override
     {
+        {
+            QMutexLocker lock(&m_outstanding_mutex);
+            m_outstanding = SciQLopPlotRange(lower, upper);
+        }
         Q_EMIT data_requested(SciQLopPlotRange(lower, upper));
         return {}; // no synchronous data; response arrives via set_data
     }
 
     inline virtual QList<SciQLopPyBuffer> get_data(SciQLopPyBuffer x, SciQLopPyBuffer y) override
     {
+        if (serving_level() == 0)
+            _answered();
         return { std::move(x), std::move(y) };
     }
 
     inline virtual QList<SciQLopPyBuffer> get_data(SciQLopPyBuffer x, SciQLopPyBuffer y,
                                                    SciQLopPyBuffer z) override
     {
+        if (serving_level() == 0)
+            _answered();
         return { std::move(x), std::move(y), std::move(z) };
     }
 
     inline virtual QList<SciQLopPyBuffer> get_data(QList<SciQLopPyBuffer> values) override
     {
+        if (serving_level() == 0)
+            _answered();
         return std::move(values);
     }
 
@@ -265,6 +406,7 @@ public:
 signals:
 #endif
     Q_SIGNAL void data_requested(const SciQLopPlotRange& range);
+    Q_SIGNAL void request_cancelled(const SciQLopPlotRange& range);
 };
 
 
@@ -289,6 +431,24 @@ public:
 
     inline void invalidate_cache() { m_callable_wrapper->invalidate_cache(); }
 
+    inline void set_cache_budget(std::size_t bytes)
+    {
+        m_callable_wrapper->set_cache_budget(bytes);
+    }
+    inline std::size_t cache_budget() const { return m_callable_wrapper->cache_budget(); }
+
+    inline void set_prefetch_enabled(bool enabled)
+    {
+        m_callable_wrapper->set_prefetch_enabled(enabled);
+    }
+    inline bool prefetch_enabled() const { return m_callable_wrapper->prefetch_enabled(); }
+
+    inline void set_adaptive_rate_limit(bool enabled)
+    {
+        m_callable_wrapper->set_adaptive_rate_limit(enabled);
+    }
+    inline bool adaptive_rate_limit() const { return m_callable_wrapper->adaptive_rate_limit(); }
+
 
 #ifdef BINDINGS_H
 #define Q_SIGNAL
@@ -297,18 +457,22 @@ signals:
     Q_SIGNAL void new_data_3d(SciQLopPyBuffer x, SciQLopPyBuffer y, SciQLopPyBuffer z);
     Q_SIGNAL void new_data_2d(SciQLopPyBuffer x, SciQLopPyBuffer y);
     Q_SIGNAL void new_data_nd(QList<SciQLopPyBuffer> values);
+    Q_SIGNAL void new_data_level(int level);
     Q_SIGNAL void pipeline_idle();
 };
 
 
 // The bound "channel" object. One per remote product. data_requested goes out
 // (SciQLop forwards it to the worker process); set_data(...) brings the final
-// buffers back in.
+// buffers back in, or the worker writes frames to a SharedMemoryRingWriter
+// this channel is attached to and they are read in place, without a copy.
 class RemoteDataPipeline : public QObject
 {
     Q_OBJECT
     RemoteDataProvider* m_provider;
     DataProviderWorker* m_worker;
+    std::shared_ptr<SharedMemoryRingReader> m_ring;
+    QTimer* m_ring_poll_timer = nullptr;
 
 public:
     RemoteDataPipeline(QObject* parent = nullptr);
@@ -329,15 +493,43 @@ public:
         m_worker->set_data(std::move(values));
     }
 
+    // A coarse answer (level > 0; larger is coarser) to show while the
+    // full-resolution set_data(...) is still being computed.
+    inline Q_SLOT void set_preview(SciQLopPyBuffer x, SciQLopPyBuffer y, int level)
+    {
+        m_worker->set_preview(std::move(x), std::move(y), level);
+    }
+    inline Q_SLOT void set_preview(SciQLopPyBuffer x, SciQLopPyBuffer y, SciQLopPyBuffer z,
+                                   int level)
+    {
+        m_worker->set_preview(std::move(x), std::move(y), std::move(z), level);
+    }
+    inline Q_SLOT void set_preview(QList<SciQLopPyBuffer> values, int level)
+    {
+        m_worker->set_preview(std::move(values), level);
+    }
+
     inline void invalidate_cache() { m_provider->invalidate_cache(); }
 
+    // Reads frames from the SharedMemoryRingWriter segment `name`; each frame
+    // goes through set_data(values). With poll_interval_ms > 0 the ring is
+    // polled on a timer, else consume_shared_memory() must be called when the
+    // producer signals new frames. False when the segment can't be opened.
+    bool attach_shared_memory(const QString& name, int poll_interval_ms = 0);
+    void detach_shared_memory();
+    inline bool shared_memory_attached() const noexcept { return m_ring != nullptr; }
+    // Forwards every frame published since the last call; returns how many.
+    Q_SLOT int consume_shared_memory();
+
 #ifdef BINDINGS_H
 #define Q_SIGNAL
 signals:
 #endif
     Q_SIGNAL void data_requested(const SciQLopPlotRange& range);
+    Q_SIGNAL void request_cancelled(const SciQLopPlotRange& range);
     Q_SIGNAL void new_data_3d(SciQLopPyBuffer x, SciQLopPyBuffer y, SciQLopPyBuffer z);
     Q_SIGNAL void new_data_2d(SciQLopPyBuffer x, SciQLopPyBuffer y);
     Q_SIGNAL void new_data_nd(QList<SciQLopPyBuffer> values);
+    Q_SIGNAL void new_data_level(int level);
     Q_SIGNAL void pipeline_idle();
 };
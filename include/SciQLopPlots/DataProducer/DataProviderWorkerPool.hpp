@@ -0,0 +1,75 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include <QMutex>
+#include <QThread>
+#include <vector>
+
+// Process-wide pool of the threads data providers live on. A provider is
+// pinned to one thread for its whole life, so its requests are still served
+// in order; providers beyond the pool size share the least loaded thread
+// instead of each starting their own. The pool also counts the requests
+// queued on each thread, so a prefetch call can step aside for a provider
+// that shares its thread and has real work waiting.
+class DataProviderWorkerPool
+{
+    struct Slot
+    {
+        QThread* thread;
+        int providers;
+        int queued_requests = 0;
+    };
+
+    std::vector<Slot> m_slots;
+    int m_max_threads;
+    bool m_stopped = false;
+    mutable QMutex m_mutex;
+
+    DataProviderWorkerPool();
+    ~DataProviderWorkerPool();
+
+    void _stop();
+
+public:
+    DataProviderWorkerPool(const DataProviderWorkerPool&) = delete;
+    DataProviderWorkerPool& operator=(const DataProviderWorkerPool&) = delete;
+
+    static DataProviderWorkerPool& instance();
+
+    // Thread for a new provider: a fresh one while below max_threads(),
+    // else the one serving the fewest providers. nullptr once the
+    // application is quitting.
+    QThread* acquire();
+    void release(QThread* thread);
+
+    // A provider on `thread` got a request to serve / its worker took it up.
+    // Unknown threads (a provider left on the caller's thread) are ignored.
+    void request_queued(QThread* thread);
+    void request_taken(QThread* thread, int count = 1);
+    int queued_requests(QThread* thread) const;
+
+    // Bound on the number of threads; lowering it doesn't move providers
+    // already placed, it only stops new threads from being started.
+    void set_max_threads(int n);
+    int max_threads() const;
+    int thread_count() const;
+};
@@ -0,0 +1,115 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "SciQLopPlots/Python/PythonInterface.hpp"
+
+#include <QList>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Time-indexed tiles of what a range provider returned, so that a pan only
+// fetches the part of the new range that was not seen yet.
+//
+// A tile is the answer to get_data(start, stop). buffers[0] holds sorted
+// float64 keys; every other buffer whose first dimension matches the keys is
+// cut by row, the rest (e.g. a colormap's 1-D value axis) must be identical in
+// all the tiles stitched together. Tiles never overlap; once their total size
+// exceeds the budget the least recently used ones are dropped.
+//
+// Not thread-safe: owned and used by the provider's worker thread only.
+class RangeTileCache
+{
+public:
+    using Interval = std::pair<double, double>;
+
+    // Speculative fetches: how many tiles were stored ahead of a request, how
+    // many of them a later request used, and the bytes dropped unused.
+    struct PrefetchStats
+    {
+        std::uint64_t tiles = 0;
+        std::uint64_t hits = 0;
+        std::size_t bytes = 0;
+        std::size_t wasted_bytes = 0;
+    };
+
+    // 0 disables the cache and drops every tile.
+    void set_budget(std::size_t bytes);
+    inline std::size_t budget() const noexcept { return m_budget; }
+    inline bool enabled() const noexcept { return m_budget != 0 && !m_unsupported; }
+
+    // Drops every tile and forgets a previous mark_unsupported().
+    void clear();
+
+    // The provider's answers can't be tiled: stay disabled until clear().
+    void mark_unsupported();
+
+    inline std::size_t size_bytes() const noexcept { return m_bytes; }
+    inline std::size_t tile_count() const noexcept { return m_tiles.size(); }
+
+    // Sub-intervals of [lower, upper] that no tile covers, in order.
+    std::vector<Interval> missing(double lower, double upper) const;
+
+    // Stores the answer to get_data(start, stop). An empty answer is a valid
+    // (empty) tile; false when the answer can't be tiled. `prefetched` marks a
+    // tile fetched ahead of any request, for prefetch_stats().
+    bool insert(double start, double stop, QList<SciQLopPyBuffer> buffers,
+                bool prefetched = false);
+
+    // The rows of [lower, upper], plus the nearest row on each side so lines
+    // still reach the plot edges. A single tile answers with views on its
+    // buffers; several are copied once into fresh arrays. nullopt when the
+    // range is not fully covered or the tiles can't be stitched.
+    std::optional<QList<SciQLopPyBuffer>> assemble(double lower, double upper);
+
+    // Drops least recently used tiles until the total fits the budget;
+    // prefetched tiles no request used yet go first.
+    void evict();
+
+    inline const PrefetchStats& prefetch_stats() const noexcept { return m_prefetch_stats; }
+
+private:
+    struct Tile
+    {
+        double stop;
+        QList<SciQLopPyBuffer> buffers;
+        std::size_t bytes;
+        std::uint64_t last_use;
+        bool prefetched = false;
+        bool used = false;
+    };
+
+    void _drop(std::map<double, Tile>::iterator it);
+    void _drop_all();
+
+    // Tiles intersecting [lower, upper], in key order.
+    std::vector<std::map<double, Tile>::iterator> _overlapping(double lower, double upper);
+
+    std::map<double, Tile> m_tiles; // keyed by start
+    std::size_t m_budget = 0;
+    std::size_t m_bytes = 0;
+    std::uint64_t m_clock = 0;
+    bool m_unsupported = false;
+    PrefetchStats m_prefetch_stats;
+};
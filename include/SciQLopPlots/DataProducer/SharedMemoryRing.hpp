@@ -0,0 +1,100 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "SciQLopPlots/Python/PythonInterface.hpp"
+
+#include <QList>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+// Fixed-size slots in a POSIX shared-memory segment, written by a producer
+// process and read in place by the plotting process: a frame is copied once,
+// into its slot, and the reader hands SciQLopPyBuffers over the slot memory
+// (SciQLopPyBuffer::from_memory) to the data pipeline. A slot goes back to the
+// writer when the last of those buffers is released, so segments are reused
+// instead of allocated per update.
+//
+// Slot handoff is a per-slot state word updated with atomic compare-exchange
+// (free -> writing -> ready -> reading -> free). When every slot is taken the
+// writer reuses the oldest frame not yet read, never one being read.
+namespace shm_ring
+{
+inline constexpr std::size_t max_arrays = 8;
+inline constexpr std::size_t max_dims = 2;
+struct Mapping;
+struct SlotHeader;
+}
+
+class SharedMemoryRingWriter
+{
+    std::shared_ptr<shm_ring::Mapping> m_mapping;
+    std::size_t m_cursor = 0;
+
+    shm_ring::SlotHeader* _claim_slot();
+
+public:
+    // Creates (replacing any stale segment with that name) and owns the
+    // segment; it is unlinked on destruction. Check is_open() on failure.
+    SharedMemoryRingWriter(const std::string& name, std::size_t slot_count,
+                           std::size_t slot_bytes);
+    ~SharedMemoryRingWriter();
+
+    SharedMemoryRingWriter(const SharedMemoryRingWriter&) = delete;
+    SharedMemoryRingWriter& operator=(const SharedMemoryRingWriter&) = delete;
+
+    bool is_open() const noexcept;
+    std::string name() const;
+    std::size_t slot_count() const noexcept;
+    std::size_t slot_bytes() const noexcept;
+
+    // Copies one frame (up to shm_ring::max_arrays C-contiguous arrays of at
+    // most shm_ring::max_dims dimensions) into a slot and publishes it.
+    // False when the frame doesn't fit a slot or every slot is being read.
+    bool write(const QList<SciQLopPyBuffer>& arrays);
+
+    std::uint64_t frames_written() const noexcept;
+    // Frames overwritten before the reader took them.
+    std::uint64_t frames_dropped() const noexcept;
+};
+
+class SharedMemoryRingReader
+{
+    std::shared_ptr<shm_ring::Mapping> m_mapping;
+
+public:
+    // Opens a segment made by a SharedMemoryRingWriter; check is_open().
+    explicit SharedMemoryRingReader(const std::string& name);
+    ~SharedMemoryRingReader();
+
+    SharedMemoryRingReader(const SharedMemoryRingReader&) = delete;
+    SharedMemoryRingReader& operator=(const SharedMemoryRingReader&) = delete;
+
+    bool is_open() const noexcept;
+
+    // Oldest published frame not yet taken, as buffers over the slot; the
+    // slot is reused once all of them (and their copies) are gone. The
+    // segment stays mapped while any of them is alive, even past the reader.
+    std::optional<QList<SciQLopPyBuffer>> take_next();
+};
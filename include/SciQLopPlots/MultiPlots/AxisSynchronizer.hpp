@@ -22,6 +22,8 @@
 #pragma once
 
 #include "SciQLopPlotCollection.hpp"
+#include <QElapsedTimer>
+#include <QTimer>
 
 class SciQLopPlotPanelInterface;
 
@@ -34,12 +36,21 @@ protected:
     AxisType m_sync_axis = AxisType::XAxis;
     bool m_propagating = false;
 
+    // Ranges coming from the synchronized axes (user pan/zoom, provider driven
+    // rescales) are coalesced: the latest one wins and is propagated to every
+    // plot at most once per frame, so N plots see one set_range (hence one
+    // queued replot and one range notification to their data providers) per
+    // frame instead of one per input event.
+    SciQLopPlotRange _pending_range;
+    QTimer* m_frame_timer = nullptr;
+    QElapsedTimer m_last_frame;
+    static constexpr int frame_interval_ms = 16;
+
+    void _propagate(const SciQLopPlotRange& range);
+    Q_SLOT void _schedule_range(const SciQLopPlotRange& range);
 
 public:
-    AxisSynchronizer(AxisType axis, QObject* parent = nullptr)
-            : SciQLopPlotCollectionBehavior(parent), m_sync_axis { axis }
-    {
-    }
+    AxisSynchronizer(AxisType axis, QObject* parent = nullptr);
 
     Q_SLOT virtual void updatePlotList(const QList<QPointer<SciQLopPlotInterface>>& plots) override;
     Q_SLOT virtual void plotAdded(SciQLopPlotInterface* plot) override;
@@ -48,7 +59,12 @@ public:
     Q_SLOT virtual void plotRemoved(SciQLopPlotInterface* plot) override { Q_UNUSED(plot); }
     Q_SLOT virtual void panelAdded(SciQLopPlotPanelInterface* panel) override;
     Q_SLOT virtual void panelRemoved(SciQLopPlotPanelInterface* panel) override;
+    // Programmatic entry point: applies immediately and supersedes any pending
+    // coalesced range.
     Q_SLOT virtual void set_axis_range(const SciQLopPlotRange& range);
+    // Propagates the pending coalesced range now, if any.
+    Q_SLOT void flush();
+    inline bool has_pending_range() const noexcept { return _pending_range.is_valid(); }
 
 #ifdef BINDINGS_H
 #define Q_SIGNAL
@@ -0,0 +1,79 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2026, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+
+#include "SciQLopPlotCollection.hpp"
+#include <QTimer>
+#include <algorithm>
+
+namespace _impl
+{
+class SciQLopPlot;
+}
+
+/*!
+ * \brief Renders the plots of a panel from one place, once per event-loop pass.
+ *
+ * Queued replots of the panel's plots (axis changes, data updates, synced
+ * siblings) only mark the plot dirty. On the next pass the scheduler renders
+ * the dirty plots that are actually on screen, hovered plot first, then top
+ * to bottom, until the frame budget is spent; the rest continue on the
+ * following pass. Plots scrolled out of the panel's viewport stay dirty and
+ * are rendered when they scroll back into view. Plots of a panel whose
+ * window is not shown are never culled, so off-screen exports keep working.
+ */
+class RenderScheduler : public SciQLopPlotCollectionBehavior
+{
+    Q_OBJECT
+    QTimer* m_frame_timer = nullptr;
+    int m_frame_budget_ms = 8;
+
+    Q_SLOT void _render_frame();
+    void _render(bool within_budget);
+    static bool is_on_screen(const QWidget* plot);
+    // Hands the plot back to immediate rendering, replotting it if it was dirty.
+    void _release(SciQLopPlotInterface* plot);
+
+public:
+    RenderScheduler(QObject* parent = nullptr);
+    ~RenderScheduler() override;
+
+    Q_SLOT void updatePlotList(const QList<QPointer<SciQLopPlotInterface>>& plots) override;
+    Q_SLOT void plotAdded(SciQLopPlotInterface* plot) override { Q_UNUSED(plot); }
+    Q_SLOT void plotRemoved(SciQLopPlotInterface* plot) override { Q_UNUSED(plot); }
+
+    // Marks every plot dirty; immediate renders the visible ones before returning.
+    void replot(bool immediate = false);
+
+    inline void set_frame_budget(int milliseconds) noexcept
+    {
+        m_frame_budget_ms = std::max(1, milliseconds);
+    }
+
+    inline int frame_budget() const noexcept { return m_frame_budget_ms; }
+
+    // Number of plots waiting to be rendered (dirty, including culled ones).
+    std::size_t pending_count() const;
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+};
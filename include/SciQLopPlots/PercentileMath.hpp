@@ -20,35 +20,103 @@
 -- Mail : alexis.jeandet@member.fsf.org
 ----------------------------------------------------------------------------*/
 #pragma once
+#include "SciQLopPlots/DSP/Select.hpp"
 #include "SciQLopPlots/SciQLopPlotRange.hpp"
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <span>
 #include <vector>
 
 namespace sciqlop::percentile
 {
-// [low, high] percentile cutoffs (nearest-rank) of `values`. The vector is
-// partially reordered by std::nth_element. Empty input yields a NaN range.
-// Shared by color-scale and value-axis robust-autoscale paths.
-inline SciQLopPlotRange percentile_range(std::vector<double>& values, double low,
+// One value standing for `weight` values of the same rank neighbourhood, as
+// handed out by QuantileSketch.
+struct WeightedValue
+{
+    double value;
+    double weight;
+};
+
+// 0-based nearest rank of percentile p among n values.
+inline std::size_t nearest_rank(std::size_t n, double p) noexcept
+{
+    const double clamped = std::clamp(p, 0., 100.);
+    const long idx = std::lround(clamped / 100. * static_cast<double>(n - 1));
+    return static_cast<std::size_t>(std::clamp<long>(idx, 0, static_cast<long>(n - 1)));
+}
+
+// [low, high] percentile cutoffs (nearest-rank) of finite `values`, in their
+// own dtype and left untouched: a parallel radix selection rather than two
+// nth_element passes over a copy. Empty input yields a NaN range. Shared by
+// color-scale and value-axis robust-autoscale paths.
+template <typename T>
+inline SciQLopPlotRange percentile_range(std::span<const T> values, double low,
                                          double high) noexcept
 {
     if (values.empty())
         return SciQLopPlotRange();
+    try
+    {
+        const auto [lo_val, hi_val] = sqp::dsp::select_ranks(
+            values, nearest_rank(values.size(), low), nearest_rank(values.size(), high));
+        const double lo = static_cast<double>(lo_val);
+        const double hi = static_cast<double>(hi_val);
+        return SciQLopPlotRange(std::min(lo, hi), std::max(lo, hi));
+    }
+    catch (const std::exception&)
+    {
+        return SciQLopPlotRange();
+    }
+}
+
+inline SciQLopPlotRange percentile_range(std::vector<double>& values, double low,
+                                         double high) noexcept
+{
+    return percentile_range(std::span<const double>(values), low, high);
+}
+
+// Same cutoffs over exact values plus sketch samples: each exact value
+// weighs 1, each sample its weight. Without samples this is the radix
+// selection (sqp::dsp::select_ranks) above; otherwise everything is sorted by
+// value and the nearest-rank cutoffs read off the cumulative weight. Both
+// vectors are consumed.
+inline SciQLopPlotRange percentile_range(std::vector<double>& exact,
+                                         std::vector<WeightedValue>& sketched, double low,
+                                         double high) noexcept
+{
+    if (sketched.empty())
+        return percentile_range(exact, low, high);
+    try
+    {
+        sketched.reserve(sketched.size() + exact.size());
+    }
+    catch (const std::exception&)
+    {
+        return SciQLopPlotRange();
+    }
+    for (const double v : exact)
+        sketched.push_back({ v, 1. });
+    std::sort(sketched.begin(), sketched.end(),
+              [](const WeightedValue& a, const WeightedValue& b) { return a.value < b.value; });
+    double total = 0.;
+    for (const auto& s : sketched)
+        total += s.weight;
 
-    const auto rank = [n = values.size()](double p) -> std::size_t
+    const auto at_rank = [&](double p) -> double
     {
-        const double clamped = std::clamp(p, 0., 100.);
-        const long idx = std::lround(clamped / 100. * static_cast<double>(n - 1));
-        return static_cast<std::size_t>(std::clamp<long>(idx, 0, static_cast<long>(n - 1)));
+        const double target = std::round(std::clamp(p, 0., 100.) / 100. * (total - 1.));
+        double cumulative = 0.;
+        for (const auto& s : sketched)
+        {
+            cumulative += s.weight;
+            if (cumulative > target)
+                return s.value;
+        }
+        return sketched.back().value;
     };
-    const std::size_t lo_idx = rank(low);
-    const std::size_t hi_idx = rank(high);
-    std::nth_element(values.begin(), values.begin() + lo_idx, values.end());
-    const double lo_val = values[lo_idx];
-    std::nth_element(values.begin(), values.begin() + hi_idx, values.end());
-    const double hi_val = values[hi_idx];
+    const double lo_val = at_rank(low);
+    const double hi_val = at_rank(high);
     return SciQLopPlotRange(std::min(lo_val, hi_val), std::max(lo_val, hi_val));
 }
 }
@@ -0,0 +1,178 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include <QObject>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+// Runs a level-of-detail build on the one thread shared by every plottable:
+// a build already fans out on the DSP pool, so more threads here would only
+// compete with it.
+void post_lod_build(std::function<void()> task);
+
+// Keeps a plottable's level-of-detail index in step with its data. reset()
+// drops the index when the data changes, request() schedules
+// Index::build(data) on the shared LOD thread, and `on_ready` runs on the
+// owner's thread once an index for the current data is available. The build
+// reads the latest request when it starts, so data replaced faster than it
+// builds (streaming) queues a single build, not a backlog; builds for data
+// replaced meanwhile are discarded.
+//
+// extend() is reset() for data that only grew by rows appended after the
+// ones the index was built from: the index is kept (index() then covers a
+// prefix of data()) and the next build is Index::extend(index, data) when
+// the Index type provides it. Such builds stay valid for later appends, so
+// they are installed even when more rows arrived while they ran.
+//
+// A build that throws or returns null leaves the index as it was; the
+// request is dropped on the owner's thread so pending() clears and a later
+// request() tries again.
+template <typename Index, typename Data>
+class AsyncLod
+{
+    struct Shared
+    {
+        std::mutex mutex;
+        QObject* object = nullptr;
+        AsyncLod* lod = nullptr;
+        Data data {};
+        std::shared_ptr<const Index> prefix;
+        std::uint64_t generation = 0;
+        bool queued = false;
+    };
+
+    std::shared_ptr<Shared> m_shared;
+    std::function<void()> m_on_ready;
+    std::shared_ptr<const Index> m_index;
+    Data m_data {};
+    std::uint64_t m_generation = 0;
+    // Generation of the last reset(): indexes built since are prefixes of m_data.
+    std::uint64_t m_base = 0;
+    std::uint64_t m_index_generation = 0;
+    std::uint64_t m_requested = static_cast<std::uint64_t>(-1);
+
+    inline bool current() const noexcept
+    {
+        return m_index && m_index_generation == m_generation;
+    }
+
+public:
+    AsyncLod(QObject* owner, std::function<void()> on_ready)
+            : m_shared { std::make_shared<Shared>() }, m_on_ready { std::move(on_ready) }
+    {
+        m_shared->object = owner;
+        m_shared->lod = this;
+    }
+
+    ~AsyncLod()
+    {
+        std::lock_guard lock { m_shared->mutex };
+        m_shared->object = nullptr;
+    }
+
+    AsyncLod(const AsyncLod&) = delete;
+    AsyncLod& operator=(const AsyncLod&) = delete;
+
+    void reset(Data data)
+    {
+        m_base = ++m_generation;
+        m_index.reset();
+        m_data = std::move(data);
+    }
+
+    void extend(Data data)
+    {
+        ++m_generation;
+        m_data = std::move(data);
+    }
+
+    void request()
+    {
+        if (current() || m_requested == m_generation)
+            return;
+        m_requested = m_generation;
+        std::lock_guard lock { m_shared->mutex };
+        m_shared->data = m_data;
+        m_shared->prefix = m_index;
+        m_shared->generation = m_generation;
+        if (std::exchange(m_shared->queued, true))
+            return;
+        post_lod_build([shared = m_shared] {
+            Data data;
+            std::shared_ptr<const Index> prefix;
+            std::uint64_t generation;
+            {
+                std::lock_guard lock { shared->mutex };
+                shared->queued = false;
+                data = std::exchange(shared->data, Data {});
+                prefix = std::exchange(shared->prefix, nullptr);
+                generation = shared->generation;
+            }
+            std::shared_ptr<const Index> index;
+            try
+            {
+                if constexpr (requires { Index::extend(*prefix, data); })
+                    index = prefix ? Index::extend(*prefix, data) : Index::build(data);
+                else
+                    index = Index::build(data);
+            }
+            catch (const std::exception&)
+            {
+            }
+            std::lock_guard lock { shared->mutex };
+            if (!shared->object)
+                return;
+            QMetaObject::invokeMethod(
+                shared->object,
+                [lod = shared->lod, index = std::move(index), generation] {
+                    if (!index)
+                    {
+                        // Failed: no longer pending, and the next request() retries.
+                        if (lod->m_requested == generation)
+                            lod->m_requested = static_cast<std::uint64_t>(-1);
+                        return;
+                    }
+                    if (generation < lod->m_base
+                        || (lod->m_index && generation <= lod->m_index_generation))
+                        return;
+                    lod->m_index = index;
+                    lod->m_index_generation = generation;
+                    if (lod->m_on_ready)
+                        lod->m_on_ready();
+                },
+                Qt::QueuedConnection);
+        });
+    }
+
+    // Index for the current data, null until built. After extend() it may
+    // cover only the rows the data had before.
+    inline const Index* index() const noexcept { return m_index.get(); }
+    inline const std::shared_ptr<const Index>& shared_index() const noexcept { return m_index; }
+    inline bool ready() const noexcept { return m_index != nullptr; }
+    // A build of the current data was requested and has not landed yet.
+    inline bool pending() const noexcept { return m_requested == m_generation && !current(); }
+    inline const Data& data() const noexcept { return m_data; }
+};
@@ -0,0 +1,80 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "SciQLopPlots/Python/PythonInterface.hpp"
+#include "SciQLopPlots/enums.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Image pyramid of a colormap's z plane. Each level averages (or takes the
+// max of) blocks of time_factor columns of the level below, and of channel
+// pairs while there are more than max_channels of them; non-finite cells are
+// left out and a block without a finite one stays NaN. Merged y values are
+// geometric means on a log y axis. A 2D (per-column) y is reduced with its
+// column block, so every level keeps the shape of the input.
+class ColorMapPyramid
+{
+public:
+    static constexpr std::size_t time_factor = 4;
+    static constexpr std::size_t max_channels = 256;
+    // Smaller planes are rasterised from full resolution fast enough.
+    static constexpr std::size_t min_cells = std::size_t { 1 } << 22;
+    static constexpr std::size_t min_columns = 256;
+
+    struct Input
+    {
+        SciQLopPyBuffer x, y, z;
+        bool log_y = false;
+        ColorMapLod reduction = ColorMapLod::Mean;
+    };
+
+    struct Level
+    {
+        std::vector<double> x;
+        // ny values, or nx * ny when y_2d.
+        std::vector<double> y;
+        // nx * ny, row-major like the input.
+        std::vector<float> z;
+        std::size_t nx = 0;
+        std::size_t ny = 0;
+        bool y_2d = false;
+        // Input columns per column of this level.
+        std::size_t stride = 1;
+    };
+
+    // Blocking build, meant for a worker thread. Throws std::invalid_argument
+    // on an unsupported dtype.
+    static std::shared_ptr<const ColorMapPyramid> build(const Input& input);
+
+    inline std::size_t level_count() const noexcept { return m_levels.size(); }
+    inline const Level& level(std::size_t index) const noexcept { return m_levels[index]; }
+
+    // Coarsest level still giving at least one column per pixel to
+    // `visible_columns` input columns, or -1 when the input itself should be
+    // drawn.
+    int level_for(std::size_t visible_columns, int pixels) const noexcept;
+
+private:
+    std::vector<Level> m_levels;
+};
@@ -0,0 +1,219 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "SciQLopPlots/Python/PythonInterface.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Scatter points behind a Histogram2D, kept as the chunks they arrived in so
+// append_data() copies nothing but the chunk: set_data() starts a new epoch,
+// each append adds a chunk whose points are numbered after the previous ones
+// (seq). Small trailing chunks are merged, so a long stream of small appends
+// keeps O(log n) of them. With a window, points older than last x - window
+// are cut; chunks entirely below the cut are dropped once the grid shown no
+// longer counts them.
+class Histogram2DPoints
+{
+public:
+    // Below this size trailing chunks are merged pairwise.
+    static constexpr std::size_t merge_limit = std::size_t { 1 } << 20;
+
+    struct Chunk
+    {
+        SciQLopPyBuffer x, y;
+        std::size_t seq = 0;
+        std::size_t size = 0;
+        // Extent of the finite x values; x_sorted when all of them are finite
+        // and in order.
+        double x_min = std::numeric_limits<double>::quiet_NaN();
+        double x_max = std::numeric_limits<double>::quiet_NaN();
+        bool x_sorted = false;
+
+        Chunk(SciQLopPyBuffer x, SciQLopPyBuffer y, std::size_t seq);
+
+        // Indices of the finite-x points sorted by x, computed (in parallel)
+        // on first use. Only windowed streams need it.
+        const std::vector<std::uint32_t>& order() const;
+
+    private:
+        mutable std::once_flag m_order_once;
+        mutable std::vector<std::uint32_t> m_order;
+    };
+
+    struct Snapshot
+    {
+        std::vector<std::shared_ptr<const Chunk>> chunks;
+        std::uint64_t epoch = 0;
+        // Points numbered below end_seq are in chunks.
+        std::size_t end_seq = 0;
+        // Points with x below cut are out of the window.
+        double cut = -std::numeric_limits<double>::infinity();
+    };
+
+    // Replaces every point. Throws std::invalid_argument when x and y sizes
+    // differ or exceed INT_MAX.
+    void set(const SciQLopPyBuffer& x, const SciQLopPyBuffer& y);
+    void append(const SciQLopPyBuffer& x, const SciQLopPyBuffer& y);
+    void clear();
+
+    // Keep only points within `window` x units of the largest x; <= 0 keeps
+    // everything.
+    void set_window(double window);
+    inline double window() const noexcept { return m_window; }
+
+    // Drops the chunks entirely below both the window cut and `counted_cut`,
+    // the cut of the grid currently shown.
+    void release(double counted_cut);
+
+    inline bool empty() const noexcept { return m_chunks.empty(); }
+    inline std::size_t chunk_count() const noexcept { return m_chunks.size(); }
+    Snapshot snapshot() const;
+
+    // Points in the window, in arrival order; the buffers given to set()
+    // when nothing was appended since.
+    std::pair<SciQLopPyBuffer, SciQLopPyBuffer> data() const;
+
+private:
+    std::vector<std::shared_ptr<const Chunk>> m_chunks;
+    std::uint64_t m_epoch = 0;
+    std::size_t m_end_seq = 0;
+    double m_x_max = -std::numeric_limits<double>::infinity();
+    double m_window = 0.;
+
+    double _cut() const noexcept;
+    void _merge_tail();
+};
+
+// Binned counts of a Histogram2DPoints snapshot, built on the LOD thread.
+// Bins are uniform (in log10 for a log axis, dropping non-positive values)
+// over the extent of the points in the window; a dimension with no extent
+// gets a unit-wide one. Counting fans out on the DSP pool with one partial
+// grid per block, merged at the end.
+//
+// Given the grid it replaces, a build only counts what changed: points
+// appended since (numbered from its end_seq), minus the points the window
+// cut moved past, found by bisecting each chunk's x order. Appends falling
+// outside the grid trigger a full count over an extent with a quarter of a
+// span of headroom on the side they grew, so growing streams stay
+// incremental.
+class Histogram2DGrid
+{
+public:
+    struct Settings
+    {
+        int x_bins = 100;
+        int y_bins = 100;
+        bool x_log = false;
+        bool y_log = false;
+        // Each x column scaled to sum to 1.
+        bool column_normalized = false;
+
+        bool same_binning(const Settings& other) const noexcept
+        {
+            return x_bins == other.x_bins && y_bins == other.y_bins && x_log == other.x_log
+                && y_log == other.y_log;
+        }
+    };
+
+    struct Input
+    {
+        Histogram2DPoints::Snapshot points;
+        Settings settings;
+        std::shared_ptr<const Histogram2DGrid> previous;
+    };
+
+    struct Axis
+    {
+        // Edges, in log10 when log.
+        double lo = 0.;
+        double hi = 1.;
+        int bins = 1;
+        bool log = false;
+
+        // Bin of v, -1 when outside [lo, hi] or not positive on a log axis.
+        inline int bin(double v) const noexcept
+        {
+            double t = v;
+            if (log)
+            {
+                if (!(v > 0.))
+                    return -1;
+                t = std::log10(v);
+            }
+            if (!(t >= lo && t <= hi))
+                return -1;
+            const int i = static_cast<int>((t - lo) * (bins / (hi - lo)));
+            return i < bins ? i : bins - 1;
+        }
+
+        double centre(int i) const noexcept;
+        double edge(int i) const noexcept;
+    };
+
+    // Blocking build, meant for a worker thread.
+    static std::shared_ptr<const Histogram2DGrid> build(const Input& input);
+
+    inline bool empty() const noexcept { return m_total <= 0.; }
+    inline const Settings& settings() const noexcept { return m_settings; }
+    inline const Axis& x_axis() const noexcept { return m_x; }
+    inline const Axis& y_axis() const noexcept { return m_y; }
+    // x_bins * y_bins, x-major like a colormap z plane.
+    inline const std::vector<double>& counts() const noexcept { return m_counts; }
+    // Counts after normalization.
+    inline const std::vector<double>& z() const noexcept { return m_z; }
+    inline double total() const noexcept { return m_total; }
+    inline double cut() const noexcept { return m_cut; }
+    inline std::size_t end_seq() const noexcept { return m_end_seq; }
+    // True when the last build only counted the changes.
+    inline bool incremental() const noexcept { return m_incremental; }
+
+    // Drawable cell positions: bin centres, or both edges of a single bin
+    // (a colormap needs two positions per dimension), with z laid out to
+    // match.
+    inline const std::vector<double>& x_positions() const noexcept { return m_x_positions; }
+    inline const std::vector<double>& y_positions() const noexcept { return m_y_positions; }
+    inline const std::vector<double>& z_plane() const noexcept { return m_plane; }
+
+private:
+    Settings m_settings;
+    Axis m_x;
+    Axis m_y;
+    std::vector<double> m_counts;
+    std::vector<double> m_z;
+    std::vector<double> m_x_positions;
+    std::vector<double> m_y_positions;
+    std::vector<double> m_plane;
+    double m_total = 0.;
+    double m_cut = -std::numeric_limits<double>::infinity();
+    std::uint64_t m_epoch = 0;
+    std::size_t m_end_seq = 0;
+    bool m_incremental = false;
+
+    void _finish();
+};
@@ -0,0 +1,128 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "SciQLopPlots/Plotables/AsyncLod.hpp"
+#include "SciQLopPlots/Python/PythonInterface.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Min/max pyramid over the value columns of a line graph. Level 0 holds, for
+// every bucket of base_stride rows and every column, the smallest and largest
+// finite value and the rows they sit on; each next level merges bucket pairs,
+// so level L buckets span base_stride << L rows. The pyramid only references
+// rows, it doesn't keep the values: queries that need raw samples at their
+// edges take the y buffer it was built from.
+class LodIndex
+{
+public:
+    static constexpr std::size_t base_stride = 256;
+    // Below this many rows NeoQCP's own resampling is already cheap enough.
+    static constexpr std::size_t min_rows = std::size_t { 1 } << 20;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    struct Bucket
+    {
+        double min;
+        double max;
+        std::size_t min_row;
+        std::size_t max_row;
+    };
+
+    // Blocking build, meant for a worker thread. y is 1D or (rows, columns)
+    // in any layout; throws std::invalid_argument on an unsupported dtype.
+    static std::shared_ptr<const LodIndex> build(const SciQLopPyBuffer& y);
+
+    // build(y) for y whose first prefix.rows() rows are the ones prefix was
+    // built from: the prefix's complete buckets are copied at every level and
+    // only its last partial bucket and the new rows are scanned.
+    static std::shared_ptr<const LodIndex> extend(const LodIndex& prefix,
+                                                  const SciQLopPyBuffer& y);
+
+    inline std::size_t rows() const noexcept { return m_rows; }
+    inline std::size_t columns() const noexcept { return m_columns; }
+    inline std::size_t level_count() const noexcept { return m_levels.size(); }
+    inline std::size_t stride(std::size_t level) const noexcept { return base_stride << level; }
+
+    // Finite min/max of `column` over rows [first, last): O(log rows) buckets
+    // plus at most 2 * base_stride raw samples read from y. Rows of y past
+    // rows() (appended since the build) are read raw. Returns false when
+    // those rows hold no finite value.
+    bool value_range(const SciQLopPyBuffer& y, std::size_t column, std::size_t first,
+                     std::size_t last, double& min, double& max) const;
+
+    // Rows to draw for rows [first, last) on about `buckets` pixels: the
+    // first, last, min and max rows of every column in each bucket of the
+    // coarsest level that still gives one bucket per pixel, plus the first
+    // and last rows of the series so the key extent is kept. Sorted, unique.
+    // Empty when even level 0 is too coarse for that many pixels.
+    std::vector<std::size_t> decimate(std::size_t first, std::size_t last,
+                                      std::size_t buckets) const;
+
+private:
+    std::size_t m_rows = 0;
+    std::size_t m_columns = 0;
+    // m_levels[L][bucket * m_columns + column]
+    std::vector<std::vector<Bucket>> m_levels;
+
+    static std::shared_ptr<const LodIndex> build(const SciQLopPyBuffer& y,
+                                                 const LodIndex* prefix);
+
+    inline const Bucket& bucket(std::size_t level, std::size_t index,
+                                std::size_t column) const noexcept
+    {
+        return m_levels[level][index * m_columns + column];
+    }
+};
+
+// The LodIndex of a line graph's values, built on the shared LOD thread once
+// the view is dense enough to need it. `on_ready` runs on the owner's thread
+// when the pyramid for the current data is available.
+class LineLod
+{
+    AsyncLod<LodIndex, SciQLopPyBuffer> m_lod;
+
+public:
+    LineLod(QObject* owner, std::function<void()> on_ready);
+
+    void reset(const SciQLopPyBuffer& y);
+    // reset() for y whose first `kept_rows` rows are the previous data's
+    // (rows appended): the current pyramid keeps serving those rows, the new
+    // ones are drawn raw until the extended pyramid is ready.
+    void extend(const SciQLopPyBuffer& y, std::size_t kept_rows);
+
+    // Rows of (x, y) to hand the renderer for keys [lower, upper] on `pixels`
+    // pixels, or an empty list when the raw data should be drawn: short
+    // series, sparse views, or a pyramid still being built.
+    std::vector<std::size_t> rows_to_draw(const SciQLopPyBuffer& x, double lower, double upper,
+                                          int pixels);
+
+    // Finite min/max of `column` for keys [lower, upper] from the pyramid.
+    // False when no pyramid is built yet or nothing finite is in range.
+    bool value_range(const SciQLopPyBuffer& x, double lower, double upper, std::size_t column,
+                     double& min, double& max) const;
+
+    inline bool ready() const noexcept { return m_lod.ready(); }
+    inline bool pending() const noexcept { return m_lod.pending(); }
+};
@@ -49,6 +49,8 @@ struct ResamplerPlotInfo
     bool y_is_log = false;
     QSize plot_size;
     QCPRange plot_range;
+    // Visible value range, for resamplers that simplify in pixel space.
+    QCPRange value_range;
 };
 
 struct ResamplerData1d
@@ -122,6 +124,12 @@ protected:
         _plot_info.plot_range = new_range;
     }
 
+    inline void set_next_value_range(const QCPRange new_range)
+    {
+        QMutexLocker locker(&_plot_info_mutex);
+        _plot_info.value_range = new_range;
+    }
+
     QCPRange _bounds(const SciQLopPyBuffer& b)
     {
         const auto len = b.flat_size();
@@ -225,6 +233,9 @@ protected:
     // Written from the GUI thread (set_line_count), read from the resampler
     // worker thread (_resample_impl) — atomic, not mutex-protected state.
     std::atomic<std::size_t> _line_cnt;
+    // A resample is queued and not started yet: later requests only update
+    // the plot info it will read, so a burst of pans costs one pass.
+    std::atomic<bool> _resample_pending { false };
 
     Q_SLOT void _async_resample();
 
@@ -25,18 +25,31 @@
 
 #include "AbstractResampler.hpp"
 #include <QMutex>
+#include <array>
 #include <qcustomplot.h>
+#include <vector>
 
 struct CurveResampler : public AbstractResampler1d
 {
     Q_OBJECT
 
+    // Rows holding each line's min/max x and y, refreshed on new data. Always
+    // kept by the simplification so QCP's key/value ranges stay exact.
+    // Only touched from the resampler thread.
+    std::vector<std::array<std::size_t, 4>> _extremes;
+
     void _resample_impl(const ResamplerData1d& data, const ResamplerPlotInfo& plot_info);
 
 public:
 #ifndef BINDINGS_H
-    Q_SIGNAL void setGraphData(QList<QVector<QCPCurveData>> data);
+    // new_data is false when only the view changed: same buffers, different
+    // simplification.
+    Q_SIGNAL void setGraphData(QList<QVector<QCPCurveData>> data, bool new_data);
 #endif // !BINDINGS_H
 
     CurveResampler(SciQLopPlottableInterface* parent, std::size_t line_cnt);
+
+    // Simplify against a new view. Parametric curves are not sorted by x,
+    // so unlike line graphs both ranges matter.
+    void resample_view(const QCPRange keys, const QCPRange values);
 };
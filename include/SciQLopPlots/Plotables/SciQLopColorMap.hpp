@@ -25,6 +25,9 @@
 #include "SciQLopPlots/Python/DtypeDispatch.hpp"
 #include "SciQLopPlots/qcp_enums.hpp"
 #include "SciQLopColorMapBase.hpp"
+#include "SciQLopPlots/Plotables/AsyncLod.hpp"
+#include "SciQLopPlots/Plotables/ColorMapPyramid.hpp"
+#include "SciQLopPlots/QuantileSketch.hpp"
 #include "QCPAbstractPlottableWrapper.hpp"
 #include "SciQLopPlots/enums.hpp"
 #include <plottables/plottable-colormap2.h>
@@ -44,9 +47,23 @@ class SciQLopColorMap : public SciQLopColorMapBase
     };
     std::shared_ptr<DataSourceWithBuffers> _dataHolder;
 
+    ColorMapLod _lod_mode = ColorMapLod::Off;
+    AsyncLod<ColorMapPyramid, ColorMapPyramid::Input> _lod;
+    // Pyramid level drawn, -1 for the raw data.
+    int _lod_level = -1;
+    QMetaObject::Connection _lod_range_connection;
+    QMetaObject::Connection _lod_log_connection;
+    // Built on the first percentile autoscale over a large window.
+    mutable AsyncLod<sciqlop::percentile::QuantileSketch,
+                     sciqlop::percentile::QuantileSketch::Input>
+        _z_quantiles;
+
     Q_OBJECT
 
     void _cmap_got_destroyed();
+    void _connect_lod();
+    void _reset_lod();
+    void _update_lod();
 
 protected:
     virtual QCPAbstractPlottable* plottable() const override
@@ -68,6 +85,21 @@ public:
     void set_auto_scale_y(bool auto_scale_y);
     inline bool auto_scale_y() const { return _auto_scale_y; }
 
+    // Draw zoomed-out views from a background-built image pyramid (mean or
+    // max of the merged cells) instead of rasterising the full-resolution
+    // plane on every pan or zoom. Only planes of ColorMapPyramid::min_cells
+    // cells or more get one.
+    void set_lod(ColorMapLod mode);
+    inline ColorMapLod lod() const { return _lod_mode; }
+
+    inline bool lod_pending() const noexcept override
+    {
+        return _lod.pending() || _z_quantiles.pending();
+    }
+
+    virtual void set_x_axis(SciQLopPlotAxisInterface* axis) noexcept override;
+    virtual void set_y_axis(SciQLopPlotAxisInterface* axis) noexcept override;
+
     SciQLopPlotRange z_percentile_range(const SciQLopPlotRange& x_range,
                                         const SciQLopPlotRange& y_range, double low,
                                         double high) const noexcept override;
@@ -168,6 +200,7 @@ public:
 signals:
 #endif
     Q_SIGNAL void auto_scale_y_changed(bool);
+    Q_SIGNAL void lod_changed(ColorMapLod mode);
     Q_SIGNAL void contour_levels_changed();
     Q_SIGNAL void contour_pen_changed(const QPen& pen);
     Q_SIGNAL void contour_labels_enabled_changed(bool enabled);
@@ -186,6 +219,30 @@ public:
     virtual ~SciQLopColorMapFunction() override = default;
 
     inline void invalidate_cache() noexcept override { invalidate_pipeline_cache(); }
+
+    inline void set_cache_budget(std::size_t bytes) noexcept override
+    {
+        set_pipeline_cache_budget(bytes);
+    }
+
+    inline std::size_t cache_budget() const noexcept override { return pipeline_cache_budget(); }
+
+    inline void set_prefetch_enabled(bool enabled) noexcept override
+    {
+        set_pipeline_prefetch_enabled(enabled);
+    }
+
+    inline bool prefetch_enabled() const noexcept override { return pipeline_prefetch_enabled(); }
+
+    inline void set_adaptive_rate_limit(bool enabled) noexcept override
+    {
+        set_pipeline_adaptive_rate_limit(enabled);
+    }
+
+    inline bool adaptive_rate_limit() const noexcept override
+    {
+        return pipeline_adaptive_rate_limit();
+    }
 };
 
 class SciQLopColorMapRemote : public SciQLopColorMap, public SciQLopRemoteGraph
@@ -41,6 +41,7 @@ protected:
     QPointer<SciQLopPlotColorScaleAxis> _colorScaleAxis;
     double _autoscale_percentile_low = 0.;
     double _autoscale_percentile_high = 100.;
+    double _autoscale_percentile_error = 1e-3;
 
     inline QCustomPlot* _plot() const { return qobject_cast<QCustomPlot*>(this->parent()); }
 
@@ -159,6 +160,13 @@ public:
     inline double autoscale_percentile_low() const noexcept { return _autoscale_percentile_low; }
     void set_autoscale_percentile_high(double percentile) noexcept;
     inline double autoscale_percentile_high() const noexcept { return _autoscale_percentile_high; }
+    // Largest rank error (fraction of the visible cells) accepted from a
+    // quantile sketch of z; 0 always scans exactly.
+    void set_autoscale_percentile_error(double error) noexcept;
+    inline double autoscale_percentile_error() const noexcept
+    {
+        return _autoscale_percentile_error;
+    }
 
     // Range of z over cells whose x/y fall in the given visible ranges, clamped
     // to [low, high] percentiles (nearest-rank). low=0/high=100 gives plain
@@ -39,12 +39,16 @@ class SciQLopCurve : public SQPQCPAbstractPlottableWrapper
 
     SciQLopPlotAxis* _keyAxis;
     SciQLopPlotAxis* _valueAxis;
+    QList<QMetaObject::Connection> _view_connections;
 
     Q_OBJECT
 
     // inline QCustomPlot* _plot() const { return qobject_cast<QCustomPlot*>(this->parent()); }
 
-    void _setCurveData(QList<QVector<QCPCurveData>> data);
+    void _setCurveData(QList<QVector<QCPCurveData>> data, bool new_data);
+    // The resampler simplifies against both visible ranges: follow them.
+    void _connect_view();
+    void _push_view();
 
     void clear_curves(bool curve_already_removed = false);
     void clear_resampler();
@@ -120,6 +124,16 @@ public:
     virtual ~SciQLopCurveFunction() override = default;
 
     inline void invalidate_cache() noexcept override { invalidate_pipeline_cache(); }
+
+    inline void set_adaptive_rate_limit(bool enabled) noexcept override
+    {
+        set_pipeline_adaptive_rate_limit(enabled);
+    }
+
+    inline bool adaptive_rate_limit() const noexcept override
+    {
+        return pipeline_adaptive_rate_limit();
+    }
 };
 
 class SciQLopCurveRemote : public SciQLopCurve, public SciQLopRemoteGraph
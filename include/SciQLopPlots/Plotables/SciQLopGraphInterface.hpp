@@ -40,6 +40,12 @@
 #include <utility>
 #include <vector>
 
+namespace sciqlop::percentile
+{
+struct WeightedValue;
+}
+#include <vector>
+
 class SciQLopPlotAxisInterface;
 class InspectorExtension;
 class InspectorExtensionHolder;
@@ -110,6 +116,15 @@ public:
 
     Q_SLOT virtual void set_data(const QList<SciQLopPyBuffer>& values) { WARN_ABSTRACT_METHOD; }
 
+    // Adds rows after the data already shown instead of replacing it; only
+    // the new rows are copied (line graphs, see StreamingSeries).
+    Q_SLOT virtual void append_data(SciQLopPyBuffer x, SciQLopPyBuffer y) { WARN_ABSTRACT_METHOD; }
+
+    // Keep only the last `window` key units (seconds on a time axis) of
+    // appended data, from the next append on; 0 keeps everything.
+    virtual void set_stream_window(double window) noexcept { }
+    virtual double stream_window() const noexcept { return 0.; }
+
     Q_SLOT virtual void set_color_data(SciQLopPyBuffer values, ::ColorGradient gradient = ::ColorGradient::Jet)
     {
         WARN_ABSTRACT_METHOD;
@@ -136,6 +151,10 @@ public:
     virtual bool busy() const noexcept { return false; }
     virtual void set_busy(bool busy) noexcept { Q_UNUSED(busy); }
 
+    // True while a background build derived from the current data (LOD
+    // pyramid, quantile sketch, histogram bins) has not been applied yet.
+    virtual bool lod_pending() const noexcept { return false; }
+
     inline virtual void set_x_axis(SciQLopPlotAxisInterface* axis) noexcept
     {
         WARN_ABSTRACT_METHOD;
@@ -196,6 +215,28 @@ public:
 
     virtual void invalidate_cache() noexcept { }
 
+    // Byte budget of the range tile cache of a callable-backed time series
+    // (see DataProviderInterface::set_cache_budget); 0 disables it. No-op on
+    // graphs whose data is not indexed by the plot's time range.
+    virtual void set_cache_budget(std::size_t bytes) noexcept { }
+    virtual std::size_t cache_budget() const noexcept { return 0; }
+
+    // Fetch neighbouring ranges into that cache while idle (see
+    // DataProviderInterface::set_prefetch_enabled). Off by default.
+    virtual void set_prefetch_enabled(bool enabled) noexcept { }
+    virtual bool prefetch_enabled() const noexcept { return false; }
+
+    // Serve range requests after a delay adapted to the callable's latency
+    // and the pace of requests (see DataProviderInterface::
+    // set_adaptive_rate_limit). On by default for callable-backed graphs.
+    virtual void set_adaptive_rate_limit(bool enabled) noexcept { }
+    virtual bool adaptive_rate_limit() const noexcept { return false; }
+
+    // Level of the data currently shown: 0 is the full-resolution answer,
+    // larger values are coarser previews delivered while it is computed.
+    inline int data_level() const noexcept { return m_data_level; }
+    inline void set_data_level(int level) noexcept { m_data_level = level; }
+
 #ifdef BINDINGS_H
 #define Q_SIGNAL
 signals:
@@ -216,6 +257,7 @@ signals:
 
     protected:
     bool _got_first_data = false;
+    int m_data_level = 0;
 
     void check_first_data(std::size_t n)
     {
@@ -285,6 +327,32 @@ public:
         Q_UNUSED(out);
     }
 
+    // Same pool, but a graph holding a quantile sketch of its values may stand
+    // for most of the window with weighted samples in `sketched`, provided the
+    // sketch's rank error is within max_rank_error. Default: every value,
+    // exactly.
+    virtual void collect_visible_samples(const SciQLopPlotRange& visible_key_range,
+                                         double max_rank_error, std::vector<double>& exact,
+                                         std::vector<sciqlop::percentile::WeightedValue>& sketched)
+        const noexcept
+    {
+        Q_UNUSED(max_rank_error);
+        Q_UNUSED(sketched);
+        collect_visible_values(visible_key_range, exact);
+    }
+
+    // Min/max of the values drawn over visible_key_range when the graph can
+    // answer without scanning them (e.g. from a level-of-detail pyramid); a
+    // default (NaN) range means nothing visible. Returns false to let the
+    // value-axis rescale fall back to NeoQCP's own scan.
+    virtual bool visible_value_range(const SciQLopPlotRange& visible_key_range,
+                                     SciQLopPlotRange& range) const noexcept
+    {
+        Q_UNUSED(visible_key_range);
+        Q_UNUSED(range);
+        return false;
+    }
+
     Q_SIGNAL void labels_changed(const QStringList& labels);
     Q_SIGNAL void colors_changed(const QList<QColor>& colors);
     Q_SIGNAL void component_list_changed();
@@ -344,6 +412,9 @@ connect_pipeline_data_to_graph(Pipeline* pipeline, SciQLopPlottableInterface* gr
         }
     };
     QList<QMetaObject::Connection> conns;
+    // Connected first so the level is known before the matching batch lands.
+    conns << QObject::connect(pipeline, &Pipeline::new_data_level, graph,
+        [g = graph](int level) { g->set_data_level(level); });
     switch (N)
     {
         case 2:
@@ -431,6 +502,33 @@ public:
     }
 
     inline void invalidate_pipeline_cache() noexcept { m_pipeline->invalidate_cache(); }
+
+    inline void set_pipeline_cache_budget(std::size_t bytes) noexcept
+    {
+        m_pipeline->set_cache_budget(bytes);
+    }
+
+    inline std::size_t pipeline_cache_budget() const noexcept { return m_pipeline->cache_budget(); }
+
+    inline void set_pipeline_prefetch_enabled(bool enabled) noexcept
+    {
+        m_pipeline->set_prefetch_enabled(enabled);
+    }
+
+    inline bool pipeline_prefetch_enabled() const noexcept
+    {
+        return m_pipeline->prefetch_enabled();
+    }
+
+    inline void set_pipeline_adaptive_rate_limit(bool enabled) noexcept
+    {
+        m_pipeline->set_adaptive_rate_limit(enabled);
+    }
+
+    inline bool pipeline_adaptive_rate_limit() const noexcept
+    {
+        return m_pipeline->adaptive_rate_limit();
+    }
 };
 
 // Mixin that binds a RemoteDataPipeline to a graph. Sibling of SciQLopFunctionGraph.
@@ -26,27 +26,32 @@
 #include "SciQLopPlots/qcp_enums.hpp"
 #include "SciQLopPlots/enums.hpp"
 #include "SciQLopColorMapBase.hpp"
+#include "SciQLopPlots/Plotables/AsyncLod.hpp"
+#include "SciQLopPlots/Plotables/Histogram2DGrid.hpp"
 #include <qcustomplot.h>
+#include <plottables/plottable-colormap2.h>
 #include <plottables/plottable-histogram2d.h>
-#include <datasource/soa-datasource.h>
+#include <datasource/soa-datasource-2d.h>
 #include <QSignalBlocker>
 #include <memory>
 #include <span>
 
 class SciQLopHistogram2D : public SciQLopColorMapBase
 {
-    QPointer<QCPHistogram2D> _hist;
-
-    struct DataSourceWithBuffers
-    {
-        SciQLopPyBuffer x, y;
-        std::shared_ptr<QCPAbstractDataSource> source;
-    };
-    std::shared_ptr<DataSourceWithBuffers> _dataHolder;
+    // Binning is ours (Histogram2DGrid); the counts are drawn as a colormap.
+    QPointer<QCPColorMap2> _hist;
+    Histogram2DPoints _points;
+    Histogram2DGrid::Settings _settings;
+    AsyncLod<Histogram2DGrid, Histogram2DGrid::Input> _grid;
+    // Grid drawn, and the base the next build only counts the changes from.
+    std::shared_ptr<const Histogram2DGrid> _shown;
+    bool _rescale_on_grid = false;
 
     Q_OBJECT
 
     void _hist_got_destroyed();
+    void _rebin();
+    void _show_grid();
 
 protected:
     virtual QCPAbstractPlottable* plottable() const override
@@ -64,7 +69,20 @@ public:
     Q_SLOT virtual void set_data(SciQLopPyBuffer x, SciQLopPyBuffer y) override;
     virtual QList<SciQLopPyBuffer> data() const noexcept override;
 
-    inline QCPHistogram2D* histogram() const { return _hist; }
+    // Adds points to the ones already binned; only the new points are
+    // counted as long as they fall inside the current bins. Emits the
+    // argument-less data_changed() only.
+    Q_SLOT void append_data(SciQLopPyBuffer x, SciQLopPyBuffer y);
+
+    // Keep only points within `window` x units of the largest x appended;
+    // 0 keeps everything. Points leaving the window are uncounted from their
+    // x slice instead of rebinning.
+    void set_stream_window(double window);
+    inline double stream_window() const noexcept { return _points.window(); }
+
+    inline bool lod_pending() const noexcept override { return _grid.pending(); }
+
+    inline QCPColorMap2* histogram() const { return _hist; }
 
     void set_bins(int x_bins, int y_bins);
     int x_bins() const;
@@ -80,6 +98,11 @@ public:
     bool x_bins_log() const;
     bool y_bins_log() const;
 
+    // Extent of the bins drawn, from the first edge to the last; empty until
+    // a grid is shown.
+    SciQLopPlotRange x_bins_range() const noexcept;
+    SciQLopPlotRange y_bins_range() const noexcept;
+
     SciQLopPlotRange z_percentile_range(const SciQLopPlotRange& x_range,
                                         const SciQLopPlotRange& y_range, double low,
                                         double high) const noexcept override;
@@ -109,6 +132,16 @@ public:
     virtual ~SciQLopHistogram2DFunction() override = default;
 
     inline void invalidate_cache() noexcept override { invalidate_pipeline_cache(); }
+
+    inline void set_adaptive_rate_limit(bool enabled) noexcept override
+    {
+        set_pipeline_adaptive_rate_limit(enabled);
+    }
+
+    inline bool adaptive_rate_limit() const noexcept override
+    {
+        return pipeline_adaptive_rate_limit();
+    }
 };
 
 class SciQLopHistogram2DRemote : public SciQLopHistogram2D, public SciQLopRemoteGraph
@@ -124,12 +157,12 @@ public:
     inline void invalidate_cache() noexcept override { invalidate_pipeline_cache(); }
 
     inline bool busy() const noexcept override { return remote_busy(); }
-    // SciQLopHistogram2D::set_busy() forwards to the underlying QCPHistogram2D,
-    // whose busyChanged is already connected to busy_changed in the ctor --
-    // so calling it here would double-emit. Block that forwarding and always
-    // emit exactly once below, driven by the authoritative remote_busy()
-    // state (this also covers the window before the QCPHistogram2D exists,
-    // where the base call is a no-op anyway).
+    // SciQLopHistogram2D::set_busy() forwards to the QCPColorMap2 drawing the
+    // counts, whose busyChanged is already connected to busy_changed in the
+    // ctor -- so calling it here would double-emit. Block that forwarding and
+    // always emit exactly once below, driven by the authoritative
+    // remote_busy() state (this also covers the window before the colormap
+    // exists, where the base call is a no-op anyway).
     inline void set_busy(bool busy) noexcept override
     {
         set_remote_busy(busy);
@@ -20,8 +20,11 @@
 -- Mail : alexis.jeandet@member.fsf.org
 ----------------------------------------------------------------------------*/
 #pragma once
+#include "SciQLopPlots/Plotables/LodIndex.hpp"
 #include "SciQLopPlots/Plotables/QCPAbstractPlottableWrapper.hpp"
+#include "SciQLopPlots/Plotables/StreamingSeries.hpp"
 #include "SciQLopPlots/Python/PythonInterface.hpp"
+#include "SciQLopPlots/QuantileSketch.hpp"
 #include "SciQLopPlots/Python/DtypeDispatch.hpp"
 #include "SciQLopPlots/SciQLopPlotAxis.hpp"
 #include <plottables/plottable-multigraph.h>
@@ -34,6 +37,17 @@ protected:
     QCPMultiGraph* _multiGraph = nullptr;
     SciQLopPyBuffer _x, _y;
     std::shared_ptr<void> _dataHolder;
+    StreamingSeries _stream;
+    // Snapshot::first_row of the stream rows in _x/_y.
+    std::size_t _stream_first_row = 0;
+    LineLod _lod;
+    QMetaObject::Connection _lodRangeConnection;
+    bool _lodEnabled = false;
+    bool _lodActive = false;
+    // Built on the first percentile autoscale over a large window.
+    mutable AsyncLod<sciqlop::percentile::QuantileSketch,
+                     sciqlop::percentile::QuantileSketch::Input>
+        _quantiles;
     QStringList _pendingLabels;
     SciQLopPlotAxis* _keyAxis = nullptr;
     SciQLopPlotAxis* _valueAxis = nullptr;
@@ -41,8 +55,25 @@ protected:
     virtual QCPMultiGraph* create_multi_graph(QCPAxis* keyAxis, QCPAxis* valueAxis) = 0;
 
     void clear_graphs(bool graph_already_removed = false);
-    void build_data_source(const SciQLopPyBuffer& x, const SciQLopPyBuffer& y);
+    // kept_rows: leading rows of (x, y) unchanged since the previous call,
+    // whose level-of-detail pyramid is extended instead of rebuilt.
+    void build_data_source(const SciQLopPyBuffer& x, const SciQLopPyBuffer& y,
+                           std::size_t kept_rows = 0);
+    void set_raw_source(const SciQLopPyBuffer& x, const SciQLopPyBuffer& y);
+    void set_decimated_source(const std::vector<std::size_t>& rows);
+    // Level-of-detail rendering for subclasses whose components draw the
+    // values as they are: once zoomed out far enough, the renderer gets the
+    // per-pixel first/min/max/last rows from a min/max pyramid instead of
+    // every sample.
+    void enable_lod();
+    void update_lod();
     void sync_components();
+    // Finite values of rows [first, last), every column.
+    void collect_rows(std::size_t first, std::size_t last, std::vector<double>& out) const;
+    // append_data() for subclasses that support it: the first append after
+    // set_data() starts the stream from the data set, later ones only copy
+    // the new rows.
+    void append_rows(SciQLopPyBuffer x, SciQLopPyBuffer y);
 
 public:
     explicit SciQLopMultiGraphBase(const QString& type_label, QCustomPlot* parent,
@@ -75,8 +106,19 @@ public:
 
     void create_graphs(const QStringList& labels);
 
+    bool lod_pending() const noexcept override
+    {
+        return _lod.pending() || _quantiles.pending();
+    }
+
 #ifndef BINDINGS_H
     void collect_visible_values(const SciQLopPlotRange& visible_key_range,
                                 std::vector<double>& out) const noexcept override;
+    void collect_visible_samples(const SciQLopPlotRange& visible_key_range, double max_rank_error,
+                                 std::vector<double>& exact,
+                                 std::vector<sciqlop::percentile::WeightedValue>& sketched)
+        const noexcept override;
+    bool visible_value_range(const SciQLopPlotRange& visible_key_range,
+                             SciQLopPlotRange& range) const noexcept override;
 #endif
 };
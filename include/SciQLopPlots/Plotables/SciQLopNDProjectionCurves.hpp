@@ -74,4 +74,14 @@ public:
     virtual ~SciQLopNDProjectionCurvesFunction() override = default;
 
     inline void invalidate_cache() noexcept override { invalidate_pipeline_cache(); }
+
+    inline void set_adaptive_rate_limit(bool enabled) noexcept override
+    {
+        set_pipeline_adaptive_rate_limit(enabled);
+    }
+
+    inline bool adaptive_rate_limit() const noexcept override
+    {
+        return pipeline_adaptive_rate_limit();
+    }
 };
@@ -23,6 +23,8 @@
 
 #include "SciQLopPlots/Python/PythonInterface.hpp"
 #include "QCPAbstractPlottableWrapper.hpp"
+#include "SciQLopPlots/Plotables/LodIndex.hpp"
+#include "SciQLopPlots/Plotables/StreamingSeries.hpp"
 #include "SciQLopPlots/SciQLopPlotAxis.hpp"
 #include <plottables/plottable-graph2.h>
 #include <datasource/abstract-datasource.h>
@@ -38,6 +40,12 @@ class SciQLopSingleLineGraph : public SQPQCPAbstractPlottableWrapper
         std::shared_ptr<QCPAbstractDataSource> source;
     };
     std::shared_ptr<DataHolder> _dataHolder;
+    StreamingSeries _stream;
+    // Snapshot::first_row of the stream rows in _dataHolder.
+    std::size_t _stream_first_row = 0;
+    LineLod _lod;
+    QMetaObject::Connection _lodRangeConnection;
+    bool _lodActive = false;
 
     SciQLopPlotAxis* _keyAxis;
     SciQLopPlotAxis* _valueAxis;
@@ -45,6 +53,10 @@ class SciQLopSingleLineGraph : public SQPQCPAbstractPlottableWrapper
     Q_OBJECT
 
     void clear_graph(bool graph_already_removed = false);
+    // kept_rows: leading rows unchanged since the previous publish (appends).
+    void _publish(const SciQLopPyBuffer& x, const SciQLopPyBuffer& y, std::size_t kept_rows = 0);
+    void _connect_lod();
+    void _update_lod();
 
 public:
     explicit SciQLopSingleLineGraph(QCustomPlot* parent, SciQLopPlotAxis* key_axis,
@@ -55,6 +67,9 @@ public:
     virtual ~SciQLopSingleLineGraph() override;
 
     Q_SLOT virtual void set_data(SciQLopPyBuffer x, SciQLopPyBuffer y) override;
+    Q_SLOT virtual void append_data(SciQLopPyBuffer x, SciQLopPyBuffer y) override;
+    inline void set_stream_window(double window) noexcept override { _stream.set_window(window); }
+    inline double stream_window() const noexcept override { return _stream.window(); }
     Q_SLOT virtual void set_color_data(SciQLopPyBuffer values, ::ColorGradient gradient = ::ColorGradient::Jet) override;
     virtual QList<SciQLopPyBuffer> data() const noexcept override;
 
@@ -68,9 +83,13 @@ public:
 
     void create_graph(const QStringList& labels);
 
+    inline bool lod_pending() const noexcept override { return _lod.pending(); }
+
 #ifndef BINDINGS_H
     void collect_visible_values(const SciQLopPlotRange& visible_key_range,
                                 std::vector<double>& out) const noexcept override;
+    bool visible_value_range(const SciQLopPlotRange& visible_key_range,
+                             SciQLopPlotRange& range) const noexcept override;
 #endif
 };
 
@@ -88,4 +107,28 @@ public:
     virtual ~SciQLopSingleLineGraphFunction() override = default;
 
     inline void invalidate_cache() noexcept override { invalidate_pipeline_cache(); }
+
+    inline void set_cache_budget(std::size_t bytes) noexcept override
+    {
+        set_pipeline_cache_budget(bytes);
+    }
+
+    inline std::size_t cache_budget() const noexcept override { return pipeline_cache_budget(); }
+
+    inline void set_prefetch_enabled(bool enabled) noexcept override
+    {
+        set_pipeline_prefetch_enabled(enabled);
+    }
+
+    inline bool prefetch_enabled() const noexcept override { return pipeline_prefetch_enabled(); }
+
+    inline void set_adaptive_rate_limit(bool enabled) noexcept override
+    {
+        set_pipeline_adaptive_rate_limit(enabled);
+    }
+
+    inline bool adaptive_rate_limit() const noexcept override
+    {
+        return pipeline_adaptive_rate_limit();
+    }
 };
@@ -43,6 +43,9 @@ public:
 
     void set_time_values(const QVector<double>& times);
     void set_color_values(const QVector<double>& values);
+    // Source row closest to t. Rows are the t of each point, which the curve
+    // resampler keeps even when it drops points.
+    std::optional<std::size_t> index_at_time(double t) const;
     std::optional<QPointF> position_at_time(double t) const;
     void set_gradient_colors(const QColor& start, const QColor& end)
     {
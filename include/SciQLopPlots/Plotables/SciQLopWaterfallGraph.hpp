@@ -86,6 +86,30 @@ public:
     ~SciQLopWaterfallGraphFunction() override = default;
 
     inline void invalidate_cache() noexcept override { invalidate_pipeline_cache(); }
+
+    inline void set_cache_budget(std::size_t bytes) noexcept override
+    {
+        set_pipeline_cache_budget(bytes);
+    }
+
+    inline std::size_t cache_budget() const noexcept override { return pipeline_cache_budget(); }
+
+    inline void set_prefetch_enabled(bool enabled) noexcept override
+    {
+        set_pipeline_prefetch_enabled(enabled);
+    }
+
+    inline bool prefetch_enabled() const noexcept override { return pipeline_prefetch_enabled(); }
+
+    inline void set_adaptive_rate_limit(bool enabled) noexcept override
+    {
+        set_pipeline_adaptive_rate_limit(enabled);
+    }
+
+    inline bool adaptive_rate_limit() const noexcept override
+    {
+        return pipeline_adaptive_rate_limit();
+    }
 };
 
 class SciQLopWaterfallGraphRemote : public SciQLopWaterfallGraph,
@@ -0,0 +1,84 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "SciQLopPlots/Python/PythonInterface.hpp"
+
+#include <cstddef>
+#include <memory>
+
+// Append-only key/value storage behind a line graph's append_data(). Rows
+// live in a fixed-capacity block and an append only writes past the rows
+// already published, so the data sources built over earlier snapshots stay
+// valid while the render thread reads them. A full block is replaced by one
+// twice as large (live rows copied once), which keeps appends amortised
+// O(new rows). With a window, rows older than last key - window are dropped
+// by moving the first row forward; their space goes at the next block
+// replacement, forced early once the dropped rows outnumber the live ones.
+class StreamingSeries
+{
+    struct Block;
+
+    std::shared_ptr<Block> m_block;
+    std::size_t m_first = 0;
+    std::size_t m_end = 0;
+    std::size_t m_dropped = 0;
+    std::size_t m_columns = 0;
+    std::size_t m_item_size = 0;
+    char m_format = '\0';
+    bool m_flat_values = true;
+    double m_window = 0.;
+
+    void _reallocate(std::size_t capacity);
+    void _reserve(std::size_t rows);
+    void _trim();
+
+public:
+    struct Snapshot
+    {
+        SciQLopPyBuffer x;
+        SciQLopPyBuffer y;
+        // Rows dropped by the window since the last clear(): two snapshots
+        // with the same first_row share their common rows at the same index.
+        std::size_t first_row = 0;
+    };
+
+    StreamingSeries();
+    ~StreamingSeries();
+
+    // Appends the rows of (x, y); y is 1D or (n, columns). Throws
+    // std::invalid_argument when y's dtype or column count differs from the
+    // rows already held or when x starts before the last key. Returns the
+    // whole (windowed) series as buffers over the storage; no rows are copied.
+    Snapshot append(const SciQLopPyBuffer& x, const SciQLopPyBuffer& y);
+
+    // Drops every row; the next append fixes dtype and column count again.
+    void clear();
+
+    // Keep only rows within `window` key units of the last key; <= 0 keeps
+    // everything.
+    void set_window(double window);
+    inline double window() const noexcept { return m_window; }
+
+    inline std::size_t size() const noexcept { return m_end - m_first; }
+    inline bool empty() const noexcept { return m_end == m_first; }
+    Snapshot snapshot() const;
+};
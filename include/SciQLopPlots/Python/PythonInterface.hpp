@@ -21,10 +21,13 @@
 ----------------------------------------------------------------------------*/
 #pragma once
 
+#include "SciQLopPlots/DataProducer/CancellationToken.hpp"
+
 #include <cassert>
 #include <cmath>
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <vector>
@@ -275,6 +278,14 @@ public:
     SciQLopPyBuffer(SciQLopPyBuffer&& other) noexcept;
     explicit SciQLopPyBuffer(PyObject* obj);
 
+    // A C-contiguous buffer over memory that doesn't come from Python (e.g. a
+    // shared-memory slot); no Python object is made until py_object() asks
+    // for one. `format` is a struct module code ('d', 'f', 'q', ...). `owner`
+    // is held by every buffer sharing this memory (including slice_rows()
+    // views and the Python object); its deleter is the release hook.
+    static SciQLopPyBuffer from_memory(void* data, std::vector<std::size_t> shape, char format,
+                                       std::size_t item_size, std::shared_ptr<void> owner);
+
     ~SciQLopPyBuffer();
 
     SciQLopPyBuffer& operator=(const SciQLopPyBuffer& other);
@@ -339,6 +350,14 @@ public:
     }
 
     PyObject* py_object() const;
+
+    // Rows [first, last) as a view on the same Python object (no copy); an
+    // invalid buffer when the exporter can't slice it contiguously.
+    SciQLopPyBuffer slice_rows(std::size_t first, std::size_t last) const;
+
+    // A new C-contiguous numpy array with this buffer's dtype and trailing
+    // shape and n_rows rows, uninitialised; an invalid buffer on failure.
+    SciQLopPyBuffer empty_like(std::size_t n_rows) const;
 };
 
 namespace std
@@ -380,6 +399,18 @@ public:
     void release();
 
     std::vector<SciQLopPyBuffer> get_data(double lower, double upper);
+    // Called with the GIL held for every preview a progressive callable
+    // yields before its full-resolution answer; 0 is full resolution, larger
+    // levels are coarser.
+    using PreviewCallback = std::function<void(int level, const std::vector<SciQLopPyBuffer>&)>;
+
+    // Callables taking a `cancellation_token` argument receive a function
+    // returning True once `token` is cancelled. A callable returning a
+    // generator yields previews, `(level, answer)` or a bare answer (level
+    // 1), and returns the full-resolution answer.
+    std::vector<SciQLopPyBuffer> get_data(double lower, double upper,
+                                          const CancellationToken& token,
+                                          const PreviewCallback& on_preview = {});
     std::vector<SciQLopPyBuffer> get_data(SciQLopPyBuffer x, SciQLopPyBuffer y);
     std::vector<SciQLopPyBuffer> get_data(SciQLopPyBuffer x, SciQLopPyBuffer y, SciQLopPyBuffer z);
 };
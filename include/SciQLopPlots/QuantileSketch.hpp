@@ -0,0 +1,79 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "SciQLopPlots/Python/PythonInterface.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sciqlop::percentile
+{
+struct WeightedValue;
+
+// Mergeable quantile summary of a 2D dataset whose rows follow a sorted key
+// (time). Rows are cut into at most max_blocks blocks; each block keeps
+// samples_per_block evenly ranked order statistics of its finite values, each
+// weighing the values it stands for. Any visible key window then merges the
+// samples of the blocks it fully covers, reads the rest exactly, and gets
+// cutoffs within rank_error of the exact ones, as a fraction of the values
+// in the window.
+class QuantileSketch
+{
+public:
+    static constexpr std::size_t samples_per_block = 512;
+    static constexpr std::size_t max_blocks = 1024;
+    static constexpr std::size_t min_block_values = std::size_t { 1 } << 16;
+    // Below this many values the exact nth_element path is just as fast.
+    static constexpr std::size_t min_values = std::size_t { 1 } << 21;
+    static constexpr double rank_error = 0.5 / samples_per_block;
+
+    struct Input
+    {
+        // 1D, or (rows, columns) in any layout.
+        SciQLopPyBuffer values;
+        std::size_t rows = 0;
+    };
+
+    // Blocking build, meant for a worker thread. Throws std::invalid_argument
+    // on an unsupported dtype.
+    static std::shared_ptr<const QuantileSketch> build(const Input& input);
+
+    inline std::size_t rows() const noexcept { return m_rows; }
+    inline std::size_t block_rows() const noexcept { return m_block_rows; }
+
+    // Appends the samples of every block that lies entirely in rows
+    // [first, last) and returns the rows they cover. The caller reads
+    // [first, covered.first) and [covered.second, last) exactly: less than
+    // two blocks of rows in total.
+    std::pair<std::size_t, std::size_t> collect(std::size_t first, std::size_t last,
+                                                std::vector<WeightedValue>& out) const;
+
+private:
+    std::size_t m_rows = 0;
+    std::size_t m_block_rows = 0;
+    // Samples of block b are m_samples[m_offsets[b] .. m_offsets[b + 1]).
+    std::vector<std::size_t> m_offsets;
+    std::vector<WeightedValue> m_samples;
+};
+}
@@ -56,6 +56,10 @@ class SciQLopPlot : public QCustomPlot
     QList<SciQLopPlotAxis*> m_axes;
     QElapsedTimer m_hover_throttle_timer;
     bool m_suppress_range_signals = false;
+    // Set while a panel RenderScheduler owns this plot: queued replots only
+    // mark the plot dirty and the scheduler decides when (and whether) to render.
+    bool m_deferred_rendering = false;
+    bool m_render_pending = false;
 
     QList<SciQLopPlottableInterface*> m_plottables;
     SciQLopColorMap* m_color_map = nullptr;
@@ -75,6 +79,7 @@ signals:
     Q_SIGNAL void plotables_list_changed();
     Q_SIGNAL void resized(QSize size);
     Q_SIGNAL void hover_x_changed(double key);
+    Q_SIGNAL void render_requested();
 
 public:
     explicit SciQLopPlot(QWidget* parent = nullptr);
@@ -176,6 +181,18 @@ public:
 
     void replot(QCustomPlot::RefreshPriority priority = rpImmediateRefresh);
 
+    inline void set_deferred_rendering(bool deferred) noexcept
+    {
+        m_deferred_rendering = deferred;
+    }
+
+    inline bool deferred_rendering() const noexcept { return m_deferred_rendering; }
+
+    inline bool render_pending() const noexcept { return m_render_pending; }
+
+    // Renders now, bypassing the scheduler; clears the dirty flag.
+    void render_now();
+
     void set_crosshair_enabled(bool enabled);
     bool crosshair_enabled() const;
     void show_crosshair_at_key(double key);
@@ -226,6 +243,16 @@ protected:
 
     int _minimal_margin(QCP::MarginSide side);
 };
+
+// Queued replot for code only holding the QCustomPlot: goes through
+// SciQLopPlot::replot so a panel render scheduler can defer or cull it.
+inline void queue_replot(QCustomPlot* plot)
+{
+    if (auto* p = qobject_cast<SciQLopPlot*>(plot))
+        p->replot(QCustomPlot::rpQueuedReplot);
+    else if (plot)
+        plot->replot(QCustomPlot::rpQueuedReplot);
+}
 }
 
 /*!
@@ -436,6 +463,9 @@ public:
 
     void replot(bool immediate = false) override;
 
+    // True while a queued replot waits for the panel's render scheduler.
+    inline bool render_pending() const noexcept { return m_impl->render_pending(); }
+
 
     virtual SciQLopPlottableInterface* plottable(int index = -1) override;
     virtual SciQLopPlottableInterface* plottable(const QString& name) override;
@@ -270,6 +270,7 @@ class SciQLopPlotAxis : public SciQLopPlotAxisInterface
     bool m_suppress_range_signals = false;
     double m_autoscale_percentile_low = 0.;
     double m_autoscale_percentile_high = 100.;
+    double m_autoscale_percentile_error = 1e-3;
     friend class _impl::SciQLopPlot;
 
 public:
@@ -281,6 +282,13 @@ public:
     void set_autoscale_percentile_high(double percentile) noexcept;
     inline double autoscale_percentile_low() const noexcept { return m_autoscale_percentile_low; }
     inline double autoscale_percentile_high() const noexcept { return m_autoscale_percentile_high; }
+    // Largest rank error (fraction of the visible values) the percentile
+    // autoscale accepts from graphs' quantile sketches; 0 always scans exactly.
+    void set_autoscale_percentile_error(double error) noexcept;
+    inline double autoscale_percentile_error() const noexcept
+    {
+        return m_autoscale_percentile_error;
+    }
 
     void set_range(const SciQLopPlotRange& range) noexcept override;
     void set_visible(bool visible) noexcept override;
@@ -86,6 +86,16 @@ enum class WaterfallOffsetMode
 };
 Q_DECLARE_METATYPE(WaterfallOffsetMode);
 
+// Reduction used by a colormap's level-of-detail pyramid; Off draws the raw
+// cells at every zoom level.
+enum class ColorMapLod
+{
+    Off,
+    Mean,
+    Max
+};
+Q_DECLARE_METATYPE(ColorMapLod);
+
 enum class PlotType
 {
     BasicXY,
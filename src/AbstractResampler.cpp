@@ -25,6 +25,7 @@
 void AbstractResampler1d::_async_resample()
 {
     PROFILE_HERE_N("resample.async_1d");
+    _resample_pending = false;
     _async_resample_callback();
 }
 
@@ -42,7 +43,8 @@ void AbstractResampler1d::resample(const QCPRange new_range)
 {
     PROFILE_HERE_N("resample.dispatch_1d");
     this->set_next_plot_range(new_range);
-    emit _resample_sig();
+    if (!_resample_pending.exchange(true))
+        emit _resample_sig();
 }
 
 void AbstractResampler2d::_async_resample()
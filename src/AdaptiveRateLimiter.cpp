@@ -0,0 +1,70 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#include "SciQLopPlots/DataProducer/AdaptiveRateLimiter.hpp"
+
+#include <algorithm>
+
+namespace
+{
+constexpr double smoothing = 0.3;
+
+double moving_average(double average, double sample)
+{
+    return average < 0. ? sample : average + smoothing * (sample - average);
+}
+} // namespace
+
+AdaptiveRateLimiter::milliseconds AdaptiveRateLimiter::on_request(clock::time_point now) noexcept
+{
+    if (m_has_last_request)
+    {
+        const auto gap = milliseconds(now - m_last_request).count();
+        m_interval_ms = gap < gesture_gap_ms ? moving_average(m_interval_ms, gap) : -1.;
+    }
+    m_has_last_request = true;
+    m_last_request = now;
+    if (!m_waiting)
+    {
+        m_waiting = true;
+        m_first_waiting = now;
+    }
+    if (!m_adaptive || m_latency_ms < 0.)
+        return milliseconds(fixed_delay_ms);
+
+    auto quiet = std::clamp(m_latency_ms / 2., min_delay_ms, max_quiet_ms);
+    if (m_interval_ms < 0. || m_interval_ms > quiet)
+        quiet = min_delay_ms;
+    const auto left = max_wait().count() - milliseconds(now - m_first_waiting).count();
+    return milliseconds(std::max(0., std::min(quiet, left)));
+}
+
+AdaptiveRateLimiter::milliseconds AdaptiveRateLimiter::max_wait() const noexcept
+{
+    if (!m_adaptive || m_latency_ms < 0.)
+        return milliseconds(min_max_wait_ms);
+    return milliseconds(std::clamp(2. * m_latency_ms, min_max_wait_ms, max_max_wait_ms));
+}
+
+void AdaptiveRateLimiter::on_answer(milliseconds latency) noexcept
+{
+    m_latency_ms = moving_average(m_latency_ms, latency.count());
+}
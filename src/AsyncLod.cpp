@@ -0,0 +1,78 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#include "SciQLopPlots/Plotables/AsyncLod.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace
+{
+class BuildQueue
+{
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::function<void()>> m_tasks;
+    std::thread m_thread;
+
+    void _loop()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock lock { m_mutex };
+                m_wake.wait(lock, [this] { return !m_tasks.empty(); });
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+public:
+    BuildQueue() : m_thread([this] { _loop(); }) { }
+
+    void push(std::function<void()> task)
+    {
+        {
+            std::lock_guard lock { m_mutex };
+            m_tasks.push_back(std::move(task));
+        }
+        m_wake.notify_one();
+    }
+};
+
+// Never destroyed: joining at static destruction time could run after the
+// interpreter owning the queued buffers is gone.
+BuildQueue& build_queue()
+{
+    static auto* queue = new BuildQueue;
+    return *queue;
+}
+
+}
+
+void post_lod_build(std::function<void()> task)
+{
+    build_queue().push(std::move(task));
+}
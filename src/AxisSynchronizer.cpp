@@ -23,6 +23,9 @@
 #include "SciQLopPlots/MultiPlots/AxisSynchronizer.hpp"
 #include "SciQLopPlots/MultiPlots/SciQLopPlotPanelInterface.hpp"
 
+#include <algorithm>
+#include <utility>
+
 void _set_axis_range(const SciQLopPlotRange& range, const QPointer<SciQLopPlotInterface>& plot,
                      AxisType m_sync_axis)
 {
@@ -30,6 +33,15 @@ void _set_axis_range(const SciQLopPlotRange& range, const QPointer<SciQLopPlotIn
         axis->set_range(range);
 }
 
+AxisSynchronizer::AxisSynchronizer(AxisType axis, QObject* parent)
+        : SciQLopPlotCollectionBehavior(parent), m_sync_axis { axis }
+{
+    m_frame_timer = new QTimer(this);
+    m_frame_timer->setSingleShot(true);
+    m_frame_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_frame_timer, &QTimer::timeout, this, &AxisSynchronizer::flush);
+}
+
 void AxisSynchronizer::updatePlotList(const QList<QPointer<SciQLopPlotInterface>>& plots)
 {
     SciQLopPlotCollectionBehavior::_update_collection(
@@ -38,19 +50,20 @@ void AxisSynchronizer::updatePlotList(const QList<QPointer<SciQLopPlotInterface>
         {
             if (auto axis = plot->axis(this->m_sync_axis))
                 connect(axis, &SciQLopPlotAxisInterface::range_changed, this,
-                        &AxisSynchronizer::set_axis_range);
+                        &AxisSynchronizer::_schedule_range);
         },
         [this](SciQLopPlotInterface* plot)
         {
             if (auto axis = plot->axis(this->m_sync_axis))
                 disconnect(axis, &SciQLopPlotAxisInterface::range_changed, this,
-                           &AxisSynchronizer::set_axis_range);
+                           &AxisSynchronizer::_schedule_range);
         });
 }
 
 
 void AxisSynchronizer::plotAdded(SciQLopPlotInterface* plot)
 {
+    flush();
     _set_axis_range(_last_range, plot, m_sync_axis);
 }
 
@@ -58,9 +71,10 @@ void AxisSynchronizer::panelAdded(SciQLopPlotPanelInterface* panel)
 {
     if (this->m_sync_axis == AxisType::TimeAxis)
     {
+        flush();
         panel->set_time_axis_range(_last_range);
         connect(panel, &SciQLopPlotPanelInterface::time_range_changed, this,
-                &AxisSynchronizer::set_axis_range);
+                &AxisSynchronizer::_schedule_range);
     }
 }
 
@@ -68,10 +82,41 @@ void AxisSynchronizer::panelRemoved(SciQLopPlotPanelInterface* panel)
 {
     if (this->m_sync_axis == AxisType::TimeAxis)
         disconnect(panel, &SciQLopPlotPanelInterface::time_range_changed, this,
-                   &AxisSynchronizer::set_axis_range);
+                   &AxisSynchronizer::_schedule_range);
 }
 
 void AxisSynchronizer::set_axis_range(const SciQLopPlotRange& range)
+{
+    m_frame_timer->stop();
+    _pending_range = SciQLopPlotRange {};
+    _propagate(range);
+}
+
+void AxisSynchronizer::flush()
+{
+    m_frame_timer->stop();
+    if (!_pending_range.is_valid())
+        return;
+    const auto range = std::exchange(_pending_range, SciQLopPlotRange {});
+    m_last_frame.start();
+    _propagate(range);
+}
+
+// The first range after an idle period goes out on the next event-loop pass;
+// anything arriving within the same frame only overwrites _pending_range.
+void AxisSynchronizer::_schedule_range(const SciQLopPlotRange& range)
+{
+    if (m_propagating || range.is_valid() == false)
+        return;
+    _pending_range = range;
+    if (!m_frame_timer->isActive())
+    {
+        const auto since_last = m_last_frame.isValid() ? m_last_frame.elapsed() : frame_interval_ms;
+        m_frame_timer->start(static_cast<int>(std::max<qint64>(0, frame_interval_ms - since_last)));
+    }
+}
+
+void AxisSynchronizer::_propagate(const SciQLopPlotRange& range)
 {
     if (m_propagating || range == _last_range || range.is_valid() == false)
         return;
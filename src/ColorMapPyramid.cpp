@@ -0,0 +1,183 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#include "SciQLopPlots/Plotables/ColorMapPyramid.hpp"
+#include "SciQLopPlots/DSP/Parallel.hpp"
+#include "SciQLopPlots/Python/DtypeDispatch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+// Mean of the finite y values of a block; geometric on a log axis as long
+// as they are all positive.
+struct YMean
+{
+    double sum = 0.;
+    double log_sum = 0.;
+    std::size_t count = 0;
+    bool positive = true;
+
+    inline void add(double v) noexcept
+    {
+        if (!std::isfinite(v))
+            return;
+        sum += v;
+        if (v > 0.)
+            log_sum += std::log(v);
+        else
+            positive = false;
+        ++count;
+    }
+
+    inline double value(bool log_y) const noexcept
+    {
+        if (count == 0)
+            return nan;
+        return (log_y && positive) ? std::exp(log_sum / count) : sum / count;
+    }
+};
+
+template <typename Y, typename Z>
+ColorMapPyramid::Level reduce(const double* x, const Y* y, const Z* z, std::size_t nx,
+                              std::size_t ny, bool y_2d, std::size_t stride, bool log_y,
+                              ColorMapLod reduction)
+{
+    constexpr auto tf = ColorMapPyramid::time_factor;
+    const std::size_t yf = (ny > ColorMapPyramid::max_channels) ? 2 : 1;
+
+    ColorMapPyramid::Level out;
+    out.nx = (nx + tf - 1) / tf;
+    out.ny = (ny + yf - 1) / yf;
+    out.y_2d = y_2d;
+    out.stride = stride * tf;
+    out.x.resize(out.nx);
+    out.y.resize(y_2d ? out.nx * out.ny : out.ny);
+    out.z.resize(out.nx * out.ny);
+
+    if (!y_2d)
+    {
+        for (std::size_t j = 0; j < out.ny; ++j)
+        {
+            YMean m;
+            for (auto c = j * yf; c < std::min(ny, (j + 1) * yf); ++c)
+                m.add(static_cast<double>(y[c]));
+            out.y[j] = m.value(log_y);
+        }
+    }
+
+    sqp::dsp::parallel_for_blocks(out.nx, 64, [&](std::size_t i0, std::size_t i1) {
+        for (auto i = i0; i < i1; ++i)
+        {
+            const auto r0 = i * tf;
+            const auto r1 = std::min(nx, r0 + tf);
+            double key_sum = 0.;
+            for (auto r = r0; r < r1; ++r)
+                key_sum += x[r];
+            out.x[i] = key_sum / static_cast<double>(r1 - r0);
+
+            for (std::size_t j = 0; j < out.ny; ++j)
+            {
+                const auto c0 = j * yf;
+                const auto c1 = std::min(ny, c0 + yf);
+                double sum = 0.;
+                double max = -std::numeric_limits<double>::infinity();
+                std::size_t count = 0;
+                YMean ym;
+                for (auto r = r0; r < r1; ++r)
+                    for (auto c = c0; c < c1; ++c)
+                    {
+                        const double v = static_cast<double>(z[r * ny + c]);
+                        if (y_2d)
+                            ym.add(static_cast<double>(y[r * ny + c]));
+                        if (!std::isfinite(v))
+                            continue;
+                        sum += v;
+                        max = std::max(max, v);
+                        ++count;
+                    }
+                const double cell = (count == 0)  ? nan
+                    : (reduction == ColorMapLod::Max) ? max
+                                                      : sum / static_cast<double>(count);
+                out.z[i * out.ny + j] = static_cast<float>(cell);
+                if (y_2d)
+                    out.y[i * out.ny + j] = ym.value(log_y);
+            }
+        }
+    });
+    return out;
+}
+
+}
+
+std::shared_ptr<const ColorMapPyramid> ColorMapPyramid::build(const Input& input)
+{
+    auto pyramid = std::make_shared<ColorMapPyramid>();
+    const auto& [x, y, z, log_y, reduction] = input;
+    if (reduction == ColorMapLod::Off || !x.is_valid() || !y.is_valid() || !z.is_valid()
+        || x.format_code() != 'd')
+        return pyramid;
+    const std::size_t nx = x.flat_size();
+    const std::size_t nz = z.flat_size();
+    if (nx < 2 || nz < min_cells || nz % nx != 0 || nx / time_factor < min_columns)
+        return pyramid;
+    const std::size_t ny = nz / nx;
+    const bool y_2d = (y.flat_size() == nz);
+    if (!y_2d && y.flat_size() != ny)
+        return pyramid;
+
+    dispatch_dtype(y.format_code(), [&](auto y_tag) {
+        dispatch_dtype(z.format_code(), [&](auto z_tag) {
+            using Y = typename decltype(y_tag)::type;
+            using Z = typename decltype(z_tag)::type;
+            pyramid->m_levels.push_back(reduce(static_cast<const double*>(x.raw_data()),
+                                               static_cast<const Y*>(y.raw_data()),
+                                               static_cast<const Z*>(z.raw_data()), nx, ny,
+                                               y_2d, 1, log_y, reduction));
+        });
+    });
+    while (pyramid->m_levels.back().nx / time_factor >= min_columns)
+    {
+        const auto& previous = pyramid->m_levels.back();
+        auto next = reduce(previous.x.data(), previous.y.data(), previous.z.data(), previous.nx,
+                           previous.ny, y_2d, previous.stride, log_y, reduction);
+        pyramid->m_levels.push_back(std::move(next));
+    }
+    return pyramid;
+}
+
+int ColorMapPyramid::level_for(std::size_t visible_columns, int pixels) const noexcept
+{
+    if (pixels <= 0)
+        return -1;
+    int best = -1;
+    for (std::size_t level = 0; level < m_levels.size(); ++level)
+    {
+        if (visible_columns / m_levels[level].stride < static_cast<std::size_t>(pixels))
+            break;
+        best = static_cast<int>(level);
+    }
+    return best;
+}
@@ -51,6 +51,8 @@ namespace
     {
         double coeffs[] = { 0.25, 0.5, 0.25 };
         [[maybe_unused]] auto fir = sqp::dsp::fir_filter<double>({ coeffs, 3 });
+        [[maybe_unused]] auto fir_fft
+            = sqp::dsp::fir_filter<double>({ coeffs, 3 }, sqp::dsp::FirMethod::FFT);
 
         double sos[] = { 1.0, 0.0, 0.0, 1.0, 0.0, 0.0 }; // passthrough
         [[maybe_unused]] auto iir = sqp::dsp::iir_sos<double>({ sos, 6 }, 1);
@@ -61,15 +63,46 @@ namespace
         [[maybe_unused]] auto stage = sqp::dsp::fft_stage<double>();
     }
 
+    // Averaged spectra
+    {
+        double x[] = { 1.0, 2.0, 3.0, 4.0 };
+        double y[] = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0 };
+        auto segs = sqp::dsp::split_segments<double>({ x, 4 }, { y, 8 }, 2);
+        [[maybe_unused]] auto psd = sqp::dsp::welch(segs, 4);
+        [[maybe_unused]] auto mt = sqp::dsp::multitaper(segs, 4, 0, 1.5);
+        [[maybe_unused]] auto c = sqp::dsp::coherence(sqp::dsp::csd(segs, 0, 1, 4));
+    }
+
     // Stats
     {
         [[maybe_unused]] auto rm = sqp::dsp::rolling_mean<double>(5);
         [[maybe_unused]] auto rs = sqp::dsp::rolling_std<double>(5);
+        [[maybe_unused]] auto bs = sqp::dsp::block_stats(std::vector<sqp::dsp::Segment<float>> {});
     }
 
     // Reduce
     {
         [[maybe_unused]] auto r = sqp::dsp::reduce<double>(sqp::dsp::ReduceOp::Sum);
     }
+
+    // Streaming filter
+    {
+        double x[] = { 1.0, 2.0, 3.0 };
+        double y[] = { 1.0, 2.0, 3.0 };
+        double sos[] = { 1.0, 0.0, 0.0, 1.0, 0.0, 0.0 };
+        sqp::dsp::StreamingFilter<double> flt { sqp::dsp::iir_sos<double>({ sos, 6 }, 1), 1 };
+        [[maybe_unused]] auto out = flt.push({ x, 3 }, { y, 3 });
+    }
+
+    // Fused pipeline
+    {
+        double x[] = { 1.0, 2.0, 3.0 };
+        float y[] = { 1.0f, 2.0f, 3.0f };
+        float coeffs[] = { 0.5f, 0.5f };
+        std::vector<sqp::dsp::Stage<float>> stages { sqp::dsp::fir_filter<float>({ coeffs, 2 }),
+            sqp::dsp::rolling_mean<float>(3), sqp::dsp::filtfilt<float>({ coeffs, 2 }),
+            sqp::dsp::interpolate_nan_stage<float>() };
+        [[maybe_unused]] auto ts = sqp::dsp::run_pipeline<float>({ x, 3 }, { y, 3 }, 1, stages);
+    }
 }
 } // anonymous namespace
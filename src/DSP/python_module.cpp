@@ -34,11 +34,15 @@
 
 #include <algorithm>
 #include <cmath>
+#include <complex>
 #include <cstdint>
 #include <cstring>
 #include <exception>
+#include <memory>
+#include <mutex>
 #include <span>
 #include <type_traits>
+#include <variant>
 #include <vector>
 
 namespace
@@ -349,6 +353,22 @@ bool check_window_size(Py_ssize_t window, Py_ssize_t nrows, const char* func_nam
     return true;
 }
 
+bool check_spectral_window(Py_ssize_t window_size, Py_ssize_t overlap, const char* func_name)
+{
+    if (window_size < 2)
+    {
+        PyErr_Format(PyExc_ValueError, "%s: window_size must be >= 2", func_name);
+        return false;
+    }
+    if (overlap < 0 || overlap >= window_size)
+    {
+        PyErr_Format(PyExc_ValueError, "%s: overlap (%zd) must be in [0, window_size=%zd)",
+            func_name, overlap, window_size);
+        return false;
+    }
+    return true;
+}
+
 bool check_sos_a0(YArray& sos)
 {
     // Check that no a0 coefficient is zero (would cause division by zero)
@@ -378,6 +398,22 @@ bool check_sos_a0(YArray& sos)
     return true;
 }
 
+bool check_resample_size(XArray& x, double target_dt)
+{
+    if (target_dt > 0.0 && x.nrows >= 2)
+    {
+        const double span = x.data[x.nrows - 1] - x.data[0];
+        const double n_out_f = std::floor(span / target_dt) + 1.0;
+        if (n_out_f > 100'000'000.0)
+        {
+            PyErr_SetString(PyExc_ValueError,
+                "resample: output would exceed 100M samples, target_dt is too small");
+            return false;
+        }
+    }
+    return true;
+}
+
 // ── Dtype dispatch ───────────────────────────────────────────────────────────
 
 // Dispatch a generic lambda on the y array's dtype.
@@ -401,6 +437,16 @@ PyObject* dispatch(int dtype, F&& f)
 
 // ── Common pipeline helper ───────────────────────────────────────────────────
 
+// Tiled loop over one gap-free series, for the has_gaps=False fast paths.
+template <typename F>
+void for_each_tile(
+    std::size_t nrows, std::size_t ncols, sqp::dsp::TileSplit split, std::size_t cost, F&& f)
+{
+    const sqp::dsp::TileExtent extent { nrows, ncols };
+    sqp::dsp::parallel_for_tiles(
+        std::span<const sqp::dsp::TileExtent>(&extent, 1), split, cost, std::forward<F>(f));
+}
+
 template <typename T>
 PyObject* apply_stage(
     XArray& x, YArray& y, double gap_factor, bool has_gaps, const sqp::dsp::Stage<T>& stage)
@@ -429,6 +475,24 @@ PyObject* apply_stage(
     return timeseries_to_tuple(ts);
 }
 
+// Segments of (x, y): split at gaps, or the whole series with the first dt as
+// sample period when the caller guarantees there are none (skips median_dt).
+template <typename T>
+std::vector<sqp::dsp::Segment<T>> make_segments(
+    XArray& x, YArray& y, double gap_factor, bool has_gaps)
+{
+    if (has_gaps)
+        return sqp::dsp::split_segments<T>(
+            x.span(), y.flat_span<T>(), static_cast<std::size_t>(y.ncols), gap_factor);
+    const double dt = (x.nrows >= 2) ? (x.data[1] - x.data[0]) : 1.0;
+    return { sqp::dsp::Segment<T> {
+        .x = x.span(),
+        .y = y.flat_span<T>(),
+        .n_cols = static_cast<std::size_t>(y.ncols),
+        .median_dt = dt,
+    } };
+}
+
 // ── Enum parsers ─────────────────────────────────────────────────────────────
 
 sqp::dsp::WindowType parse_window_type(const char* s)
@@ -457,6 +521,237 @@ sqp::dsp::ReduceOp parse_reduce_op(const char* s)
     return sqp::dsp::ReduceOp::Sum;
 }
 
+bool parse_fir_method(const char* s, sqp::dsp::FirMethod& method)
+{
+    if (std::strcmp(s, "auto") == 0)
+        method = sqp::dsp::FirMethod::Auto;
+    else if (std::strcmp(s, "direct") == 0)
+        method = sqp::dsp::FirMethod::Direct;
+    else if (std::strcmp(s, "fft") == 0)
+        method = sqp::dsp::FirMethod::FFT;
+    else
+    {
+        PyErr_Format(PyExc_ValueError, "method must be 'auto', 'direct' or 'fft', got '%s'", s);
+        return false;
+    }
+    return true;
+}
+
+// ── Pipeline stage specs ─────────────────────────────────────────────────────
+//
+// pipeline() takes its stages as (name, param) tuples. They are parsed and
+// validated with the GIL held, then turned into sqp::dsp::Stage<T> once the
+// y dtype is known.
+
+enum class StageKind
+{
+    InterpolateNan,
+    Resample,
+    FirFilter,
+    Filtfilt,
+    IirSos,
+    Sosfiltfilt,
+    RollingMean,
+    RollingStd,
+    Reduce,
+};
+
+struct StageSpec
+{
+    StageKind kind = StageKind::Resample;
+    std::unique_ptr<YArray> coeffs; // taps or (n_sections, 6) SOS matrix
+    double target_dt = 0.0;
+    std::size_t count = 0; // window or max_consecutive
+    sqp::dsp::ReduceOp op = sqp::dsp::ReduceOp::Sum;
+    sqp::dsp::FirMethod fir_method = sqp::dsp::FirMethod::Auto;
+};
+
+bool parse_stage_kind(const char* name, StageKind& kind)
+{
+    static constexpr std::pair<const char*, StageKind> kinds[] = {
+        { "interpolate_nan", StageKind::InterpolateNan },
+        { "resample", StageKind::Resample },
+        { "fir_filter", StageKind::FirFilter },
+        { "filtfilt", StageKind::Filtfilt },
+        { "iir_sos", StageKind::IirSos },
+        { "sosfiltfilt", StageKind::Sosfiltfilt },
+        { "rolling_mean", StageKind::RollingMean },
+        { "rolling_std", StageKind::RollingStd },
+        { "reduce", StageKind::Reduce },
+    };
+    for (const auto& [n, k] : kinds)
+    {
+        if (std::strcmp(name, n) == 0)
+        {
+            kind = k;
+            return true;
+        }
+    }
+    PyErr_Format(PyExc_ValueError, "pipeline: unknown stage '%s'", name);
+    return false;
+}
+
+bool parse_stage_param(PyObject* param, const char* name, int dtype, XArray& x, StageSpec& spec)
+{
+    switch (spec.kind)
+    {
+        case StageKind::InterpolateNan:
+        case StageKind::RollingMean:
+        case StageKind::RollingStd:
+        {
+            const auto n = PyLong_AsSsize_t(param);
+            if (n == -1 && PyErr_Occurred())
+                return false;
+            if (n <= 0)
+            {
+                PyErr_Format(PyExc_ValueError, "pipeline: %s parameter must be > 0, got %zd",
+                    name, n);
+                return false;
+            }
+            spec.count = static_cast<std::size_t>(n);
+            return true;
+        }
+        case StageKind::Resample:
+            spec.target_dt = PyFloat_AsDouble(param);
+            if (spec.target_dt == -1.0 && PyErr_Occurred())
+                return false;
+            return check_resample_size(x, spec.target_dt);
+        case StageKind::Reduce:
+        {
+            const char* op = PyUnicode_AsUTF8(param);
+            if (!op)
+                return false;
+            spec.op = parse_reduce_op(op);
+            return true;
+        }
+        case StageKind::FirFilter:
+        case StageKind::Filtfilt:
+        case StageKind::IirSos:
+        case StageKind::Sosfiltfilt:
+        {
+            spec.coeffs = std::make_unique<YArray>();
+            auto& c = *spec.coeffs;
+            if (!c.parse(param))
+                return false;
+            if (c.dtype != dtype)
+            {
+                PyErr_Format(PyExc_TypeError, "pipeline: %s coefficients must match y dtype", name);
+                return false;
+            }
+            const bool is_sos = spec.kind == StageKind::IirSos
+                || spec.kind == StageKind::Sosfiltfilt;
+            if (is_sos)
+            {
+                if (c.ncols != 6)
+                {
+                    PyErr_SetString(
+                        PyExc_ValueError, "SOS matrix must have 6 columns [b0,b1,b2,a0,a1,a2]");
+                    return false;
+                }
+                return check_sos_a0(c);
+            }
+            if (c.nrows < 1)
+            {
+                PyErr_SetString(PyExc_ValueError, "coeffs must have at least 1 tap");
+                return false;
+            }
+            return true;
+        }
+    }
+    return true;
+}
+
+bool parse_stage_specs(PyObject* stages_obj, int dtype, XArray& x, std::vector<StageSpec>& specs)
+{
+    PyObject* seq = PySequence_Fast(stages_obj, "stages must be a sequence of (name, param)");
+    if (!seq)
+        return false;
+    const auto n = PySequence_Fast_GET_SIZE(seq);
+    specs.resize(static_cast<std::size_t>(n));
+    for (Py_ssize_t i = 0; i < n; ++i)
+    {
+        PyObject* item = PySequence_Fast_GET_ITEM(seq, i);
+        if (!PyTuple_Check(item) || PyTuple_GET_SIZE(item) != 2)
+        {
+            PyErr_Format(PyExc_TypeError, "pipeline: stage %zd must be a (name, param) tuple", i);
+            Py_DECREF(seq);
+            return false;
+        }
+        const char* name = PyUnicode_AsUTF8(PyTuple_GET_ITEM(item, 0));
+        auto& spec = specs[static_cast<std::size_t>(i)];
+        if (!name || !parse_stage_kind(name, spec.kind)
+            || !parse_stage_param(PyTuple_GET_ITEM(item, 1), name, dtype, x, spec))
+        {
+            Py_DECREF(seq);
+            return false;
+        }
+    }
+    Py_DECREF(seq);
+    return true;
+}
+
+template <typename T>
+sqp::dsp::Stage<T> build_stage(const StageSpec& spec)
+{
+    auto coeffs = [&]() -> std::span<const T>
+    {
+        const auto& c = *spec.coeffs;
+        return { c.typed_data<T>(), static_cast<std::size_t>(c.nrows * c.ncols) };
+    };
+    const auto n_sections = [&] { return static_cast<std::size_t>(spec.coeffs->nrows); };
+
+    switch (spec.kind)
+    {
+        case StageKind::InterpolateNan:
+            return sqp::dsp::interpolate_nan_stage<T>(spec.count);
+        case StageKind::Resample:
+            return sqp::dsp::resample_uniform<T>(spec.target_dt);
+        case StageKind::FirFilter:
+            return sqp::dsp::fir_filter<T>(coeffs(), spec.fir_method);
+        case StageKind::Filtfilt:
+            return sqp::dsp::filtfilt<T>(coeffs(), spec.fir_method);
+        case StageKind::IirSos:
+            return sqp::dsp::iir_sos<T>(coeffs(), n_sections());
+        case StageKind::Sosfiltfilt:
+            return sqp::dsp::sosfiltfilt<T>(coeffs(), n_sections());
+        case StageKind::RollingMean:
+            return sqp::dsp::rolling_mean<T>(spec.count);
+        case StageKind::RollingStd:
+            return sqp::dsp::rolling_std<T>(spec.count);
+        case StageKind::Reduce:
+            return sqp::dsp::reduce<T>(spec.op);
+    }
+    return {};
+}
+
+// ── FFT setup cache counters ─────────────────────────────────────────────────
+//
+// The cache lives in the header-only DSP library, which does not depend on the
+// tracer. SciQLopPlots.dsp installs tracing.counter() as the sink; the hit and
+// miss totals are handed to it, GIL held, after each call that used the cache.
+
+PyObject* counter_sink = nullptr;
+
+void publish_fft_cache_counters()
+{
+    if (!counter_sink)
+        return;
+    const auto stats = sqp::dsp::fft_cache_stats();
+    const std::pair<const char*, std::uint64_t> counters[] = {
+        { "dsp.fft_cache.hits", stats.hits },
+        { "dsp.fft_cache.misses", stats.misses },
+    };
+    for (const auto& [name, value] : counters)
+    {
+        PyObject* res = PyObject_CallFunction(
+            counter_sink, "sds", name, static_cast<double>(value), "dsp");
+        // A failing sink must not turn a computed result into an error
+        if (!res)
+            PyErr_WriteUnraisable(counter_sink);
+        Py_XDECREF(res);
+    }
+}
+
 // ── Module functions ─────────────────────────────────────────────────────────
 
 PyObject* dsp_split_segments(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
@@ -568,17 +863,8 @@ PyObject* dsp_resample(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
     if (!check_xy_sizes(x, y) || !check_gap_factor(gap_factor))
         return nullptr;
 
-    if (target_dt > 0.0 && x.nrows >= 2)
-    {
-        const double span = x.data[x.nrows - 1] - x.data[0];
-        const double n_out_f = std::floor(span / target_dt) + 1.0;
-        if (n_out_f > 100'000'000.0)
-        {
-            PyErr_SetString(PyExc_ValueError,
-                "resample: output would exceed 100M samples, target_dt is too small");
-            return nullptr;
-        }
-    }
+    if (!check_resample_size(x, target_dt))
+        return nullptr;
 
     return dispatch(y.dtype, [&]<typename T>() -> PyObject*
     {
@@ -638,14 +924,14 @@ PyObject* dsp_resample(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
             for (npy_intp i = 0; i < n_out; ++i)
                 x_out_ptr[i] = x_start + static_cast<double>(i) * dt;
 
-            for (std::size_t col = 0; col < ncols; ++col)
-            {
-                sqp::dsp::detail::interp_column(
-                    x.data, y.typed_data<T>(),
-                    static_cast<std::size_t>(x.nrows), ncols, col,
-                    x_out_ptr, y_out_ptr,
-                    static_cast<std::size_t>(n_out), ncols);
-            }
+            for_each_tile(static_cast<std::size_t>(n_out), ncols, sqp::dsp::TileSplit::Both, 2,
+                [&](const sqp::dsp::Tile& tile) {
+                    for (std::size_t col = tile.col_begin; col < tile.col_end; ++col)
+                        sqp::dsp::detail::interp_column(x.data, y.typed_data<T>(),
+                            static_cast<std::size_t>(x.nrows), ncols, col, x_out_ptr, y_out_ptr,
+                            static_cast<std::size_t>(n_out), ncols, tile.row_begin,
+                            tile.row_end);
+                });
             SQDSP_GIL_RELEASE_END
 
             auto* tuple = PyTuple_Pack(2, x_out_obj, y_out_obj);
@@ -665,11 +951,16 @@ PyObject* dsp_fir_filter(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
     PyObject* coeffs_obj = nullptr;
     double gap_factor = 3.0;
     int has_gaps = 1;
+    const char* method_str = "auto";
 
-    static const char* kwlist[] = { "x", "y", "coeffs", "gap_factor", "has_gaps", nullptr };
+    static const char* kwlist[]
+        = { "x", "y", "coeffs", "gap_factor", "has_gaps", "method", nullptr };
     if (!PyArg_ParseTupleAndKeywords(
-            args, kwargs, "OOO|dp", const_cast<char**>(kwlist), &x_obj, &y_obj, &coeffs_obj,
-            &gap_factor, &has_gaps))
+            args, kwargs, "OOO|dps", const_cast<char**>(kwlist), &x_obj, &y_obj, &coeffs_obj,
+            &gap_factor, &has_gaps, &method_str))
+        return nullptr;
+    sqp::dsp::FirMethod method;
+    if (!parse_fir_method(method_str, method))
         return nullptr;
 
     XArray x;
@@ -700,15 +991,19 @@ PyObject* dsp_fir_filter(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
             const auto nrows = static_cast<std::size_t>(y.nrows);
             const auto ncols = static_cast<std::size_t>(y.ncols);
             SQDSP_GIL_RELEASE_BEGIN
-            for (std::size_t col = 0; col < ncols; ++col)
-                sqp::dsp::detail::fir_apply_column(
-                    y.typed_data<T>(), nrows, ncols, col,
-                    coeffs.typed_data<T>(), static_cast<std::size_t>(coeffs.nrows), out.y_ptr);
+            const sqp::dsp::detail::FirTaps<T> taps(
+                coeffs.typed_data<T>(), static_cast<std::size_t>(coeffs.nrows), method);
+            for_each_tile(nrows, ncols, sqp::dsp::TileSplit::Both, taps.cost(),
+                [&](const sqp::dsp::Tile& tile) {
+                    for (std::size_t col = tile.col_begin; col < tile.col_end; ++col)
+                        sqp::dsp::detail::fir_apply_column_rows(y.typed_data<T>(), ncols, col,
+                            tile.row_begin, tile.row_end, taps, out.y_ptr);
+                });
             SQDSP_GIL_RELEASE_END
             return out.to_tuple();
         }
         auto stage = sqp::dsp::fir_filter<T>(
-            { coeffs.typed_data<T>(), static_cast<std::size_t>(coeffs.nrows) });
+            { coeffs.typed_data<T>(), static_cast<std::size_t>(coeffs.nrows) }, method);
         return apply_stage<T>(x, y, gap_factor, has_gaps, stage);
     });
 }
@@ -758,10 +1053,13 @@ PyObject* dsp_iir_sos(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
             const auto nrows = static_cast<std::size_t>(y.nrows);
             const auto ncols = static_cast<std::size_t>(y.ncols);
             SQDSP_GIL_RELEASE_BEGIN
-            for (std::size_t col = 0; col < ncols; ++col)
-                sqp::dsp::detail::sos_apply_column(
-                    y.typed_data<T>(), nrows, ncols, col,
-                    sos.typed_data<T>(), static_cast<std::size_t>(sos.nrows), out.y_ptr);
+            const auto n_sections = static_cast<std::size_t>(sos.nrows);
+            for_each_tile(nrows, ncols, sqp::dsp::TileSplit::Columns, n_sections,
+                [&](const sqp::dsp::Tile& tile) {
+                    for (std::size_t col = tile.col_begin; col < tile.col_end; ++col)
+                        sqp::dsp::detail::sos_apply_column(y.typed_data<T>(), nrows, ncols, col,
+                            sos.typed_data<T>(), n_sections, out.y_ptr);
+                });
             SQDSP_GIL_RELEASE_END
             return out.to_tuple();
         }
@@ -779,11 +1077,16 @@ PyObject* dsp_filtfilt(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
     PyObject* coeffs_obj = nullptr;
     double gap_factor = 3.0;
     int has_gaps = 1;
+    const char* method_str = "auto";
 
-    static const char* kwlist[] = { "x", "y", "coeffs", "gap_factor", "has_gaps", nullptr };
+    static const char* kwlist[]
+        = { "x", "y", "coeffs", "gap_factor", "has_gaps", "method", nullptr };
     if (!PyArg_ParseTupleAndKeywords(
-            args, kwargs, "OOO|dp", const_cast<char**>(kwlist), &x_obj, &y_obj, &coeffs_obj,
-            &gap_factor, &has_gaps))
+            args, kwargs, "OOO|dps", const_cast<char**>(kwlist), &x_obj, &y_obj, &coeffs_obj,
+            &gap_factor, &has_gaps, &method_str))
+        return nullptr;
+    sqp::dsp::FirMethod method;
+    if (!parse_fir_method(method_str, method))
         return nullptr;
 
     XArray x;
@@ -816,33 +1119,19 @@ PyObject* dsp_filtfilt(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
             const auto nrows = static_cast<std::size_t>(y.nrows);
             const auto ncols = static_cast<std::size_t>(y.ncols);
             SQDSP_GIL_RELEASE_BEGIN
-            for (std::size_t col = 0; col < ncols; ++col)
-                sqp::dsp::detail::filtfilt_column(
-                    y.typed_data<T>(), nrows, ncols, col,
-                    coeffs.typed_data<T>(), static_cast<std::size_t>(coeffs.nrows), out.y_ptr);
+            const sqp::dsp::detail::FirTaps<T> taps(
+                coeffs.typed_data<T>(), static_cast<std::size_t>(coeffs.nrows), method);
+            for_each_tile(nrows, ncols, sqp::dsp::TileSplit::Columns, 2 * taps.cost(),
+                [&](const sqp::dsp::Tile& tile) {
+                    for (std::size_t col = tile.col_begin; col < tile.col_end; ++col)
+                        sqp::dsp::detail::filtfilt_column(y.typed_data<T>(), nrows, ncols, col,
+                            taps, out.y_ptr);
+                });
             SQDSP_GIL_RELEASE_END
             return out.to_tuple();
         }
-        // Gap-aware: build segments, apply filtfilt per segment
-        auto coeffs_vec = std::vector<T>(
-            coeffs.typed_data<T>(), coeffs.typed_data<T>() + coeffs.nrows);
-        auto stage = [coeffs_vec](const std::vector<sqp::dsp::Segment<T>>& segments)
-            -> std::vector<sqp::dsp::TimeSeries<T>>
-        {
-            std::vector<sqp::dsp::TimeSeries<T>> results(segments.size());
-            sqp::dsp::parallel_for(segments.size(), [&](std::size_t i) {
-                const auto& seg = segments[i];
-                auto& r = results[i];
-                r.x.assign(seg.x.begin(), seg.x.end());
-                r.y.resize(seg.y.size());
-                r.n_cols = seg.n_cols;
-                for (std::size_t col = 0; col < seg.n_cols; ++col)
-                    sqp::dsp::detail::filtfilt_column(
-                        seg.y.data(), seg.x.size(), seg.n_cols, col,
-                        coeffs_vec.data(), coeffs_vec.size(), r.y.data());
-            });
-            return results;
-        };
+        auto stage = sqp::dsp::filtfilt<T>(
+            { coeffs.typed_data<T>(), static_cast<std::size_t>(coeffs.nrows) }, method);
         return apply_stage<T>(x, y, gap_factor, has_gaps, stage);
     });
 }
@@ -894,33 +1183,19 @@ PyObject* dsp_sosfiltfilt(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
             const auto nrows = static_cast<std::size_t>(y.nrows);
             const auto ncols = static_cast<std::size_t>(y.ncols);
             SQDSP_GIL_RELEASE_BEGIN
-            for (std::size_t col = 0; col < ncols; ++col)
-                sqp::dsp::detail::sosfiltfilt_column(
-                    y.typed_data<T>(), nrows, ncols, col,
-                    sos.typed_data<T>(), static_cast<std::size_t>(sos.nrows), out.y_ptr);
+            const auto n_sections = static_cast<std::size_t>(sos.nrows);
+            for_each_tile(nrows, ncols, sqp::dsp::TileSplit::Columns, 2 * n_sections,
+                [&](const sqp::dsp::Tile& tile) {
+                    for (std::size_t col = tile.col_begin; col < tile.col_end; ++col)
+                        sqp::dsp::detail::sosfiltfilt_column(y.typed_data<T>(), nrows, ncols,
+                            col, sos.typed_data<T>(), n_sections, out.y_ptr);
+                });
             SQDSP_GIL_RELEASE_END
             return out.to_tuple();
         }
-        auto sos_vec = std::vector<T>(
-            sos.typed_data<T>(), sos.typed_data<T>() + sos.nrows * 6);
-        auto n_sec = static_cast<std::size_t>(sos.nrows);
-        auto stage = [sos_vec, n_sec](const std::vector<sqp::dsp::Segment<T>>& segments)
-            -> std::vector<sqp::dsp::TimeSeries<T>>
-        {
-            std::vector<sqp::dsp::TimeSeries<T>> results(segments.size());
-            sqp::dsp::parallel_for(segments.size(), [&](std::size_t i) {
-                const auto& seg = segments[i];
-                auto& r = results[i];
-                r.x.assign(seg.x.begin(), seg.x.end());
-                r.y.resize(seg.y.size());
-                r.n_cols = seg.n_cols;
-                for (std::size_t col = 0; col < seg.n_cols; ++col)
-                    sqp::dsp::detail::sosfiltfilt_column(
-                        seg.y.data(), seg.x.size(), seg.n_cols, col,
-                        sos_vec.data(), n_sec, r.y.data());
-            });
-            return results;
-        };
+        auto stage = sqp::dsp::sosfiltfilt<T>(
+            { sos.typed_data<T>(), static_cast<std::size_t>(sos.nrows * 6) },
+            static_cast<std::size_t>(sos.nrows));
         return apply_stage<T>(x, y, gap_factor, has_gaps, stage);
     });
 }
@@ -953,25 +1228,9 @@ PyObject* dsp_fft(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
     {
         std::vector<sqp::dsp::FFTResult<T>> results;
         SQDSP_GIL_RELEASE_BEGIN
-        std::vector<sqp::dsp::Segment<T>> segments;
-        if (has_gaps)
-        {
-            segments = sqp::dsp::split_segments<T>(
-                x.span(), y.flat_span<T>(), static_cast<std::size_t>(y.ncols), gap_factor);
-        }
-        else
-        {
-            // No gaps: skip expensive median_dt, use first dt as sample period
-            const double dt = (x.nrows >= 2) ? (x.data[1] - x.data[0]) : 1.0;
-            segments.push_back(sqp::dsp::Segment<T> {
-                .x = x.span(),
-                .y = y.flat_span<T>(),
-                .n_cols = static_cast<std::size_t>(y.ncols),
-                .median_dt = dt,
-            });
-        }
-        results = sqp::dsp::fft(segments, win);
+        results = sqp::dsp::fft(make_segments<T>(x, y, gap_factor, has_gaps), win);
         SQDSP_GIL_RELEASE_END
+        publish_fft_cache_counters();
 
         PyObject* list = PyList_New(static_cast<Py_ssize_t>(results.size()));
         if (!list)
@@ -1057,25 +1316,11 @@ PyObject* dsp_spectrogram(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
     {
         std::vector<sqp::dsp::SpectrogramResult<T>> results;
         SQDSP_GIL_RELEASE_BEGIN
-        std::vector<sqp::dsp::Segment<T>> segments;
-        if (has_gaps)
-        {
-            segments = sqp::dsp::split_segments<T>(
-                x.span(), y.flat_span<T>(), static_cast<std::size_t>(y.ncols), gap_factor);
-        }
-        else
-        {
-            const double dt = (x.nrows >= 2) ? (x.data[1] - x.data[0]) : 1.0;
-            segments.push_back(sqp::dsp::Segment<T> {
-                .x = x.span(),
-                .y = y.flat_span<T>(),
-                .n_cols = static_cast<std::size_t>(y.ncols),
-                .median_dt = dt,
-            });
-        }
-        results = sqp::dsp::spectrogram(segments, static_cast<std::size_t>(col),
+        results = sqp::dsp::spectrogram(make_segments<T>(x, y, gap_factor, has_gaps),
+            static_cast<std::size_t>(col),
             static_cast<std::size_t>(window_size), static_cast<std::size_t>(overlap), win);
         SQDSP_GIL_RELEASE_END
+        publish_fft_cache_counters();
 
         PyObject* list = PyList_New(static_cast<Py_ssize_t>(results.size()));
         if (!list)
@@ -1113,6 +1358,226 @@ PyObject* dsp_spectrogram(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
     });
 }
 
+// ── Averaged spectra ─────────────────────────────────────────────────────────
+
+bool check_spectral_result(std::size_t n_windows, Py_ssize_t window_size, const char* func_name)
+{
+    if (n_windows == 0)
+    {
+        PyErr_Format(PyExc_ValueError,
+            "%s: no gap-free stretch holds a full window of %zd samples", func_name,
+            window_size);
+        return false;
+    }
+    return true;
+}
+
+PyObject* power_spectrum_to_tuple(const sqp::dsp::PowerSpectrum& r)
+{
+    PyObject* f_arr = double_vec_to_1d(r.f);
+    PyObject* p_arr = (r.n_cols == 1) ? double_vec_to_1d(r.psd)
+                                      : vec_to_2d(r.psd, static_cast<npy_intp>(r.f.size()),
+                                            static_cast<npy_intp>(r.n_cols));
+    if (!f_arr || !p_arr)
+    {
+        Py_XDECREF(f_arr);
+        Py_XDECREF(p_arr);
+        return nullptr;
+    }
+    PyObject* tuple = PyTuple_Pack(2, f_arr, p_arr);
+    Py_DECREF(f_arr);
+    Py_DECREF(p_arr);
+    return tuple;
+}
+
+PyObject* dsp_welch(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
+{
+    PyObject* x_obj = nullptr;
+    PyObject* y_obj = nullptr;
+    Py_ssize_t window_size = 256;
+    Py_ssize_t overlap = 0;
+    double gap_factor = 3.0;
+    const char* window_str = "hann";
+    int detrend = 1;
+    int has_gaps = 1;
+
+    static const char* kwlist[] = { "x", "y", "window_size", "overlap", "gap_factor", "window",
+        "detrend", "has_gaps", nullptr };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|nndspp", const_cast<char**>(kwlist),
+            &x_obj, &y_obj, &window_size, &overlap, &gap_factor, &window_str, &detrend,
+            &has_gaps))
+        return nullptr;
+
+    XArray x;
+    YArray y;
+    if (!x.parse(x_obj) || !y.parse(y_obj))
+        return nullptr;
+    if (!check_xy_sizes(x, y) || !check_gap_factor(gap_factor)
+        || !check_spectral_window(window_size, overlap, "welch"))
+        return nullptr;
+
+    auto win = parse_window_type(window_str);
+
+    return dispatch(y.dtype, [&]<typename T>() -> PyObject*
+    {
+        sqp::dsp::PowerSpectrum result;
+        SQDSP_GIL_RELEASE_BEGIN
+        result = sqp::dsp::welch(make_segments<T>(x, y, gap_factor, has_gaps),
+            static_cast<std::size_t>(window_size), static_cast<std::size_t>(overlap), win,
+            detrend != 0);
+        SQDSP_GIL_RELEASE_END
+        publish_fft_cache_counters();
+        if (!check_spectral_result(result.n_windows, window_size, "welch"))
+            return static_cast<PyObject*>(nullptr);
+        return power_spectrum_to_tuple(result);
+    });
+}
+
+PyObject* dsp_multitaper(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
+{
+    PyObject* x_obj = nullptr;
+    PyObject* y_obj = nullptr;
+    Py_ssize_t window_size = 256;
+    Py_ssize_t overlap = 0;
+    double nw = 4.0;
+    Py_ssize_t n_tapers = 0;
+    double gap_factor = 3.0;
+    int detrend = 1;
+    int has_gaps = 1;
+
+    static const char* kwlist[] = { "x", "y", "window_size", "overlap", "nw", "n_tapers",
+        "gap_factor", "detrend", "has_gaps", nullptr };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|nndndpp", const_cast<char**>(kwlist),
+            &x_obj, &y_obj, &window_size, &overlap, &nw, &n_tapers, &gap_factor, &detrend,
+            &has_gaps))
+        return nullptr;
+
+    XArray x;
+    YArray y;
+    if (!x.parse(x_obj) || !y.parse(y_obj))
+        return nullptr;
+    if (!check_xy_sizes(x, y) || !check_gap_factor(gap_factor)
+        || !check_spectral_window(window_size, overlap, "multitaper"))
+        return nullptr;
+    if (!(nw > 0.0) || nw >= static_cast<double>(window_size) / 2.0)
+    {
+        PyErr_Format(PyExc_ValueError, "multitaper: nw must be in (0, window_size / 2)");
+        return nullptr;
+    }
+    if (n_tapers < 0 || n_tapers > window_size)
+    {
+        PyErr_Format(PyExc_ValueError, "multitaper: n_tapers (%zd) must be in [0, window_size]",
+            n_tapers);
+        return nullptr;
+    }
+
+    return dispatch(y.dtype, [&]<typename T>() -> PyObject*
+    {
+        sqp::dsp::PowerSpectrum result;
+        SQDSP_GIL_RELEASE_BEGIN
+        result = sqp::dsp::multitaper(make_segments<T>(x, y, gap_factor, has_gaps),
+            static_cast<std::size_t>(window_size), static_cast<std::size_t>(overlap), nw,
+            static_cast<std::size_t>(n_tapers), detrend != 0);
+        SQDSP_GIL_RELEASE_END
+        publish_fft_cache_counters();
+        if (!check_spectral_result(result.n_windows, window_size, "multitaper"))
+            return static_cast<PyObject*>(nullptr);
+        return power_spectrum_to_tuple(result);
+    });
+}
+
+// csd() and coherence() share their arguments and the cross spectrum.
+PyObject* cross_spectrum(PyObject* args, PyObject* kwargs, bool coherence)
+{
+    const char* name = coherence ? "coherence" : "csd";
+    PyObject* x_obj = nullptr;
+    PyObject* y_obj = nullptr;
+    Py_ssize_t col_a = 0;
+    Py_ssize_t col_b = 1;
+    Py_ssize_t window_size = 256;
+    Py_ssize_t overlap = 0;
+    double gap_factor = 3.0;
+    const char* window_str = "hann";
+    int detrend = 1;
+    int has_gaps = 1;
+
+    static const char* kwlist[] = { "x", "y", "col_a", "col_b", "window_size", "overlap",
+        "gap_factor", "window", "detrend", "has_gaps", nullptr };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|nnnndspp", const_cast<char**>(kwlist),
+            &x_obj, &y_obj, &col_a, &col_b, &window_size, &overlap, &gap_factor, &window_str,
+            &detrend, &has_gaps))
+        return nullptr;
+
+    XArray x;
+    YArray y;
+    if (!x.parse(x_obj) || !y.parse(y_obj))
+        return nullptr;
+    if (!check_xy_sizes(x, y) || !check_gap_factor(gap_factor)
+        || !check_spectral_window(window_size, overlap, name))
+        return nullptr;
+    for (const auto col : { col_a, col_b })
+    {
+        if (col < 0 || col >= y.ncols)
+        {
+            PyErr_Format(PyExc_ValueError, "%s: col (%zd) out of range [0, %zd)", name, col,
+                y.ncols);
+            return nullptr;
+        }
+    }
+
+    auto win = parse_window_type(window_str);
+
+    return dispatch(y.dtype, [&]<typename T>() -> PyObject*
+    {
+        sqp::dsp::CrossSpectrum result;
+        std::vector<double> cxy;
+        SQDSP_GIL_RELEASE_BEGIN
+        result = sqp::dsp::csd(make_segments<T>(x, y, gap_factor, has_gaps),
+            static_cast<std::size_t>(col_a), static_cast<std::size_t>(col_b),
+            static_cast<std::size_t>(window_size), static_cast<std::size_t>(overlap), win,
+            detrend != 0);
+        if (coherence)
+            cxy = sqp::dsp::coherence(result);
+        SQDSP_GIL_RELEASE_END
+        publish_fft_cache_counters();
+        if (!check_spectral_result(result.n_windows, window_size, name))
+            return static_cast<PyObject*>(nullptr);
+
+        PyObject* f_arr = double_vec_to_1d(result.f);
+        PyObject* v_arr = nullptr;
+        if (coherence)
+            v_arr = double_vec_to_1d(cxy);
+        else
+        {
+            npy_intp dims[1] = { static_cast<npy_intp>(result.pxy.size()) };
+            v_arr = PyArray_SimpleNew(1, dims, NPY_CDOUBLE);
+            if (v_arr)
+                std::memcpy(PyArray_DATA(reinterpret_cast<PyArrayObject*>(v_arr)),
+                    result.pxy.data(), result.pxy.size() * sizeof(std::complex<double>));
+        }
+        if (!f_arr || !v_arr)
+        {
+            Py_XDECREF(f_arr);
+            Py_XDECREF(v_arr);
+            return static_cast<PyObject*>(nullptr);
+        }
+        PyObject* tuple = PyTuple_Pack(2, f_arr, v_arr);
+        Py_DECREF(f_arr);
+        Py_DECREF(v_arr);
+        return tuple;
+    });
+}
+
+PyObject* dsp_csd(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
+{
+    return cross_spectrum(args, kwargs, false);
+}
+
+PyObject* dsp_coherence(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
+{
+    return cross_spectrum(args, kwargs, true);
+}
+
 PyObject* dsp_rolling_mean(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
 {
     PyObject* x_obj = nullptr;
@@ -1143,13 +1608,11 @@ PyObject* dsp_rolling_mean(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
             ZeroCopyOutput<T> out;
             if (!out.alloc_like(x, y))
                 return static_cast<PyObject*>(nullptr);
-            const auto nrows = static_cast<std::size_t>(y.nrows);
-            const auto ncols = static_cast<std::size_t>(y.ncols);
-            const auto win = static_cast<std::size_t>(window);
+            const sqp::dsp::detail::RollingSeries<T> series { y.typed_data<T>(),
+                static_cast<std::size_t>(y.nrows), static_cast<std::size_t>(y.ncols), out.y_ptr };
             SQDSP_GIL_RELEASE_BEGIN
-            for (std::size_t col = 0; col < ncols; ++col)
-                sqp::dsp::detail::rolling_mean_column(
-                    y.typed_data<T>(), nrows, ncols, col, win, out.y_ptr);
+            sqp::dsp::detail::rolling_windows<T>(
+                { &series, 1 }, static_cast<std::size_t>(window), false);
             SQDSP_GIL_RELEASE_END
             return out.to_tuple();
         }
@@ -1188,13 +1651,11 @@ PyObject* dsp_rolling_std(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
             ZeroCopyOutput<T> out;
             if (!out.alloc_like(x, y))
                 return static_cast<PyObject*>(nullptr);
-            const auto nrows = static_cast<std::size_t>(y.nrows);
-            const auto ncols = static_cast<std::size_t>(y.ncols);
-            const auto win = static_cast<std::size_t>(window);
+            const sqp::dsp::detail::RollingSeries<T> series { y.typed_data<T>(),
+                static_cast<std::size_t>(y.nrows), static_cast<std::size_t>(y.ncols), out.y_ptr };
             SQDSP_GIL_RELEASE_BEGIN
-            for (std::size_t col = 0; col < ncols; ++col)
-                sqp::dsp::detail::rolling_std_column(
-                    y.typed_data<T>(), nrows, ncols, col, win, out.y_ptr);
+            sqp::dsp::detail::rolling_windows<T>(
+                { &series, 1 }, static_cast<std::size_t>(window), true);
             SQDSP_GIL_RELEASE_END
             return out.to_tuple();
         }
@@ -1235,9 +1696,12 @@ PyObject* dsp_reduce(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
             const auto ncols = static_cast<std::size_t>(y.ncols);
             const auto op = parse_reduce_op(op_str);
             SQDSP_GIL_RELEASE_BEGIN
-            for (std::size_t row = 0; row < nrows; ++row)
-                out.y_ptr[row] = sqp::dsp::detail::reduce_row(
-                    &y.typed_data<T>()[row * ncols], ncols, op);
+            for_each_tile(nrows, ncols, sqp::dsp::TileSplit::Rows, 1,
+                [&](const sqp::dsp::Tile& tile) {
+                    for (std::size_t row = tile.row_begin; row < tile.row_end; ++row)
+                        out.y_ptr[row] = sqp::dsp::detail::reduce_row(
+                            &y.typed_data<T>()[row * ncols], ncols, op);
+                });
             SQDSP_GIL_RELEASE_END
             return out.to_tuple();
         }
@@ -1331,10 +1795,13 @@ PyObject* dsp_reduce_axes(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
         }
 
         SQDSP_GIL_RELEASE_BEGIN
-        sqp::dsp::parallel_for(nrows, [&](std::size_t row) {
-            sqp::dsp::detail::reduce_axes_row(
-                &y.typed_data<T>()[row * prod], spec, op, &y_out_ptr[row * spec.out_size]);
-        });
+        // One task per row block: a task per row costs more than reducing it
+        for_each_tile(nrows, prod, sqp::dsp::TileSplit::Rows, 1,
+            [&](const sqp::dsp::Tile& tile) {
+                for (std::size_t row = tile.row_begin; row < tile.row_end; ++row)
+                    sqp::dsp::detail::reduce_axes_row(&y.typed_data<T>()[row * prod], spec, op,
+                        &y_out_ptr[row * spec.out_size]);
+            });
         SQDSP_GIL_RELEASE_END
 
         auto* tuple = PyTuple_Pack(2, x_ref, y_out_obj);
@@ -1344,6 +1811,332 @@ PyObject* dsp_reduce_axes(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
     });
 }
 
+PyObject* dsp_pipeline(PyObject* /*self*/, PyObject* args, PyObject* kwargs)
+{
+    PyObject* x_obj = nullptr;
+    PyObject* y_obj = nullptr;
+    PyObject* stages_obj = nullptr;
+    double gap_factor = 3.0;
+    int fused = 1;
+
+    static const char* kwlist[] = { "x", "y", "stages", "gap_factor", "fused", nullptr };
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "OOO|dp", const_cast<char**>(kwlist), &x_obj, &y_obj, &stages_obj,
+            &gap_factor, &fused))
+        return nullptr;
+
+    XArray x;
+    YArray y;
+    if (!x.parse(x_obj) || !y.parse(y_obj))
+        return nullptr;
+    if (!check_xy_sizes(x, y) || !check_gap_factor(gap_factor))
+        return nullptr;
+
+    std::vector<StageSpec> specs;
+    if (!parse_stage_specs(stages_obj, y.dtype, x, specs))
+        return nullptr;
+
+    return dispatch(y.dtype, [&]<typename T>() -> PyObject*
+    {
+        std::vector<sqp::dsp::Stage<T>> stages;
+        stages.reserve(specs.size());
+        for (const auto& spec : specs)
+        {
+            stages.push_back(build_stage<T>(spec));
+            // Unfused: every stage materialises its output (reference executor)
+            if (!fused)
+                stages.back().make_kernel = nullptr;
+        }
+
+        sqp::dsp::TimeSeries<T> ts;
+        SQDSP_GIL_RELEASE_BEGIN
+        ts = sqp::dsp::run_pipeline<T>(x.span(), y.flat_span<T>(),
+            static_cast<std::size_t>(y.ncols), stages, gap_factor);
+        SQDSP_GIL_RELEASE_END
+        return timeseries_to_tuple(ts);
+    });
+}
+
+PyObject* dsp_fft_cache_stats(PyObject* /*self*/, PyObject* /*args*/)
+{
+    const auto stats = sqp::dsp::fft_cache_stats();
+    return Py_BuildValue("{s:K,s:K,s:n,s:n}", "hits",
+        static_cast<unsigned long long>(stats.hits), "misses",
+        static_cast<unsigned long long>(stats.misses), "entries",
+        static_cast<Py_ssize_t>(stats.entries), "capacity",
+        static_cast<Py_ssize_t>(stats.capacity));
+}
+
+PyObject* dsp_clear_fft_cache(PyObject* /*self*/, PyObject* /*args*/)
+{
+    sqp::dsp::clear_fft_cache();
+    Py_RETURN_NONE;
+}
+
+PyObject* dsp_set_fft_cache_capacity(PyObject* /*self*/, PyObject* args)
+{
+    Py_ssize_t capacity = 0;
+    if (!PyArg_ParseTuple(args, "n", &capacity))
+        return nullptr;
+    if (capacity < 0)
+    {
+        PyErr_Format(PyExc_ValueError, "capacity must be >= 0, got %zd", capacity);
+        return nullptr;
+    }
+    sqp::dsp::set_fft_cache_capacity(static_cast<std::size_t>(capacity));
+    Py_RETURN_NONE;
+}
+
+PyObject* dsp_set_counter_sink(PyObject* /*self*/, PyObject* sink)
+{
+    if (sink != Py_None && !PyCallable_Check(sink))
+    {
+        PyErr_SetString(PyExc_TypeError, "counter sink must be callable or None");
+        return nullptr;
+    }
+    Py_XSETREF(counter_sink, sink == Py_None ? nullptr : Py_NewRef(sink));
+    Py_RETURN_NONE;
+}
+
+// ── StreamingFilter type ─────────────────────────────────────────────────────
+//
+// Stateful fir_filter/iir_sos for data that arrives in chunks. The C++ filter
+// lives behind a pointer so the Python object stays a plain C struct; its
+// mutex serialises push() calls, which run without the GIL.
+
+// The filter is built by the first push(), for the dtype of its y: like the
+// batch filters, the coefficients follow the data rather than the other way
+// round. Until then only the validated coefficients are kept.
+struct StreamingFilterState
+{
+    std::variant<std::monostate, sqp::dsp::StreamingFilter<double>,
+        sqp::dsp::StreamingFilter<float>, sqp::dsp::StreamingFilter<int32_t>>
+        filter;
+    StageSpec spec;
+    std::size_t n_cols;
+    double gap_factor;
+    std::mutex mutex;
+};
+
+struct PyStreamingFilter
+{
+    PyObject_HEAD
+    StreamingFilterState* state;
+};
+
+int streaming_filter_init(PyObject* self_obj, PyObject* args, PyObject* kwargs)
+{
+    auto* self = reinterpret_cast<PyStreamingFilter*>(self_obj);
+    const char* kind_str = nullptr;
+    PyObject* coeffs_obj = nullptr;
+    Py_ssize_t n_cols = 1;
+    double gap_factor = 3.0;
+
+    static const char* kwlist[] = { "kind", "coeffs", "n_cols", "gap_factor", nullptr };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sO|nd", const_cast<char**>(kwlist),
+            &kind_str, &coeffs_obj, &n_cols, &gap_factor))
+        return -1;
+    if (!check_gap_factor(gap_factor))
+        return -1;
+    if (n_cols <= 0)
+    {
+        PyErr_Format(PyExc_ValueError, "n_cols must be > 0, got %zd", n_cols);
+        return -1;
+    }
+
+    StageSpec spec;
+    // Only the direct FIR path has a streaming kernel
+    spec.fir_method = sqp::dsp::FirMethod::Direct;
+    if (!parse_stage_kind(kind_str, spec.kind))
+        return -1;
+    if (spec.kind != StageKind::FirFilter && spec.kind != StageKind::IirSos)
+    {
+        PyErr_SetString(PyExc_ValueError, "StreamingFilter kind must be 'fir_filter' or 'iir_sos'");
+        return -1;
+    }
+    XArray no_x;
+    YArray probe;
+    if (!probe.parse(coeffs_obj)
+        || !parse_stage_param(coeffs_obj, kind_str, probe.dtype, no_x, spec))
+        return -1;
+
+    delete self->state;
+    self->state = new StreamingFilterState {
+        .spec = std::move(spec),
+        .n_cols = static_cast<std::size_t>(n_cols),
+        .gap_factor = gap_factor,
+    };
+    return 0;
+}
+
+// Build the filter for y's dtype, casting the coefficients to it. The kept
+// coefficients are left as given, so a failed cast can be retried.
+bool build_streaming_filter(StreamingFilterState& state, int dtype)
+{
+    PyObject* cast = PyArray_FROMANY(reinterpret_cast<PyObject*>(state.spec.coeffs->arr), dtype,
+        1, 2, NPY_ARRAY_C_CONTIGUOUS | NPY_ARRAY_FORCECAST);
+    if (!cast)
+        return false;
+    StageSpec spec { .kind = state.spec.kind, .fir_method = state.spec.fir_method };
+    XArray no_x;
+    const char* kind_str = spec.kind == StageKind::FirFilter ? "fir_filter" : "iir_sos";
+    const bool ok = parse_stage_param(cast, kind_str, dtype, no_x, spec);
+    Py_DECREF(cast);
+    if (!ok)
+        return false;
+    return dispatch(dtype, [&]<typename T>() -> PyObject*
+    {
+        state.filter.emplace<sqp::dsp::StreamingFilter<T>>(
+            build_stage<T>(spec), state.n_cols, state.gap_factor);
+        return Py_None;
+    }) != nullptr;
+}
+
+void streaming_filter_dealloc(PyObject* self_obj)
+{
+    auto* self = reinterpret_cast<PyStreamingFilter*>(self_obj);
+    delete self->state;
+    Py_TYPE(self_obj)->tp_free(self_obj);
+}
+
+StreamingFilterState* streaming_filter_state(PyObject* self_obj)
+{
+    auto* state = reinterpret_cast<PyStreamingFilter*>(self_obj)->state;
+    if (!state)
+        PyErr_SetString(PyExc_RuntimeError, "StreamingFilter is not initialised");
+    return state;
+}
+
+PyObject* streaming_filter_push(PyObject* self_obj, PyObject* args, PyObject* kwargs)
+{
+    auto* state = streaming_filter_state(self_obj);
+    if (!state)
+        return nullptr;
+    PyObject* x_obj = nullptr;
+    PyObject* y_obj = nullptr;
+    static const char* kwlist[] = { "x", "y", nullptr };
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "OO", const_cast<char**>(kwlist), &x_obj, &y_obj))
+        return nullptr;
+
+    XArray x;
+    YArray y;
+    if (!x.parse(x_obj) || !y.parse(y_obj))
+        return nullptr;
+    if (!check_xy_sizes(x, y))
+        return nullptr;
+    {
+        // Pushes hold the mutex without the GIL but never wait for the GIL
+        // while holding it, so taking it here cannot deadlock.
+        std::lock_guard lock { state->mutex };
+        if (std::holds_alternative<std::monostate>(state->filter)
+            && !build_streaming_filter(*state, y.dtype))
+            return nullptr;
+    }
+
+    return dispatch(y.dtype, [&]<typename T>() -> PyObject*
+    {
+        auto* filter_ptr = std::get_if<sqp::dsp::StreamingFilter<T>>(&state->filter);
+        if (!filter_ptr)
+        {
+            PyErr_SetString(PyExc_TypeError, "y must have the same dtype as the first push");
+            return static_cast<PyObject*>(nullptr);
+        }
+        auto& filter = *filter_ptr;
+        if (static_cast<std::size_t>(y.ncols) != filter.n_cols())
+        {
+            PyErr_Format(PyExc_ValueError, "y has %zd columns, filter expects %zu", y.ncols,
+                filter.n_cols());
+            return static_cast<PyObject*>(nullptr);
+        }
+        std::vector<T> out;
+        SQDSP_GIL_RELEASE_BEGIN
+        std::lock_guard lock { state->mutex };
+        out = filter.push(x.span(), y.flat_span<T>());
+        SQDSP_GIL_RELEASE_END
+        return (PyArray_NDIM(y.arr) == 1) ? vec_to_1d(out) : vec_to_2d(out, y.nrows, y.ncols);
+    });
+}
+
+PyObject* streaming_filter_reset(PyObject* self_obj, PyObject* /*unused*/)
+{
+    auto* state = streaming_filter_state(self_obj);
+    if (!state)
+        return nullptr;
+    {
+        // A concurrent push() holds the mutex without the GIL: wait for it
+        // without the GIL as well.
+        SQDSP_GIL_RELEASE_BEGIN
+        std::lock_guard lock { state->mutex };
+        std::visit([]<typename F>(F& f)
+        {
+            if constexpr (!std::is_same_v<F, std::monostate>)
+                f.reset();
+        },
+            state->filter);
+        SQDSP_GIL_RELEASE_END
+    }
+    Py_RETURN_NONE;
+}
+
+PyObject* streaming_filter_median_dt(PyObject* self_obj, void* /*closure*/)
+{
+    auto* state = streaming_filter_state(self_obj);
+    if (!state)
+        return nullptr;
+    std::lock_guard lock { state->mutex };
+    return PyFloat_FromDouble(std::visit([]<typename F>(F& f)
+    {
+        if constexpr (std::is_same_v<F, std::monostate>)
+            return 0.0;
+        else
+            return f.median_dt();
+    },
+        state->filter));
+}
+
+// clang-format off
+PyMethodDef streaming_filter_methods[] = {
+    {"push", reinterpret_cast<PyCFunction>(streaming_filter_push),
+     METH_VARARGS | METH_KEYWORDS,
+     "push(x, y) -> y_out\n"
+     "Filter the next chunk (rows after everything pushed so far).\n"
+     "Filter state carries over from the previous chunk and resets at gaps.\n"
+     "Returns one output row per input row. The first push fixes the dtype\n"
+     "(coeffs are converted to it); later pushes must use the same dtype\n"
+     "and n_cols columns."},
+
+    {"reset", streaming_filter_reset, METH_NOARGS,
+     "reset()\nForget the filter state and cadence, as if nothing had been pushed."},
+
+    {nullptr, nullptr, 0, nullptr},
+};
+
+PyGetSetDef streaming_filter_getset[] = {
+    {"median_dt", streaming_filter_median_dt, nullptr,
+     "Cadence used for gap detection (0.0 until two timestamps were seen).", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr},
+};
+// clang-format on
+
+PyTypeObject StreamingFilterType = {
+    .ob_base = PyVarObject_HEAD_INIT(nullptr, 0)
+    .tp_name = "_sciqlop_dsp.StreamingFilter",
+    .tp_basicsize = sizeof(PyStreamingFilter),
+    .tp_dealloc = streaming_filter_dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "StreamingFilter(kind, coeffs, n_cols=1, gap_factor=3.0)\n"
+              "Causal filter with persistent state for chunked/live data.\n"
+              "kind: 'fir_filter' (coeffs: taps) or 'iir_sos' (coeffs: (n_sections, 6)).\n"
+              "coeffs are converted to the dtype of the first pushed y.\n"
+              "Appending N samples costs O(N). A step > gap_factor * median_dt\n"
+              "(cadence of the first chunk) resets the state, like split_segments.",
+    .tp_methods = streaming_filter_methods,
+    .tp_getset = streaming_filter_getset,
+    .tp_init = streaming_filter_init,
+    .tp_new = PyType_GenericNew,
+};
+
 // ── Module definition ────────────────────────────────────────────────────────
 
 // clang-format off
@@ -1366,8 +2159,10 @@ PyMethodDef methods[] = {
 
     {"fir_filter", reinterpret_cast<PyCFunction>(dsp_fir_filter),
      METH_VARARGS | METH_KEYWORDS,
-     "fir_filter(x, y, coeffs, gap_factor=3.0) -> (x_out, y_out)\n"
-     "FIR filter per segment. coeffs auto-converted to match y dtype."},
+     "fir_filter(x, y, coeffs, gap_factor=3.0, has_gaps=True, method='auto') -> (x_out, y_out)\n"
+     "FIR filter per segment. coeffs auto-converted to match y dtype.\n"
+     "method: 'direct' (time domain), 'fft' (overlap-add) or 'auto' (fft from 96 taps).\n"
+     "The fft path matches direct to ~1e-12*sum|h|*max|x| (float64)."},
 
     {"iir_sos", reinterpret_cast<PyCFunction>(dsp_iir_sos),
      METH_VARARGS | METH_KEYWORDS,
@@ -1377,8 +2172,9 @@ PyMethodDef methods[] = {
 
     {"filtfilt", reinterpret_cast<PyCFunction>(dsp_filtfilt),
      METH_VARARGS | METH_KEYWORDS,
-     "filtfilt(x, y, coeffs, gap_factor=3.0, has_gaps=True) -> (x_out, y_out)\n"
-     "Zero-phase FIR filter (forward-backward). Equivalent to scipy.signal.filtfilt."},
+     "filtfilt(x, y, coeffs, gap_factor=3.0, has_gaps=True, method='auto') -> (x_out, y_out)\n"
+     "Zero-phase FIR filter (forward-backward). Equivalent to scipy.signal.filtfilt.\n"
+     "method: see fir_filter."},
 
     {"sosfiltfilt", reinterpret_cast<PyCFunction>(dsp_sosfiltfilt),
      METH_VARARGS | METH_KEYWORDS,
@@ -1396,6 +2192,33 @@ PyMethodDef methods[] = {
      "  -> list[(t, f, power)]\n"
      "Per-segment spectrogram. Power preserves y dtype; t/f always float64."},
 
+    {"welch", reinterpret_cast<PyCFunction>(dsp_welch),
+     METH_VARARGS | METH_KEYWORDS,
+     "welch(x, y, window_size=256, overlap=0, gap_factor=3.0, window='hann', detrend=True,\n"
+     "      has_gaps=True) -> (f, psd)\n"
+     "Welch PSD averaged over the windows of every gap-free segment (overlap=0 means\n"
+     "window_size/2). One-sided density, as scipy.signal.welch. psd: float64,\n"
+     "(n_freq,) or (n_freq, n_cols)."},
+
+    {"multitaper", reinterpret_cast<PyCFunction>(dsp_multitaper),
+     METH_VARARGS | METH_KEYWORDS,
+     "multitaper(x, y, window_size=256, overlap=0, nw=4.0, n_tapers=0, gap_factor=3.0,\n"
+     "           detrend=True, has_gaps=True) -> (f, psd)\n"
+     "Multitaper PSD: windows as welch, each tapered by the first n_tapers DPSS\n"
+     "(default 2*nw-1) and the eigenspectra averaged. Same scaling as welch."},
+
+    {"csd", reinterpret_cast<PyCFunction>(dsp_csd),
+     METH_VARARGS | METH_KEYWORDS,
+     "csd(x, y, col_a=0, col_b=1, window_size=256, overlap=0, gap_factor=3.0, window='hann',\n"
+     "    detrend=True, has_gaps=True) -> (f, pxy)\n"
+     "Welch cross-spectral density of two columns, as scipy.signal.csd. pxy: complex128."},
+
+    {"coherence", reinterpret_cast<PyCFunction>(dsp_coherence),
+     METH_VARARGS | METH_KEYWORDS,
+     "coherence(x, y, col_a=0, col_b=1, window_size=256, overlap=0, gap_factor=3.0,\n"
+     "          window='hann', detrend=True, has_gaps=True) -> (f, cxy)\n"
+     "Magnitude-squared coherence of two columns, as scipy.signal.coherence."},
+
     {"rolling_mean", reinterpret_cast<PyCFunction>(dsp_rolling_mean),
      METH_VARARGS | METH_KEYWORDS,
      "rolling_mean(x, y, window, gap_factor=3.0) -> (x_out, y_out)\n"
@@ -1419,6 +2242,38 @@ PyMethodDef methods[] = {
      "axes: tuple of axes to reduce (e.g. (1, 2) to sum over angles).\n"
      "Output has prod(kept_shape) columns."},
 
+    {"pipeline", reinterpret_cast<PyCFunction>(dsp_pipeline),
+     METH_VARARGS | METH_KEYWORDS,
+     "pipeline(x, y, stages, gap_factor=3.0, fused=True) -> (x_out, y_out)\n"
+     "Run a chain of stages per segment and reassemble with NaN at gaps.\n"
+     "stages: sequence of (name, param) tuples, applied in order:\n"
+     "  ('interpolate_nan', max_consecutive), ('resample', target_dt),\n"
+     "  ('fir_filter', coeffs), ('filtfilt', coeffs), ('iir_sos', sos),\n"
+     "  ('sosfiltfilt', sos), ('rolling_mean', window), ('rolling_std', window),\n"
+     "  ('reduce', op).\n"
+     "Consecutive fir_filter/iir_sos/rolling_*/reduce stages are streamed in\n"
+     "cache-sized blocks without intermediate copies; fused=False runs every\n"
+     "stage on whole segments (same result, more memory)."},
+
+    {"fft_cache_stats", dsp_fft_cache_stats, METH_NOARGS,
+     "fft_cache_stats() -> dict(hits, misses, entries, capacity)\n"
+     "Lookups of the shared FFT plan/window cache used by fft, spectrogram, the\n"
+     "averaged spectra and the FIR overlap-add path. Keyed by (size, window, dtype),\n"
+     "or (size, nw, n_tapers) for DPSS tapers; LRU evicted."},
+
+    {"clear_fft_cache", dsp_clear_fft_cache, METH_NOARGS,
+     "clear_fft_cache()\n"
+     "Drop every cached FFT plan/window and reset the hit/miss totals."},
+
+    {"set_fft_cache_capacity", dsp_set_fft_cache_capacity, METH_VARARGS,
+     "set_fft_cache_capacity(n)\n"
+     "Maximum number of cached (size, window, dtype) entries (default 64)."},
+
+    {"_set_counter_sink", dsp_set_counter_sink, METH_O,
+     "_set_counter_sink(fn)\n"
+     "fn(name, value, category) receives the cache hit/miss totals after each\n"
+     "fft/spectrogram call. None disables it. Installed by SciQLopPlots.dsp."},
+
     {nullptr, nullptr, 0, nullptr},
 };
 // clang-format on
@@ -1437,5 +2292,17 @@ PyModuleDef module_def = {
 PyMODINIT_FUNC PyInit__sciqlop_dsp()
 {
     import_array();
-    return PyModule_Create(&module_def);
+    if (PyType_Ready(&StreamingFilterType) < 0)
+        return nullptr;
+    PyObject* module = PyModule_Create(&module_def);
+    if (!module)
+        return nullptr;
+    if (PyModule_AddObjectRef(
+            module, "StreamingFilter", reinterpret_cast<PyObject*>(&StreamingFilterType))
+        < 0)
+    {
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
 }
@@ -57,8 +57,37 @@ template double nan_reduce_sum_t::operator()<xsimd::SQP_DSP_ARCH>(
 template float nan_reduce_sum_t::operator()<xsimd::SQP_DSP_ARCH>(
     xsimd::SQP_DSP_ARCH, const float*, std::size_t);
 
+// copy_finite
+template std::size_t copy_finite_t::operator()<xsimd::SQP_DSP_ARCH>(
+    xsimd::SQP_DSP_ARCH, const double*, std::size_t, double*);
+template std::size_t copy_finite_t::operator()<xsimd::SQP_DSP_ARCH>(
+    xsimd::SQP_DSP_ARCH, const float*, std::size_t, float*);
+
 // adjacent_diff
 template void adjacent_diff_t::operator()<xsimd::SQP_DSP_ARCH>(
     xsimd::SQP_DSP_ARCH, const double*, double*, std::size_t);
 
+// complex_power
+template void complex_power_t::operator()<xsimd::SQP_DSP_ARCH>(
+    xsimd::SQP_DSP_ARCH, const std::complex<double>*, double*, std::size_t);
+
+// diff_counts, first_diff_above
+template DiffCounts diff_counts_t::operator()<xsimd::SQP_DSP_ARCH>(
+    xsimd::SQP_DSP_ARCH, const double*, std::size_t, double, double);
+template std::size_t first_diff_above_t::operator()<xsimd::SQP_DSP_ARCH>(
+    xsimd::SQP_DSP_ARCH, const double*, std::size_t, double);
+
+// rolling_moments, column_moments
+template void rolling_moments_t::operator()<xsimd::SQP_DSP_ARCH>(xsimd::SQP_DSP_ARCH,
+    const double*, const double*, std::size_t, std::size_t, const double*, double*, double*,
+    bool, bool);
+template void column_moments_t::operator()<xsimd::SQP_DSP_ARCH>(xsimd::SQP_DSP_ARCH,
+    const double*, std::size_t, std::size_t, std::size_t, const double*, double*);
+
+// gather_lanes, scatter_lanes
+template void gather_lanes_t::operator()<xsimd::SQP_DSP_ARCH>(xsimd::SQP_DSP_ARCH, const double*,
+    std::size_t, std::size_t, std::size_t, const double*, double*);
+template void scatter_lanes_t::operator()<xsimd::SQP_DSP_ARCH>(xsimd::SQP_DSP_ARCH, const double*,
+    std::size_t, std::size_t, double*, std::size_t);
+
 } // namespace sqp::dsp::simd
@@ -29,12 +29,32 @@ namespace sqp::dsp::simd
 
 decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(dot_product_t {}))
     dispatched_dot_product = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(dot_product_t {});
-auto dispatched_elementwise_mul = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(elementwise_mul_t {});
+decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(elementwise_mul_t {}))
+    dispatched_elementwise_mul = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(elementwise_mul_t {});
 auto dispatched_reduce_sum = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(reduce_sum_t {});
 auto dispatched_reduce_min_max = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(reduce_min_max_t {});
 auto dispatched_nan_reduce_sum = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(nan_reduce_sum_t {});
+decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(copy_finite_t {}))
+    dispatched_copy_finite = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(copy_finite_t {});
 
 decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(adjacent_diff_t {}))
     dispatched_adjacent_diff = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(adjacent_diff_t {});
 
+decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(complex_power_t {}))
+    dispatched_complex_power = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(complex_power_t {});
+
+decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(diff_counts_t {}))
+    dispatched_diff_counts = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(diff_counts_t {});
+decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(first_diff_above_t {}))
+    dispatched_first_diff_above = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(first_diff_above_t {});
+
+decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(rolling_moments_t {}))
+    dispatched_rolling_moments = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(rolling_moments_t {});
+decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(column_moments_t {}))
+    dispatched_column_moments = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(column_moments_t {});
+decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(gather_lanes_t {}))
+    dispatched_gather_lanes = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(gather_lanes_t {});
+decltype(xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(scatter_lanes_t {}))
+    dispatched_scatter_lanes = xsimd::dispatch<SQP_DSP_XSIMD_ARCH_LIST>(scatter_lanes_t {});
+
 } // namespace sqp::dsp::simd
@@ -20,8 +20,13 @@
 -- Mail : alexis.jeandet@member.fsf.org
 ----------------------------------------------------------------------------*/
 #include "SciQLopPlots/DataProducer/DataProducer.hpp"
+#include "SciQLopPlots/DataProducer/DataProviderWorkerPool.hpp"
+#include "SciQLopPlots/DataProducer/SharedMemoryRing.hpp"
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include "SciQLopPlots/Debug.hpp"
+#include "SciQLopPlots/Tracing.hpp"
 
 
 void DataProviderInterface::_threaded_update()
@@ -29,6 +34,7 @@ void DataProviderInterface::_threaded_update()
     SciQLopPlotRange range;
     bool do_range = false;
     std::variant<std::monostate, _2D_data, _3D_data, _NDdata> data;
+    int data_level = 0;
     bool do_data = false;
     {
         QMutexLocker lock(&m_mutex);
@@ -36,24 +42,28 @@ void DataProviderInterface::_threaded_update()
         {
             range = m_next_range;
             m_range_pending = false;
+            m_rate_limiter.on_served();
             do_range = true;
         }
         if (m_data_pending)
         {
             data = m_next_data;
+            data_level = m_next_data_level;
             m_data_pending = false;
             do_data = true;
         }
+        if (do_range || do_data)
+            DataProviderWorkerPool::instance().request_taken(thread(), do_range + do_data);
     }
 
     if (do_range)
         _range_based_update(range);
     if (do_data)
         std::visit(
-            [this](auto&& d)
+            [this, data_level](auto&& d)
             {
                 if constexpr (!std::is_same_v<std::decay_t<decltype(d)>, std::monostate>)
-                    _data_based_update(d);
+                    _data_based_update(d, data_level);
             },
             data);
 
@@ -66,8 +76,14 @@ void DataProviderInterface::_threaded_update()
         Q_EMIT pipeline_idle();
 }
 
-void DataProviderInterface::_notify_new_data(const QList<SciQLopPyBuffer> &data)
+// A coarser level than one already notified since the last range request
+// is dropped: it would replace better data for the same range.
+void DataProviderInterface::_notify_new_data(const QList<SciQLopPyBuffer>& data, int level)
 {
+    if (data.isEmpty() || level > m_shown_level)
+        return;
+    m_shown_level = level;
+    Q_EMIT new_data_level(level);
     if (data.size() == 2)
     {
         Q_EMIT new_data_2d(data[0], data[1]);
@@ -85,16 +101,237 @@ void DataProviderInterface::_notify_new_data(const QList<SciQLopPyBuffer> &data)
 void DataProviderInterface::_range_based_update(const SciQLopPlotRange& new_range)
 {
     bool force;
+    std::size_t budget;
     {
         QMutexLocker lock(&m_mutex);
         force = m_force_next_update;
         m_force_next_update = false;
+        budget = m_cache_budget;
     }
+    if (budget != m_tile_cache.budget())
+        m_tile_cache.set_budget(budget);
+    if (force)
+        m_tile_cache.clear();
     if (!force && new_range == m_current_range)
         return;
-    auto r = get_data(new_range.start(), new_range.stop());
+    const auto token = _begin_request(new_range);
+    const auto start = AdaptiveRateLimiter::clock::now();
+    m_shown_level = std::numeric_limits<int>::max();
+    m_previews_allowed = !m_tile_cache.enabled();
+    auto r = m_tile_cache.enabled()
+        ? _cached_get_data(new_range.start(), new_range.stop(), token)
+        : get_data(new_range.start(), new_range.stop());
+    m_previews_allowed = false;
+    const AdaptiveRateLimiter::milliseconds latency = AdaptiveRateLimiter::clock::now() - start;
+    _end_request();
+    if (token.is_cancelled())
+    {
+        // A newer request superseded this one: drop the (possibly partial)
+        // answer, keep showing the current range and keep a pending refresh.
+        if (force)
+        {
+            QMutexLocker lock(&m_mutex);
+            m_force_next_update = true;
+        }
+        return;
+    }
+    {
+        QMutexLocker lock(&m_mutex);
+        m_rate_limiter.on_answer(latency);
+    }
+    ::SciQLopPlots::tracing::counter("dataprovider.latency_ms", latency.count(), "dataprovider");
     m_current_range = new_range;
     _notify_new_data(r);
+    _schedule_prefetch(new_range);
+}
+
+CancellationToken DataProviderInterface::_begin_request(std::optional<SciQLopPlotRange> range)
+{
+    QMutexLocker lock(&m_mutex);
+    m_request_token = CancellationToken::make();
+    m_request_range = range;
+    m_request_started = AdaptiveRateLimiter::clock::now();
+    return m_request_token;
+}
+
+void DataProviderInterface::_end_request()
+{
+    QMutexLocker lock(&m_mutex);
+    m_request_token = {};
+    m_request_range.reset();
+}
+
+void DataProviderInterface::publish_preview(int level, const QList<SciQLopPyBuffer>& data)
+{
+    if (!m_previews_allowed || level <= 0 || cancellation_token().is_cancelled())
+        return;
+    _notify_new_data(data, level);
+}
+
+CancellationToken DataProviderInterface::cancellation_token()
+{
+    QMutexLocker lock(&m_mutex);
+    return m_request_token;
+}
+
+void DataProviderInterface::cancel_stale_requests(const std::optional<SciQLopPlotRange>& new_range)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_request_range)
+    {
+        m_request_token.cancel();
+        return;
+    }
+    if (!new_range)
+        return;
+    // During a scrub every move supersedes the running call: cancelling it
+    // each time would never let an answer through. Its answer still covers
+    // part of an overlapping range, and a young call gets the time the
+    // limiter would make the next request wait anyway.
+    const auto& running = *m_request_range;
+    if (new_range->start() < running.stop() && running.start() < new_range->stop())
+        return;
+    m_request_token.cancel_at(
+        m_request_started
+        + std::chrono::duration_cast<AdaptiveRateLimiter::clock::duration>(
+            m_rate_limiter.max_wait()));
+}
+
+// Fetches only the uncovered parts of [lower, upper], one get_data() call per
+// gap, then stitches the answer from the tiles. An answer that can't be tiled
+// (unsorted or non-float64 keys, ...) turns the cache off until the next
+// invalidate_cache() and the range is fetched whole, as without a cache.
+// Once `token` is cancelled the answer of the running call isn't stored and
+// the remaining gaps aren't fetched.
+QList<SciQLopPyBuffer> DataProviderInterface::_cached_get_data(double lower, double upper,
+                                                               const CancellationToken& token)
+{
+    for (const auto& [start, stop] : m_tile_cache.missing(lower, upper))
+    {
+        auto answer = get_data(start, stop);
+        if (token.is_cancelled())
+            return {};
+        if (!m_tile_cache.insert(start, stop, std::move(answer)))
+        {
+            m_tile_cache.mark_unsupported();
+            return get_data(lower, upper);
+        }
+    }
+    auto r = m_tile_cache.assemble(lower, upper);
+    m_tile_cache.evict();
+    _trace_cache_counters();
+    if (!r)
+    {
+        m_tile_cache.mark_unsupported();
+        return get_data(lower, upper);
+    }
+    return std::move(*r);
+}
+
+// Queues the uncovered parts of the neighbourhood of `range`, nearest first:
+// the range twice as wide (one zoom level out), then the full windows on
+// either side. Each queued interval is at most half a window, which bounds
+// how long a real request can wait behind a prefetch call.
+void DataProviderInterface::_schedule_prefetch(const SciQLopPlotRange& range)
+{
+    m_prefetch_queue.clear();
+    const auto generation = ++m_prefetch_generation;
+    bool enabled;
+    {
+        QMutexLocker lock(&m_mutex);
+        enabled = m_prefetch_enabled;
+    }
+    const double lower = range.start();
+    const double upper = range.stop();
+    const double half = (upper - lower) / 2.;
+    if (!enabled || !m_tile_cache.enabled() || !(half > 0.))
+        return;
+    for (const auto& [start, stop] : { RangeTileCache::Interval { lower - half, lower },
+                                       RangeTileCache::Interval { upper, upper + half },
+                                       RangeTileCache::Interval { lower - 2 * half, lower - half },
+                                       RangeTileCache::Interval { upper + half, upper + 2 * half } })
+    {
+        for (const auto& gap : m_tile_cache.missing(start, stop))
+            m_prefetch_queue.push_back(gap);
+    }
+    if (!m_prefetch_queue.empty())
+        QMetaObject::invokeMethod(
+            this, [this, generation]() { _prefetch_step(generation); }, Qt::QueuedConnection);
+}
+
+void DataProviderInterface::_prefetch_step(std::uint64_t generation)
+{
+    if (generation != m_prefetch_generation || m_prefetch_queue.empty())
+        return;
+    {
+        // A real request is waiting (or prefetch was switched off): give up
+        // the rest, the next range update queues a fresh neighbourhood.
+        QMutexLocker lock(&m_mutex);
+        if (m_range_pending || m_data_pending || m_force_next_update || !m_prefetch_enabled)
+        {
+            m_prefetch_queue.clear();
+            return;
+        }
+    }
+    if (!m_tile_cache.enabled())
+    {
+        m_prefetch_queue.clear();
+        return;
+    }
+    if (DataProviderWorkerPool::instance().queued_requests(thread()) > 0)
+    {
+        // Another provider on this thread has a real request waiting (maybe
+        // still in its rate limiter): step aside and come back after it.
+        QTimer::singleShot(static_cast<int>(AdaptiveRateLimiter::min_delay_ms), this,
+                           [this, generation]() { _prefetch_step(generation); });
+        return;
+    }
+    const auto [start, stop] = m_prefetch_queue.front();
+    m_prefetch_queue.erase(m_prefetch_queue.begin());
+    {
+        ::SciQLopPlots::tracing::ScopedZone _sz("dataprovider.prefetch", "dataprovider");
+        const auto token = _begin_request(std::nullopt);
+        for (const auto& [lower, upper] : m_tile_cache.missing(start, stop))
+        {
+            auto answer = get_data(lower, upper);
+            if (token.is_cancelled())
+            {
+                _end_request();
+                m_prefetch_queue.clear();
+                return;
+            }
+            if (!m_tile_cache.insert(lower, upper, std::move(answer), true))
+            {
+                _end_request();
+                m_tile_cache.mark_unsupported();
+                m_prefetch_queue.clear();
+                return;
+            }
+        }
+        _end_request();
+    }
+    m_tile_cache.evict();
+    _trace_cache_counters();
+    if (!m_prefetch_queue.empty())
+        QMetaObject::invokeMethod(
+            this, [this, generation]() { _prefetch_step(generation); }, Qt::QueuedConnection);
+}
+
+void DataProviderInterface::_trace_cache_counters() const
+{
+    if (!::SciQLopPlots::tracing::is_enabled())
+        return;
+    const auto& stats = m_tile_cache.prefetch_stats();
+    ::SciQLopPlots::tracing::counter("dataprovider.cache.bytes",
+                                     static_cast<double>(m_tile_cache.size_bytes()), "dataprovider");
+    if (stats.tiles == 0)
+        return;
+    ::SciQLopPlots::tracing::counter("dataprovider.prefetch.hit_rate",
+                                     static_cast<double>(stats.hits) / stats.tiles, "dataprovider");
+    ::SciQLopPlots::tracing::counter("dataprovider.prefetch.bytes",
+                                     static_cast<double>(stats.bytes), "dataprovider");
+    ::SciQLopPlots::tracing::counter("dataprovider.prefetch.wasted_bytes",
+                                     static_cast<double>(stats.wasted_bytes), "dataprovider");
 }
 
 void DataProviderInterface::invalidate_cache()
@@ -103,22 +340,71 @@ void DataProviderInterface::invalidate_cache()
     m_force_next_update = true;
 }
 
-void DataProviderInterface::_data_based_update(const _2D_data& new_data)
+void DataProviderInterface::set_cache_budget(std::size_t bytes)
+{
+    QMutexLocker lock(&m_mutex);
+    m_cache_budget = bytes;
+}
+
+std::size_t DataProviderInterface::cache_budget()
+{
+    QMutexLocker lock(&m_mutex);
+    return m_cache_budget;
+}
+
+void DataProviderInterface::set_prefetch_enabled(bool enabled)
+{
+    QMutexLocker lock(&m_mutex);
+    m_prefetch_enabled = enabled;
+}
+
+bool DataProviderInterface::prefetch_enabled()
+{
+    QMutexLocker lock(&m_mutex);
+    return m_prefetch_enabled;
+}
+
+void DataProviderInterface::set_adaptive_rate_limit(bool enabled)
 {
-    _notify_new_data(get_data(new_data.x, new_data.y));
+    QMutexLocker lock(&m_mutex);
+    m_rate_limiter.set_adaptive(enabled);
+}
+
+bool DataProviderInterface::adaptive_rate_limit()
+{
+    QMutexLocker lock(&m_mutex);
+    return m_rate_limiter.adaptive();
+}
+
+void DataProviderInterface::_data_based_update(const _2D_data& new_data, int level)
+{
+    m_serving_level = level;
+    _notify_new_data(get_data(new_data.x, new_data.y), level);
+    m_serving_level = 0;
 }
 
-void DataProviderInterface::_data_based_update(const _3D_data& new_data)
+void DataProviderInterface::_data_based_update(const _3D_data& new_data, int level)
 {
-   _notify_new_data(get_data(new_data.x, new_data.y, new_data.z));
+    m_serving_level = level;
+    _notify_new_data(get_data(new_data.x, new_data.y, new_data.z), level);
+    m_serving_level = 0;
 }
 
-void DataProviderInterface::_data_based_update(const _NDdata &new_data)
+void DataProviderInterface::_data_based_update(const _NDdata& new_data, int level)
 {
-    _notify_new_data(get_data(new_data));
+    m_serving_level = level;
+    _notify_new_data(get_data(new_data), level);
+    m_serving_level = 0;
 }
 
 
+DataProviderInterface::~DataProviderInterface()
+{
+    QMutexLocker lock(&m_mutex);
+    if (const int queued = m_range_pending + m_data_pending)
+        DataProviderWorkerPool::instance().request_taken(thread(), queued);
+}
+
 DataProviderInterface::DataProviderInterface(QObject* parent) : QObject(parent)
 {
     m_rate_limit_timer = new QTimer(this);
@@ -155,28 +441,42 @@ QList<SciQLopPyBuffer> DataProviderInterface::get_data(QList<SciQLopPyBuffer> va
 
 void DataProviderInterface::set_range(SciQLopPlotRange new_state) noexcept
 {
+    cancel_stale_requests(new_state);
+    AdaptiveRateLimiter::milliseconds delay;
     {
         QMutexLocker lock(&m_mutex);
         m_next_range = new_state;
+        if (!m_range_pending)
+            DataProviderWorkerPool::instance().request_queued(thread());
         m_range_pending = true;
+        delay = m_rate_limiter.on_request(AdaptiveRateLimiter::clock::now());
     }
+    ::SciQLopPlots::tracing::counter("dataprovider.debounce_ms", delay.count(), "dataprovider");
     // Range fetches are rate-limited (panning spams them): the timer coalesces
-    // the wake-up. _threaded_update then services whichever slots are pending.
-    QMetaObject::invokeMethod(m_rate_limit_timer, qOverload<>(&QTimer::start),
-                              Qt::QueuedConnection);
+    // the wake-up, each request restarting it with the delay the limiter
+    // picked. _threaded_update then services whichever slots are pending.
+    const auto ms = static_cast<int>(std::ceil(delay.count()));
+    QMetaObject::invokeMethod(
+        m_rate_limit_timer, [timer = m_rate_limit_timer, ms]() { timer->start(ms); },
+        Qt::QueuedConnection);
 }
 
 // The data setters wake on their OWN pending flag only, independently of a
 // pending range fetch — so a range fetch in flight no longer suppresses the
 // data wake-up (and vice-versa). Consecutive data calls still coalesce.
-void DataProviderInterface::set_data(_2D_data new_state) noexcept
+void DataProviderInterface::set_data(_2D_data new_state, int level) noexcept
 {
+    cancel_stale_requests(std::nullopt);
     bool should_emit = false;
     {
         QMutexLocker lock(&m_mutex);
+        if (m_data_pending && level > m_next_data_level)
+            return;
         m_next_data = new_state;
+        m_next_data_level = level;
         if (!m_data_pending)
         {
+            DataProviderWorkerPool::instance().request_queued(thread());
             m_data_pending = true;
             should_emit = true;
         }
@@ -185,14 +485,19 @@ void DataProviderInterface::set_data(_2D_data new_state) noexcept
         Q_EMIT _state_changed();
 }
 
-void DataProviderInterface::set_data(_3D_data new_state) noexcept
+void DataProviderInterface::set_data(_3D_data new_state, int level) noexcept
 {
+    cancel_stale_requests(std::nullopt);
     bool should_emit = false;
     {
         QMutexLocker lock(&m_mutex);
+        if (m_data_pending && level > m_next_data_level)
+            return;
         m_next_data = new_state;
+        m_next_data_level = level;
         if (!m_data_pending)
         {
+            DataProviderWorkerPool::instance().request_queued(thread());
             m_data_pending = true;
             should_emit = true;
         }
@@ -201,14 +506,19 @@ void DataProviderInterface::set_data(_3D_data new_state) noexcept
         Q_EMIT _state_changed();
 }
 
-void DataProviderInterface::set_data(_NDdata new_state) noexcept
+void DataProviderInterface::set_data(_NDdata new_state, int level) noexcept
 {
+    cancel_stale_requests(std::nullopt);
     bool should_emit = false;
     {
         QMutexLocker lock(&m_mutex);
+        if (m_data_pending && level > m_next_data_level)
+            return;
         m_next_data = new_state;
+        m_next_data_level = level;
         if (!m_data_pending)
         {
+            DataProviderWorkerPool::instance().request_queued(thread());
             m_data_pending = true;
             should_emit = true;
         }
@@ -219,17 +529,28 @@ void DataProviderInterface::set_data(_NDdata new_state) noexcept
 
 DataProviderWorker::~DataProviderWorker()
 {
-    m_worker_thread->quit();
-    m_worker_thread->wait();
+    if (m_data_provider)
+    {
+        {
+            // Nobody will see the answer: let a running call stop early.
+            QMutexLocker lock(&m_data_provider->m_mutex);
+            m_data_provider->m_request_token.cancel();
+        }
+        m_data_provider->deleteLater();
+    }
+    if (m_worker_thread)
+        DataProviderWorkerPool::instance().release(m_worker_thread);
 }
 
+// Once the application is quitting the pool hands out no thread and the
+// provider stays on the caller's thread.
 void DataProviderWorker::set_data_provider(DataProviderInterface* data_provider)
 {
     data_provider->setParent(nullptr);
     m_data_provider = data_provider;
-    m_data_provider->moveToThread(m_worker_thread);
-    connect(m_worker_thread, &QThread::finished, m_data_provider, &QObject::deleteLater);
-    connect(m_worker_thread, &QThread::finished, m_worker_thread, &QObject::deleteLater);
+    m_worker_thread = DataProviderWorkerPool::instance().acquire();
+    if (m_worker_thread)
+        m_data_provider->moveToThread(m_worker_thread);
 }
 
 SimplePyCallablePipeline::SimplePyCallablePipeline(GetDataPyCallable&& callable, QObject* parent)
@@ -244,6 +565,8 @@ SimplePyCallablePipeline::SimplePyCallablePipeline(GetDataPyCallable&& callable,
         &SimplePyCallablePipeline::new_data_3d);
     connect(m_callable_wrapper, &SimplePyCallablePWrapper::new_data_nd, this,
         &SimplePyCallablePipeline::new_data_nd);
+    connect(m_callable_wrapper, &SimplePyCallablePWrapper::new_data_level, this,
+        &SimplePyCallablePipeline::new_data_level);
     connect(m_callable_wrapper, &SimplePyCallablePWrapper::pipeline_idle, this,
         &SimplePyCallablePipeline::pipeline_idle);
 }
@@ -255,12 +578,61 @@ RemoteDataPipeline::RemoteDataPipeline(QObject* parent) : QObject(parent)
     m_worker->set_data_provider(m_provider);
     connect(m_provider, &RemoteDataProvider::data_requested, this,
             &RemoteDataPipeline::data_requested);
+    connect(m_provider, &RemoteDataProvider::request_cancelled, this,
+            &RemoteDataPipeline::request_cancelled);
     connect(m_provider, &RemoteDataProvider::new_data_2d, this,
             &RemoteDataPipeline::new_data_2d);
     connect(m_provider, &RemoteDataProvider::new_data_3d, this,
             &RemoteDataPipeline::new_data_3d);
     connect(m_provider, &RemoteDataProvider::new_data_nd, this,
             &RemoteDataPipeline::new_data_nd);
+    connect(m_provider, &RemoteDataProvider::new_data_level, this,
+            &RemoteDataPipeline::new_data_level);
     connect(m_provider, &RemoteDataProvider::pipeline_idle, this,
             &RemoteDataPipeline::pipeline_idle);
 }
+
+bool RemoteDataPipeline::attach_shared_memory(const QString& name, int poll_interval_ms)
+{
+    detach_shared_memory();
+    auto ring = std::make_shared<SharedMemoryRingReader>(name.toStdString());
+    if (!ring->is_open())
+        return false;
+    m_ring = std::move(ring);
+    if (poll_interval_ms > 0)
+    {
+        m_ring_poll_timer = new QTimer(this);
+        connect(m_ring_poll_timer, &QTimer::timeout, this,
+                &RemoteDataPipeline::consume_shared_memory);
+        m_ring_poll_timer->start(poll_interval_ms);
+    }
+    return true;
+}
+
+void RemoteDataPipeline::detach_shared_memory()
+{
+    if (m_ring_poll_timer)
+    {
+        delete m_ring_poll_timer;
+        m_ring_poll_timer = nullptr;
+    }
+    // Frames already handed to the pipeline keep the segment mapped.
+    m_ring.reset();
+}
+
+int RemoteDataPipeline::consume_shared_memory()
+{
+    if (!m_ring)
+        return 0;
+    int frames = 0;
+    while (auto frame = m_ring->take_next())
+    {
+        // A frame superseded while still pending in the provider is dropped
+        // there, which frees its slot.
+        m_worker->set_data(std::move(*frame));
+        ++frames;
+    }
+    if (frames > 0)
+        ::SciQLopPlots::tracing::counter("dataprovider.shm_frames", frames, "dataprovider");
+    return frames;
+}
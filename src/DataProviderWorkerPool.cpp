@@ -0,0 +1,140 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#include "SciQLopPlots/DataProducer/DataProviderWorkerPool.hpp"
+
+#include <QCoreApplication>
+#include <algorithm>
+
+namespace
+{
+auto find_slot(auto& slots, QThread* thread)
+{
+    return std::find_if(std::begin(slots), std::end(slots),
+                        [thread](const auto& s) { return s.thread == thread; });
+}
+} // namespace
+
+DataProviderWorkerPool::DataProviderWorkerPool()
+        // Provider calls mostly wait on I/O (archives, web services, disks),
+        // and Python releases the GIL while they block, so a provider stuck
+        // behind a busy neighbour on its thread waits for nothing the CPU is
+        // doing. Size for blocking calls, not for cores.
+        : m_max_threads { std::clamp(2 * QThread::idealThreadCount(), 8, 16) }
+{
+}
+
+// Threads still inside a provider call after the interpreter is gone would
+// never return: wait a little, then leave them to the process exit.
+DataProviderWorkerPool::~DataProviderWorkerPool()
+{
+    _stop();
+    for (auto& slot : m_slots)
+    {
+        if (slot.thread->wait(500))
+            delete slot.thread;
+    }
+}
+
+void DataProviderWorkerPool::_stop()
+{
+    QMutexLocker lock(&m_mutex);
+    m_stopped = true;
+    for (auto& slot : m_slots)
+        slot.thread->quit();
+}
+
+DataProviderWorkerPool& DataProviderWorkerPool::instance()
+{
+    static DataProviderWorkerPool pool;
+    return pool;
+}
+
+QThread* DataProviderWorkerPool::acquire()
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_stopped)
+        return nullptr;
+    auto least = std::min_element(std::begin(m_slots), std::end(m_slots),
+                                  [](const Slot& a, const Slot& b)
+                                  { return a.providers < b.providers; });
+    if (least == std::end(m_slots)
+        || (least->providers > 0 && std::size(m_slots) < static_cast<std::size_t>(m_max_threads)))
+    {
+        if (m_slots.empty() && QCoreApplication::instance())
+            QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                             [] { instance()._stop(); });
+        auto* thread = new QThread;
+        thread->setObjectName(QStringLiteral("dataProv-%1").arg(static_cast<int>(std::size(m_slots))));
+        thread->start();
+        m_slots.push_back({ thread, 0 });
+        least = std::prev(std::end(m_slots));
+    }
+    ++least->providers;
+    return least->thread;
+}
+
+void DataProviderWorkerPool::release(QThread* thread)
+{
+    QMutexLocker lock(&m_mutex);
+    auto slot = find_slot(m_slots, thread);
+    if (slot != std::end(m_slots) && slot->providers > 0)
+        --slot->providers;
+}
+
+void DataProviderWorkerPool::request_queued(QThread* thread)
+{
+    QMutexLocker lock(&m_mutex);
+    if (auto slot = find_slot(m_slots, thread); slot != std::end(m_slots))
+        ++slot->queued_requests;
+}
+
+void DataProviderWorkerPool::request_taken(QThread* thread, int count)
+{
+    QMutexLocker lock(&m_mutex);
+    if (auto slot = find_slot(m_slots, thread); slot != std::end(m_slots))
+        slot->queued_requests -= count;
+}
+
+int DataProviderWorkerPool::queued_requests(QThread* thread) const
+{
+    QMutexLocker lock(&m_mutex);
+    auto slot = find_slot(m_slots, thread);
+    return slot != std::end(m_slots) ? slot->queued_requests : 0;
+}
+
+void DataProviderWorkerPool::set_max_threads(int n)
+{
+    QMutexLocker lock(&m_mutex);
+    m_max_threads = std::max(1, n);
+}
+
+int DataProviderWorkerPool::max_threads() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_max_threads;
+}
+
+int DataProviderWorkerPool::thread_count() const
+{
+    QMutexLocker lock(&m_mutex);
+    return static_cast<int>(std::size(m_slots));
+}
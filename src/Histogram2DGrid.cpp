@@ -0,0 +1,669 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#include "SciQLopPlots/Plotables/Histogram2DGrid.hpp"
+#include "SciQLopPlots/DSP/Parallel.hpp"
+#include "SciQLopPlots/Python/DtypeDispatch.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+constexpr double inf = std::numeric_limits<double>::infinity();
+constexpr std::size_t min_block_points = std::size_t { 1 } << 16;
+
+template <typename F>
+void dispatch_xy(const Histogram2DPoints::Chunk& chunk, F&& f)
+{
+    dispatch_dtype(chunk.x.format_code(),
+                   [&](auto x_tag)
+                   {
+                       dispatch_dtype(chunk.y.format_code(),
+                                      [&](auto y_tag)
+                                      {
+                                          using X = typename decltype(x_tag)::type;
+                                          using Y = typename decltype(y_tag)::type;
+                                          f(static_cast<const X*>(chunk.x.raw_data()),
+                                            static_cast<const Y*>(chunk.y.raw_data()));
+                                      });
+                   });
+}
+
+// Points of a chunk a pass looks at: positions [first, last) of `order`
+// (or of the chunk itself when null), restricted to point indices below
+// limit and x in [x_lo, x_hi).
+struct Slice
+{
+    const std::uint32_t* order = nullptr;
+    std::size_t first = 0;
+    std::size_t last = 0;
+    std::size_t limit = 0;
+    double x_lo = -inf;
+    double x_hi = inf;
+};
+
+struct Extent
+{
+    double x_lo = inf;
+    double x_hi = -inf;
+    double y_lo = inf;
+    double y_hi = -inf;
+
+    inline bool empty() const noexcept { return x_lo > x_hi; }
+
+    inline void merge(const Extent& other) noexcept
+    {
+        x_lo = std::min(x_lo, other.x_lo);
+        x_hi = std::max(x_hi, other.x_hi);
+        y_lo = std::min(y_lo, other.y_lo);
+        y_hi = std::max(y_hi, other.y_hi);
+    }
+};
+
+// Extent of the binnable points of a slice (finite, positive on a log axis),
+// in the axes' own space (log10 for a log axis).
+template <typename X, typename Y>
+Extent slice_extent(const X* x, const Y* y, const Slice& s, bool x_log, bool y_log)
+{
+    Extent total;
+    std::mutex mutex;
+    sqp::dsp::parallel_for_blocks(
+        s.last - s.first, min_block_points,
+        [&](std::size_t b0, std::size_t b1)
+        {
+            Extent local;
+            for (std::size_t k = s.first + b0; k < s.first + b1; ++k)
+            {
+                const std::size_t p = s.order ? s.order[k] : k;
+                if (p >= s.limit)
+                    continue;
+                const double xv = static_cast<double>(x[p]);
+                const double yv = static_cast<double>(y[p]);
+                if (!(xv >= s.x_lo && xv < s.x_hi) || !std::isfinite(yv))
+                    continue;
+                if ((x_log && !(xv > 0.)) || (y_log && !(yv > 0.)))
+                    continue;
+                local.x_lo = std::min(local.x_lo, xv);
+                local.x_hi = std::max(local.x_hi, xv);
+                local.y_lo = std::min(local.y_lo, yv);
+                local.y_hi = std::max(local.y_hi, yv);
+            }
+            std::lock_guard lock { mutex };
+            total.merge(local);
+        });
+    if (!total.empty())
+    {
+        if (x_log)
+        {
+            total.x_lo = std::log10(total.x_lo);
+            total.x_hi = std::log10(total.x_hi);
+        }
+        if (y_log)
+        {
+            total.y_lo = std::log10(total.y_lo);
+            total.y_hi = std::log10(total.y_hi);
+        }
+    }
+    return total;
+}
+
+// Adds sign times the counts of a slice to `counts`. Each block fills its own
+// partial grid; blocks are sized so that a partial is small next to the points
+// it counts.
+template <typename X, typename Y>
+void accumulate(const X* x, const Y* y, const Slice& s, const Histogram2DGrid::Axis& ax,
+                const Histogram2DGrid::Axis& ay, double sign, std::vector<double>& counts)
+{
+    const std::size_t cells = counts.size();
+    std::mutex mutex;
+    sqp::dsp::parallel_for_blocks(
+        s.last - s.first, std::max(min_block_points, 8 * cells),
+        [&](std::size_t b0, std::size_t b1)
+        {
+            std::vector<std::uint32_t> partial(cells, 0);
+            for (std::size_t k = s.first + b0; k < s.first + b1; ++k)
+            {
+                const std::size_t p = s.order ? s.order[k] : k;
+                if (p >= s.limit)
+                    continue;
+                const double xv = static_cast<double>(x[p]);
+                if (!(xv >= s.x_lo && xv < s.x_hi))
+                    continue;
+                const int i = ax.bin(xv);
+                if (i < 0)
+                    continue;
+                const int j = ay.bin(static_cast<double>(y[p]));
+                if (j < 0)
+                    continue;
+                ++partial[static_cast<std::size_t>(i) * ay.bins + j];
+            }
+            std::lock_guard lock { mutex };
+            for (std::size_t c = 0; c < cells; ++c)
+                counts[c] += sign * partial[c];
+        });
+}
+
+// Every point of a chunk in [x_lo, x_hi), as a slice.
+Slice whole(const Histogram2DPoints::Chunk& chunk, double x_lo, double x_hi)
+{
+    return Slice { nullptr, 0, chunk.size, chunk.size, x_lo, x_hi };
+}
+
+// Points of a chunk numbered below limit with x in [x_lo, x_hi), found by
+// bisecting its x order.
+Slice x_slice(const Histogram2DPoints::Chunk& chunk, std::size_t limit, double x_lo, double x_hi)
+{
+    Slice s { nullptr, 0, 0, limit, x_lo, x_hi };
+    dispatch_dtype(chunk.x.format_code(),
+                   [&](auto x_tag)
+                   {
+                       using X = typename decltype(x_tag)::type;
+                       const auto* x = static_cast<const X*>(chunk.x.raw_data());
+                       const auto below = [x](std::size_t p, double v)
+                       { return static_cast<double>(x[p]) < v; };
+                       if (chunk.x_sorted)
+                       {
+                           // Identity order: bisect positions directly.
+                           std::size_t lo = 0, hi = std::min(limit, chunk.size);
+                           const auto bound = [&](double v)
+                           {
+                               std::size_t a = lo, b = hi;
+                               while (a < b)
+                               {
+                                   const std::size_t m = a + (b - a) / 2;
+                                   if (below(m, v))
+                                       a = m + 1;
+                                   else
+                                       b = m;
+                               }
+                               return a;
+                           };
+                           s.first = bound(x_lo);
+                           s.last = bound(x_hi);
+                           return;
+                       }
+                       const auto& order = chunk.order();
+                       s.order = order.data();
+                       const auto cmp = [&](std::uint32_t p, double v) { return below(p, v); };
+                       s.first = std::lower_bound(order.begin(), order.end(), x_lo, cmp)
+                           - order.begin();
+                       s.last = std::lower_bound(order.begin() + s.first, order.end(), x_hi, cmp)
+                           - order.begin();
+                   });
+    return s;
+}
+
+Histogram2DGrid::Axis make_axis(double lo, double hi, int bins, bool log)
+{
+    if (!(hi > lo))
+    {
+        lo -= 0.5;
+        hi += 0.5;
+    }
+    return Histogram2DGrid::Axis { lo, hi, std::max(bins, 1), log };
+}
+
+struct Keyed
+{
+    double x;
+    std::uint32_t index;
+};
+
+void parallel_sort(std::vector<Keyed>& items)
+{
+    const auto cmp = [](const Keyed& a, const Keyed& b) { return a.x < b.x; };
+    const std::size_t n = items.size();
+    const std::size_t blocks = std::clamp<std::size_t>(
+        n / min_block_points, 1, sqp::dsp::pool().thread_count());
+    if (blocks == 1)
+    {
+        std::sort(items.begin(), items.end(), cmp);
+        return;
+    }
+    std::vector<std::size_t> bounds(blocks + 1);
+    for (std::size_t b = 0; b <= blocks; ++b)
+        bounds[b] = b * n / blocks;
+    sqp::dsp::parallel_for(blocks,
+                           [&](std::size_t b) {
+                               std::sort(items.begin() + bounds[b], items.begin() + bounds[b + 1],
+                                         cmp);
+                           });
+    std::vector<Keyed> scratch(n);
+    auto* src = &items;
+    auto* dst = &scratch;
+    for (std::size_t width = 1; width < blocks; width *= 2)
+    {
+        const std::size_t pairs = (blocks + 2 * width - 1) / (2 * width);
+        sqp::dsp::parallel_for(pairs,
+                               [&](std::size_t pair)
+                               {
+                                   const std::size_t b0 = pair * 2 * width;
+                                   const std::size_t b1 = std::min(b0 + width, blocks);
+                                   const std::size_t b2 = std::min(b0 + 2 * width, blocks);
+                                   std::merge(src->begin() + bounds[b0], src->begin() + bounds[b1],
+                                              src->begin() + bounds[b1], src->begin() + bounds[b2],
+                                              dst->begin() + bounds[b0], cmp);
+                               });
+        std::swap(src, dst);
+    }
+    if (src != &items)
+        items.swap(scratch);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Histogram2DPoints
+// ---------------------------------------------------------------------------
+
+Histogram2DPoints::Chunk::Chunk(SciQLopPyBuffer x_, SciQLopPyBuffer y_, std::size_t seq_)
+        : x { std::move(x_) }, y { std::move(y_) }, seq { seq_ }, size { x.flat_size() }
+{
+    struct Scan
+    {
+        double lo = inf;
+        double hi = -inf;
+        double first = std::numeric_limits<double>::quiet_NaN();
+        double last = std::numeric_limits<double>::quiet_NaN();
+        bool sorted = true;
+    };
+    std::vector<std::pair<std::size_t, Scan>> scans;
+    std::mutex mutex;
+    dispatch_dtype(x.format_code(),
+                   [&](auto x_tag)
+                   {
+                       using X = typename decltype(x_tag)::type;
+                       const auto* data = static_cast<const X*>(x.raw_data());
+                       sqp::dsp::parallel_for_blocks(
+                           size, min_block_points,
+                           [&](std::size_t b0, std::size_t b1)
+                           {
+                               Scan scan;
+                               double prev = -inf;
+                               for (std::size_t i = b0; i < b1; ++i)
+                               {
+                                   const double v = static_cast<double>(data[i]);
+                                   if (!std::isfinite(v))
+                                   {
+                                       scan.sorted = false;
+                                       continue;
+                                   }
+                                   scan.sorted = scan.sorted && v >= prev;
+                                   prev = v;
+                                   scan.lo = std::min(scan.lo, v);
+                                   scan.hi = std::max(scan.hi, v);
+                               }
+                               scan.first = static_cast<double>(data[b0]);
+                               scan.last = static_cast<double>(data[b1 - 1]);
+                               std::lock_guard lock { mutex };
+                               scans.emplace_back(b0, scan);
+                           });
+                   });
+    std::sort(scans.begin(), scans.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    double lo = inf, hi = -inf;
+    bool sorted = true;
+    for (std::size_t b = 0; b < scans.size(); ++b)
+    {
+        const auto& scan = scans[b].second;
+        lo = std::min(lo, scan.lo);
+        hi = std::max(hi, scan.hi);
+        sorted = sorted && scan.sorted && (b == 0 || scans[b - 1].second.last <= scan.first);
+    }
+    if (lo <= hi)
+    {
+        x_min = lo;
+        x_max = hi;
+    }
+    x_sorted = sorted && size > 0;
+}
+
+const std::vector<std::uint32_t>& Histogram2DPoints::Chunk::order() const
+{
+    std::call_once(m_order_once,
+                   [this]
+                   {
+                       if (x_sorted)
+                           return;
+                       std::vector<Keyed> keyed;
+                       keyed.reserve(size);
+                       dispatch_dtype(x.format_code(),
+                                      [&](auto x_tag)
+                                      {
+                                          using X = typename decltype(x_tag)::type;
+                                          const auto* data = static_cast<const X*>(x.raw_data());
+                                          for (std::size_t i = 0; i < size; ++i)
+                                          {
+                                              const double v = static_cast<double>(data[i]);
+                                              if (std::isfinite(v))
+                                                  keyed.push_back(
+                                                      { v, static_cast<std::uint32_t>(i) });
+                                          }
+                                      });
+                       parallel_sort(keyed);
+                       m_order.resize(keyed.size());
+                       for (std::size_t k = 0; k < keyed.size(); ++k)
+                           m_order[k] = keyed[k].index;
+                   });
+    return m_order;
+}
+
+void Histogram2DPoints::set(const SciQLopPyBuffer& x, const SciQLopPyBuffer& y)
+{
+    if (x.flat_size() != y.flat_size())
+        throw std::invalid_argument("Histogram2D: x and y must have the same length");
+    if (x.flat_size() > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+        throw std::invalid_argument(
+            "Histogram2D: buffer size exceeds INT_MAX (2^31-1) elements");
+    ++m_epoch;
+    m_chunks.clear();
+    m_end_seq = 0;
+    m_x_max = -inf;
+    append(x, y);
+}
+
+void Histogram2DPoints::append(const SciQLopPyBuffer& x, const SciQLopPyBuffer& y)
+{
+    if (x.flat_size() != y.flat_size())
+        throw std::invalid_argument("Histogram2D: x and y must have the same length");
+    if (x.flat_size() > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+        throw std::invalid_argument(
+            "Histogram2D: buffer size exceeds INT_MAX (2^31-1) elements");
+    if (x.flat_size() == 0)
+        return;
+    auto chunk = std::make_shared<const Chunk>(x, y, m_end_seq);
+    m_end_seq += chunk->size;
+    if (!std::isnan(chunk->x_max))
+        m_x_max = std::max(m_x_max, chunk->x_max);
+    m_chunks.push_back(std::move(chunk));
+    _merge_tail();
+}
+
+void Histogram2DPoints::clear()
+{
+    ++m_epoch;
+    m_chunks.clear();
+    m_end_seq = 0;
+    m_x_max = -inf;
+}
+
+void Histogram2DPoints::set_window(double window)
+{
+    m_window = window > 0. ? window : 0.;
+}
+
+double Histogram2DPoints::_cut() const noexcept
+{
+    if (m_window <= 0. || !std::isfinite(m_x_max))
+        return -inf;
+    return m_x_max - m_window;
+}
+
+void Histogram2DPoints::release(double counted_cut)
+{
+    const double cut = std::min(_cut(), counted_cut);
+    std::erase_if(m_chunks, [cut](const auto& chunk) { return chunk->x_max < cut; });
+}
+
+void Histogram2DPoints::_merge_tail()
+{
+    while (m_chunks.size() >= 2)
+    {
+        const auto& a = m_chunks[m_chunks.size() - 2];
+        const auto& b = m_chunks.back();
+        if (a->size >= merge_limit || b->size >= merge_limit || a->size > 2 * b->size
+            || a->seq + a->size != b->seq)
+            return;
+        const std::size_t n = a->size + b->size;
+        auto xs = std::make_shared<std::vector<double>>(n);
+        auto ys = std::make_shared<std::vector<double>>(n);
+        std::size_t offset = 0;
+        for (const auto* chunk : { a.get(), b.get() })
+        {
+            dispatch_xy(*chunk,
+                        [&](const auto* x, const auto* y)
+                        {
+                            for (std::size_t i = 0; i < chunk->size; ++i)
+                            {
+                                (*xs)[offset + i] = static_cast<double>(x[i]);
+                                (*ys)[offset + i] = static_cast<double>(y[i]);
+                            }
+                        });
+            offset += chunk->size;
+        }
+        auto merged = std::make_shared<const Chunk>(
+            SciQLopPyBuffer::from_memory(xs->data(), { n }, 'd', sizeof(double), xs),
+            SciQLopPyBuffer::from_memory(ys->data(), { n }, 'd', sizeof(double), ys), a->seq);
+        m_chunks.pop_back();
+        m_chunks.back() = std::move(merged);
+    }
+}
+
+Histogram2DPoints::Snapshot Histogram2DPoints::snapshot() const
+{
+    return Snapshot { m_chunks, m_epoch, m_end_seq, _cut() };
+}
+
+std::pair<SciQLopPyBuffer, SciQLopPyBuffer> Histogram2DPoints::data() const
+{
+    const double cut = _cut();
+    if (m_chunks.size() == 1 && m_chunks.front()->seq == 0
+        && !(m_chunks.front()->x_min < cut))
+        return { m_chunks.front()->x, m_chunks.front()->y };
+    auto xs = std::make_shared<std::vector<double>>();
+    auto ys = std::make_shared<std::vector<double>>();
+    for (const auto& chunk : m_chunks)
+    {
+        dispatch_xy(*chunk,
+                    [&](const auto* x, const auto* y)
+                    {
+                        for (std::size_t i = 0; i < chunk->size; ++i)
+                        {
+                            const double xv = static_cast<double>(x[i]);
+                            if (xv < cut)
+                                continue;
+                            xs->push_back(xv);
+                            ys->push_back(static_cast<double>(y[i]));
+                        }
+                    });
+    }
+    if (xs->empty())
+        return {};
+    const std::size_t n = xs->size();
+    return { SciQLopPyBuffer::from_memory(xs->data(), { n }, 'd', sizeof(double), xs),
+             SciQLopPyBuffer::from_memory(ys->data(), { n }, 'd', sizeof(double), ys) };
+}
+
+// ---------------------------------------------------------------------------
+// Histogram2DGrid
+// ---------------------------------------------------------------------------
+
+double Histogram2DGrid::Axis::edge(int i) const noexcept
+{
+    const double t = lo + (hi - lo) * i / bins;
+    return log ? std::pow(10., t) : t;
+}
+
+double Histogram2DGrid::Axis::centre(int i) const noexcept
+{
+    const double t = lo + (hi - lo) * (i + 0.5) / bins;
+    return log ? std::pow(10., t) : t;
+}
+
+std::shared_ptr<const Histogram2DGrid> Histogram2DGrid::build(const Input& input)
+{
+    const auto& points = input.points;
+    const auto& settings = input.settings;
+    const auto* previous = input.previous.get();
+    auto grid = std::make_shared<Histogram2DGrid>();
+    grid->m_settings = settings;
+    grid->m_epoch = points.epoch;
+    grid->m_end_seq = points.end_seq;
+    grid->m_cut = points.cut;
+
+    const bool comparable = previous && !previous->empty() && previous->m_epoch == points.epoch
+        && previous->m_settings.same_binning(settings) && previous->m_end_seq <= points.end_seq
+        && points.cut >= previous->m_cut;
+
+    if (comparable)
+    {
+        // Points appended since the previous grid, and whether they fit it.
+        Extent added;
+        for (const auto& chunk : points.chunks)
+        {
+            if (chunk->seq + chunk->size <= previous->m_end_seq)
+                continue;
+            Slice s = whole(*chunk, points.cut, inf);
+            s.first = previous->m_end_seq > chunk->seq ? previous->m_end_seq - chunk->seq : 0;
+            dispatch_xy(*chunk, [&](const auto* x, const auto* y)
+                        { added.merge(slice_extent(x, y, s, settings.x_log, settings.y_log)); });
+        }
+        const auto& px = previous->m_x;
+        const auto& py = previous->m_y;
+        if (added.empty()
+            || (added.x_lo >= px.lo && added.x_hi <= px.hi && added.y_lo >= py.lo
+                && added.y_hi <= py.hi))
+        {
+            grid->m_x = px;
+            grid->m_y = py;
+            grid->m_counts = previous->m_counts;
+            for (const auto& chunk : points.chunks)
+            {
+                dispatch_xy(*chunk,
+                            [&](const auto* x, const auto* y)
+                            {
+                                if (chunk->seq + chunk->size > previous->m_end_seq)
+                                {
+                                    Slice s = whole(*chunk, points.cut, inf);
+                                    s.first = previous->m_end_seq > chunk->seq
+                                        ? previous->m_end_seq - chunk->seq
+                                        : 0;
+                                    accumulate(x, y, s, grid->m_x, grid->m_y, 1.,
+                                               grid->m_counts);
+                                }
+                                // Counted points the window moved past.
+                                if (points.cut > previous->m_cut && chunk->seq < previous->m_end_seq
+                                    && chunk->x_min < points.cut
+                                    && chunk->x_max >= previous->m_cut)
+                                {
+                                    const Slice s = x_slice(*chunk,
+                                                            previous->m_end_seq - chunk->seq,
+                                                            previous->m_cut, points.cut);
+                                    accumulate(x, y, s, grid->m_x, grid->m_y, -1.,
+                                               grid->m_counts);
+                                }
+                            });
+            }
+            grid->m_incremental = true;
+            grid->_finish();
+            return grid;
+        }
+    }
+
+    Extent extent;
+    for (const auto& chunk : points.chunks)
+        dispatch_xy(*chunk,
+                    [&](const auto* x, const auto* y) {
+                        extent.merge(slice_extent(x, y, whole(*chunk, points.cut, inf),
+                                                  settings.x_log, settings.y_log));
+                    });
+    if (extent.empty())
+    {
+        grid->_finish();
+        return grid;
+    }
+    if (comparable)
+    {
+        // An append outgrew the previous grid: leave room for the next ones.
+        const auto grow = [](double& lo, double& hi, double old_lo, double old_hi)
+        {
+            const double headroom = (hi - lo) / 4.;
+            if (lo < old_lo)
+                lo -= headroom;
+            if (hi > old_hi)
+                hi += headroom;
+        };
+        grow(extent.x_lo, extent.x_hi, previous->m_x.lo, previous->m_x.hi);
+        grow(extent.y_lo, extent.y_hi, previous->m_y.lo, previous->m_y.hi);
+    }
+    grid->m_x = make_axis(extent.x_lo, extent.x_hi, settings.x_bins, settings.x_log);
+    grid->m_y = make_axis(extent.y_lo, extent.y_hi, settings.y_bins, settings.y_log);
+    grid->m_counts.assign(static_cast<std::size_t>(grid->m_x.bins) * grid->m_y.bins, 0.);
+    for (const auto& chunk : points.chunks)
+        dispatch_xy(*chunk,
+                    [&](const auto* x, const auto* y) {
+                        accumulate(x, y, whole(*chunk, points.cut, inf), grid->m_x, grid->m_y, 1.,
+                                   grid->m_counts);
+                    });
+    grid->_finish();
+    return grid;
+}
+
+void Histogram2DGrid::_finish()
+{
+    m_total = 0.;
+    for (double c : m_counts)
+        m_total += c;
+    m_z = m_counts;
+    m_x_positions.clear();
+    m_y_positions.clear();
+    m_plane.clear();
+    if (m_total <= 0.)
+        return;
+
+    const auto nx = static_cast<std::size_t>(m_x.bins);
+    const auto ny = static_cast<std::size_t>(m_y.bins);
+    if (m_settings.column_normalized)
+    {
+        for (std::size_t i = 0; i < nx; ++i)
+        {
+            double sum = 0.;
+            for (std::size_t j = 0; j < ny; ++j)
+                sum += m_z[i * ny + j];
+            if (sum > 0.)
+                for (std::size_t j = 0; j < ny; ++j)
+                    m_z[i * ny + j] /= sum;
+        }
+    }
+
+    const auto positions = [](const Axis& axis, std::vector<double>& out)
+    {
+        if (axis.bins == 1)
+            out = { axis.edge(0), axis.edge(1) };
+        else
+            for (int i = 0; i < axis.bins; ++i)
+                out.push_back(axis.centre(i));
+    };
+    positions(m_x, m_x_positions);
+    positions(m_y, m_y_positions);
+    if (nx > 1 && ny > 1)
+    {
+        m_plane = m_z;
+        return;
+    }
+    const std::size_t px = m_x_positions.size();
+    const std::size_t py = m_y_positions.size();
+    m_plane.resize(px * py);
+    for (std::size_t i = 0; i < px; ++i)
+        for (std::size_t j = 0; j < py; ++j)
+            m_plane[i * py + j] = m_z[std::min(i, nx - 1) * ny + std::min(j, ny - 1)];
+}
@@ -0,0 +1,334 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#include "SciQLopPlots/Plotables/LodIndex.hpp"
+#include "SciQLopPlots/DSP/Parallel.hpp"
+#include "SciQLopPlots/Python/DtypeDispatch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace
+{
+constexpr double inf = std::numeric_limits<double>::infinity();
+
+inline void merge(LodIndex::Bucket& into, const LodIndex::Bucket& other) noexcept
+{
+    if (other.min < into.min)
+    {
+        into.min = other.min;
+        into.min_row = other.min_row;
+    }
+    if (other.max > into.max)
+    {
+        into.max = other.max;
+        into.max_row = other.max_row;
+    }
+}
+
+struct Layout
+{
+    std::size_t rows;
+    std::size_t columns;
+    bool row_major;
+
+    explicit Layout(const SciQLopPyBuffer& y)
+            : rows { y.ndim() == 1 ? y.flat_size() : y.size(0) }
+            , columns { y.ndim() == 1 ? 1 : y.size(1) }
+            , row_major { y.ndim() == 1 || y.row_major() }
+    {
+    }
+
+    template <typename V>
+    inline double at(const V* values, std::size_t row, std::size_t column) const noexcept
+    {
+        return static_cast<double>(row_major ? values[row * columns + column]
+                                             : values[column * rows + row]);
+    }
+};
+
+// Finite min/max of one column over rows [first, last), merged into `into`.
+template <typename V>
+inline void scan(const V* values, const Layout& layout, std::size_t column, std::size_t first,
+                 std::size_t last, LodIndex::Bucket& into) noexcept
+{
+    for (std::size_t row = first; row < last; ++row)
+    {
+        const double v = layout.at(values, row, column);
+        if constexpr (std::is_floating_point_v<V>)
+        {
+            if (!std::isfinite(v))
+                continue;
+        }
+        if (v < into.min)
+        {
+            into.min = v;
+            into.min_row = row;
+        }
+        if (v > into.max)
+        {
+            into.max = v;
+            into.max_row = row;
+        }
+    }
+}
+
+}
+
+std::shared_ptr<const LodIndex> LodIndex::build(const SciQLopPyBuffer& y)
+{
+    return build(y, nullptr);
+}
+
+std::shared_ptr<const LodIndex> LodIndex::extend(const LodIndex& prefix, const SciQLopPyBuffer& y)
+{
+    return build(y, &prefix);
+}
+
+std::shared_ptr<const LodIndex> LodIndex::build(const SciQLopPyBuffer& y, const LodIndex* prefix)
+{
+    auto index = std::make_shared<LodIndex>();
+    if (!y.is_valid())
+        return index;
+    const Layout layout { y };
+    index->m_rows = layout.rows;
+    index->m_columns = layout.columns;
+    if (layout.rows == 0 || layout.columns == 0)
+        return index;
+    if (prefix
+        && (prefix->m_columns != layout.columns || prefix->m_rows > layout.rows
+            || prefix->m_levels.empty()))
+        prefix = nullptr;
+
+    const auto columns = layout.columns;
+    auto& level0 = index->m_levels.emplace_back((layout.rows + base_stride - 1) / base_stride
+                                                * columns);
+    const auto n_buckets = level0.size() / columns;
+    // Buckets [0, kept) of the current level are complete in the prefix and
+    // can be copied: base_stride << L rows each, all below prefix->m_rows.
+    std::size_t kept = prefix ? prefix->m_rows / base_stride : 0;
+    if (kept > 0)
+        std::copy_n(prefix->m_levels[0].begin(), kept * columns, level0.begin());
+    dispatch_dtype(y.format_code(), [&](auto tag) {
+        using V = typename decltype(tag)::type;
+        const auto* values = static_cast<const V*>(y.raw_data());
+        sqp::dsp::parallel_for_blocks(n_buckets - kept, 64, [&](std::size_t b0, std::size_t b1) {
+            for (std::size_t b = kept + b0; b < kept + b1; ++b)
+            {
+                const auto first = b * base_stride;
+                const auto last = std::min(layout.rows, first + base_stride);
+                for (std::size_t c = 0; c < columns; ++c)
+                {
+                    Bucket bucket { inf, -inf, npos, npos };
+                    scan(values, layout, c, first, last, bucket);
+                    level0[b * columns + c] = bucket;
+                }
+            }
+        });
+    });
+
+    while (index->m_levels.back().size() > columns)
+    {
+        const auto& previous = index->m_levels.back();
+        const auto count = previous.size() / columns;
+        std::vector<Bucket> next((count + 1) / 2 * columns);
+        // A bucket is complete in the prefix when both halves are.
+        kept /= 2;
+        if (kept > 0)
+            std::copy_n(prefix->m_levels[index->m_levels.size()].begin(), kept * columns,
+                        next.begin());
+        for (std::size_t b = 2 * kept; b < count; ++b)
+            for (std::size_t c = 0; c < columns; ++c)
+            {
+                auto& into = next[(b / 2) * columns + c];
+                if (b % 2 == 0)
+                    into = previous[b * columns + c];
+                else
+                    merge(into, previous[b * columns + c]);
+            }
+        index->m_levels.push_back(std::move(next));
+    }
+    return index;
+}
+
+bool LodIndex::value_range(const SciQLopPyBuffer& y, std::size_t column, std::size_t first,
+                           std::size_t last, double& min, double& max) const
+{
+    if (first >= last || column >= m_columns)
+        return false;
+    const Layout layout { y };
+    if (layout.rows < m_rows || layout.columns != m_columns)
+        return false;
+    last = std::min(last, layout.rows);
+
+    Bucket result { inf, -inf, npos, npos };
+    dispatch_dtype(y.format_code(), [&](auto tag) {
+        using V = typename decltype(tag)::type;
+        const auto* values = static_cast<const V*>(y.raw_data());
+        if (last > m_rows)
+        {
+            scan(values, layout, column, std::max(first, m_rows), last, result);
+            last = m_rows;
+            if (first >= last)
+                return;
+        }
+        // Raw samples up to the first and from the last bucket boundary...
+        const auto head_end
+            = std::min(last, (first + base_stride - 1) / base_stride * base_stride);
+        scan(values, layout, column, first, head_end, result);
+        first = head_end;
+        if (first < last)
+        {
+            const auto tail_begin = std::max(first, last / base_stride * base_stride);
+            scan(values, layout, column, tail_begin, last, result);
+            last = tail_begin;
+        }
+    });
+
+    // ...then whole buckets, bottom-up: an odd edge bucket is taken as is,
+    // the even-aligned rest is covered by the next level.
+    auto lo = first / base_stride;
+    auto hi = last / base_stride;
+    for (std::size_t level = 0; lo < hi && level < m_levels.size(); ++level, lo /= 2, hi /= 2)
+    {
+        if (lo % 2 == 1)
+            merge(result, bucket(level, lo++, column));
+        if (hi % 2 == 1)
+            merge(result, bucket(level, --hi, column));
+    }
+
+    if (result.min_row == npos)
+        return false;
+    min = result.min;
+    max = result.max;
+    return true;
+}
+
+std::vector<std::size_t> LodIndex::decimate(std::size_t first, std::size_t last,
+                                            std::size_t buckets) const
+{
+    last = std::min(last, m_rows);
+    if (first >= last || buckets == 0 || m_levels.empty())
+        return {};
+    const auto rows_per_bucket = (last - first) / buckets;
+    if (rows_per_bucket < base_stride)
+        return {};
+
+    std::size_t level = 0;
+    while (level + 1 < m_levels.size() && stride(level + 1) <= rows_per_bucket)
+        ++level;
+    const auto step = stride(level);
+    const auto b0 = first / step;
+    const auto b1 = (last - 1) / step + 1;
+
+    std::vector<std::size_t> out;
+    out.reserve((b1 - b0) * (2 + 2 * m_columns) + 2);
+    out.push_back(0);
+    std::vector<std::size_t> picked;
+    picked.reserve(2 + 2 * m_columns);
+    for (auto b = b0; b < b1; ++b)
+    {
+        picked.clear();
+        picked.push_back(b * step);
+        picked.push_back(std::min(m_rows, (b + 1) * step) - 1);
+        for (std::size_t c = 0; c < m_columns; ++c)
+        {
+            const auto& e = bucket(level, b, c);
+            if (e.min_row != npos)
+            {
+                picked.push_back(e.min_row);
+                picked.push_back(e.max_row);
+            }
+        }
+        std::sort(picked.begin(), picked.end());
+        out.insert(out.end(), picked.begin(), picked.end());
+    }
+    out.push_back(m_rows - 1);
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+LineLod::LineLod(QObject* owner, std::function<void()> on_ready)
+        : m_lod { owner, std::move(on_ready) }
+{
+}
+
+void LineLod::reset(const SciQLopPyBuffer& y)
+{
+    m_lod.reset(y);
+}
+
+void LineLod::extend(const SciQLopPyBuffer& y, std::size_t kept_rows)
+{
+    const auto* index = m_lod.index();
+    if (index && index->rows() <= kept_rows)
+        m_lod.extend(y);
+    else
+        m_lod.reset(y);
+}
+
+std::vector<std::size_t> LineLod::rows_to_draw(const SciQLopPyBuffer& x, double lower,
+                                               double upper, int pixels)
+{
+    if (!x.is_valid() || pixels <= 0)
+        return {};
+    const auto n = x.flat_size();
+    if (n < LodIndex::min_rows)
+        return {};
+    const auto* keys = static_cast<const double*>(x.raw_data());
+    const std::size_t first = std::lower_bound(keys, keys + n, lower) - keys;
+    const std::size_t last = std::upper_bound(keys + first, keys + n, upper) - keys;
+    const auto buckets = static_cast<std::size_t>(pixels);
+    if (first >= last || (last - first) / buckets < LodIndex::base_stride)
+        return {};
+    if (m_lod.data().is_valid())
+        m_lod.request();
+    const auto* index = m_lod.index();
+    if (!index || index->rows() > n)
+        return {};
+    const auto built = index->rows();
+    auto rows = index->decimate(first, std::min(last, built), buckets);
+    if (rows.empty() || built == n)
+        return rows;
+    // Rows appended since the build, raw until the extended pyramid is ready.
+    rows.reserve(rows.size() + (last - std::max(first, built)) + 1);
+    for (auto row = std::max(first, built); row < last; ++row)
+        rows.push_back(row);
+    if (rows.back() != n - 1)
+        rows.push_back(n - 1);
+    return rows;
+}
+
+bool LineLod::value_range(const SciQLopPyBuffer& x, double lower, double upper,
+                          std::size_t column, double& min, double& max) const
+{
+    const auto* index = m_lod.index();
+    if (!index || !x.is_valid() || index->rows() > x.flat_size())
+        return false;
+    const auto n = x.flat_size();
+    const auto* keys = static_cast<const double*>(x.raw_data());
+    const std::size_t first = std::lower_bound(keys, keys + n, lower) - keys;
+    const std::size_t last = std::upper_bound(keys + first, keys + n, upper) - keys;
+    return index->value_range(m_lod.data(), column, first, last, min, max);
+}
@@ -57,8 +57,13 @@ extern "C"
 #include <iostream>
 #endif
 
+#include <chrono>
+#include <condition_variable>
 #include <deque>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <tuple>
 #include <variant>
 #include <functional>
 #include <QDebug>
@@ -325,6 +330,46 @@ PyObject* create_memoryview_from_ptr(T* ptr, std::vector<std::size_t> shape)
 */
 
 
+// Read-only buffer exporter for SciQLopPyBuffer::from_memory() buffers:
+// numpy views the memory through it without a copy, and it keeps a reference
+// on the memory's owner for as long as Python does.
+struct _ExternalMemoryExporter
+{
+    PyObject_HEAD
+    void* buf;
+    Py_ssize_t len;
+    std::shared_ptr<void>* owner;
+};
+
+static int _external_memory_getbuffer(PyObject* self, Py_buffer* view, int flags)
+{
+    auto* exporter = reinterpret_cast<_ExternalMemoryExporter*>(self);
+    return PyBuffer_FillInfo(view, self, exporter->buf, exporter->len, 1, flags);
+}
+
+static void _external_memory_dealloc(PyObject* self)
+{
+    auto* type = Py_TYPE(self);
+    delete reinterpret_cast<_ExternalMemoryExporter*>(self)->owner;
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+// Must be called while GIL is held
+static PyTypeObject* _external_memory_type()
+{
+    static PyType_Slot slots[] = {
+        { Py_bf_getbuffer, reinterpret_cast<void*>(_external_memory_getbuffer) },
+        { Py_tp_dealloc, reinterpret_cast<void*>(_external_memory_dealloc) },
+        { 0, nullptr },
+    };
+    static PyType_Spec spec = { "SciQLopPlots.ExternalMemory",
+                                static_cast<int>(sizeof(_ExternalMemoryExporter)), 0,
+                                Py_TPFLAGS_DEFAULT, slots };
+    static PyTypeObject* type = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&spec));
+    return type;
+}
+
 struct _PyBuffer_impl
 {
     Py_buffer buffer = { 0 };
@@ -332,13 +377,91 @@ struct _PyBuffer_impl
     std::vector<std::size_t> shape;
     bool is_valid = false;
     bool is_row_major = true;
+    // from_memory() buffers: `buffer` is filled by hand (there is no exporter
+    // to release) and py_obj is only made on demand, under py_obj_mutex.
+    std::shared_ptr<void> external_owner;
+    char external_format[2] = { 0, 0 };
+    std::mutex py_obj_mutex;
 
     _PyBuffer_impl() = default;
 
     explicit _PyBuffer_impl(PyObject* obj) { this->init_buffer(obj); }
 
+    _PyBuffer_impl(void* data, std::vector<std::size_t> dims, char format, std::size_t item_size,
+                   std::shared_ptr<void> owner)
+            : shape { std::move(dims) }, external_owner { std::move(owner) }
+    {
+        if (shape.empty())
+            shape.push_back(0);
+        external_format[0] = format;
+        buffer.buf = data;
+        buffer.itemsize = static_cast<Py_ssize_t>(item_size);
+        buffer.len = static_cast<Py_ssize_t>(
+            std::accumulate(std::cbegin(shape), std::cend(shape), std::size_t { 1 },
+                            std::multiplies<std::size_t>())
+            * item_size);
+        buffer.readonly = 1;
+        buffer.format = external_format;
+        buffer.ndim = static_cast<int>(shape.size());
+        is_valid = data != nullptr && item_size != 0;
+    }
+
     ~_PyBuffer_impl() { this->release(); }
 
+    // A read-only numpy array over the external memory, made once.
+    inline PyObject* external_py_object()
+    {
+        {
+            std::lock_guard<std::mutex> lock(py_obj_mutex);
+            if (!py_obj.is_null() || !is_valid)
+                return py_obj.py_object();
+        }
+        // Built without py_obj_mutex: taking the GIL while holding it could
+        // deadlock against a GIL holder waiting on the mutex.
+        auto scoped_gil = PyAutoScopedGIL();
+        _drain_deferred_queue();
+        auto* type = _external_memory_type();
+        auto* numpy = type ? PyImport_ImportModule("numpy") : nullptr;
+        if (numpy == nullptr)
+        {
+            PyErr_Clear();
+            return nullptr;
+        }
+        auto* exporter = PyObject_New(_ExternalMemoryExporter, type);
+        PyObject* array = nullptr;
+        if (exporter != nullptr)
+        {
+            exporter->buf = buffer.buf;
+            exporter->len = buffer.len;
+            exporter->owner = new std::shared_ptr<void>(external_owner);
+            auto* flat = PyObject_CallMethod(numpy, "frombuffer", "Os",
+                                             reinterpret_cast<PyObject*>(exporter),
+                                             external_format);
+            Py_DECREF(exporter);
+            if (flat != nullptr)
+            {
+                auto* py_shape = PyTuple_New(static_cast<Py_ssize_t>(shape.size()));
+                for (std::size_t i = 0; i < shape.size(); ++i)
+                    PyTuple_SetItem(py_shape, static_cast<Py_ssize_t>(i),
+                                    PyLong_FromSize_t(shape[i]));
+                array = PyObject_CallMethod(flat, "reshape", "O", py_shape);
+                Py_DECREF(py_shape);
+                Py_DECREF(flat);
+            }
+        }
+        Py_DECREF(numpy);
+        if (array == nullptr)
+        {
+            PyErr_Clear();
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(py_obj_mutex);
+        if (py_obj.is_null())
+            py_obj.set_obj(array);
+        Py_DECREF(array);
+        return py_obj.py_object();
+    }
+
     inline void init_buffer(PyObject* obj)
     {
         this->py_obj.set_obj(obj);
@@ -384,6 +507,13 @@ struct _PyBuffer_impl
 
     inline void release()
     {
+        if (this->external_owner)
+        {
+            this->external_owner.reset();
+            this->is_valid = false;
+            this->buffer = { 0 };
+            return;
+        }
         if (this->is_valid)
         {
             if (_current_thread_holds_gil())
@@ -424,6 +554,16 @@ SciQLopPyBuffer::SciQLopPyBuffer(PyObject* obj)
     this->_impl = std::shared_ptr<_PyBuffer_impl>(new _PyBuffer_impl(obj));
 }
 
+SciQLopPyBuffer SciQLopPyBuffer::from_memory(void* data, std::vector<std::size_t> shape,
+                                             char format, std::size_t item_size,
+                                             std::shared_ptr<void> owner)
+{
+    SciQLopPyBuffer result;
+    result._impl = std::make_shared<_PyBuffer_impl>(data, std::move(shape), format, item_size,
+                                                    std::move(owner));
+    return result;
+}
+
 SciQLopPyBuffer::~SciQLopPyBuffer() { }
 
 SciQLopPyBuffer& SciQLopPyBuffer::operator=(const SciQLopPyBuffer& other)
@@ -519,9 +659,11 @@ std::size_t SciQLopPyBuffer::item_size() const
 
 PyObject* SciQLopPyBuffer::py_object() const
 {
-    if (_impl)
-        return this->_impl->py_obj.py_object();
-    return nullptr;
+    if (!_impl)
+        return nullptr;
+    if (_impl->external_owner)
+        return _impl->external_py_object();
+    return this->_impl->py_obj.py_object();
 }
 
 std::size_t SciQLopPyBuffer::flat_size() const
@@ -533,6 +675,90 @@ std::size_t SciQLopPyBuffer::flat_size() const
     return 0;
 }
 
+SciQLopPyBuffer SciQLopPyBuffer::slice_rows(std::size_t first, std::size_t last) const
+{
+    if (!is_valid() || first > last || last > size(0))
+        return {};
+    if (_impl->external_owner)
+    {
+        // Always C-contiguous: a view at a row offset sharing the owner.
+        auto dims = shape();
+        const auto row_bytes = (flat_size() / std::max<std::size_t>(dims[0], 1)) * item_size();
+        dims[0] = last - first;
+        return from_memory(static_cast<char*>(raw_data()) + first * row_bytes, std::move(dims),
+                           format_code(), item_size(), _impl->external_owner);
+    }
+    auto scoped_gil = PyAutoScopedGIL();
+    _drain_deferred_queue();
+    auto* start = PyLong_FromSize_t(first);
+    auto* stop = PyLong_FromSize_t(last);
+    auto* slice = (start && stop) ? PySlice_New(start, stop, nullptr) : nullptr;
+    Py_XDECREF(start);
+    Py_XDECREF(stop);
+    if (slice == nullptr)
+    {
+        PyErr_Clear();
+        return {};
+    }
+    auto* view = PyObject_GetItem(py_object(), slice);
+    Py_DECREF(slice);
+    if (view == nullptr)
+    {
+        PyErr_Clear();
+        return {};
+    }
+    SciQLopPyBuffer result;
+    try
+    {
+        // Throws when the slice is not contiguous (e.g. rows of an F-order array).
+        result = SciQLopPyBuffer(view);
+    }
+    catch (const std::runtime_error&)
+    {
+        PyErr_Clear();
+    }
+    Py_DECREF(view);
+    return result;
+}
+
+SciQLopPyBuffer SciQLopPyBuffer::empty_like(std::size_t n_rows) const
+{
+    if (!is_valid() || _impl->buffer.format == nullptr)
+        return {};
+    auto scoped_gil = PyAutoScopedGIL();
+    _drain_deferred_queue();
+    auto* numpy = PyImport_ImportModule("numpy");
+    if (numpy == nullptr)
+    {
+        PyErr_Clear();
+        return {};
+    }
+    const auto& dims = shape();
+    auto* py_shape = PyTuple_New(static_cast<Py_ssize_t>(std::max<std::size_t>(dims.size(), 1)));
+    PyTuple_SetItem(py_shape, 0, PyLong_FromSize_t(n_rows));
+    for (std::size_t i = 1; i < dims.size(); ++i)
+        PyTuple_SetItem(py_shape, static_cast<Py_ssize_t>(i), PyLong_FromSize_t(dims[i]));
+    auto* array = PyObject_CallMethod(numpy, "empty", "Os", py_shape, _impl->buffer.format);
+    Py_DECREF(py_shape);
+    Py_DECREF(numpy);
+    if (array == nullptr)
+    {
+        PyErr_Clear();
+        return {};
+    }
+    SciQLopPyBuffer result;
+    try
+    {
+        result = SciQLopPyBuffer(array);
+    }
+    catch (const std::runtime_error&)
+    {
+        PyErr_Clear();
+    }
+    Py_DECREF(array);
+    return result;
+}
+
 // Convert a Python list/tuple of buffer-protocol objects into PyBuffers.
 // `SciQLopPyBuffer`'s constructor throws on non-numeric / non-buffer items; catching
 // here drops the whole batch instead of letting the exception escape into the
@@ -584,10 +810,104 @@ inline std::vector<SciQLopPyBuffer> _collect_buffers(PyObject* res)
     return data;
 }
 
+// Answers of a callable that returned an iterator (typically a generator).
+// Each yielded answer is a preview, delivered to `on_preview` at once: either
+// `(level, answer)` or a bare answer, taken as level 1. The full-resolution
+// answer is the generator's return value or, without one, the last yielded
+// answer. Stops (closing the generator) once `token` is cancelled. Caller
+// holds the GIL.
+inline std::vector<SciQLopPyBuffer>
+_collect_progressive(PyObject* iter, const CancellationToken& token,
+                     const GetDataPyCallable::PreviewCallback& on_preview)
+{
+    std::vector<SciQLopPyBuffer> last;
+    while (!token.is_cancelled())
+    {
+        PyObject* item = nullptr;
+        const auto status = PyIter_Send(iter, Py_None, &item);
+        if (status == PYGEN_ERROR)
+        {
+            PyErr_Print();
+            PyErr_Clear();
+            return {};
+        }
+        if (status == PYGEN_RETURN)
+        {
+            if (item != nullptr && item != Py_None)
+                last = _collect_buffers(item);
+            Py_XDECREF(item);
+            return last;
+        }
+        int level = 1;
+        PyObject* answer = item;
+        if (PyTuple_Check(item) && PyTuple_Size(item) == 2
+            && PyLong_Check(PyTuple_GetItem(item, 0)))
+        {
+            level = std::max(0, static_cast<int>(PyLong_AsLong(PyTuple_GetItem(item, 0))));
+            answer = PyTuple_GetItem(item, 1);
+        }
+        last = _collect_buffers(answer);
+        Py_DECREF(item);
+        if (on_preview && !last.empty())
+            on_preview(level, last);
+    }
+    return {};
+}
+
+// Whether `callable` takes a `cancellation_token` argument. Caller holds the GIL.
+static bool _accepts_cancellation_token(PyObject* callable)
+{
+    bool accepts = false;
+    if (auto* inspect = PyImport_ImportModule("inspect"))
+    {
+        if (auto* sig = PyObject_CallMethod(inspect, "signature", "O", callable))
+        {
+            if (auto* params = PyObject_GetAttrString(sig, "parameters"))
+            {
+                accepts = PyMapping_HasKeyString(params, "cancellation_token") == 1;
+                Py_DECREF(params);
+            }
+            Py_DECREF(sig);
+        }
+        Py_DECREF(inspect);
+    }
+    PyErr_Clear(); // builtins without a signature just don't get a token
+    return accepts;
+}
+
+// The token a callable receives: a no-argument function returning True once
+// the answer is no longer wanted. Caller holds the GIL.
+static constexpr const char* s_token_capsule_name = "SciQLopPlots.CancellationToken";
+
+static PyObject* _token_is_cancelled(PyObject* self, PyObject*)
+{
+    auto* token = static_cast<CancellationToken*>(PyCapsule_GetPointer(self, s_token_capsule_name));
+    return PyBool_FromLong(token != nullptr && token->is_cancelled());
+}
+
+static PyMethodDef s_token_method = { "cancellation_token", _token_is_cancelled, METH_NOARGS,
+                                      "True once the answer to this request is no longer wanted." };
+
+static PyObject* _make_token_object(const CancellationToken& token)
+{
+    auto* capsule = PyCapsule_New(new CancellationToken(token), s_token_capsule_name,
+                                  [](PyObject* c)
+                                  {
+                                      delete static_cast<CancellationToken*>(
+                                          PyCapsule_GetPointer(c, s_token_capsule_name));
+                                  });
+    if (capsule == nullptr)
+        return nullptr;
+    auto* fn = PyCFunction_New(&s_token_method, capsule);
+    Py_DECREF(capsule);
+    return fn;
+}
+
 struct _GetDataPyCallable_impl
 {
     PyObjectWrapper _py_obj;
     bool _is_valid = false;
+    bool _accepts_token = false;
 
     _GetDataPyCallable_impl() = default;
     _GetDataPyCallable_impl(const _GetDataPyCallable_impl&) = default;
@@ -606,9 +926,12 @@ struct _GetDataPyCallable_impl
         auto scoped_gil = PyAutoScopedGIL();
         _drain_deferred_queue();
         this->_is_valid = PyCallable_Check(obj);
+        this->_accepts_token = this->_is_valid && _accepts_cancellation_token(obj);
     }
 
-    inline std::vector<SciQLopPyBuffer> get_data(double lower, double upper)
+    inline std::vector<SciQLopPyBuffer> get_data(double lower, double upper,
+                                                 const CancellationToken& token,
+                                                 const GetDataPyCallable::PreviewCallback& on_preview)
     {
         std::vector<SciQLopPyBuffer> data;
         if (_is_valid)
@@ -623,11 +946,29 @@ struct _GetDataPyCallable_impl
             }
             PyTuple_SetItem(args, 0, PyFloat_FromDouble(lower));
             PyTuple_SetItem(args, 1, PyFloat_FromDouble(upper));
-            auto res = PyObject_CallObject(_py_obj.py_object(), args);
+            PyObject* kwargs = nullptr;
+            if (_accepts_token)
+            {
+                kwargs = PyDict_New();
+                auto* token_obj = _make_token_object(token);
+                if (kwargs == nullptr || token_obj == nullptr
+                    || PyDict_SetItemString(kwargs, "cancellation_token", token_obj) != 0)
+                {
+                    Py_XDECREF(token_obj);
+                    Py_XDECREF(kwargs);
+                    Py_DECREF(args);
+                    PyErr_Clear();
+                    return data;
+                }
+                Py_DECREF(token_obj);
+            }
+            auto res = PyObject_Call(_py_obj.py_object(), args, kwargs);
+            Py_XDECREF(kwargs);
             Py_DECREF(args);
             if (res != nullptr)
             {
-                data = _collect_buffers(res);
+                data = PyIter_Check(res) ? _collect_progressive(res, token, on_preview)
+                                         : _collect_buffers(res);
                 Py_DECREF(res);
             }
             else
@@ -799,11 +1140,103 @@ void GetDataPyCallable::release()
     }
 }
 
+// ---------------------------------------------------------------------------
+// In-flight range calls
+//
+// Several graphs of a panel usually plot the same product over the same
+// range, each from its own provider thread. While a call of a callable for
+// [lower, upper] runs, another one with the same callable and bounds waits
+// for it and shares its final answer (not the previews) instead of calling
+// Python again. A thread
+// holding the GIL never waits (the running call needs the GIL to finish),
+// it calls on its own. A waiter whose own token gets cancelled stops waiting
+// and returns nothing, as a cancelled call would.
+// ---------------------------------------------------------------------------
+
+namespace
+{
+
+struct InFlightRangeCall
+{
+    std::condition_variable done_cv;
+    bool done = false;
+    // The caller's token was cancelled: the answer may be partial, waiters
+    // call again instead of sharing it.
+    bool cancelled = false;
+    std::vector<SciQLopPyBuffer> result;
+};
+
+using InFlightKey = std::tuple<PyObject*, double, double>;
+
+constexpr auto s_in_flight_poll_interval = std::chrono::milliseconds(10);
+
+std::mutex s_in_flight_mutex;
+std::map<InFlightKey, std::shared_ptr<InFlightRangeCall>> s_in_flight;
+
+} // namespace
+
 std::vector<SciQLopPyBuffer> GetDataPyCallable::get_data(double lower, double upper)
 {
-    if (this->_impl)
-        return this->_impl->get_data(lower, upper);
-    return {};
+    return get_data(lower, upper, CancellationToken {});
+}
+
+std::vector<SciQLopPyBuffer> GetDataPyCallable::get_data(double lower, double upper,
+                                                         const CancellationToken& token,
+                                                         const PreviewCallback& on_preview)
+{
+    if (!this->_impl)
+        return {};
+    if (!this->_impl->_is_valid || _current_thread_holds_gil())
+        return this->_impl->get_data(lower, upper, token, on_preview);
+
+    const InFlightKey key { this->py_object(), lower, upper };
+    std::shared_ptr<InFlightRangeCall> call;
+    {
+        std::unique_lock lock(s_in_flight_mutex);
+        for (auto it = s_in_flight.find(key); it != std::end(s_in_flight);
+             it = s_in_flight.find(key))
+        {
+            auto running = it->second;
+            // Tokens are polled, not signalled: wake up now and then to give
+            // up on the shared call once our own request is cancelled.
+            while (!running->done_cv.wait_for(lock, s_in_flight_poll_interval,
+                                              [&running] { return running->done; }))
+            {
+                if (token.is_cancelled())
+                    return {};
+            }
+            if (!running->cancelled)
+                return running->result;
+            if (token.is_cancelled())
+                return {};
+        }
+        call = std::make_shared<InFlightRangeCall>();
+        s_in_flight.emplace(key, call);
+    }
+    std::vector<SciQLopPyBuffer> result;
+    try
+    {
+        result = this->_impl->get_data(lower, upper, token, on_preview);
+    }
+    catch (...)
+    {
+        std::lock_guard lock(s_in_flight_mutex);
+        s_in_flight.erase(key);
+        call->cancelled = true;
+        call->done = true;
+        call->done_cv.notify_all();
+        throw;
+    }
+    {
+        std::lock_guard lock(s_in_flight_mutex);
+        s_in_flight.erase(key);
+        call->cancelled = token.is_cancelled();
+        if (!call->cancelled)
+            call->result = result;
+        call->done = true;
+    }
+    call->done_cv.notify_all();
+    return result;
 }
 
 std::vector<SciQLopPyBuffer> GetDataPyCallable::get_data(SciQLopPyBuffer x, SciQLopPyBuffer y)
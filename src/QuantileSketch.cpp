@@ -0,0 +1,147 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#include "SciQLopPlots/QuantileSketch.hpp"
+#include "SciQLopPlots/DSP/Parallel.hpp"
+#include "SciQLopPlots/PercentileMath.hpp"
+#include "SciQLopPlots/Python/DtypeDispatch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace sciqlop::percentile
+{
+namespace
+{
+
+// Places the order statistics at `ranks` (sorted, absolute indexes into
+// [base, ...)) in position without sorting everything: O(n log k).
+void select_ranks(double* base, std::size_t begin, std::size_t end, const std::size_t* ranks_begin,
+                  const std::size_t* ranks_end)
+{
+    if (ranks_begin == ranks_end || begin >= end)
+        return;
+    const auto* mid = ranks_begin + (ranks_end - ranks_begin) / 2;
+    std::nth_element(base + begin, base + *mid, base + end);
+    select_ranks(base, begin, *mid, ranks_begin, mid);
+    select_ranks(base, *mid + 1, end, mid + 1, ranks_end);
+}
+
+void summarize(std::vector<double>& values, std::vector<WeightedValue>& out)
+{
+    const std::size_t m = values.size();
+    const std::size_t k = QuantileSketch::samples_per_block;
+    if (m <= k)
+    {
+        std::sort(values.begin(), values.end());
+        for (const double v : values)
+            out.push_back({ v, 1. });
+        return;
+    }
+    // Sample i stands for ranks [i * m / k, (i + 1) * m / k) and sits in the
+    // middle of them.
+    std::vector<std::size_t> ranks(k);
+    for (std::size_t i = 0; i < k; ++i)
+        ranks[i] = (2 * i + 1) * m / (2 * k);
+    select_ranks(values.data(), 0, m, ranks.data(), ranks.data() + k);
+    for (std::size_t i = 0; i < k; ++i)
+        out.push_back({ values[ranks[i]],
+                        static_cast<double>((i + 1) * m / k - i * m / k) });
+}
+
+}
+
+std::shared_ptr<const QuantileSketch> QuantileSketch::build(const Input& input)
+{
+    auto sketch = std::make_shared<QuantileSketch>();
+    const auto& values = input.values;
+    if (!values.is_valid() || input.rows == 0 || values.flat_size() % input.rows != 0)
+        return sketch;
+    const std::size_t rows = input.rows;
+    const std::size_t columns = values.flat_size() / rows;
+    if (columns == 0)
+        return sketch;
+    const bool row_major = values.ndim() == 1 || values.row_major();
+
+    const std::size_t block_rows = std::max<std::size_t>(
+        { 1, (rows + max_blocks - 1) / max_blocks, (min_block_values + columns - 1) / columns });
+    const std::size_t blocks = (rows + block_rows - 1) / block_rows;
+    sketch->m_rows = rows;
+    sketch->m_block_rows = block_rows;
+
+    std::vector<std::vector<WeightedValue>> per_block(blocks);
+    dispatch_dtype(values.format_code(), [&](auto tag) {
+        using V = typename decltype(tag)::type;
+        const auto* data = static_cast<const V*>(values.raw_data());
+        sqp::dsp::parallel_for_blocks(blocks, 1, [&](std::size_t b0, std::size_t b1) {
+            std::vector<double> scratch;
+            for (std::size_t b = b0; b < b1; ++b)
+            {
+                const std::size_t first = b * block_rows;
+                const std::size_t last = std::min(rows, first + block_rows);
+                scratch.clear();
+                scratch.reserve((last - first) * columns);
+                for (std::size_t row = first; row < last; ++row)
+                {
+                    for (std::size_t c = 0; c < columns; ++c)
+                    {
+                        const double v = static_cast<double>(
+                            row_major ? data[row * columns + c] : data[c * rows + row]);
+                        if constexpr (std::is_floating_point_v<V>)
+                        {
+                            if (!std::isfinite(v))
+                                continue;
+                        }
+                        scratch.push_back(v);
+                    }
+                }
+                summarize(scratch, per_block[b]);
+            }
+        });
+    });
+
+    sketch->m_offsets.reserve(blocks + 1);
+    sketch->m_offsets.push_back(0);
+    for (const auto& samples : per_block)
+        sketch->m_offsets.push_back(sketch->m_offsets.back() + samples.size());
+    sketch->m_samples.reserve(sketch->m_offsets.back());
+    for (const auto& samples : per_block)
+        sketch->m_samples.insert(sketch->m_samples.end(), samples.begin(), samples.end());
+    return sketch;
+}
+
+std::pair<std::size_t, std::size_t> QuantileSketch::collect(std::size_t first, std::size_t last,
+                                                            std::vector<WeightedValue>& out) const
+{
+    last = std::min(last, m_rows);
+    if (m_block_rows == 0 || first >= last)
+        return { last, last };
+    const std::size_t blocks = m_offsets.size() - 1;
+    const std::size_t b0 = (first + m_block_rows - 1) / m_block_rows;
+    // The last block may be short: it is whole when the window reaches the end.
+    const std::size_t b1 = last == m_rows ? blocks : last / m_block_rows;
+    if (b0 >= b1)
+        return { last, last };
+    out.insert(out.end(), m_samples.begin() + m_offsets[b0], m_samples.begin() + m_offsets[b1]);
+    return { b0 * m_block_rows, std::min(b1 * m_block_rows, m_rows) };
+}
+}
@@ -0,0 +1,339 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#include "SciQLopPlots/DataProducer/RangeTileCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
+
+namespace
+{
+
+std::size_t buffer_bytes(const SciQLopPyBuffer& b)
+{
+    return b.flat_size() * b.item_size();
+}
+
+// Whether buffer i of an answer is cut by row. A 1-D buffer 1 of a 3-buffer
+// answer is the value axis of a colormap (x, y, z) and stays whole even when
+// its length happens to match the keys.
+bool row_indexed(const QList<SciQLopPyBuffer>& buffers, qsizetype i)
+{
+    if (i == 0)
+        return true;
+    if (buffers.size() == 3 && i == 1 && buffers[1].ndim() == 1)
+        return false;
+    return buffers[i].ndim() >= 1 && buffers[i].size(0) == buffers[0].size(0);
+}
+
+std::size_t row_elements(const SciQLopPyBuffer& b)
+{
+    const auto& shape = b.shape();
+    return std::accumulate(std::next(std::begin(shape)), std::end(shape), std::size_t { 1 },
+                           std::multiplies<std::size_t>());
+}
+
+bool same_layout(const SciQLopPyBuffer& a, const SciQLopPyBuffer& b)
+{
+    return a.format_code() == b.format_code() && a.item_size() == b.item_size()
+        && a.ndim() == b.ndim()
+        && std::equal(std::next(std::begin(a.shape())), std::end(a.shape()),
+                      std::next(std::begin(b.shape())));
+}
+
+bool same_content(const SciQLopPyBuffer& a, const SciQLopPyBuffer& b)
+{
+    if (a.format_code() != b.format_code() || a.shape() != b.shape()
+        || a.row_major() != b.row_major())
+        return false;
+    // Same memory (same Python object, or the same shared-memory slot) without
+    // asking for py_object(), which would make one for from_memory() buffers.
+    return a.raw_data() == b.raw_data()
+        || std::memcmp(a.raw_data(), b.raw_data(), buffer_bytes(a)) == 0;
+}
+
+struct Piece
+{
+    const QList<SciQLopPyBuffer>* buffers;
+    std::size_t first;
+    std::size_t last;
+};
+
+// Rows [first, last) of src, appended at row `at` of the C-order dst.
+bool copy_rows(const SciQLopPyBuffer& src, std::size_t first, std::size_t last,
+               const SciQLopPyBuffer& dst, std::size_t at)
+{
+    const auto item = src.item_size();
+    const auto row_bytes = row_elements(src) * item;
+    auto* out = static_cast<char*>(dst.raw_data()) + at * row_bytes;
+    const auto* in = static_cast<const char*>(src.raw_data());
+    if (src.ndim() == 1 || src.row_major())
+    {
+        std::memcpy(out, in + first * row_bytes, (last - first) * row_bytes);
+        return true;
+    }
+    if (src.ndim() != 2)
+        return false;
+    // F-order 2-D: element (r, c) sits at c * n_rows + r.
+    const auto n_rows = src.size(0);
+    const auto n_cols = src.size(1);
+    for (std::size_t r = first; r < last; ++r, out += row_bytes)
+        for (std::size_t c = 0; c < n_cols; ++c)
+            std::memcpy(out + c * item, in + (c * n_rows + r) * item, item);
+    return true;
+}
+
+} // namespace
+
+void RangeTileCache::set_budget(std::size_t bytes)
+{
+    m_budget = bytes;
+    if (m_budget == 0)
+        clear();
+    else
+        evict();
+}
+
+void RangeTileCache::clear()
+{
+    _drop_all();
+    m_unsupported = false;
+}
+
+void RangeTileCache::mark_unsupported()
+{
+    _drop_all();
+    m_unsupported = true;
+}
+
+void RangeTileCache::_drop(std::map<double, Tile>::iterator it)
+{
+    if (it->second.prefetched && !it->second.used)
+        m_prefetch_stats.wasted_bytes += it->second.bytes;
+    m_bytes -= it->second.bytes;
+    m_tiles.erase(it);
+}
+
+void RangeTileCache::_drop_all()
+{
+    while (!m_tiles.empty())
+        _drop(std::begin(m_tiles));
+}
+
+std::vector<RangeTileCache::Interval> RangeTileCache::missing(double lower, double upper) const
+{
+    std::vector<Interval> gaps;
+    auto it = m_tiles.upper_bound(lower);
+    if (it != m_tiles.begin())
+        --it;
+    double cursor = lower;
+    bool covered = false;
+    for (; it != m_tiles.end() && it->first <= upper; ++it)
+    {
+        const auto start = it->first;
+        const auto stop = it->second.stop;
+        if (stop < cursor)
+            continue;
+        if (start > cursor)
+            gaps.emplace_back(cursor, start);
+        cursor = std::max(cursor, stop);
+        covered = true;
+    }
+    if (cursor < upper || !covered)
+        gaps.emplace_back(cursor, upper);
+    return gaps;
+}
+
+bool RangeTileCache::insert(double start, double stop, QList<SciQLopPyBuffer> buffers,
+                            bool prefetched)
+{
+    std::size_t bytes = 0;
+    if (!buffers.isEmpty())
+    {
+        const auto& keys = buffers[0];
+        if (buffers.size() < 2 || !keys.is_valid() || keys.format_code() != 'd'
+            || keys.ndim() != 1)
+            return false;
+        const auto* x = keys.data();
+        if (!std::is_sorted(x, x + keys.size(0)))
+            return false;
+        for (const auto& b : buffers)
+        {
+            if (!b.is_valid())
+                return false;
+            bytes += buffer_bytes(b);
+        }
+    }
+    for (auto it = m_tiles.begin(); it != m_tiles.end();)
+    {
+        auto next = std::next(it);
+        if (it->first < stop && it->second.stop > start)
+            _drop(it);
+        it = next;
+    }
+    if (auto same = m_tiles.find(start); same != m_tiles.end())
+        _drop(same);
+    // A prefetched tile is speculative: it sits below every tile a request
+    // used until assemble() uses it, so evict() drops it before the view.
+    m_tiles[start] = Tile { stop, std::move(buffers), bytes, prefetched ? 0 : ++m_clock,
+                            prefetched };
+    m_bytes += bytes;
+    if (prefetched)
+    {
+        ++m_prefetch_stats.tiles;
+        m_prefetch_stats.bytes += bytes;
+    }
+    return true;
+}
+
+std::vector<std::map<double, RangeTileCache::Tile>::iterator>
+RangeTileCache::_overlapping(double lower, double upper)
+{
+    std::vector<std::map<double, Tile>::iterator> tiles;
+    auto it = m_tiles.upper_bound(lower);
+    if (it != m_tiles.begin())
+        --it;
+    for (; it != m_tiles.end() && it->first <= upper; ++it)
+        if (it->second.stop >= lower)
+            tiles.push_back(it);
+    return tiles;
+}
+
+std::optional<QList<SciQLopPyBuffer>> RangeTileCache::assemble(double lower, double upper)
+{
+    if (!missing(lower, upper).empty())
+        return std::nullopt;
+    auto tiles = _overlapping(lower, upper);
+    for (auto& t : tiles)
+    {
+        auto& tile = t->second;
+        tile.last_use = ++m_clock;
+        if (tile.prefetched && !tile.used)
+            ++m_prefetch_stats.hits;
+        tile.used = true;
+    }
+    std::erase_if(tiles, [](const auto& t) { return t->second.buffers.isEmpty(); });
+    if (tiles.empty())
+        return QList<SciQLopPyBuffer> {};
+
+    const auto& proto = tiles.front()->second.buffers;
+    const auto n_buffers = proto.size();
+    for (const auto& t : tiles)
+    {
+        const auto& buffers = t->second.buffers;
+        if (buffers.size() != n_buffers)
+            return std::nullopt;
+        for (qsizetype i = 1; i < n_buffers; ++i)
+        {
+            if (row_indexed(buffers, i) != row_indexed(proto, i))
+                return std::nullopt;
+            if (row_indexed(proto, i) ? !same_layout(buffers[i], proto[i])
+                                      : !same_content(buffers[i], proto[i]))
+                return std::nullopt;
+        }
+    }
+
+    // Rows of each tile inside both [lower, upper] and the tile's own
+    // interval; a key already taken from the previous tile is skipped so that
+    // samples on a shared boundary come out once.
+    std::vector<Piece> pieces;
+    std::optional<double> last_key;
+    for (std::size_t k = 0; k < tiles.size(); ++k)
+    {
+        const auto start = tiles[k]->first;
+        const auto& tile = tiles[k]->second;
+        const auto& keys = tile.buffers[0];
+        const auto* x = keys.data();
+        const auto n = keys.size(0);
+        const double lo = k == 0 ? lower : std::max(lower, start);
+        const double hi = k + 1 == tiles.size() ? upper : std::min(upper, tile.stop);
+        auto first = static_cast<std::size_t>(std::lower_bound(x, x + n, lo) - x);
+        auto last = static_cast<std::size_t>(std::upper_bound(x, x + n, hi) - x);
+        if (k == 0 && first > 0)
+            --first;
+        if (k + 1 == tiles.size() && last < n)
+            ++last;
+        if (last_key)
+            first = std::max(first,
+                             static_cast<std::size_t>(std::upper_bound(x, x + n, *last_key) - x));
+        if (first < last)
+        {
+            last_key = x[last - 1];
+            pieces.push_back({ &tile.buffers, first, last });
+        }
+    }
+
+    QList<SciQLopPyBuffer> result;
+    if (pieces.size() == 1)
+    {
+        const auto& piece = pieces.front();
+        const auto n = (*piece.buffers)[0].size(0);
+        for (qsizetype i = 0; i < n_buffers; ++i)
+        {
+            const auto& b = (*piece.buffers)[i];
+            if (!row_indexed(*piece.buffers, i) || (piece.first == 0 && piece.last == n))
+                result.append(b);
+            else if (auto view = b.slice_rows(piece.first, piece.last); view.is_valid())
+                result.append(std::move(view));
+            else
+                break;
+        }
+        if (result.size() == n_buffers)
+            return result;
+        result.clear();
+    }
+
+    std::size_t n_rows = 0;
+    for (const auto& p : pieces)
+        n_rows += p.last - p.first;
+    for (qsizetype i = 0; i < n_buffers; ++i)
+    {
+        if (!row_indexed(proto, i))
+        {
+            result.append(proto[i]);
+            continue;
+        }
+        auto out = proto[i].empty_like(n_rows);
+        if (!out.is_valid())
+            return std::nullopt;
+        std::size_t at = 0;
+        for (const auto& p : pieces)
+        {
+            if (!copy_rows((*p.buffers)[i], p.first, p.last, out, at))
+                return std::nullopt;
+            at += p.last - p.first;
+        }
+        result.append(std::move(out));
+    }
+    return result;
+}
+
+void RangeTileCache::evict()
+{
+    while (m_bytes > m_budget && !m_tiles.empty())
+    {
+        _drop(std::min_element(std::begin(m_tiles), std::end(m_tiles),
+                               [](const auto& a, const auto& b)
+                               { return a.second.last_use < b.second.last_use; }));
+    }
+}
@@ -0,0 +1,176 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2026, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+
+#include "SciQLopPlots/MultiPlots/RenderScheduler.hpp"
+#include "SciQLopPlots/Profiling.hpp"
+#include "SciQLopPlots/SciQLopPlot.hpp"
+
+#include <QElapsedTimer>
+#include <QEvent>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace
+{
+_impl::SciQLopPlot* _impl_of(SciQLopPlotInterface* plot)
+{
+    if (auto p = qobject_cast<SciQLopPlot*>(plot))
+        return qobject_cast<_impl::SciQLopPlot*>(p->qcp_plot());
+    return nullptr;
+}
+}
+
+RenderScheduler::RenderScheduler(QObject* parent) : SciQLopPlotCollectionBehavior(parent)
+{
+    m_frame_timer = new QTimer(this);
+    m_frame_timer->setSingleShot(true);
+    m_frame_timer->setInterval(0);
+    connect(m_frame_timer, &QTimer::timeout, this, &RenderScheduler::_render_frame);
+    // The container is moved inside the panel viewport when scrolled and
+    // resized with it, both can bring culled plots into view.
+    if (parent)
+        parent->installEventFilter(this);
+}
+
+RenderScheduler::~RenderScheduler()
+{
+    // Removed from its panel (remove_behavior) or torn down with it: plots
+    // that outlive the scheduler must render their queued replots again.
+    for (const auto& plot : std::as_const(_plots))
+    {
+        if (plot)
+            _release(plot);
+    }
+}
+
+void RenderScheduler::updatePlotList(const QList<QPointer<SciQLopPlotInterface>>& plots)
+{
+    SciQLopPlotCollectionBehavior::_update_collection(
+        _plots, plots,
+        [this](SciQLopPlotInterface* plot)
+        {
+            if (auto impl = _impl_of(plot))
+            {
+                impl->set_deferred_rendering(true);
+                connect(impl, &_impl::SciQLopPlot::render_requested, m_frame_timer,
+                        qOverload<>(&QTimer::start));
+                plot->installEventFilter(this);
+            }
+        },
+        [this](SciQLopPlotInterface* plot) { _release(plot); });
+    if (pending_count())
+        m_frame_timer->start();
+}
+
+void RenderScheduler::_release(SciQLopPlotInterface* plot)
+{
+    if (auto impl = _impl_of(plot))
+    {
+        plot->removeEventFilter(this);
+        disconnect(impl, &_impl::SciQLopPlot::render_requested, m_frame_timer, nullptr);
+        impl->set_deferred_rendering(false);
+        if (impl->render_pending())
+            impl->replot(QCustomPlot::rpQueuedReplot);
+    }
+}
+
+void RenderScheduler::replot(bool immediate)
+{
+    for (const auto& plot : std::as_const(_plots))
+    {
+        if (auto impl = _impl_of(plot))
+            impl->replot(QCustomPlot::rpQueuedReplot);
+    }
+    if (immediate)
+        _render(false);
+}
+
+std::size_t RenderScheduler::pending_count() const
+{
+    std::size_t count = 0;
+    for (const auto& plot : _plots)
+    {
+        if (auto impl = _impl_of(plot); impl && impl->render_pending())
+            count++;
+    }
+    return count;
+}
+
+bool RenderScheduler::is_on_screen(const QWidget* plot)
+{
+    // Nothing to cull against until the panel is shown, and grabs/exports of
+    // hidden panels still need rendered plots.
+    if (!plot->window()->isVisible())
+        return true;
+    return plot->isVisible() && !plot->visibleRegion().isEmpty();
+}
+
+void RenderScheduler::_render_frame()
+{
+    _render(true);
+}
+
+void RenderScheduler::_render(bool within_budget)
+{
+    PROFILE_HERE_N("panel.render_frame");
+    std::vector<QPointer<_impl::SciQLopPlot>> due;
+    due.reserve(_plots.size());
+    for (const auto& plot : std::as_const(_plots))
+    {
+        if (auto impl = _impl_of(plot); impl && impl->render_pending() && is_on_screen(plot))
+            due.emplace_back(impl);
+    }
+    // hovered plot first, the others keep their top to bottom order
+    std::stable_partition(due.begin(), due.end(),
+                          [](const auto& impl) { return impl->underMouse(); });
+
+    QElapsedTimer frame;
+    frame.start();
+    for (const auto& impl : due)
+    {
+        if (within_budget && frame.elapsed() >= m_frame_budget_ms)
+        {
+            m_frame_timer->start();
+            return;
+        }
+        if (!impl.isNull() && impl->render_pending())
+            impl->render_now();
+    }
+}
+
+bool RenderScheduler::eventFilter(QObject* watched, QEvent* event)
+{
+    Q_UNUSED(watched);
+    switch (event->type())
+    {
+        case QEvent::Move:
+        case QEvent::Resize:
+        case QEvent::Show:
+            if (!m_frame_timer->isActive() && pending_count())
+                m_frame_timer->start();
+            break;
+        default:
+            break;
+    }
+    return false;
+}
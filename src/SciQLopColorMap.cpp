@@ -20,15 +20,103 @@
 -- Mail : alexis.jeandet@member.fsf.org
 ----------------------------------------------------------------------------*/
 #include "SciQLopPlots/Plotables/SciQLopColorMap.hpp"
+#include "SciQLopPlots/DSP/Parallel.hpp"
+#include "SciQLopPlots/DSP/Select.hpp"
 #include "SciQLopPlots/PercentileMath.hpp"
+#include "SciQLopPlots/SciQLopPlot.hpp"
 #include "SciQLopPlots/Profiling.hpp"
 #include "SciQLopPlots/Tracing.hpp"
 #include "SciQLopPlots/constants.hpp"
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
 #include <vector>
 
+namespace
+{
+using ChannelRuns = std::vector<std::pair<std::size_t, std::size_t>>;
+
+// [begin, end) runs of consecutive channels inside [y_lo, y_hi], for a y axis
+// shared by every row: computed once so the gather copies whole runs instead
+// of testing y per cell.
+template <typename Y>
+ChannelRuns visible_channel_runs(const Y* y, std::size_t n, double y_lo, double y_hi)
+{
+    ChannelRuns runs;
+    for (std::size_t j = 0; j < n;)
+    {
+        while (j < n && !(static_cast<double>(y[j]) >= y_lo && static_cast<double>(y[j]) <= y_hi))
+            ++j;
+        const std::size_t begin = j;
+        while (j < n && static_cast<double>(y[j]) >= y_lo && static_cast<double>(y[j]) <= y_hi)
+            ++j;
+        if (j > begin)
+            runs.emplace_back(begin, j);
+    }
+    return runs;
+}
+
+// Finite z of rows [first, last) on visible channels, written contiguously
+// to out (room for (last - first) * row_capacity values) in row order.
+// Row blocks are gathered in parallel, each into its own slot, then packed.
+template <typename Y, typename Z>
+std::size_t gather_visible_z(const Y* y, const Z* z, std::size_t y_per_row, bool y_is_2d,
+                             const ChannelRuns& runs, std::size_t row_capacity, double y_lo,
+                             double y_hi, std::size_t first, std::size_t last, Z* out)
+{
+    if (first >= last || row_capacity == 0)
+        return 0;
+    constexpr std::size_t min_block_cells = std::size_t { 1 } << 16;
+    const std::size_t min_rows = std::max<std::size_t>(1, min_block_cells / row_capacity);
+
+    std::mutex mutex;
+    std::vector<std::pair<std::size_t, std::size_t>> blocks; // (slot offset, count)
+    sqp::dsp::parallel_for_blocks(
+        last - first, min_rows,
+        [&](std::size_t b0, std::size_t b1)
+        {
+            Z* slot = out + b0 * row_capacity;
+            std::size_t count = 0;
+            for (std::size_t i = first + b0; i < first + b1; ++i)
+            {
+                const Z* row = z + i * y_per_row;
+                if (!y_is_2d)
+                {
+                    for (const auto& [begin, end] : runs)
+                        count += sqp::dsp::copy_finite(row + begin, end - begin, slot + count);
+                    continue;
+                }
+                const Y* y_row = y + i * y_per_row;
+                for (std::size_t j = 0; j < y_per_row; ++j)
+                {
+                    const double yj = static_cast<double>(y_row[j]);
+                    if (yj < y_lo || yj > y_hi)
+                        continue;
+                    if (std::isfinite(static_cast<double>(row[j])))
+                        slot[count++] = row[j];
+                }
+            }
+            std::lock_guard lock(mutex);
+            blocks.emplace_back(b0 * row_capacity, count);
+        });
+
+    std::sort(blocks.begin(), blocks.end());
+    std::size_t packed = 0;
+    for (const auto& [offset, count] : blocks)
+    {
+        if (offset != packed)
+            std::copy(out + offset, out + offset + count, out + packed);
+        packed += count;
+    }
+    return packed;
+}
+
+} // namespace
+
 void SciQLopColorMap::_cmap_got_destroyed()
 {
     _cmap = nullptr;
@@ -38,6 +126,12 @@ SciQLopColorMap::SciQLopColorMap(QCustomPlot* parent, SciQLopPlotAxis* xAxis,
                                  SciQLopPlotAxis* yAxis, SciQLopPlotColorScaleAxis* zAxis,
                                  const QString& name, QVariantMap metaData)
     : SciQLopColorMapBase(xAxis, yAxis, zAxis, std::move(metaData), parent)
+    , _lod{this, [this] {
+        _update_lod();
+        if (auto* plot = _plot())
+            _impl::queue_replot(plot);
+    }}
+    , _z_quantiles{this, {}}
 {
     _cmap = new QCPColorMap2(_keyAxis->qcp_axis(), _valueAxis->qcp_axis());
     _cmap->setLayer(Constants::LayersNames::ColorMap);
@@ -52,6 +146,7 @@ SciQLopColorMap::SciQLopColorMap(QCustomPlot* parent, SciQLopPlotAxis* xAxis,
     _cmap->setName(name);
 
     install_rescale_provider();
+    _connect_lod();
 
     if (auto legend_item = _legend_item(); legend_item)
     {
@@ -95,6 +190,8 @@ void SciQLopColorMap::set_data(SciQLopPyBuffer x, SciQLopPyBuffer y, SciQLopPyBu
     if (nx_sz == 0 || nz_sz == 0)
     {
         _dataHolder.reset();
+        _lod_level = -1;
+        _lod.reset({});
         _cmap->setDataSource(std::shared_ptr<QCPAbstractDataSource2D>{});
         m_data_range = SciQLopPlotRange();
         Q_EMIT data_changed(x, y, z);
@@ -172,6 +269,9 @@ void SciQLopColorMap::set_data(SciQLopPyBuffer x, SciQLopPyBuffer y, SciQLopPyBu
             _cmap->setDataSource(std::move(aliased));
         });
     });
+    _lod_level = -1;
+    _reset_lod();
+    _z_quantiles.reset({ z, nx_sz });
 
     check_first_data(nx);
 
@@ -205,6 +305,113 @@ void SciQLopColorMap::set_auto_scale_y(bool auto_scale_y)
     Q_EMIT auto_scale_y_changed(auto_scale_y);
 }
 
+void SciQLopColorMap::set_lod(ColorMapLod mode)
+{
+    if (mode == _lod_mode)
+        return;
+    _lod_mode = mode;
+    _reset_lod();
+    Q_EMIT lod_changed(mode);
+    if (auto* plot = _plot())
+        _impl::queue_replot(plot);
+}
+
+void SciQLopColorMap::set_x_axis(SciQLopPlotAxisInterface* axis) noexcept
+{
+    SciQLopColorMapBase::set_x_axis(axis);
+    _connect_lod();
+    _update_lod();
+}
+
+void SciQLopColorMap::set_y_axis(SciQLopPlotAxisInterface* axis) noexcept
+{
+    SciQLopColorMapBase::set_y_axis(axis);
+    _connect_lod();
+    _reset_lod();
+}
+
+void SciQLopColorMap::_connect_lod()
+{
+    disconnect(_lod_range_connection);
+    disconnect(_lod_log_connection);
+    if (_keyAxis)
+        _lod_range_connection = connect(_keyAxis, &SciQLopPlotAxis::range_changed, this,
+                                        [this](SciQLopPlotRange) { _update_lod(); });
+    // Merged y values are geometric means on a log axis: rebuild on toggle.
+    if (_valueAxis)
+        _lod_log_connection = connect(_valueAxis, &SciQLopPlotAxis::log_changed, this,
+                                      [this](bool) { _reset_lod(); });
+}
+
+void SciQLopColorMap::_reset_lod()
+{
+    if (_lod_level >= 0 && _cmap && _dataHolder)
+        _cmap->setDataSource(
+            std::shared_ptr<QCPAbstractDataSource2D>(_dataHolder, _dataHolder->source.get()));
+    _lod_level = -1;
+    if (_lod_mode == ColorMapLod::Off || !_dataHolder)
+    {
+        _lod.reset({});
+        return;
+    }
+    _lod.reset(ColorMapPyramid::Input { _dataHolder->x, _dataHolder->y, _dataHolder->z,
+                                        _valueAxis && _valueAxis->log(), _lod_mode });
+    _update_lod();
+}
+
+// Zoomed out to time_factor or more columns per pixel, draw the coarsest
+// pyramid level that still has a column per pixel; the pyramid is requested
+// the first time a view needs it.
+void SciQLopColorMap::_update_lod()
+{
+    if (!_cmap || !_dataHolder || _lod_mode == ColorMapLod::Off || !_keyAxis)
+        return;
+    auto* axis = _keyAxis->qcp_axis();
+    if (!axis || !axis->axisRect())
+        return;
+    const auto range = axis->range();
+    const int pixels = (axis->orientation() == Qt::Horizontal) ? axis->axisRect()->width()
+                                                               : axis->axisRect()->height();
+    const auto* keys = static_cast<const double*>(_dataHolder->x.raw_data());
+    const std::size_t nx = _dataHolder->x.flat_size();
+    const std::size_t first = std::lower_bound(keys, keys + nx, range.lower) - keys;
+    const std::size_t last = std::upper_bound(keys + first, keys + nx, range.upper) - keys;
+    const std::size_t visible = last - first;
+
+    int level = -1;
+    if (pixels > 0 && _dataHolder->z.flat_size() >= ColorMapPyramid::min_cells
+        && visible / ColorMapPyramid::time_factor >= static_cast<std::size_t>(pixels))
+    {
+        if (const auto* pyramid = _lod.index())
+            level = pyramid->level_for(visible, pixels);
+        else
+            _lod.request();
+    }
+    if (level == _lod_level)
+        return;
+    _lod_level = level;
+    if (level < 0)
+    {
+        _cmap->setDataSource(
+            std::shared_ptr<QCPAbstractDataSource2D>(_dataHolder, _dataHolder->source.get()));
+        return;
+    }
+
+    struct LevelSource
+    {
+        std::shared_ptr<const ColorMapPyramid> pyramid;
+        std::shared_ptr<QCPAbstractDataSource2D> source;
+    };
+    const auto& pyramid = _lod.shared_index();
+    const auto& l = pyramid->level(static_cast<std::size_t>(level));
+    auto source = std::make_shared<QCPSoADataSource2D<
+        std::span<const double>, std::span<const double>, std::span<const float>>>(
+        std::span<const double>(l.x), std::span<const double>(l.y),
+        std::span<const float>(l.z));
+    auto holder = std::make_shared<LevelSource>(LevelSource { pyramid, source });
+    _cmap->setDataSource(std::shared_ptr<QCPAbstractDataSource2D>(holder, source.get()));
+}
+
 SciQLopPlotRange SciQLopColorMap::z_percentile_range(const SciQLopPlotRange& x_range,
                                                      const SciQLopPlotRange& y_range, double low,
                                                      double high) const noexcept
@@ -239,18 +446,17 @@ SciQLopPlotRange SciQLopColorMap::z_percentile_range(const SciQLopPlotRange& x_r
     if (row0 >= row1)
         return SciQLopPlotRange();
 
-    std::vector<double> values;
+    SciQLopPlotRange result;
     // noexcept gather: dispatch_dtype throws std::invalid_argument on
     // unsupported codes. _dataHolder is only assigned after set_data's own
     // dispatch succeeds, so reaching here with an unknown dtype is
     // unreachable today — catch it anyway to keep the noexcept contract
     // honest for any future dtype that lands in set_data before this fn.
-    // reserve() can also throw std::bad_alloc/std::length_error on a huge
-    // zoomed-out span; it must stay inside the try so this noexcept function
-    // doesn't std::terminate under memory pressure.
+    // The gather buffer can also throw std::bad_alloc/std::length_error on a
+    // huge zoomed-out span; it must stay inside the try so this noexcept
+    // function doesn't std::terminate under memory pressure.
     try
     {
-        values.reserve((row1 - row0) * y_per_row);
         dispatch_dtype(yb.format_code(),
                        [&](auto y_tag)
                        {
@@ -261,20 +467,58 @@ SciQLopPlotRange SciQLopColorMap::z_percentile_range(const SciQLopPlotRange& x_r
                                               using Z = typename decltype(z_tag)::type;
                                               const auto* y_ptr = static_cast<const Y*>(yb.raw_data());
                                               const auto* z_ptr = static_cast<const Z*>(zb.raw_data());
-                                              for (std::size_t i = row0; i < row1; ++i)
+                                              // 1D y: the visible channels are the same on
+                                              // every row, mask them once.
+                                              ChannelRuns runs;
+                                              std::size_t row_capacity = y_per_row;
+                                              if (!y_is_2d)
+                                              {
+                                                  runs = visible_channel_runs(y_ptr, y_per_row, y_lo, y_hi);
+                                                  row_capacity = 0;
+                                                  for (const auto& [begin, end] : runs)
+                                                      row_capacity += end - begin;
+                                              }
+                                              const auto gather = [&](std::size_t first, std::size_t last,
+                                                                      Z* out)
+                                              {
+                                                  return gather_visible_z(y_ptr, z_ptr, y_per_row, y_is_2d,
+                                                                          runs, row_capacity, y_lo, y_hi,
+                                                                          first, last, out);
+                                              };
+                                              // The sketch summarizes whole rows: usable when
+                                              // every channel is visible, which is the
+                                              // zoomed-out case where gathering hurts.
+                                              const auto* sketch = _z_quantiles.index();
+                                              const bool all_channels = !y_is_2d && row_capacity == y_per_row;
+                                              if (all_channels
+                                                  && _autoscale_percentile_error
+                                                      >= sciqlop::percentile::QuantileSketch::rank_error
+                                                  && (row1 - row0) * y_per_row
+                                                      >= sciqlop::percentile::QuantileSketch::min_values)
                                               {
-                                                  for (std::size_t j = 0; j < y_per_row; ++j)
+                                                  _z_quantiles.request();
+                                                  if (sketch && sketch->rows() == nx)
                                                   {
-                                                      const std::size_t idx = i * y_per_row + j;
-                                                      const double yj = static_cast<double>(
-                                                          y_is_2d ? y_ptr[idx] : y_ptr[j]);
-                                                      if (yj < y_lo || yj > y_hi)
-                                                          continue;
-                                                      const double zv = static_cast<double>(z_ptr[idx]);
-                                                      if (std::isfinite(zv))
-                                                          values.push_back(zv);
+                                                      std::vector<sciqlop::percentile::WeightedValue> sketched;
+                                                      const auto covered
+                                                          = sketch->collect(row0, row1, sketched);
+                                                      const std::size_t edge_rows
+                                                          = (covered.first - row0) + (row1 - covered.second);
+                                                      auto edges = std::make_unique_for_overwrite<Z[]>(
+                                                          edge_rows * row_capacity);
+                                                      std::size_t count = gather(row0, covered.first, edges.get());
+                                                      count += gather(covered.second, row1, edges.get() + count);
+                                                      std::vector<double> values(edges.get(), edges.get() + count);
+                                                      result = sciqlop::percentile::percentile_range(
+                                                          values, sketched, low, high);
+                                                      return;
                                                   }
                                               }
+                                              auto values = std::make_unique_for_overwrite<Z[]>(
+                                                  (row1 - row0) * row_capacity);
+                                              const std::size_t count = gather(row0, row1, values.get());
+                                              result = sciqlop::percentile::percentile_range(
+                                                  std::span<const Z>(values.get(), count), low, high);
                                           });
                        });
     }
@@ -282,8 +526,7 @@ SciQLopPlotRange SciQLopColorMap::z_percentile_range(const SciQLopPlotRange& x_r
     {
         return SciQLopPlotRange();
     }
-
-    return sciqlop::percentile::percentile_range(values, low, high);
+    return result;
 }
 
 SciQLopColorMapFunction::SciQLopColorMapFunction(QCustomPlot* parent, SciQLopPlotAxis* xAxis,
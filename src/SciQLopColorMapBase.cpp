@@ -116,6 +116,13 @@ void SciQLopColorMapBase::set_autoscale_percentile_high(double percentile) noexc
     _autoscale_percentile_high = std::clamp(percentile, 0., 100.);
 }
 
+void SciQLopColorMapBase::set_autoscale_percentile_error(double error) noexcept
+{
+    if (std::isnan(error))
+        return;
+    _autoscale_percentile_error = std::clamp(error, 0., 1.);
+}
+
 std::optional<SciQLopPlotRange> SciQLopColorMapBase::z_rescale_range() const noexcept
 {
     if (_autoscale_percentile_low <= 0. && _autoscale_percentile_high >= 100.)
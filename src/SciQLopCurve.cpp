@@ -26,8 +26,9 @@
 #include "SciQLopPlots/Python/DtypeDispatch.hpp"
 #include "SciQLopPlots/Python/Validation.hpp"
 #include <cmath>
+#include <utility>
 
-void SciQLopCurve::_setCurveData(QList<QVector<QCPCurveData>> data)
+void SciQLopCurve::_setCurveData(QList<QVector<QCPCurveData>> data, bool new_data)
 {
     // The resampler emits via QueuedConnection, so the component count may
     // have grown or shrunk between emit and delivery. Cap iteration to the
@@ -40,9 +41,46 @@ void SciQLopCurve::_setCurveData(QList<QVector<QCPCurveData>> data)
         if (curve)
             curve->data()->set(data[i], true);
     }
-    set_busy(false);
+    // A view-only pass redraws the same buffers at a different simplification:
+    // neither a data change nor the end of a pending set_data.
+    if (new_data)
+        set_busy(false);
     Q_EMIT this->replot();
-    Q_EMIT data_changed();
+    if (new_data)
+        Q_EMIT data_changed();
+}
+
+void SciQLopCurve::_connect_view()
+{
+    for (const auto& c : std::as_const(_view_connections))
+        disconnect(c);
+    _view_connections.clear();
+    if (_keyAxis)
+    {
+        _view_connections << connect(_keyAxis, &SciQLopPlotAxis::range_changed, this,
+                                     [this](SciQLopPlotRange) { _push_view(); });
+        _view_connections << connect(_keyAxis, &SciQLopPlotAxis::log_changed, this,
+                                     [this](bool log) { _resampler->set_x_scale_log(log); });
+        _resampler->set_x_scale_log(_keyAxis->log());
+    }
+    if (_valueAxis)
+    {
+        _view_connections << connect(_valueAxis, &SciQLopPlotAxis::range_changed, this,
+                                     [this](SciQLopPlotRange) { _push_view(); });
+        _view_connections << connect(_valueAxis, &SciQLopPlotAxis::log_changed, this,
+                                     [this](bool log) { _resampler->set_y_scale_log(log); });
+        _resampler->set_y_scale_log(_valueAxis->log());
+    }
+    _push_view();
+}
+
+void SciQLopCurve::_push_view()
+{
+    if (!_resampler || !_keyAxis || !_valueAxis)
+        return;
+    const auto keys = _keyAxis->range();
+    const auto values = _valueAxis->range();
+    _resampler->resample_view({ keys.first, keys.second }, { values.first, values.second });
 }
 
 void SciQLopCurve::clear_curves(bool curve_already_removed)
@@ -52,6 +90,9 @@ void SciQLopCurve::clear_curves(bool curve_already_removed)
 
 void SciQLopCurve::clear_resampler()
 {
+    for (const auto& c : std::as_const(_view_connections))
+        disconnect(c);
+    _view_connections.clear();
     disconnect(this->_resampler, &CurveResampler::setGraphData, this, &SciQLopCurve::_setCurveData);
     this->_resampler_thread->quit();
     this->_resampler_thread->wait();
@@ -80,6 +121,7 @@ SciQLopCurve::SciQLopCurve(QCustomPlot* parent, SciQLopPlotAxis* keyAxis,
 {
     create_resampler(labels);
     this->create_graphs(labels);
+    _connect_view();
 }
 
 SciQLopCurve::SciQLopCurve(QCustomPlot* parent, SciQLopPlotAxis* keyAxis,
@@ -89,6 +131,7 @@ SciQLopCurve::SciQLopCurve(QCustomPlot* parent, SciQLopPlotAxis* keyAxis,
         , _valueAxis { valueAxis }
 {
     create_resampler({});
+    _connect_view();
 }
 
 SciQLopCurve::~SciQLopCurve()
@@ -193,6 +236,7 @@ void SciQLopCurve::set_x_axis(SciQLopPlotAxisInterface* axis) noexcept
         for (auto p : m_components)
             qobject_cast<QCPCurve*>(p->plottable())->setKeyAxis(a);
     });
+    _connect_view();
 }
 
 void SciQLopCurve::set_y_axis(SciQLopPlotAxisInterface* axis) noexcept
@@ -201,6 +245,7 @@ void SciQLopCurve::set_y_axis(SciQLopPlotAxisInterface* axis) noexcept
         for (auto p : m_components)
             qobject_cast<QCPCurve*>(p->plottable())->setValueAxis(a);
     });
+    _connect_view();
 }
 
 void SciQLopCurve::create_graphs(const QStringList& labels)
@@ -258,10 +303,35 @@ void SciQLopCurve::set_time_color_gradient(const QColor& start, const QColor& en
 
 std::optional<QPointF> SciQLopCurve::position_at_time(double t) const
 {
-    if (!m_components.isEmpty())
-        if (auto* tc = dynamic_cast<SciQLopTimeColoredCurve*>(m_components.first()->plottable()))
-            return tc->position_at_time(t);
-    return std::nullopt;
+    if (m_components.isEmpty() || !_resampler)
+        return std::nullopt;
+    auto* tc = dynamic_cast<SciQLopTimeColoredCurve*>(m_components.first()->plottable());
+    if (!tc)
+        return std::nullopt;
+    const auto idx = tc->index_at_time(t);
+    // Drawn points are simplified: read the row from the source buffers.
+    const auto buffers = _resampler->get_data();
+    if (!idx || buffers.size() < 2 || !buffers[0].is_valid() || !buffers[1].is_valid()
+        || *idx >= buffers[0].flat_size() || *idx >= buffers[1].flat_size())
+        return std::nullopt;
+    const auto at = [row = *idx](const SciQLopPyBuffer& b)
+    {
+        return dispatch_dtype(b.format_code(),
+                              [&](auto tag) -> double
+                              {
+                                  using T = typename decltype(tag)::type;
+                                  return static_cast<double>(
+                                      static_cast<const T*>(b.raw_data())[row]);
+                              });
+    };
+    try
+    {
+        return QPointF(at(buffers[0]), at(buffers[1]));
+    }
+    catch (const std::invalid_argument&)
+    {
+        return std::nullopt;
+    }
 }
 
 SciQLopCurveFunction::SciQLopCurveFunction(QCustomPlot* parent, SciQLopPlotAxis* key_axis,
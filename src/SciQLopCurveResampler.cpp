@@ -20,8 +20,11 @@
 -- Mail : alexis.jeandet@member.fsf.org
 ----------------------------------------------------------------------------*/
 #include "SciQLopPlots/Plotables/Resamplers/SciQLopCurveResampler.hpp"
+#include "SciQLopPlots/Profiling.hpp"
 #include "SciQLopPlots/Python/DtypeDispatch.hpp"
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 template <typename X, typename Y>
 QVector<QCPCurveData> curve_copy_data(const X* x, const Y* y, std::size_t x_size, const int y_incr)
@@ -37,50 +40,267 @@ QVector<QCPCurveData> curve_copy_data(const X* x, const Y* y, std::size_t x_size
     return data;
 }
 
-void CurveResampler::_resample_impl(const ResamplerData1d& data, const ResamplerPlotInfo& plot_info)
+namespace
+{
+
+// Data coordinate -> pixel along one axis, log10 on log axes (non-positive
+// values map to NaN and are handled like gaps).
+struct PixelMap
 {
-    if (data.x.is_valid() && data.x.flat_size() > 0 && data.new_data)
+    double origin = 0.;
+    double scale = 0.;
+    bool log = false;
+
+    PixelMap(const QCPRange& range, int pixels, bool is_log) : log { is_log }
     {
-        const auto y_incr = 1UL;
-        const auto count = data.x.flat_size();
-        QList<QVector<QCPCurveData>> curve_data;
-        // x/y may be any numeric dtype (set_data validates support); dispatch on
-        // both and convert to double. Guarded so an unexpected dtype can't
-        // terminate this worker thread.
-        try
+        const double lo = log ? std::log10(range.lower) : range.lower;
+        const double hi = log ? std::log10(range.upper) : range.upper;
+        origin = lo;
+        scale = static_cast<double>(pixels) / (hi - lo);
+    }
+
+    inline double operator()(double v) const noexcept
+    {
+        if (log)
+            v = v > 0. ? std::log10(v) : std::numeric_limits<double>::quiet_NaN();
+        return (v - origin) * scale;
+    }
+};
+
+inline bool range_usable(const QCPRange& r, bool log) noexcept
+{
+    return std::isfinite(r.lower) && std::isfinite(r.upper) && r.upper > r.lower
+        && (!log || r.lower > 0.);
+}
+
+inline bool view_usable(const ResamplerPlotInfo& info) noexcept
+{
+    return info.plot_size.width() > 0 && info.plot_size.height() > 0
+        && range_usable(info.plot_range, info.x_is_log)
+        && range_usable(info.value_range, info.y_is_log);
+}
+
+template <typename T>
+inline bool finite(T v) noexcept
+{
+    if constexpr (std::is_floating_point_v<T>)
+        return std::isfinite(v);
+    else
+        return true;
+}
+
+template <typename X, typename Y>
+std::array<std::size_t, 4> curve_extremes(const X* x, const Y* y, std::size_t count)
+{
+    std::array<std::size_t, 4> rows { 0, 0, 0, 0 };
+    bool x_seen = false, y_seen = false;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (finite(x[i]))
         {
-            dispatch_dtype(
-                data.x.format_code(),
-                [&](auto x_tag)
-                {
-                    dispatch_dtype(
-                        data.y.format_code(),
-                        [&](auto y_tag)
-                        {
-                            using X = typename decltype(x_tag)::type;
-                            using Y = typename decltype(y_tag)::type;
-                            const auto* xs = static_cast<const X*>(data.x.raw_data());
-                            const auto* ys = static_cast<const Y*>(data.y.raw_data());
-                            // Hard bound against the y buffer: line_count() can
-                            // race ahead of a queued data batch (set_line_count
-                            // runs on the GUI thread), so never trust it alone.
-                            const auto lines
-                                = std::min(line_count(), data.y.flat_size() / count);
-                            for (auto line_index = 0UL; line_index < lines; line_index++)
-                                curve_data.emplace_back(
-                                    curve_copy_data(xs, ys + (line_index * count), count, y_incr));
-                        });
-                });
+            if (!x_seen || x[i] < x[rows[0]])
+                rows[0] = i;
+            if (!x_seen || x[i] > x[rows[1]])
+                rows[1] = i;
+            x_seen = true;
         }
-        catch (const std::invalid_argument&)
+        if (finite(y[i]))
         {
+            if (!y_seen || y[i] < y[rows[2]])
+                rows[2] = i;
+            if (!y_seen || y[i] > y[rows[3]])
+                rows[3] = i;
+            y_seen = true;
+        }
+    }
+    return rows;
+}
+
+// Pixel-space simplification of one parametric line, reading the native
+// dtype buffers in place:
+//  - points closer than half a pixel to the last kept one are dropped (the
+//    same threshold SciQLopTimeColoredCurve::draw applies),
+//  - a run of far off-screen points sharing an outside half-plane collapses
+//    to its first and last rows, since no segment of it can cross the view;
+//    "far" leaves one view of margin on each side so a pan shows real points
+//    until the next pass lands,
+//  - one point per NaN gap is kept so QCPCurve still breaks the line there.
+// The first, last and extreme rows are always kept. t stays the source row so
+// time coloring still indexes the full color array.
+template <typename X, typename Y>
+QVector<QCPCurveData> curve_simplify(const X* x, const Y* y, std::size_t count,
+                                     const PixelMap& to_px_x, const PixelMap& to_px_y,
+                                     double width, double height,
+                                     const std::array<std::size_t, 4>& keep)
+{
+    QVector<QCPCurveData> out;
+    const auto emit_row = [&](std::size_t i)
+    {
+        out.append(
+            QCPCurveData { static_cast<double>(i), static_cast<double>(x[i]),
+                           static_cast<double>(y[i]) });
+    };
+    const auto outcode = [&](double px, double py) -> unsigned
+    {
+        return (px < -width ? 1u : 0u) | (px > 2. * width ? 2u : 0u)
+            | (py < -height ? 4u : 0u) | (py > 2. * height ? 8u : 0u);
+    };
+
+    double last_px = 0., last_py = 0.;
+    bool has_last = false;
+    bool in_gap = false;
+    unsigned run_code = 0;
+    std::size_t run_first = 0, run_last = 0;
+    double run_last_px = 0., run_last_py = 0.;
+
+    const auto flush_run = [&]()
+    {
+        if (run_code == 0)
             return;
+        emit_row(run_first);
+        if (run_last != run_first)
+            emit_row(run_last);
+        last_px = run_last_px;
+        last_py = run_last_py;
+        has_last = true;
+        run_code = 0;
+    };
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const double px = to_px_x(static_cast<double>(x[i]));
+        const double py = to_px_y(static_cast<double>(y[i]));
+        if (!std::isfinite(px) || !std::isfinite(py))
+        {
+            flush_run();
+            if (!in_gap)
+                emit_row(i);
+            in_gap = true;
+            has_last = false;
+            continue;
         }
-        Q_EMIT setGraphData(curve_data);
+        in_gap = false;
+        const bool forced = i == 0 || i + 1 == count
+            || std::find(keep.begin(), keep.end(), i) != keep.end();
+        const unsigned code = outcode(px, py);
+        if (code != 0 && !forced)
+        {
+            if (run_code != 0 && (run_code & code) != 0)
+            {
+                run_code &= code;
+                run_last = i;
+                run_last_px = px;
+                run_last_py = py;
+                continue;
+            }
+            flush_run();
+            run_code = code;
+            run_first = run_last = i;
+            run_last_px = px;
+            run_last_py = py;
+            continue;
+        }
+        flush_run();
+        if (!forced && has_last)
+        {
+            const double dx = px - last_px;
+            const double dy = py - last_py;
+            if (dx * dx + dy * dy < 0.25)
+                continue;
+        }
+        emit_row(i);
+        last_px = px;
+        last_py = py;
+        has_last = true;
     }
+    flush_run();
+    return out;
+}
+
+} // namespace
+
+void CurveResampler::_resample_impl(const ResamplerData1d& data, const ResamplerPlotInfo& plot_info)
+{
+    PROFILE_HERE_N("CurveResampler::_resample_impl");
+    if (!data.x.is_valid() || data.x.flat_size() == 0 || !data.y.is_valid())
+        return;
+    const bool simplify = view_usable(plot_info);
+    // A view change with nothing to simplify against would resend the same
+    // full copy: skip it.
+    if (!data.new_data && !simplify)
+        return;
+    const auto y_incr = 1UL;
+    const auto count = data.x.flat_size();
+    QList<QVector<QCPCurveData>> curve_data;
+    // x/y may be any numeric dtype (set_data validates support); dispatch on
+    // both and read the buffers in place, converting per kept point. Guarded
+    // so an unexpected dtype can't terminate this worker thread.
+    try
+    {
+        dispatch_dtype(
+            data.x.format_code(),
+            [&](auto x_tag)
+            {
+                dispatch_dtype(
+                    data.y.format_code(),
+                    [&](auto y_tag)
+                    {
+                        using X = typename decltype(x_tag)::type;
+                        using Y = typename decltype(y_tag)::type;
+                        const auto* xs = static_cast<const X*>(data.x.raw_data());
+                        const auto* ys = static_cast<const Y*>(data.y.raw_data());
+                        // Hard bound against the y buffer: line_count() can
+                        // race ahead of a queued data batch (set_line_count
+                        // runs on the GUI thread), so never trust it alone.
+                        const auto lines
+                            = std::min(line_count(), data.y.flat_size() / count);
+                        if (data.new_data)
+                        {
+                            _extremes.clear();
+                            for (auto line_index = 0UL; line_index < lines; line_index++)
+                                _extremes.push_back(
+                                    curve_extremes(xs, ys + (line_index * count), count));
+                        }
+                        if (!simplify)
+                        {
+                            for (auto line_index = 0UL; line_index < lines; line_index++)
+                                curve_data.emplace_back(curve_copy_data(
+                                    xs, ys + (line_index * count), count, y_incr));
+                            return;
+                        }
+                        const PixelMap to_px_x { plot_info.plot_range,
+                                                 plot_info.plot_size.width(),
+                                                 plot_info.x_is_log };
+                        const PixelMap to_px_y { plot_info.value_range,
+                                                 plot_info.plot_size.height(),
+                                                 plot_info.y_is_log };
+                        for (auto line_index = 0UL; line_index < lines; line_index++)
+                        {
+                            const auto keep = line_index < _extremes.size()
+                                ? _extremes[line_index]
+                                : std::array<std::size_t, 4> { 0, 0, 0, 0 };
+                            curve_data.emplace_back(curve_simplify(
+                                xs, ys + (line_index * count), count, to_px_x, to_px_y,
+                                plot_info.plot_size.width(), plot_info.plot_size.height(),
+                                keep));
+                        }
+                    });
+            });
+    }
+    catch (const std::invalid_argument&)
+    {
+        return;
+    }
+    Q_EMIT setGraphData(curve_data, data.new_data);
 }
 
 CurveResampler::CurveResampler(SciQLopPlottableInterface* parent, std::size_t line_cnt)
         : AbstractResampler1d { parent, line_cnt }
 {
 }
+
+void CurveResampler::resample_view(const QCPRange keys, const QCPRange values)
+{
+    this->set_next_value_range(values);
+    this->resample(keys);
+}
@@ -156,7 +156,12 @@ SciQLopRemoteGraph::SciQLopRemoteGraph(SciQLopPlottableInterface* as_graph, int
 
     // Clear busy on the same arity the data path is wired for, so a mismatched
     // signal can never drop busy without data having reached the graph.
-    const auto clear_busy = [g = this->as_graph]() { g->set_busy(false); };
+    // Coarse previews (set_preview) keep the graph busy until the full answer.
+    const auto clear_busy = [g = this->as_graph]()
+    {
+        if (g->data_level() == 0)
+            g->set_busy(false);
+    };
     switch (N)
     {
         case 2:
@@ -23,10 +23,11 @@
 #include <magic_enum/magic_enum.hpp>
 #include <stdexcept>
 #include "SciQLopPlots/PercentileMath.hpp"
+#include "SciQLopPlots/SciQLopPlot.hpp"
+#include "SciQLopPlots/Tracing.hpp"
 #include "SciQLopPlots/constants.hpp"
 #include <algorithm>
 #include <cmath>
-#include <plottables/plottable-colormap.h>
 #include <vector>
 
 void SciQLopHistogram2D::_hist_got_destroyed()
@@ -39,11 +40,13 @@ SciQLopHistogram2D::SciQLopHistogram2D(QCustomPlot* parent, SciQLopPlotAxis* xAx
                                        const QString& name, int x_bins, int y_bins,
                                        QVariantMap metaData)
     : SciQLopColorMapBase(xAxis, yAxis, zAxis, std::move(metaData), parent)
+    , _grid{this, [this] { _show_grid(); }}
 {
-    _hist = new QCPHistogram2D(_keyAxis->qcp_axis(), _valueAxis->qcp_axis());
+    _settings.x_bins = std::max(x_bins, 1);
+    _settings.y_bins = std::max(y_bins, 1);
+    _hist = new QCPColorMap2(_keyAxis->qcp_axis(), _valueAxis->qcp_axis());
     _hist->setLayer(Constants::LayersNames::ColorMap);
-    _hist->setBins(x_bins, y_bins);
-    connect(_hist, &QCPHistogram2D::destroyed, this, &SciQLopHistogram2D::_hist_got_destroyed);
+    connect(_hist, &QCPColorMap2::destroyed, this, &SciQLopHistogram2D::_hist_got_destroyed);
     connect(_hist, &QCPAbstractPlottable::busyChanged,
             this, &SciQLopPlottableInterface::busy_changed);
     SciQLopHistogram2D::set_gradient(ColorGradient::Jet);
@@ -60,16 +63,14 @@ SciQLopHistogram2D::SciQLopHistogram2D(QCustomPlot* parent, SciQLopPlotAxis* xAx
         connect(_keyAxis, &SciQLopPlotAxis::log_changed, this,
                 [this](bool on)
                 {
-                    if (_hist)
-                        _hist->refreshBinning();
+                    _rebin();
                     Q_EMIT x_bins_log_changed(on);
                 });
     if (_valueAxis)
         connect(_valueAxis, &SciQLopPlotAxis::log_changed, this,
                 [this](bool on)
                 {
-                    if (_hist)
-                        _hist->refreshBinning();
+                    _rebin();
                     Q_EMIT y_bins_log_changed(on);
                 });
 
@@ -96,6 +97,8 @@ SciQLopHistogram2D::~SciQLopHistogram2D()
 
 void SciQLopHistogram2D::set_data(SciQLopPyBuffer x, SciQLopPyBuffer y)
 {
+    ::SciQLopPlots::tracing::ScopedZone _sz("setdata.histogram2d", "setdata");
+    _sz.add_arg("n_points", static_cast<int64_t>(x.flat_size()));
     if (!_hist || !x.is_valid() || !y.is_valid())
         return;
 
@@ -103,47 +106,108 @@ void SciQLopHistogram2D::set_data(SciQLopPyBuffer x, SciQLopPyBuffer y)
         throw std::runtime_error(
             "Histogram2D.set_data: x and y must have the same length");
 
-    dispatch_dtype(x.format_code(), [&](auto x_tag) {
-        dispatch_dtype(y.format_code(), [&](auto y_tag) {
-            using X = typename decltype(x_tag)::type;
-            using Y = typename decltype(y_tag)::type;
-            const auto* x_ptr = static_cast<const X*>(x.raw_data());
-            const auto* y_ptr = static_cast<const Y*>(y.raw_data());
-            const int nx = static_cast<int>(x.flat_size());
-            const int ny = static_cast<int>(y.flat_size());
-
-            auto source = std::make_shared<
-                QCPSoADataSource<std::span<const X>, std::span<const Y>>>(
-                std::span<const X>(x_ptr, nx), std::span<const Y>(y_ptr, ny));
-
-            _dataHolder = std::make_shared<DataSourceWithBuffers>(
-                DataSourceWithBuffers { x, y, source });
-            auto aliased = std::shared_ptr<QCPAbstractDataSource>(_dataHolder, source.get());
-            _hist->setDataSource(std::move(aliased));
-        });
-    });
+    _points.set(x, y);
+    _rebin();
 
     if (!_got_first_data && x.flat_size() > 0)
     {
         _got_first_data = true;
-        connect(
-            &_hist->pipeline(),
-            &QCPHistogramPipeline::finished, this,
-            [this](uint64_t) {
-                _hist->rescaleDataRange();
-                Q_EMIT request_rescale();
-            },
-            Qt::SingleShotConnection);
+        _rescale_on_grid = true;
     }
 
     Q_EMIT data_changed(x, y);
     Q_EMIT data_changed();
 }
 
+void SciQLopHistogram2D::append_data(SciQLopPyBuffer x, SciQLopPyBuffer y)
+{
+    ::SciQLopPlots::tracing::ScopedZone _sz("appenddata.histogram2d", "setdata");
+    _sz.add_arg("n_points", static_cast<int64_t>(x.flat_size()));
+    if (!_hist || !x.is_valid() || !y.is_valid())
+        return;
+
+    if (x.flat_size() != y.flat_size())
+        throw std::runtime_error(
+            "Histogram2D.append_data: x and y must have the same length");
+
+    _points.append(x, y);
+    if (_shown)
+        _points.release(_shown->cut());
+    _rebin();
+
+    if (!_got_first_data && x.flat_size() > 0)
+    {
+        _got_first_data = true;
+        _rescale_on_grid = true;
+    }
+
+    Q_EMIT data_changed();
+}
+
+void SciQLopHistogram2D::set_stream_window(double window)
+{
+    _points.set_window(window);
+    _rebin();
+}
+
+void SciQLopHistogram2D::_rebin()
+{
+    if (!_hist)
+        return;
+    _settings.x_log = x_bins_log();
+    _settings.y_log = y_bins_log();
+    _grid.reset({ _points.snapshot(), _settings, _shown });
+    _hist->setBusy(true);
+    _grid.request();
+}
+
+void SciQLopHistogram2D::_show_grid()
+{
+    const auto& grid = _grid.shared_index();
+    if (!grid || !_hist)
+        return;
+    _shown = grid;
+    _hist->setBusy(false);
+    if (grid->empty())
+        _hist->setDataSource(std::shared_ptr<QCPAbstractDataSource2D> {});
+    else
+    {
+        struct GridSource
+        {
+            std::shared_ptr<const Histogram2DGrid> grid;
+            std::shared_ptr<QCPAbstractDataSource2D> source;
+        };
+        auto source = std::make_shared<QCPSoADataSource2D<
+            std::span<const double>, std::span<const double>, std::span<const double>>>(
+            std::span<const double>(grid->x_positions()),
+            std::span<const double>(grid->y_positions()),
+            std::span<const double>(grid->z_plane()));
+        auto holder = std::make_shared<GridSource>(GridSource { grid, source });
+        _hist->setDataSource(std::shared_ptr<QCPAbstractDataSource2D>(holder, source.get()));
+        if (_rescale_on_grid)
+        {
+            _rescale_on_grid = false;
+            _hist->rescaleDataRange(true);
+            Q_EMIT request_rescale();
+        }
+    }
+    if (auto* plot = _plot())
+        _impl::queue_replot(plot);
+}
+
 QList<SciQLopPyBuffer> SciQLopHistogram2D::data() const noexcept
 {
-    if (_dataHolder)
-        return { _dataHolder->x, _dataHolder->y };
+    if (_points.empty())
+        return {};
+    try
+    {
+        auto [x, y] = _points.data();
+        if (x.is_valid())
+            return { x, y };
+    }
+    catch (const std::exception&)
+    {
+    }
     return {};
 }
 
@@ -155,21 +219,23 @@ void SciQLopHistogram2D::set_bins(int x_bins, int y_bins)
         throw std::invalid_argument("histogram bins must be positive");
     if (_hist)
     {
-        if (_hist->keyBins() == x_bins && _hist->valueBins() == y_bins)
+        if (_settings.x_bins == x_bins && _settings.y_bins == y_bins)
             return;
-        _hist->setBins(x_bins, y_bins);
+        _settings.x_bins = x_bins;
+        _settings.y_bins = y_bins;
+        _rebin();
         Q_EMIT bins_changed(x_bins, y_bins);
     }
 }
 
 int SciQLopHistogram2D::x_bins() const
 {
-    return _hist ? _hist->keyBins() : 0;
+    return _hist ? _settings.x_bins : 0;
 }
 
 int SciQLopHistogram2D::y_bins() const
 {
-    return _hist ? _hist->valueBins() : 0;
+    return _hist ? _settings.y_bins : 0;
 }
 
 void SciQLopHistogram2D::set_normalization(int normalization)
@@ -178,16 +244,20 @@ void SciQLopHistogram2D::set_normalization(int normalization)
         throw std::invalid_argument("invalid histogram normalization value");
     if (_hist)
     {
-        if (static_cast<int>(_hist->normalization()) == normalization)
+        if (this->normalization() == normalization)
             return;
-        _hist->setNormalization(static_cast<QCPHistogram2D::Normalization>(normalization));
+        _settings.column_normalized = (normalization == QCPHistogram2D::nColumn);
+        _rebin();
         Q_EMIT normalization_changed(normalization);
     }
 }
 
 int SciQLopHistogram2D::normalization() const
 {
-    return _hist ? static_cast<int>(_hist->normalization()) : 0;
+    if (!_hist)
+        return 0;
+    return static_cast<int>(_settings.column_normalized ? QCPHistogram2D::nColumn
+                                                        : QCPHistogram2D::nNone);
 }
 
 // Log binning is just the axis being logarithmic. Driving the axis re-bins (and
@@ -214,55 +284,53 @@ bool SciQLopHistogram2D::y_bins_log() const
     return _valueAxis && _valueAxis->log();
 }
 
+SciQLopPlotRange SciQLopHistogram2D::x_bins_range() const noexcept
+{
+    if (!_shown)
+        return SciQLopPlotRange();
+    const auto& axis = _shown->x_axis();
+    return SciQLopPlotRange(axis.edge(0), axis.edge(axis.bins));
+}
+
+SciQLopPlotRange SciQLopHistogram2D::y_bins_range() const noexcept
+{
+    if (!_shown)
+        return SciQLopPlotRange();
+    const auto& axis = _shown->y_axis();
+    return SciQLopPlotRange(axis.edge(0), axis.edge(axis.bins));
+}
+
 SciQLopPlotRange SciQLopHistogram2D::z_percentile_range(const SciQLopPlotRange& x_range,
                                                         const SciQLopPlotRange& y_range, double low,
                                                         double high) const noexcept
 {
-    if (!_hist)
-        return SciQLopPlotRange();
-    // The binned grid (cell counts) is produced asynchronously; if it isn't
-    // ready yet, fall back to the plain min/max path (empty range ⇒ nullopt).
-    const QCPColorMapData* grid = _hist->pipeline().result();
-    if (!grid)
-        return SciQLopPlotRange();
-    const int nkey = grid->keySize();
-    const int nval = grid->valueSize();
-    if (nkey <= 0 || nval <= 0)
+    // The grid is built asynchronously; until one is shown, fall back to the
+    // plain min/max path (empty range ⇒ nullopt).
+    if (!_shown || _shown->empty())
         return SciQLopPlotRange();
+    const auto& gx = _shown->x_axis();
+    const auto& gy = _shown->y_axis();
+    const auto& z = _shown->z();
 
     const double x_lo = std::min(x_range.start(), x_range.stop());
     const double x_hi = std::max(x_range.start(), x_range.stop());
     const double y_lo = std::min(y_range.start(), y_range.stop());
     const double y_hi = std::max(y_range.start(), y_range.stop());
 
-    // Cells are uniform in coordinate space, but under log binning the renderer
-    // places them at log positions. Remap each cell centre the same way so the
-    // viewport filter matches what is actually drawn.
-    const QCPRange kr = grid->keyRange();
-    const QCPRange vr = grid->valueRange();
-    const bool x_log = x_bins_log() && kr.lower > 0. && kr.upper > kr.lower;
-    const bool y_log = y_bins_log() && vr.lower > 0. && vr.upper > vr.lower;
-    const auto to_log = [](double linear, const QCPRange& r)
-    {
-        const double t = (linear - r.lower) / (r.upper - r.lower);
-        return std::pow(10., std::log10(r.lower) + t * (std::log10(r.upper) - std::log10(r.lower)));
-    };
-
+    // Bin centres are where the cells are drawn, log bins included.
     std::vector<double> values;
-    values.reserve(static_cast<std::size_t>(nkey) * static_cast<std::size_t>(nval));
-    for (int i = 0; i < nkey; ++i)
+    values.reserve(z.size());
+    for (int i = 0; i < gx.bins; ++i)
     {
-        for (int j = 0; j < nval; ++j)
+        const double kx = gx.centre(i);
+        if (kx < x_lo || kx > x_hi)
+            continue;
+        for (int j = 0; j < gy.bins; ++j)
         {
-            double kx = 0., vy = 0.;
-            grid->cellToCoord(i, j, &kx, &vy);
-            if (x_log)
-                kx = to_log(kx, kr);
-            if (y_log)
-                vy = to_log(vy, vr);
-            if (kx < x_lo || kx > x_hi || vy < y_lo || vy > y_hi)
+            const double vy = gy.centre(j);
+            if (vy < y_lo || vy > y_hi)
                 continue;
-            const double zv = grid->cell(i, j);
+            const double zv = z[static_cast<std::size_t>(i) * gy.bins + j];
             if (std::isfinite(zv))
                 values.push_back(zv);
         }
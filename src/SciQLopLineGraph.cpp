@@ -27,6 +27,7 @@ SciQLopLineGraph::SciQLopLineGraph(QCustomPlot* parent, SciQLopPlotAxis* key_axi
     : SciQLopMultiGraphBase("Line", parent, key_axis, value_axis, labels, metaData)
 {
     create_graphs(labels);
+    enable_lod();
 }
 
 SciQLopLineGraphFunction::SciQLopLineGraphFunction(QCustomPlot* parent, SciQLopPlotAxis* key_axis,
@@ -1,11 +1,13 @@
 #include "SciQLopPlots/Plotables/SciQLopMultiGraphBase.hpp"
 #include "SciQLopPlots/Plotables/AxisHelpers.hpp"
 #include "SciQLopPlots/Plotables/SciQLopGraphComponent.hpp"
+#include "SciQLopPlots/PercentileMath.hpp"
 #include "SciQLopPlots/Python/Validation.hpp"
 #include "SciQLopPlots/Profiling.hpp"
 #include "SciQLopPlots/Tracing.hpp"
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <datasource/row-major-multi-datasource.h>
 #include <datasource/soa-multi-datasource.h>
 #include <vector>
@@ -15,6 +17,11 @@ SciQLopMultiGraphBase::SciQLopMultiGraphBase(const QString& type_label, QCustomP
                                              SciQLopPlotAxis* value_axis,
                                              const QStringList& labels, QVariantMap metaData)
     : SQPQCPAbstractPlottableWrapper(type_label, metaData, parent)
+    , _lod{this, [this] {
+        update_lod();
+        Q_EMIT this->replot();
+    }}
+    , _quantiles{this, {}}
     , _pendingLabels{labels}
     , _keyAxis{key_axis}
     , _valueAxis{value_axis}
@@ -47,7 +54,8 @@ void SciQLopMultiGraphBase::clear_graphs(bool graph_already_removed)
     _multiGraph = nullptr;
 }
 
-void SciQLopMultiGraphBase::build_data_source(const SciQLopPyBuffer& x, const SciQLopPyBuffer& y)
+void SciQLopMultiGraphBase::build_data_source(const SciQLopPyBuffer& x, const SciQLopPyBuffer& y,
+                                              std::size_t kept_rows)
 {
     const auto* keys = static_cast<const double*>(x.raw_data());
     const int n = static_cast<int>(x.flat_size());
@@ -57,6 +65,24 @@ void SciQLopMultiGraphBase::build_data_source(const SciQLopPyBuffer& x, const Sc
     else
         m_data_range = SciQLopPlotRange();
 
+    set_raw_source(x, y);
+    _quantiles.reset({ y, x.flat_size() });
+    _lodActive = false;
+    if (_lodEnabled)
+    {
+        if (kept_rows > 0)
+            _lod.extend(y, kept_rows);
+        else
+            _lod.reset(y);
+        update_lod();
+    }
+}
+
+void SciQLopMultiGraphBase::set_raw_source(const SciQLopPyBuffer& x, const SciQLopPyBuffer& y)
+{
+    const auto* keys = static_cast<const double*>(x.raw_data());
+    const int n = static_cast<int>(x.flat_size());
+
     // Build the data source with a dataGuard that co-owns the PyBuffers,
     // preventing use-after-free when the async pipeline thread reads while
     // new data arrives and replaces _x/_y.
@@ -101,6 +127,78 @@ void SciQLopMultiGraphBase::build_data_source(const SciQLopPyBuffer& x, const Sc
     _dataHolder = std::move(guard);
 }
 
+void SciQLopMultiGraphBase::set_decimated_source(const std::vector<std::size_t>& rows)
+{
+    const auto* keys = _x.data();
+    const std::size_t n = _x.flat_size();
+    const std::size_t m = rows.size();
+    const std::size_t k = (_y.ndim() == 1) ? 1 : _y.size(1);
+    const bool row_major = (_y.ndim() == 1) || _y.row_major();
+
+    dispatch_dtype(_y.format_code(), [&](auto tag) {
+        using V = typename decltype(tag)::type;
+        const auto* ys = static_cast<const V*>(_y.raw_data());
+
+        // A few rows per pixel and column: copied, so unlike the raw source
+        // this one owns its storage.
+        struct Decimated
+        {
+            std::vector<double> keys;
+            std::vector<V> values;
+        };
+        auto decimated = std::make_shared<Decimated>();
+        decimated->keys.resize(m);
+        decimated->values.resize(m * k);
+        for (std::size_t i = 0; i < m; ++i)
+        {
+            const auto row = rows[i];
+            decimated->keys[i] = keys[row];
+            for (std::size_t col = 0; col < k; ++col)
+                decimated->values[col * m + i] = row_major ? ys[row * k + col] : ys[col * n + row];
+        }
+
+        std::vector<std::span<const V>> columns;
+        columns.reserve(k);
+        for (std::size_t col = 0; col < k; ++col)
+            columns.emplace_back(decimated->values.data() + col * m, m);
+        auto source = std::make_shared<
+            QCPSoAMultiDataSource<std::span<const double>, std::span<const V>>>(
+            std::span<const double>(decimated->keys), std::move(columns), decimated);
+        _multiGraph->setDataSource(std::move(source));
+    });
+}
+
+void SciQLopMultiGraphBase::enable_lod()
+{
+    _lodEnabled = true;
+    if (_keyAxis)
+        _lodRangeConnection = connect(_keyAxis, &SciQLopPlotAxis::range_changed, this,
+                                      [this](SciQLopPlotRange) { update_lod(); });
+}
+
+void SciQLopMultiGraphBase::update_lod()
+{
+    if (!_lodEnabled || !_multiGraph || !_x.is_valid() || !_y.is_valid() || !_keyAxis)
+        return;
+    auto* axis = _keyAxis->qcp_axis();
+    if (!axis || !axis->axisRect())
+        return;
+    const auto range = axis->range();
+    const int pixels = (axis->orientation() == Qt::Horizontal) ? axis->axisRect()->width()
+                                                               : axis->axisRect()->height();
+    const auto rows = _lod.rows_to_draw(_x, range.lower, range.upper, pixels);
+    if (!rows.empty())
+    {
+        set_decimated_source(rows);
+        _lodActive = true;
+    }
+    else if (_lodActive)
+    {
+        set_raw_source(_x, _y);
+        _lodActive = false;
+    }
+}
+
 void SciQLopMultiGraphBase::sync_components()
 {
     const int nComponents = _multiGraph->componentCount();
@@ -135,6 +233,8 @@ void SciQLopMultiGraphBase::set_data(SciQLopPyBuffer x, SciQLopPyBuffer y)
 
     _x = x;
     _y = y;
+    _stream.clear();
+    _stream_first_row = 0;
 
     build_data_source(x, y);
     sync_components();
@@ -145,11 +245,70 @@ void SciQLopMultiGraphBase::set_data(SciQLopPyBuffer x, SciQLopPyBuffer y)
     Q_EMIT data_changed();
 }
 
+void SciQLopMultiGraphBase::append_rows(SciQLopPyBuffer x, SciQLopPyBuffer y)
+{
+    PROFILE_HERE_N("appenddata.multigraph");
+    ::SciQLopPlots::tracing::ScopedZone _sz("appenddata.multigraph", "setdata");
+    _sz.add_arg("n_points", static_cast<int64_t>(x.flat_size()));
+    if (!_multiGraph || !x.is_valid() || !y.is_valid())
+        return;
+
+    const auto previous_rows = _x.is_valid() ? _x.flat_size() : 0;
+    if (_stream.empty() && previous_rows > 0)
+        _stream.append(_x, _y);
+    auto snapshot = _stream.append(x, y);
+    if (!snapshot.x.is_valid())
+        return;
+    // Without a window trim the previous rows keep their index.
+    const auto kept_rows = snapshot.first_row == _stream_first_row ? previous_rows : 0;
+    _stream_first_row = snapshot.first_row;
+    _x = std::move(snapshot.x);
+    _y = std::move(snapshot.y);
+
+    // O(1): the data source spans the stream's storage.
+    build_data_source(_x, _y, kept_rows);
+    sync_components();
+
+    Q_EMIT this->replot();
+    check_first_data(static_cast<int>(_x.flat_size()));
+    Q_EMIT data_changed(_x, _y);
+    Q_EMIT data_changed();
+}
+
 QList<SciQLopPyBuffer> SciQLopMultiGraphBase::data() const noexcept
 {
     return {_x, _y};
 }
 
+void SciQLopMultiGraphBase::collect_rows(std::size_t first, std::size_t last,
+                                         std::vector<double>& out) const
+{
+    if (first >= last)
+        return;
+    const std::size_t n = _x.flat_size();
+    const std::size_t k = (_y.ndim() == 1) ? 1 : _y.shape()[1];
+    const bool row_major = (_y.ndim() == 1) || _y.row_major();
+    out.reserve(out.size() + (last - first) * k);
+    dispatch_dtype(_y.format_code(), [&](auto tag) {
+        using V = typename decltype(tag)::type;
+        const auto* ys = static_cast<const V*>(_y.raw_data());
+        for (std::size_t i = first; i < last; ++i)
+        {
+            for (std::size_t j = 0; j < k; ++j)
+            {
+                const double v = static_cast<double>(
+                    row_major ? ys[i * k + j] : ys[j * n + i]);
+                if constexpr (std::is_floating_point_v<V>)
+                {
+                    if (!std::isfinite(v))
+                        continue;
+                }
+                out.push_back(v);
+            }
+        }
+    });
+}
+
 void SciQLopMultiGraphBase::collect_visible_values(const SciQLopPlotRange& visible_key_range,
                                                    std::vector<double>& out) const noexcept
 {
@@ -164,45 +323,88 @@ void SciQLopMultiGraphBase::collect_visible_values(const SciQLopPlotRange& visib
     const double x_lo = visible_key_range.first;
     const double x_hi = visible_key_range.second;
     const double* xs = _x.data();
-    const std::size_t k = (_y.ndim() == 1) ? 1 : _y.shape()[1];
-    const bool row_major = (_y.ndim() == 1) || _y.row_major();
 
     // x is sorted (the NeoQCP data sources binary-search the same keys):
     // bound the scan to the visible window and reserve only what it can hold —
     // a full-dataset reserve allocated hundreds of MB when zoomed far in.
     const std::size_t i0 = std::lower_bound(xs, xs + n, x_lo) - xs;
     const std::size_t i1 = std::upper_bound(xs + i0, xs + n, x_hi) - xs;
-    if (i0 >= i1)
-        return;
+    try
+    {
+        collect_rows(i0, i1, out);
+    }
+    catch (const std::exception&) { /* unsupported dtype or out of memory — skip */ }
+}
+
+void SciQLopMultiGraphBase::collect_visible_samples(
+    const SciQLopPlotRange& visible_key_range, double max_rank_error, std::vector<double>& exact,
+    std::vector<sciqlop::percentile::WeightedValue>& sketched) const noexcept
+{
+    using sciqlop::percentile::QuantileSketch;
+    if (max_rank_error < QuantileSketch::rank_error || !_x.is_valid() || !_y.is_valid()
+        || _x.format_code() != 'd')
+        return collect_visible_values(visible_key_range, exact);
+    const std::size_t n = _x.flat_size();
+    const std::size_t k = (_y.ndim() == 1) ? 1 : _y.shape()[1];
+    const double* xs = _x.data();
+    const std::size_t i0 = std::lower_bound(xs, xs + n, visible_key_range.first) - xs;
+    const std::size_t i1 = std::upper_bound(xs + i0, xs + n, visible_key_range.second) - xs;
+    if (i0 >= i1 || (i1 - i0) * k < QuantileSketch::min_values)
+        return collect_visible_values(visible_key_range, exact);
+
+    try
+    {
+        _quantiles.request();
+        const auto* sketch = _quantiles.index();
+        // Until the sketch lands, this autoscale scans like before.
+        if (!sketch || sketch->rows() != n)
+            return collect_rows(i0, i1, exact);
+        const auto covered = sketch->collect(i0, i1, sketched);
+        collect_rows(i0, covered.first, exact);
+        collect_rows(covered.second, i1, exact);
+    }
+    catch (const std::exception&) { /* unsupported dtype or out of memory — skip */ }
+}
 
-    out.reserve(out.size() + (i1 - i0) * k);
+bool SciQLopMultiGraphBase::visible_value_range(const SciQLopPlotRange& visible_key_range,
+                                                SciQLopPlotRange& range) const noexcept
+{
+    if (!_lodEnabled || !_multiGraph || !_lod.ready())
+        return false;
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -lo;
     try
     {
-        dispatch_dtype(_y.format_code(), [&](auto tag) {
-            using V = typename decltype(tag)::type;
-            const auto* ys = static_cast<const V*>(_y.raw_data());
-            for (std::size_t i = i0; i < i1; ++i)
+        for (int i = 0; i < _multiGraph->componentCount(); ++i)
+        {
+            if (!_multiGraph->component(i).visible)
+                continue;
+            double min, max;
+            if (_lod.value_range(_x, visible_key_range.first, visible_key_range.second,
+                                 static_cast<std::size_t>(i), min, max))
             {
-                for (std::size_t j = 0; j < k; ++j)
-                {
-                    const double v = static_cast<double>(
-                        row_major ? ys[i * k + j] : ys[j * n + i]);
-                    if constexpr (std::is_floating_point_v<V>)
-                    {
-                        if (!std::isfinite(v))
-                            continue;
-                    }
-                    out.push_back(v);
-                }
+                lo = std::min(lo, min);
+                hi = std::max(hi, max);
             }
-        });
+        }
+    }
+    catch (const std::invalid_argument&)
+    {
+        return false;
     }
-    catch (const std::invalid_argument&) { /* unsupported dtype — skip */ }
+    range = (lo <= hi) ? SciQLopPlotRange(lo, hi) : SciQLopPlotRange();
+    return true;
 }
 
 void SciQLopMultiGraphBase::set_x_axis(SciQLopPlotAxisInterface* axis) noexcept
 {
     apply_axis(_keyAxis, axis, [this](auto* a) { if (_multiGraph) _multiGraph->setKeyAxis(a); });
+    if (_lodEnabled)
+    {
+        disconnect(_lodRangeConnection);
+        enable_lod();
+        update_lod();
+    }
 }
 
 void SciQLopMultiGraphBase::set_y_axis(SciQLopPlotAxisInterface* axis) noexcept
@@ -37,6 +37,7 @@
 #include "SciQLopPlots/constants.hpp"
 #include "SciQLopPlots/MultiPlots/SciQLopPlotCollection.hpp"
 #include "SciQLopPlots/MultiPlots/SciQLopPlotContainer.hpp"
+#include "SciQLopPlots/MultiPlots/RenderScheduler.hpp"
 #include "SciQLopPlots/MultiPlots/TimeAxisSynchronizer.hpp"
 #include "SciQLopPlots/MultiPlots/VPlotsAlign.hpp"
 #include "SciQLopPlots/MultiPlots/XAxisSynchronizer.hpp"
@@ -78,6 +79,7 @@ SciQLopMultiPlotPanel::SciQLopMultiPlotPanel(QWidget* parent, bool synchronize_x
         ::register_behavior<VPlotsAlign>(_container);
         _place_holder_manager = new PlaceHolderManager(this);
     }
+    ::register_behavior<RenderScheduler>(_container);
     if (synchronize_x)
         ::register_behavior<XAxisSynchronizer>(_container);
     if (synchronize_time)
@@ -109,7 +111,10 @@ SciQLopMultiPlotPanel::~SciQLopMultiPlotPanel()
 
 void SciQLopMultiPlotPanel::replot(bool immediate)
 {
-    _container->replot(immediate);
+    if (auto* render_scheduler = ::behavior<RenderScheduler>(_container))
+        render_scheduler->replot(immediate);
+    else
+        _container->replot(immediate);
 }
 
 void SciQLopMultiPlotPanel::add_panel(SciQLopPlotPanelInterface* panel)
@@ -264,9 +269,13 @@ SciQLopPlotInterface* SciQLopMultiPlotPanel::create_plot(int index, PlotType plo
     return plot;
 }
 
+// Programmatic range changes are not frame-coalesced: flush the synchronizer so
+// the propagation and its range_changed happen before returning.
 void SciQLopMultiPlotPanel::set_x_axis_range(const SciQLopPlotRange& range)
 {
     _container->set_x_axis_range(range);
+    if (auto* x_axis_synchronizer = ::behavior<XAxisSynchronizer>(_container))
+        x_axis_synchronizer->flush();
 }
 
 const SciQLopPlotRange& SciQLopMultiPlotPanel::x_axis_range() const
@@ -280,6 +289,8 @@ void SciQLopMultiPlotPanel::set_time_axis_range(const SciQLopPlotRange& range)
         if (auto* time_axis_synchronizer = ::behavior<TimeAxisSynchronizer>(_container))
             time_axis_synchronizer->set_axis_range(range);
     _container->set_time_axis_range(range);
+    if (auto* time_axis_synchronizer = ::behavior<TimeAxisSynchronizer>(_container))
+        time_axis_synchronizer->flush();
 }
 
 const SciQLopPlotRange& SciQLopMultiPlotPanel::time_axis_range() const
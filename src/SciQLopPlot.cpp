@@ -241,10 +241,28 @@ QMargins SciQLopPlot::minimal_axis_margins()
 
 void SciQLopPlot::replot(RefreshPriority priority)
 {
+    if (m_deferred_rendering && priority != rpImmediateRefresh)
+    {
+        if (!m_render_pending)
+        {
+            m_render_pending = true;
+            emit render_requested();
+        }
+        return;
+    }
     PROFILE_HERE_N("plot.replot");
+    // Not deferred, or rendered right away: nothing waits on a scheduler.
+    m_render_pending = false;
     QCustomPlot::replot(priority);
 }
 
+void SciQLopPlot::render_now()
+{
+    PROFILE_HERE_N("plot.replot");
+    m_render_pending = false;
+    QCustomPlot::replot(rpRefreshHint);
+}
+
 void SciQLopPlot::mousePressEvent(QMouseEvent* event)
 {
     QCustomPlot::mousePressEvent(event);
@@ -543,7 +561,8 @@ void SciQLopPlot::_register_plottable_wrapper(SciQLopPlottableInterface* plottab
                     m_color_map = nullptr;
                 emit this->plotables_list_changed();
             });
-    connect(plottable, &SciQLopGraphInterface::replot, this, [this]() { this->replot(); });
+    connect(plottable, &SciQLopGraphInterface::replot, this,
+            [this]() { this->replot(m_deferred_rendering ? rpQueuedReplot : rpImmediateRefresh); });
     connect(this, &SciQLopPlot::resized, plottable,
             &SciQLopPlottableInterface::parent_plot_resized);
     emit this->plotables_list_changed();
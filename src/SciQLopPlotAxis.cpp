@@ -22,14 +22,15 @@
 #include "SciQLopPlots/SciQLopPlotAxis.hpp"
 
 #include "SciQLopPlots/PercentileMath.hpp"
+#include "SciQLopPlots/Plotables/QCPAbstractPlottableWrapper.hpp"
 #include "SciQLopPlots/Plotables/SciQLopGraphInterface.hpp"
 #include "SciQLopPlots/SciQLopPlot.hpp"
 #include "SciQLopPlots/Tracing.hpp"
 #include "SciQLopPlots/qcp_enums.hpp"
 #include "qcustomplot.h"
+#include <QSet>
 #include <algorithm>
 #include <plottables/plottable-colormap2.h>
-#include <plottables/plottable-histogram2d.h>
 #include <cmath>
 #include <vector>
 
@@ -96,7 +97,7 @@ void SciQLopPlotAxis::set_range(const SciQLopPlotRange& range) noexcept
         {
             m_last_valid_range = clamped;
             m_axis->setRange(clamped.start(), clamped.stop());
-            m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+            _impl::queue_replot(m_axis->parentPlot());
         }
         if (clamped != range)
             Q_EMIT range_clamped(range, clamped);
@@ -108,7 +109,7 @@ void SciQLopPlotAxis::set_visible(bool visible) noexcept
     if (!m_axis.isNull() && m_axis->visible() != visible)
     {
         m_axis->setVisible(visible);
-        m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(m_axis->parentPlot());
         Q_EMIT visible_changed(visible);
     }
 }
@@ -132,7 +133,7 @@ void SciQLopPlotAxis::set_log(bool log) noexcept
                 m_axis->setTicker(QSharedPointer<QCPAxisTicker>(new QCPAxisTicker));
             }
         }
-        m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(m_axis->parentPlot());
         Q_EMIT log_changed(log);
     }
 }
@@ -142,7 +143,7 @@ void SciQLopPlotAxis::set_label(const QString& label) noexcept
     if (!m_axis.isNull() && m_axis->label() != label)
     {
         m_axis->setLabel(label);
-        m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(m_axis->parentPlot());
         Q_EMIT label_changed(label);
     }
 }
@@ -156,7 +157,7 @@ void SciQLopPlotAxis::set_selected(bool selected) noexcept
                                      | QCPAxis::spAxisLabel);
         else
             m_axis->setSelectedParts(QCPAxis::spNone);
-        m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(m_axis->parentPlot());
         Q_EMIT selection_changed(selected);
     }
 }
@@ -176,7 +177,7 @@ void SciQLopPlotAxis::set_tick_labels_visible(bool visible) noexcept
             m_axis->setTickLabelPadding(5);
             m_axis->setPadding(5);
         }
-        m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(m_axis->parentPlot());
         Q_EMIT tick_labels_visible_changed(visible);
     }
 }
@@ -186,7 +187,7 @@ void SciQLopPlotAxis::set_label_font(const QFont& font) noexcept
     if (!m_axis.isNull() && m_axis->labelFont() != font)
     {
         m_axis->setLabelFont(font);
-        m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(m_axis->parentPlot());
         Q_EMIT label_font_changed(font);
     }
 }
@@ -196,7 +197,7 @@ void SciQLopPlotAxis::set_label_color(const QColor& color) noexcept
     if (!m_axis.isNull() && m_axis->labelColor() != color)
     {
         m_axis->setLabelColor(color);
-        m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(m_axis->parentPlot());
         Q_EMIT label_color_changed(color);
     }
 }
@@ -206,7 +207,7 @@ void SciQLopPlotAxis::set_tick_label_font(const QFont& font) noexcept
     if (!m_axis.isNull() && m_axis->tickLabelFont() != font)
     {
         m_axis->setTickLabelFont(font);
-        m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(m_axis->parentPlot());
         Q_EMIT tick_label_font_changed(font);
     }
 }
@@ -216,7 +217,7 @@ void SciQLopPlotAxis::set_tick_label_color(const QColor& color) noexcept
     if (!m_axis.isNull() && m_axis->tickLabelColor() != color)
     {
         m_axis->setTickLabelColor(color);
-        m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(m_axis->parentPlot());
         Q_EMIT tick_label_color_changed(color);
     }
 }
@@ -337,6 +338,13 @@ void SciQLopPlotAxis::set_autoscale_percentile_high(double percentile) noexcept
     m_autoscale_percentile_high = std::clamp(percentile, 0., 100.);
 }
 
+void SciQLopPlotAxis::set_autoscale_percentile_error(double error) noexcept
+{
+    if (std::isnan(error))
+        return;
+    m_autoscale_percentile_error = std::clamp(error, 0., 1.);
+}
+
 void SciQLopPlotAxis::rescale() noexcept
 {
     if (m_axis.isNull())
@@ -362,6 +370,9 @@ void SciQLopPlotAxis::rescale() noexcept
     {
         ::SciQLopPlots::tracing::ScopedZone _sz("axis.rescale.percentile", "rescale");
         std::vector<double> pooled;
+        // Large graphs may answer most of their window from a quantile
+        // sketch: weighted samples instead of every value.
+        std::vector<sciqlop::percentile::WeightedValue> sketched;
         for (auto* p : plot->sqp_plottables())
         {
             // qobject_cast to SciQLopGraphInterface deliberately excludes
@@ -376,19 +387,24 @@ void SciQLopPlotAxis::rescale() noexcept
             if (!keyAxis || !keyAxis->qcp_axis())
                 continue;
             const auto kr = keyAxis->qcp_axis()->range();
-            graph->collect_visible_values(SciQLopPlotRange(kr.lower, kr.upper), pooled);
+            graph->collect_visible_samples(SciQLopPlotRange(kr.lower, kr.upper),
+                                           m_autoscale_percentile_error, pooled, sketched);
         }
         if (is_log)
         {
             const auto cutoff
                 = [&](double v) { return signDomain == QCP::sdNegative ? v >= 0. : v <= 0.; };
             pooled.erase(std::remove_if(pooled.begin(), pooled.end(), cutoff), pooled.end());
+            sketched.erase(std::remove_if(sketched.begin(), sketched.end(),
+                                          [&](const auto& s) { return cutoff(s.value); }),
+                           sketched.end());
         }
         _sz.add_arg("pool_size", static_cast<int64_t>(pooled.size()));
-        if (!pooled.empty())
+        _sz.add_arg("sketch_samples", static_cast<int64_t>(sketched.size()));
+        if (!pooled.empty() || !sketched.empty())
         {
             const auto r = sciqlop::percentile::percentile_range(
-                pooled, m_autoscale_percentile_low, m_autoscale_percentile_high);
+                pooled, sketched, m_autoscale_percentile_low, m_autoscale_percentile_high);
             // Degenerate (zero-width) percentile ranges happen when data has
             // less precision than double inside the band (e.g. uint64 values
             // larger than 2^53). QCPAxis::setRange silently rejects them, so
@@ -424,9 +440,46 @@ void SciQLopPlotAxis::rescale() noexcept
         }
     }
 
+    // Graphs that can bound their visible values from a level-of-detail
+    // pyramid answer in O(log n) instead of NeoQCP's scan over every visible
+    // sample; their QCP plottables are then skipped below. Log axes keep the
+    // scan, which also filters on the sign domain.
+    QSet<QCPAbstractPlottable*> answered;
+    if (auto* plot = qobject_cast<_impl::SciQLopPlot*>(m_axis->parentPlot()); plot && !is_log)
+    {
+        for (auto* p : plot->sqp_plottables())
+        {
+            auto* graph = qobject_cast<SQPQCPAbstractPlottableWrapper*>(p);
+            if (!graph || graph->y_axis() != this)
+                continue;
+            auto* keyAxis = qobject_cast<SciQLopPlotAxis*>(graph->x_axis());
+            if (!keyAxis || !keyAxis->qcp_axis())
+                continue;
+            const auto plottables = graph->qcp_plottables();
+            if (plottables.isEmpty()
+                || std::none_of(plottables.cbegin(), plottables.cend(),
+                                [](auto* qp) { return qp->realVisibility(); }))
+                continue;
+            const auto kr = keyAxis->qcp_axis()->range();
+            SciQLopPlotRange graphRange;
+            if (!graph->visible_value_range(SciQLopPlotRange(kr.lower, kr.upper), graphRange))
+                continue;
+            for (auto* qp : plottables)
+                answered.insert(qp);
+            if (std::isnan(graphRange.first) || std::isnan(graphRange.second))
+                continue;
+            const QCPRange plottableRange(graphRange.first, graphRange.second);
+            if (!haveRange)
+                newRange = plottableRange;
+            else
+                newRange.expand(plottableRange);
+            haveRange = true;
+        }
+    }
+
     for (auto* plottable : m_axis->plottables())
     {
-        if (!plottable->realVisibility())
+        if (!plottable->realVisibility() || answered.contains(plottable))
             continue;
         bool found = false;
         QCPRange plottableRange;
@@ -465,7 +518,7 @@ void SciQLopPlotAxis::rescale() noexcept
         set_range(SciQLopPlotRange(newRange.lower, newRange.upper, _is_time_axis));
         return;
     }
-    m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+    _impl::queue_replot(m_axis->parentPlot());
 }
 
 QCPAxis* SciQLopPlotAxis::qcp_axis() const noexcept
@@ -544,7 +597,7 @@ void SciQLopPlotColorScaleAxis::set_range(const SciQLopPlotRange& range) noexcep
             || m_axis->dataRange().upper != range.stop()))
     {
         m_axis->setDataRange(QCPRange(range.start(), range.stop()));
-        m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(m_axis->parentPlot());
     }
 }
 
@@ -553,7 +606,7 @@ void SciQLopPlotColorScaleAxis::set_visible(bool visible) noexcept
     if (!m_axis.isNull() && m_axis->visible() != visible)
     {
         m_axis->setVisible(visible);
-        m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(m_axis->parentPlot());
         Q_EMIT visible_changed(visible);
     }
 }
@@ -580,7 +633,7 @@ void SciQLopPlotColorScaleAxis::set_log(bool log) noexcept
             }
         }
         update_number_precision();  // log -> clean powers, linear -> adaptive
-        m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(m_axis->parentPlot());
         Q_EMIT log_changed(log);
     }
 }
@@ -590,7 +643,7 @@ void SciQLopPlotColorScaleAxis::set_label(const QString& label) noexcept
     if (!m_axis.isNull() && m_axis->label() != label)
     {
         m_axis->setLabel(label);
-        m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(m_axis->parentPlot());
         Q_EMIT label_changed(label);
     }
 }
@@ -604,7 +657,7 @@ void SciQLopPlotColorScaleAxis::set_color_gradient(const ColorGradient gradient)
         new_gradient.setNanHandling(QCPColorGradient::nhTransparent);
         m_axis->setGradient(new_gradient);
         m_axis->rescaleDataRange(true);
-        m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(m_axis->parentPlot());
         Q_EMIT color_gradient_changed(gradient);
     }
 }
@@ -674,11 +727,12 @@ void SciQLopPlotColorScaleAxis::rescale() noexcept
             if (auto r = m_rescale_range_provider(); r.has_value())
             {
                 set_range(*r);
-                m_axis->parentPlot()->replot(QCustomPlot::rpQueuedReplot);
+                _impl::queue_replot(m_axis->parentPlot());
                 return;
             }
         }
-        // QCPColorScale::rescaleDataRange only finds QCPColorMap, not QCPColorMap2/QCPHistogram2D.
+        // QCPColorScale::rescaleDataRange only finds QCPColorMap, not QCPColorMap2
+        // (colormaps and histograms both draw through it).
         auto* plot = m_axis->parentPlot();
         for (int i = 0; i < plot->plottableCount(); ++i)
         {
@@ -687,15 +741,10 @@ void SciQLopPlotColorScaleAxis::rescale() noexcept
             {
                 cm2->rescaleDataRange(true);
             }
-            else if (auto* hist = qobject_cast<QCPHistogram2D*>(plot->plottable(i));
-                     hist && hist->colorScale() == m_axis.data())
-            {
-                hist->rescaleDataRange(true);
-            }
         }
         // Also try the legacy path for any QCPColorMap instances
         m_axis->rescaleDataRange(true);
-        plot->replot(QCustomPlot::rpQueuedReplot);
+        _impl::queue_replot(plot);
     }
 }
 
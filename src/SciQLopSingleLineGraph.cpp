@@ -61,10 +61,15 @@ SciQLopSingleLineGraph::SciQLopSingleLineGraph(QCustomPlot* parent, SciQLopPlotA
                                                 SciQLopPlotAxis* value_axis,
                                                 const QStringList& labels, QVariantMap metaData)
     : SQPQCPAbstractPlottableWrapper("Line", metaData, parent)
+    , _lod{this, [this] {
+        _update_lod();
+        Q_EMIT this->replot();
+    }}
     , _keyAxis{key_axis}
     , _valueAxis{value_axis}
 {
     create_graph(labels);
+    _connect_lod();
 }
 
 SciQLopSingleLineGraph::~SciQLopSingleLineGraph()
@@ -79,12 +84,37 @@ void SciQLopSingleLineGraph::set_data(SciQLopPyBuffer x, SciQLopPyBuffer y)
 
     if (x.format_code() != 'd')
         throw std::runtime_error("Keys (x) must be float64");
-    // The y span below is built with x's length: a shorter y would be read out
+    // The y span _publish builds uses x's length: a shorter y would be read out
     // of bounds at render time. y may be 1D or a single (n, 1) column.
     sqp::validation::validate_xy(x, y);
     if (y.flat_size() != x.flat_size())
         throw std::invalid_argument("y must hold exactly one value per x sample");
 
+    _stream.clear();
+    _stream_first_row = 0;
+    _publish(x, y);
+}
+
+void SciQLopSingleLineGraph::append_data(SciQLopPyBuffer x, SciQLopPyBuffer y)
+{
+    if (!_graph || !x.is_valid() || !y.is_valid())
+        return;
+    if (y.flat_size() != x.flat_size())
+        throw std::invalid_argument("y must hold exactly one value per x sample");
+    const auto previous_rows = _dataHolder ? _dataHolder->x.flat_size() : 0;
+    if (_stream.empty() && previous_rows > 0)
+        _stream.append(_dataHolder->x, _dataHolder->y);
+    auto snapshot = _stream.append(x, y);
+    if (!snapshot.x.is_valid())
+        return;
+    const auto kept_rows = snapshot.first_row == _stream_first_row ? previous_rows : 0;
+    _stream_first_row = snapshot.first_row;
+    _publish(snapshot.x, snapshot.y, kept_rows);
+}
+
+void SciQLopSingleLineGraph::_publish(const SciQLopPyBuffer& x, const SciQLopPyBuffer& y,
+                                      std::size_t kept_rows)
+{
     const auto* keys = static_cast<const double*>(x.raw_data());
     const int n = static_cast<int>(x.flat_size());
 
@@ -107,6 +137,12 @@ void SciQLopSingleLineGraph::set_data(SciQLopPyBuffer x, SciQLopPyBuffer y)
         auto aliased = std::shared_ptr<QCPAbstractDataSource>(_dataHolder, source.get());
         _graph->setDataSource(std::move(aliased));
     });
+    _lodActive = false;
+    if (kept_rows > 0)
+        _lod.extend(y, kept_rows);
+    else
+        _lod.reset(y);
+    _update_lod();
 
     Q_EMIT this->replot();
     check_first_data(n);
@@ -114,6 +150,69 @@ void SciQLopSingleLineGraph::set_data(SciQLopPyBuffer x, SciQLopPyBuffer y)
     Q_EMIT data_changed();
 }
 
+void SciQLopSingleLineGraph::_connect_lod()
+{
+    disconnect(_lodRangeConnection);
+    if (_keyAxis)
+        _lodRangeConnection = connect(_keyAxis, &SciQLopPlotAxis::range_changed, this,
+                                      [this](SciQLopPlotRange) { _update_lod(); });
+}
+
+// Zoomed out past LodIndex::base_stride samples per pixel, the graph draws
+// the first/min/max/last rows of each pixel column from the pyramid; the raw
+// source comes back once zoomed in again.
+void SciQLopSingleLineGraph::_update_lod()
+{
+    if (!_graph || !_dataHolder || !_keyAxis)
+        return;
+    auto* axis = _keyAxis->qcp_axis();
+    if (!axis || !axis->axisRect())
+        return;
+    const auto& x = _dataHolder->x;
+    const auto& y = _dataHolder->y;
+    const auto range = axis->range();
+    const int pixels = (axis->orientation() == Qt::Horizontal) ? axis->axisRect()->width()
+                                                               : axis->axisRect()->height();
+    const auto rows = _lod.rows_to_draw(x, range.lower, range.upper, pixels);
+    if (rows.empty())
+    {
+        if (_lodActive)
+        {
+            _graph->setDataSource(
+                std::shared_ptr<QCPAbstractDataSource>(_dataHolder, _dataHolder->source.get()));
+            _lodActive = false;
+        }
+        return;
+    }
+
+    const auto* keys = static_cast<const double*>(x.raw_data());
+    const std::size_t m = rows.size();
+    dispatch_dtype(y.format_code(), [&](auto tag) {
+        using V = typename decltype(tag)::type;
+        const auto* values = static_cast<const V*>(y.raw_data());
+        struct Decimated
+        {
+            std::vector<double> keys;
+            std::vector<V> values;
+            std::shared_ptr<QCPAbstractDataSource> source;
+        };
+        auto decimated = std::make_shared<Decimated>();
+        decimated->keys.resize(m);
+        decimated->values.resize(m);
+        for (std::size_t i = 0; i < m; ++i)
+        {
+            decimated->keys[i] = keys[rows[i]];
+            decimated->values[i] = values[rows[i]];
+        }
+        decimated->source = std::make_shared<
+            QCPSoADataSource<std::span<const double>, std::span<const V>>>(
+            std::span<const double>(decimated->keys), std::span<const V>(decimated->values));
+        _graph->setDataSource(
+            std::shared_ptr<QCPAbstractDataSource>(decimated, decimated->source.get()));
+    });
+    _lodActive = true;
+}
+
 void SciQLopSingleLineGraph::set_color_data(SciQLopPyBuffer values, ::ColorGradient gradient)
 {
     if (!_graph || !values.is_valid())
@@ -209,9 +308,31 @@ void SciQLopSingleLineGraph::collect_visible_values(const SciQLopPlotRange& visi
     catch (const std::invalid_argument&) { /* unsupported dtype — skip */ }
 }
 
+bool SciQLopSingleLineGraph::visible_value_range(const SciQLopPlotRange& visible_key_range,
+                                                 SciQLopPlotRange& range) const noexcept
+{
+    if (!_dataHolder || !_lod.ready())
+        return false;
+    double min, max;
+    try
+    {
+        range = _lod.value_range(_dataHolder->x, visible_key_range.first,
+                                 visible_key_range.second, 0, min, max)
+            ? SciQLopPlotRange(min, max)
+            : SciQLopPlotRange();
+    }
+    catch (const std::invalid_argument&)
+    {
+        return false;
+    }
+    return true;
+}
+
 void SciQLopSingleLineGraph::set_x_axis(SciQLopPlotAxisInterface* axis) noexcept
 {
     apply_axis(_keyAxis, axis, [this](auto* a) { if (_graph) _graph->setKeyAxis(a); });
+    _connect_lod();
+    _update_lod();
 }
 
 void SciQLopSingleLineGraph::set_y_axis(SciQLopPlotAxisInterface* axis) noexcept
@@ -49,30 +49,35 @@ void SciQLopTimeColoredCurve::set_color_values(const QVector<double>& values)
     }
 }
 
-std::optional<QPointF> SciQLopTimeColoredCurve::position_at_time(double t) const
+std::optional<std::size_t> SciQLopTimeColoredCurve::index_at_time(double t) const
 {
-    if (m_time_values.isEmpty() || mDataContainer->isEmpty())
+    if (m_time_values.isEmpty())
         return std::nullopt;
 
     auto it = std::lower_bound(m_time_values.begin(), m_time_values.end(), t);
-    int idx;
     if (it == m_time_values.end())
-        idx = m_time_values.size() - 1;
-    else if (it == m_time_values.begin())
-        idx = 0;
-    else
-    {
-        int hi = static_cast<int>(it - m_time_values.begin());
-        int lo = hi - 1;
-        idx = (t - m_time_values[lo] <= m_time_values[hi] - t) ? lo : hi;
-    }
+        return static_cast<std::size_t>(m_time_values.size() - 1);
+    if (it == m_time_values.begin())
+        return 0;
+    const auto hi = static_cast<std::size_t>(it - m_time_values.begin());
+    const auto lo = hi - 1;
+    return (t - m_time_values[lo] <= m_time_values[hi] - t) ? lo : hi;
+}
 
-    if (idx < mDataContainer->size())
-    {
-        const auto& d = *(mDataContainer->constBegin() + idx);
-        return QPointF(d.key, d.value);
-    }
-    return std::nullopt;
+std::optional<QPointF> SciQLopTimeColoredCurve::position_at_time(double t) const
+{
+    const auto idx = index_at_time(t);
+    if (!idx || mDataContainer->isEmpty())
+        return std::nullopt;
+
+    // Nearest drawn point at or after that row; exact unless the row was
+    // simplified away.
+    auto it = std::lower_bound(mDataContainer->constBegin(), mDataContainer->constEnd(),
+                               static_cast<double>(*idx),
+                               [](const QCPCurveData& d, double row) { return d.t < row; });
+    if (it == mDataContainer->constEnd())
+        return std::nullopt;
+    return QPointF(it->key, it->value);
 }
 
 void SciQLopTimeColoredCurve::draw(QCPPainter* painter)
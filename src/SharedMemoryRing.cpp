@@ -0,0 +1,421 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#include "SciQLopPlots/DataProducer/SharedMemoryRing.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <numeric>
+#include <string_view>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace shm_ring
+{
+
+inline constexpr std::uint32_t magic = 0x52515153; // "SQQR"
+inline constexpr std::uint32_t version = 1;
+inline constexpr std::size_t alignment = 64;
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free
+                  && std::atomic<std::uint64_t>::is_always_lock_free,
+              "shared-memory slot handoff needs address-free atomics");
+
+enum SlotState : std::uint32_t
+{
+    Free = 0,
+    Writing = 1,
+    Ready = 2,
+    Reading = 3,
+};
+
+struct ArrayDescriptor
+{
+    std::uint64_t offset;
+    std::uint64_t bytes;
+    std::uint64_t shape[max_dims];
+    std::uint32_t ndim;
+    std::uint32_t item_size;
+    char format;
+};
+
+struct alignas(alignment) SlotHeader
+{
+    std::atomic<std::uint32_t> state;
+    std::uint32_t n_arrays;
+    std::atomic<std::uint64_t> sequence;
+    ArrayDescriptor arrays[max_arrays];
+};
+
+struct alignas(alignment) RingHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t slot_count;
+    std::uint64_t slot_bytes;
+    std::atomic<std::uint64_t> next_sequence;
+    std::atomic<std::uint64_t> dropped;
+};
+
+inline std::size_t align_up(std::size_t n)
+{
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+inline std::size_t segment_size(std::size_t slot_count, std::size_t slot_bytes)
+{
+    return sizeof(RingHeader) + slot_count * (sizeof(SlotHeader) + slot_bytes);
+}
+
+struct Mapping
+{
+    std::string name;
+    void* base = nullptr;
+    std::size_t size = 0;
+    bool owner = false;
+
+    Mapping() = default;
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    ~Mapping()
+    {
+#ifndef _WIN32
+        if (base != nullptr)
+            munmap(base, size);
+        if (owner)
+            shm_unlink(name.c_str());
+#endif
+    }
+
+    inline RingHeader* header() const { return static_cast<RingHeader*>(base); }
+
+    inline SlotHeader* slot(std::size_t index) const
+    {
+        return reinterpret_cast<SlotHeader*>(static_cast<char*>(base) + sizeof(RingHeader))
+            + index;
+    }
+
+    inline char* payload(std::size_t index) const
+    {
+        return static_cast<char*>(base) + sizeof(RingHeader)
+            + header()->slot_count * sizeof(SlotHeader) + index * header()->slot_bytes;
+    }
+};
+
+// POSIX object names are a single component starting with '/'.
+inline std::string object_name(const std::string& name)
+{
+    return (!name.empty() && name.front() == '/') ? name : "/" + name;
+}
+
+std::shared_ptr<Mapping> create(const std::string& name, std::size_t slot_count,
+                                std::size_t slot_bytes)
+{
+#ifndef _WIN32
+    auto mapping = std::make_shared<Mapping>();
+    mapping->name = object_name(name);
+    mapping->size = segment_size(slot_count, slot_bytes);
+    shm_unlink(mapping->name.c_str());
+    const int fd = shm_open(mapping->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        return nullptr;
+    mapping->owner = true;
+    if (ftruncate(fd, static_cast<off_t>(mapping->size)) != 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+    void* base = mmap(nullptr, mapping->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return nullptr;
+    mapping->base = base;
+    // ftruncate zero-fills: every slot starts free.
+    auto* header = new (base) RingHeader {};
+    header->slot_count = slot_count;
+    header->slot_bytes = slot_bytes;
+    for (std::size_t i = 0; i < slot_count; ++i)
+        new (mapping->slot(i)) SlotHeader {};
+    header->version = version;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = magic;
+    return mapping;
+#else
+    return nullptr;
+#endif
+}
+
+std::shared_ptr<Mapping> open(const std::string& name)
+{
+#ifndef _WIN32
+    auto mapping = std::make_shared<Mapping>();
+    mapping->name = object_name(name);
+    const int fd = shm_open(mapping->name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+        return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(RingHeader))
+    {
+        close(fd);
+        return nullptr;
+    }
+    mapping->size = static_cast<std::size_t>(st.st_size);
+    void* base = mmap(nullptr, mapping->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return nullptr;
+    mapping->base = base;
+    const auto* header = mapping->header();
+    // The segment comes from another process: check it before trusting it.
+    if (header->magic != magic || header->version != version || header->slot_count == 0
+        || header->slot_bytes % alignment != 0
+        || header->slot_count > (std::numeric_limits<std::size_t>::max() / 2)
+               / (sizeof(SlotHeader) + header->slot_bytes)
+        || segment_size(header->slot_count, header->slot_bytes) > mapping->size)
+        return nullptr;
+    return mapping;
+#else
+    return nullptr;
+#endif
+}
+
+// A frame's descriptors as found in the slot; false if they point outside it.
+bool valid_frame(const SlotHeader& slot, std::size_t slot_bytes)
+{
+    static constexpr std::string_view numeric_formats = "bBhHiIlLqQfd";
+    if (slot.n_arrays == 0 || slot.n_arrays > max_arrays)
+        return false;
+    for (std::size_t i = 0; i < slot.n_arrays; ++i)
+    {
+        const auto& a = slot.arrays[i];
+        if (a.ndim == 0 || a.ndim > max_dims || a.item_size == 0 || a.item_size > 8
+            || numeric_formats.find(a.format) == std::string_view::npos)
+            return false;
+        std::uint64_t count = 1;
+        for (std::size_t d = 0; d < a.ndim; ++d)
+        {
+            if (a.shape[d] != 0 && count > std::numeric_limits<std::uint64_t>::max() / a.shape[d])
+                return false;
+            count *= a.shape[d];
+        }
+        if (count > slot_bytes / a.item_size || count * a.item_size != a.bytes
+            || a.offset > slot_bytes || a.bytes > slot_bytes - a.offset)
+            return false;
+    }
+    return true;
+}
+
+// Held (through shared_ptr<void>) by every buffer over a slot being read.
+struct SlotLease
+{
+    std::shared_ptr<Mapping> mapping;
+    SlotHeader* slot;
+
+    ~SlotLease() { slot->state.store(Free, std::memory_order_release); }
+};
+
+} // namespace shm_ring
+
+using namespace shm_ring;
+
+SharedMemoryRingWriter::SharedMemoryRingWriter(const std::string& name, std::size_t slot_count,
+                                               std::size_t slot_bytes)
+{
+    if (slot_count > 0 && slot_bytes > 0)
+        m_mapping = shm_ring::create(name, slot_count, align_up(slot_bytes));
+}
+
+SharedMemoryRingWriter::~SharedMemoryRingWriter() = default;
+
+bool SharedMemoryRingWriter::is_open() const noexcept
+{
+    return m_mapping != nullptr;
+}
+
+std::string SharedMemoryRingWriter::name() const
+{
+    return m_mapping ? m_mapping->name : std::string {};
+}
+
+std::size_t SharedMemoryRingWriter::slot_count() const noexcept
+{
+    return m_mapping ? m_mapping->header()->slot_count : 0;
+}
+
+std::size_t SharedMemoryRingWriter::slot_bytes() const noexcept
+{
+    return m_mapping ? m_mapping->header()->slot_bytes : 0;
+}
+
+std::uint64_t SharedMemoryRingWriter::frames_written() const noexcept
+{
+    return m_mapping ? m_mapping->header()->next_sequence.load(std::memory_order_relaxed) : 0;
+}
+
+std::uint64_t SharedMemoryRingWriter::frames_dropped() const noexcept
+{
+    return m_mapping ? m_mapping->header()->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+SlotHeader* SharedMemoryRingWriter::_claim_slot()
+{
+    const auto n = m_mapping->header()->slot_count;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        auto* slot = m_mapping->slot((m_cursor + i) % n);
+        auto expected = static_cast<std::uint32_t>(Free);
+        if (slot->state.compare_exchange_strong(expected, Writing, std::memory_order_acquire))
+        {
+            m_cursor = (m_cursor + i + 1) % n;
+            return slot;
+        }
+    }
+    // Full: reuse the oldest frame still waiting for the reader. The reader
+    // may take it meanwhile; only one of the two exchanges succeeds.
+    for (int attempt = 0; attempt < 4; ++attempt)
+    {
+        SlotHeader* oldest = nullptr;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto* slot = m_mapping->slot(i);
+            if (slot->state.load(std::memory_order_relaxed) == Ready
+                && (oldest == nullptr
+                    || slot->sequence.load(std::memory_order_relaxed)
+                        < oldest->sequence.load(std::memory_order_relaxed)))
+                oldest = slot;
+        }
+        if (oldest == nullptr)
+            return nullptr;
+        auto expected = static_cast<std::uint32_t>(Ready);
+        if (oldest->state.compare_exchange_strong(expected, Writing, std::memory_order_acquire))
+        {
+            m_mapping->header()->dropped.fetch_add(1, std::memory_order_relaxed);
+            return oldest;
+        }
+    }
+    return nullptr;
+}
+
+bool SharedMemoryRingWriter::write(const QList<SciQLopPyBuffer>& arrays)
+{
+    if (!m_mapping || arrays.isEmpty() || static_cast<std::size_t>(arrays.size()) > max_arrays)
+        return false;
+    std::size_t total = 0;
+    for (const auto& a : arrays)
+    {
+        if (!a.is_valid() || a.ndim() == 0 || a.ndim() > max_dims
+            || (a.ndim() > 1 && !a.row_major()))
+            return false;
+        total += align_up(a.flat_size() * a.item_size());
+    }
+    if (total > slot_bytes())
+        return false;
+    auto* slot = _claim_slot();
+    if (slot == nullptr)
+        return false;
+    auto* payload = m_mapping->payload(static_cast<std::size_t>(slot - m_mapping->slot(0)));
+    std::size_t offset = 0;
+    slot->n_arrays = static_cast<std::uint32_t>(arrays.size());
+    for (std::size_t i = 0; i < slot->n_arrays; ++i)
+    {
+        const auto& a = arrays[i];
+        const auto bytes = a.flat_size() * a.item_size();
+        auto& d = slot->arrays[i];
+        d = ArrayDescriptor {};
+        d.offset = offset;
+        d.bytes = bytes;
+        d.ndim = static_cast<std::uint32_t>(a.ndim());
+        for (std::size_t k = 0; k < a.ndim(); ++k)
+            d.shape[k] = a.size(k);
+        d.item_size = static_cast<std::uint32_t>(a.item_size());
+        d.format = a.format_code();
+        std::memcpy(payload + offset, a.raw_data(), bytes);
+        offset += align_up(bytes);
+    }
+    slot->sequence.store(
+        m_mapping->header()->next_sequence.fetch_add(1, std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+    slot->state.store(Ready, std::memory_order_release);
+    return true;
+}
+
+SharedMemoryRingReader::SharedMemoryRingReader(const std::string& name)
+        : m_mapping { shm_ring::open(name) }
+{
+}
+
+SharedMemoryRingReader::~SharedMemoryRingReader() = default;
+
+bool SharedMemoryRingReader::is_open() const noexcept
+{
+    return m_mapping != nullptr;
+}
+
+std::optional<QList<SciQLopPyBuffer>> SharedMemoryRingReader::take_next()
+{
+    if (!m_mapping)
+        return std::nullopt;
+    const auto n = m_mapping->header()->slot_count;
+    const auto slot_bytes = m_mapping->header()->slot_bytes;
+    for (std::size_t attempt = 0; attempt < 2 * n; ++attempt)
+    {
+        SlotHeader* oldest = nullptr;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto* slot = m_mapping->slot(i);
+            if (slot->state.load(std::memory_order_relaxed) == Ready
+                && (oldest == nullptr
+                    || slot->sequence.load(std::memory_order_relaxed)
+                        < oldest->sequence.load(std::memory_order_relaxed)))
+                oldest = slot;
+        }
+        if (oldest == nullptr)
+            return std::nullopt;
+        auto expected = static_cast<std::uint32_t>(Ready);
+        if (!oldest->state.compare_exchange_strong(expected, Reading, std::memory_order_acquire))
+            continue; // the writer reused it first
+        auto lease = std::shared_ptr<SlotLease>(new SlotLease { m_mapping, oldest });
+        if (!valid_frame(*oldest, slot_bytes))
+            continue; // dropping the lease frees the slot
+        auto* payload = m_mapping->payload(static_cast<std::size_t>(oldest - m_mapping->slot(0)));
+        QList<SciQLopPyBuffer> frame;
+        frame.reserve(oldest->n_arrays);
+        for (std::size_t i = 0; i < oldest->n_arrays; ++i)
+        {
+            const auto& d = oldest->arrays[i];
+            frame.append(SciQLopPyBuffer::from_memory(
+                payload + d.offset,
+                std::vector<std::size_t>(std::cbegin(d.shape), std::cbegin(d.shape) + d.ndim),
+                d.format, d.item_size, lease));
+        }
+        return frame;
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,161 @@
+/*------------------------------------------------------------------------------
+-- This file is a part of the SciQLop Software
+-- Copyright (C) 2024, Plasma Physics Laboratory - CNRS
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; either version 2 of the License, or
+-- (at your option) any later version.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#include "SciQLopPlots/Plotables/StreamingSeries.hpp"
+#include "SciQLopPlots/Python/Validation.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+constexpr std::size_t min_capacity = 1024;
+}
+
+struct StreamingSeries::Block
+{
+    std::unique_ptr<double[]> keys;
+    std::unique_ptr<std::byte[]> values;
+    std::size_t capacity;
+
+    Block(std::size_t rows, std::size_t row_bytes)
+            : keys { new double[rows] }, values { new std::byte[rows * row_bytes] }, capacity { rows }
+    {
+    }
+};
+
+StreamingSeries::StreamingSeries() = default;
+StreamingSeries::~StreamingSeries() = default;
+
+void StreamingSeries::_reallocate(std::size_t capacity)
+{
+    // Never resized in place: snapshots handed out earlier keep the old block.
+    const auto live = size();
+    const auto row_bytes = m_columns * m_item_size;
+    auto block = std::make_shared<Block>(std::max(capacity, min_capacity), row_bytes);
+    if (live > 0)
+    {
+        std::copy_n(m_block->keys.get() + m_first, live, block->keys.get());
+        std::memcpy(block->values.get(), m_block->values.get() + m_first * row_bytes,
+                    live * row_bytes);
+    }
+    m_block = std::move(block);
+    m_first = 0;
+    m_end = live;
+}
+
+void StreamingSeries::_reserve(std::size_t rows)
+{
+    if (!m_block || m_end + rows > m_block->capacity)
+        _reallocate(2 * (size() + rows));
+}
+
+void StreamingSeries::_trim()
+{
+    if (m_window <= 0. || empty())
+        return;
+    const auto* keys = m_block->keys.get();
+    const double lower = keys[m_end - 1] - m_window;
+    const auto first = static_cast<std::size_t>(
+        std::lower_bound(keys + m_first, keys + m_end, lower) - keys);
+    m_dropped += first - m_first;
+    m_first = first;
+    if (m_first > std::max(size(), min_capacity))
+        _reallocate(2 * size());
+}
+
+StreamingSeries::Snapshot StreamingSeries::append(const SciQLopPyBuffer& x,
+                                                  const SciQLopPyBuffer& y)
+{
+    if (!x.is_valid() || !y.is_valid())
+        return snapshot();
+    if (x.format_code() != 'd')
+        throw std::invalid_argument("Keys (x) must be float64");
+    sqp::validation::validate_xy(x, y);
+    const auto rows = x.flat_size();
+    const auto columns = y.ndim() == 1 ? std::size_t { 1 } : y.size(1);
+    if (empty())
+    {
+        m_format = y.format_code();
+        m_item_size = y.item_size();
+        m_columns = columns;
+        m_flat_values = y.ndim() == 1;
+        m_block.reset();
+        m_first = m_end = 0;
+    }
+    else if (y.format_code() != m_format || columns != m_columns)
+        throw std::invalid_argument("append_data: y dtype and columns must match the data "
+                                    "already appended");
+    if (rows == 0 || columns == 0)
+        return snapshot();
+    const auto* new_keys = static_cast<const double*>(x.raw_data());
+    if (!empty() && new_keys[0] < m_block->keys[m_end - 1])
+        throw std::invalid_argument("append_data: x must not start before the last key");
+
+    _reserve(rows);
+    std::copy_n(new_keys, rows, m_block->keys.get() + m_end);
+    const auto row_bytes = m_columns * m_item_size;
+    auto* dst = m_block->values.get() + m_end * row_bytes;
+    const auto* src = static_cast<const std::byte*>(y.raw_data());
+    if (y.ndim() == 1 || y.row_major())
+        std::memcpy(dst, src, rows * row_bytes);
+    else
+    {
+        // Column-major chunk: store row-major like the rest.
+        for (std::size_t col = 0; col < m_columns; ++col)
+            for (std::size_t row = 0; row < rows; ++row)
+                std::memcpy(dst + (row * m_columns + col) * m_item_size,
+                            src + (col * rows + row) * m_item_size, m_item_size);
+    }
+    m_end += rows;
+    _trim();
+    return snapshot();
+}
+
+void StreamingSeries::clear()
+{
+    m_block.reset();
+    m_first = m_end = 0;
+    m_dropped = 0;
+    m_columns = 0;
+}
+
+void StreamingSeries::set_window(double window)
+{
+    m_window = window > 0. ? window : 0.;
+    _trim();
+}
+
+StreamingSeries::Snapshot StreamingSeries::snapshot() const
+{
+    if (empty())
+        return {};
+    const auto rows = size();
+    const auto row_bytes = m_columns * m_item_size;
+    auto x = SciQLopPyBuffer::from_memory(m_block->keys.get() + m_first, { rows }, 'd',
+                                          sizeof(double), m_block);
+    auto y = SciQLopPyBuffer::from_memory(
+        m_block->values.get() + m_first * row_bytes,
+        m_flat_values ? std::vector<std::size_t> { rows } : std::vector<std::size_t> { rows, m_columns },
+        m_format, m_item_size, m_block);
+    return { std::move(x), std::move(y), m_dropped };
+}
@@ -67,3 +67,16 @@ def force_gc():
     gc.collect()
     QApplication.processEvents()
     gc.collect()
+
+
+def settle(qtbot, *plottables, plot=None, timeout=10000):
+    """Wait until the background builds of `plottables` (LOD pyramids,
+    quantile sketches, histogram bins) for their current data have landed.
+    With `plot`, it is rendered first, so the view requests what it needs,
+    and again once the results are in."""
+    if plot is not None:
+        plot.replot(True)
+    qtbot.waitUntil(lambda: not any(p.lod_pending() for p in plottables), timeout=timeout)
+    QApplication.processEvents()
+    if plot is not None:
+        plot.replot(True)
@@ -0,0 +1,62 @@
+"""append_data: streaming rows onto line graphs without resending history."""
+import numpy as np
+import pytest
+
+
+def _chunk(start, n=100, dt=0.01, columns=None):
+    x = start + np.arange(n) * dt
+    if columns is None:
+        return x, np.sin(x)
+    return x, np.column_stack([np.sin(x + c) for c in range(columns)])
+
+
+@pytest.mark.parametrize("columns", [None, 3], ids=["single_line", "multi_line"])
+class TestAppendData:
+    def test_appends_extend_the_data(self, plot, columns):
+        g = plot.line(*_chunk(0.0, columns=columns))
+        g.append_data(*_chunk(1.0, columns=columns))
+        g.append_data(*_chunk(2.0, columns=columns))
+        x, y = (np.asarray(b) for b in g.data())
+        expected_x = np.concatenate([_chunk(s, columns=columns)[0] for s in (0.0, 1.0, 2.0)])
+        expected_y = np.concatenate([_chunk(s, columns=columns)[1] for s in (0.0, 1.0, 2.0)])
+        assert np.array_equal(x, expected_x)
+        assert np.array_equal(y, expected_y)
+
+    def test_window_keeps_only_recent_rows(self, plot, columns):
+        g = plot.line(*_chunk(0.0, columns=columns))
+        g.set_stream_window(1.5)
+        assert g.stream_window() == 1.5
+        for start in range(1, 10):
+            g.append_data(*_chunk(float(start), columns=columns))
+        x = np.asarray(g.data()[0])
+        assert x[-1] == pytest.approx(9.99)
+        assert x[-1] - x[0] <= 1.5
+        assert x[0] >= 9.99 - 1.5
+
+    def test_set_data_restarts_the_stream(self, plot, columns):
+        g = plot.line(*_chunk(0.0, columns=columns))
+        g.append_data(*_chunk(1.0, columns=columns))
+        g.set_data(*_chunk(5.0, columns=columns))
+        g.append_data(*_chunk(6.0, columns=columns))
+        x = np.asarray(g.data()[0])
+        assert x[0] == 5.0 and x.size == 200
+
+    def test_keys_going_backwards_are_rejected(self, plot, columns):
+        g = plot.line(*_chunk(5.0, columns=columns))
+        with pytest.raises(Exception):
+            g.append_data(*_chunk(0.0, columns=columns))
+        assert np.asarray(g.data()[0])[0] == 5.0
+
+
+def test_column_count_must_not_change(plot):
+    g = plot.line(*_chunk(0.0, columns=2))
+    with pytest.raises(Exception):
+        g.append_data(*_chunk(1.0, columns=3))
+
+
+def test_column_major_chunks(plot):
+    x, y = _chunk(0.0, columns=2)
+    g = plot.line(x, y)
+    x2, y2 = _chunk(1.0, columns=2)
+    g.append_data(x2, np.asfortranarray(y2))
+    assert np.array_equal(np.asarray(g.data()[1])[100:], y2)
@@ -0,0 +1,75 @@
+"""Axis synchronizers coalesce range changes coming from the plots' own axes
+(interactive pan/zoom) and propagate the latest one once per frame, while
+programmatic panel range setters still apply synchronously."""
+from SciQLopPlots import SciQLopMultiPlotPanel, SciQLopPlotRange, PlotType
+
+N_PLOTS = 4
+
+
+def _stacked_panel(qtbot, plot_type=PlotType.BasicXY, **kwargs):
+    panel = SciQLopMultiPlotPanel(**kwargs)
+    qtbot.addWidget(panel)
+    for _ in range(N_PLOTS):
+        panel.create_plot(plot_type=plot_type)
+    # let the initial ranges settle before observing propagation
+    qtbot.wait(50)
+    return panel
+
+
+def _same(a, b):
+    return abs(a.start() - b.start()) < 1e-9 and abs(a.stop() - b.stop()) < 1e-9
+
+
+class TestInteractiveSyncIsCoalesced:
+
+    def test_burst_propagates_latest_range_once(self, qtbot):
+        panel = _stacked_panel(qtbot, synchronize_x=True)
+        received = []
+        panel.plot_at(N_PLOTS - 1).x_axis().range_changed.connect(
+            lambda r: received.append((r.start(), r.stop())))
+
+        source = panel.plot_at(0).x_axis()
+        for i in range(10):
+            source.set_range(SciQLopPlotRange(10.0 + i, 20.0 + i))
+        final = SciQLopPlotRange(19.0, 29.0)
+
+        for i in range(1, N_PLOTS):
+            qtbot.waitUntil(lambda i=i: _same(panel.plot_at(i).x_axis().range(), final),
+                            timeout=2000)
+        assert received == [(19.0, 29.0)]
+
+    def test_time_panel_reports_one_change_per_burst(self, qtbot):
+        panel = _stacked_panel(qtbot, PlotType.TimeSeries, synchronize_x=False,
+                               synchronize_time=True)
+        emitted = []
+        panel.time_range_changed.connect(lambda r: emitted.append((r.start(), r.stop())))
+
+        source = panel.plot_at(0).time_axis()
+        for i in range(5):
+            source.set_range(SciQLopPlotRange(100.0 + i, 200.0 + i))
+
+        qtbot.waitUntil(lambda: len(emitted) > 0, timeout=2000)
+        qtbot.wait(50)
+        assert emitted == [(104.0, 204.0)]
+        assert _same(panel.plot_at(N_PLOTS - 1).time_axis().range(),
+                     SciQLopPlotRange(104.0, 204.0))
+
+
+class TestProgrammaticSyncIsImmediate:
+
+    def test_set_x_axis_range(self, qtbot):
+        panel = _stacked_panel(qtbot, synchronize_x=True)
+        r = SciQLopPlotRange(2.0, 8.0)
+        panel.set_x_axis_range(r)
+        for i in range(N_PLOTS):
+            assert _same(panel.plot_at(i).x_axis().range(), r)
+
+    def test_set_time_axis_range_notifies_before_returning(self, qtbot):
+        panel = _stacked_panel(qtbot, PlotType.TimeSeries, synchronize_x=False,
+                               synchronize_time=True)
+        emitted = []
+        panel.time_range_changed.connect(lambda r: emitted.append((r.start(), r.stop())))
+        panel.set_time_axis_range(SciQLopPlotRange(100.0, 200.0))
+        assert emitted == [(100.0, 200.0)]
+        for i in range(N_PLOTS):
+            assert _same(panel.plot_at(i).time_axis().range(), SciQLopPlotRange(100.0, 200.0))
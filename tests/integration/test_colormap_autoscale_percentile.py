@@ -121,6 +121,50 @@ class TestZPercentileRange:
         assert r.stop() == pytest.approx(2.0)
 
 
+def _nearest_rank(values, p):
+    finite = np.sort(values[np.isfinite(values)].astype(np.float64))
+    return finite[int(p / 100.0 * (finite.size - 1) + 0.5)]
+
+
+class TestZPercentileGather:
+    """Large visible windows go through the parallel gather and radix
+    selection; the cutoffs must still be the exact nearest-rank ones."""
+
+    @pytest.mark.parametrize("dtype", [np.float32, np.float64, np.int16])
+    def test_exact_cutoffs_on_split_channel_window(self, plot, dtype):
+        nx, ny = 3000, 96
+        x = np.arange(nx, dtype=np.float64)
+        # non-monotonic channels: the visible ones form several runs
+        y = np.tile(np.arange(0.0, 8.0), ny // 8)
+        rng = np.random.default_rng(3)
+        z = (rng.standard_normal((nx, ny)) * 1000).astype(dtype)
+        if np.issubdtype(dtype, np.floating):
+            z[rng.random((nx, ny)) < 0.01] = np.nan
+            z[5, 5] = np.inf
+        cmap = plot.colormap(x, y, z)
+        cmap.set_autoscale_percentile_error(0.0)
+        r = cmap.z_percentile_range(
+            SciQLopPlotRange(100.0, 2900.0), SciQLopPlotRange(2.0, 5.0), 1.0, 99.0
+        )
+        visible = z[100:2901][:, (y >= 2.0) & (y <= 5.0)]
+        assert r.start() == _nearest_rank(visible, 1.0)
+        assert r.stop() == _nearest_rank(visible, 99.0)
+
+    def test_exact_cutoffs_with_2d_y(self, plot):
+        nx, ny = 2000, 64
+        x = np.arange(nx, dtype=np.float64)
+        y = np.arange(nx * ny, dtype=np.float64).reshape(nx, ny) % 97
+        z = np.random.default_rng(4).lognormal(0.0, 2.0, (nx, ny))
+        cmap = plot.colormap(x, y, z)
+        cmap.set_autoscale_percentile_error(0.0)
+        r = cmap.z_percentile_range(
+            SciQLopPlotRange(x[0], x[-1]), SciQLopPlotRange(10.0, 60.0), 5.0, 95.0
+        )
+        visible = z[(y >= 10.0) & (y <= 60.0)]
+        assert r.start() == _nearest_rank(visible, 5.0)
+        assert r.stop() == _nearest_rank(visible, 95.0)
+
+
 class TestPercentileConfig:
 
     def test_default_percentiles(self, plot, sample_colormap_data):
@@ -0,0 +1,74 @@
+"""Colormap level-of-detail pyramid.
+
+With set_lod(Mean|Max), a colormap of at least ColorMapPyramid::min_cells
+cells draws zoomed-out views from a background-built pyramid instead of the
+full-resolution plane. The pyramid is a rendering aid only: data(), the
+z autoscale and the API behave as without it.
+"""
+import numpy as np
+
+from SciQLopPlots import ColorMapLod, SciQLopPlotRange
+from conftest import settle
+
+NX, NY = 40_000, 128
+
+
+def _spectrogram():
+    x = np.arange(NX, dtype=np.float64) * 0.5
+    y = np.logspace(0, 3, NY)
+    z = np.random.default_rng(0).random((NX, NY)).astype(np.float32)
+    return x, y, z
+
+
+class TestColorMapLod:
+    def test_off_by_default(self, plot):
+        x, y, z = _spectrogram()
+        cmap = plot.colormap(x, y, z)
+        assert cmap.lod() == ColorMapLod.Off
+
+    def test_set_lod_emits_and_round_trips(self, plot):
+        x, y, z = _spectrogram()
+        cmap = plot.colormap(x, y, z)
+        seen = []
+        cmap.lod_changed.connect(seen.append)
+        cmap.set_lod(ColorMapLod.Max)
+        cmap.set_lod(ColorMapLod.Max)
+        assert cmap.lod() == ColorMapLod.Max
+        assert seen == [ColorMapLod.Max]
+
+    def test_zoomed_out_render_keeps_data_untouched(self, plot, qtbot):
+        plot.show()
+        x, y, z = _spectrogram()
+        cmap = plot.colormap(x, y, z)
+        cmap.set_lod(ColorMapLod.Mean)
+        plot.x_axis().set_range(SciQLopPlotRange(x[0], x[-1]))
+        settle(qtbot, cmap, plot=plot)
+        plot.x_axis().set_range(SciQLopPlotRange(x[100], x[400]))
+        settle(qtbot, cmap, plot=plot)
+        plot.x_axis().set_range(SciQLopPlotRange(x[0], x[-1]))
+        settle(qtbot, cmap, plot=plot)
+        np.testing.assert_array_equal(np.asarray(cmap.data()[2]), z)
+
+    def test_log_y_toggle_and_new_data(self, plot, qtbot):
+        plot.show()
+        x, y, z = _spectrogram()
+        cmap = plot.colormap(x, y, z)
+        cmap.set_lod(ColorMapLod.Max)
+        plot.x_axis().set_range(SciQLopPlotRange(x[0], x[-1]))
+        settle(qtbot, cmap, plot=plot)
+        cmap.set_y_log_scale(True)
+        settle(qtbot, cmap, plot=plot)
+        z2 = z * 2
+        cmap.set_data(x, y, z2)
+        settle(qtbot, cmap, plot=plot)
+        np.testing.assert_array_equal(np.asarray(cmap.data()[2]), z2)
+
+    def test_per_column_y(self, plot, qtbot):
+        plot.show()
+        x, y, z = _spectrogram()
+        y2 = np.tile(y, (NX, 1)) * (1.0 + np.arange(NX)[:, None] * 1e-6)
+        cmap = plot.colormap(x, y2, z)
+        cmap.set_lod(ColorMapLod.Mean)
+        plot.x_axis().set_range(SciQLopPlotRange(x[0], x[-1]))
+        settle(qtbot, cmap, plot=plot)
+        assert np.asarray(cmap.data()[1]).shape == y2.shape
@@ -0,0 +1,67 @@
+"""View-dependent simplification of parametric curves.
+
+The curve resampler reads the caller's buffers in their own dtype and hands
+QCPCurve only the points that matter at the current view. What the curve
+reports and how the axes rescale must not depend on that.
+"""
+import numpy as np
+from PySide6.QtWidgets import QApplication
+
+from SciQLopPlots import SciQLopPlotRange
+
+N = 1_000_000
+
+
+def _spiral(dtype=np.float64):
+    t = np.linspace(0.0, 200.0, N)
+    r = 1.0 + 0.01 * t
+    return (np.cos(t) * r).astype(dtype), (np.sin(t) * r).astype(dtype)
+
+
+def _settle(qtbot, plot, g):
+    qtbot.waitUntil(lambda: not g.busy(), timeout=10000)
+    qtbot.wait(100)
+    for _ in range(10):
+        QApplication.processEvents()
+    plot.replot(True)
+
+
+class TestCurveDecimation:
+    def test_data_keeps_dtype_and_size(self, plot, qtbot):
+        plot.show()
+        x, y = _spiral(np.float32)
+        g = plot.parametric_curve(x, y, labels=["c"])
+        _settle(qtbot, plot, g)
+        gx, gy = (np.asarray(b) for b in g.data()[:2])
+        assert gx.dtype == np.float32 and gy.dtype == np.float32
+        assert gx.size == N and gy.size == N
+        np.testing.assert_array_equal(gy, y)
+
+    def test_rescale_hits_exact_extremes(self, plot, qtbot):
+        plot.show()
+        x, y = _spiral()
+        x[123_457] = 50.0
+        y[654_321] = -40.0
+        g = plot.parametric_curve(x, y, labels=["c"])
+        _settle(qtbot, plot, g)
+        plot.x_axis().set_range(SciQLopPlotRange(-0.5, 0.5))
+        plot.y_axis().set_range(SciQLopPlotRange(-0.5, 0.5))
+        _settle(qtbot, plot, g)
+        plot.x_axis().rescale()
+        plot.y_axis().rescale()
+        xr, yr = plot.x_axis().range(), plot.y_axis().range()
+        assert xr.start() <= x.min() and xr.stop() >= 50.0
+        assert yr.start() <= -40.0 and yr.stop() >= y.max()
+
+    def test_pan_is_not_a_data_change(self, plot, qtbot):
+        plot.show()
+        x, y = _spiral()
+        g = plot.parametric_curve(x, y, labels=["c"])
+        _settle(qtbot, plot, g)
+        changes = []
+        g.data_changed.connect(lambda *args: changes.append(args))
+        for i in range(5):
+            plot.x_axis().set_range(SciQLopPlotRange(-1.0 + 0.1 * i, 1.0 + 0.1 * i))
+        _settle(qtbot, plot, g)
+        assert changes == []
+        assert not g.busy()
@@ -0,0 +1,73 @@
+"""Function graphs share a bounded pool of provider threads.
+
+Each graph's provider is pinned to one pool thread, so a panel with many
+function graphs no longer starts one thread per graph. Concurrent calls of
+the same callable for the same range, from different provider threads, are
+served by a single Python call.
+"""
+import time
+
+import numpy as np
+import pytest
+from conftest import process_events
+
+
+def _source(calls, delay=0.0):
+    def cb(start, stop):
+        calls.append((start, stop))
+        if delay:
+            time.sleep(delay)
+        x = np.linspace(start, stop, 64)
+        return x, np.sin(x)
+    return cb
+
+
+def _wait_data(graphs, qtbot, lower, upper):
+    def done():
+        for g in graphs:
+            x = np.asarray(g.data()[0])
+            assert x.size and x[0] == lower and x[-1] == upper
+    qtbot.waitUntil(done, timeout=5000)
+
+
+class TestDataProviderPool:
+    def test_thread_count_is_bounded(self, plot, qtbot):
+        from SciQLopPlots import (SciQLopPlotRange, data_provider_pool_max_threads,
+                                  data_provider_pool_thread_count)
+        calls = []
+        graphs = [plot.line(_source(calls)) for _ in range(12)]
+        for g in graphs:
+            g.set_range(SciQLopPlotRange(0.0, 10.0))
+        _wait_data(graphs, qtbot, 0.0, 10.0)
+        assert 1 <= data_provider_pool_thread_count() <= data_provider_pool_max_threads()
+
+    def test_max_threads_is_settable(self):
+        from SciQLopPlots import (data_provider_pool_max_threads,
+                                  data_provider_pool_set_max_threads)
+        before = data_provider_pool_max_threads()
+        try:
+            data_provider_pool_set_max_threads(3)
+            assert data_provider_pool_max_threads() == 3
+            data_provider_pool_set_max_threads(0)
+            assert data_provider_pool_max_threads() == 1
+        finally:
+            data_provider_pool_set_max_threads(before)
+
+    def test_identical_concurrent_requests_are_coalesced(self, plot, qtbot):
+        from SciQLopPlots import SciQLopPlotRange, data_provider_pool_thread_count
+        calls = []
+        cb = _source(calls, delay=0.2)
+        graphs = [plot.line(cb) for _ in range(8)]
+        for _ in range(10):
+            process_events()
+        if data_provider_pool_thread_count() < 2:
+            pytest.skip("single provider thread: nothing runs concurrently")
+
+        for g in graphs:
+            g.set_range(SciQLopPlotRange(1000.0, 1010.0))
+        _wait_data(graphs, qtbot, 1000.0, 1010.0)
+        n = calls.count((1000.0, 1010.0))
+        assert 1 <= n < len(graphs)
+        for g in graphs[1:]:
+            np.testing.assert_array_equal(np.asarray(g.data()[1]),
+                                          np.asarray(graphs[0].data()[1]))
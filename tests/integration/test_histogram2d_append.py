@@ -0,0 +1,113 @@
+"""Native Histogram2D binning: append_data and windowed streams.
+
+Counts are kept between updates: appended points inside the current bins are
+counted on their own, and a stream window uncounts the x slice it moves past.
+The result must match binning everything again (numpy.histogram2d over the
+same bins).
+"""
+import numpy as np
+import pytest
+
+from SciQLopPlots import SciQLopPlotRange
+from conftest import settle
+
+
+def _max_count(hist):
+    full = SciQLopPlotRange(-1e300, 1e300)
+    return hist.z_percentile_range(full, full, 0.0, 100.0).stop()
+
+
+def _edges(bins_range, bins):
+    return np.linspace(bins_range.start(), bins_range.stop(), bins + 1)
+
+
+def _grid(hist):
+    """Every cell of the grid shown, read one bin centre at a time, and the
+    edges it was binned on."""
+    x_edges = _edges(hist.x_bins_range(), hist.x_bins())
+    y_edges = _edges(hist.y_bins_range(), hist.y_bins())
+    x_centres = 0.5 * (x_edges[:-1] + x_edges[1:])
+    y_centres = 0.5 * (y_edges[:-1] + y_edges[1:])
+    dx = 0.25 * (x_edges[1] - x_edges[0])
+    dy = 0.25 * (y_edges[1] - y_edges[0])
+    grid = np.empty((x_centres.size, y_centres.size))
+    for i, cx in enumerate(x_centres):
+        for j, cy in enumerate(y_centres):
+            cell = hist.z_percentile_range(SciQLopPlotRange(cx - dx, cx + dx),
+                                           SciQLopPlotRange(cy - dy, cy + dy), 0.0, 100.0)
+            grid[i, j] = cell.stop()
+    return grid, x_edges, y_edges
+
+
+def _assert_grid_matches_numpy(hist, x, y):
+    grid, x_edges, y_edges = _grid(hist)
+    expected, _, _ = np.histogram2d(x, y, bins=[x_edges, y_edges])
+    np.testing.assert_array_equal(grid, expected)
+    assert grid.sum() == x.size
+
+
+class TestAppend:
+    def test_append_inside_bins_matches_numpy(self, plot, qtbot):
+        rng = np.random.default_rng(11)
+        x = rng.uniform(0.0, 10.0, 200_000)
+        y = rng.uniform(-5.0, 5.0, 200_000)
+        # the corners pin the extent so later chunks stay inside the bins
+        x[:2] = [0.0, 10.0]
+        y[:2] = [-5.0, 5.0]
+        hist = plot.add_histogram2d("append", 40, 30)
+        hist.set_data(x, y)
+        settle(qtbot, hist)
+        _assert_grid_matches_numpy(hist, x, y)
+
+        xs, ys = [x], [y]
+        for _ in range(5):
+            cx = rng.normal(5.0, 1.0, 20_000).clip(0.0, 10.0)
+            cy = rng.normal(0.0, 1.0, 20_000).clip(-5.0, 5.0)
+            hist.append_data(cx, cy)
+            xs.append(cx)
+            ys.append(cy)
+        settle(qtbot, hist)
+        all_x, all_y = np.concatenate(xs), np.concatenate(ys)
+        # still the bins of the first set_data: only the chunks were counted
+        assert hist.x_bins_range().start() == 0.0 and hist.x_bins_range().stop() == 10.0
+        _assert_grid_matches_numpy(hist, all_x, all_y)
+        data = hist.data()
+        assert len(data[0]) == all_x.size
+
+    def test_append_without_set_data(self, plot, qtbot):
+        hist = plot.add_histogram2d("fresh", 10, 10)
+        hist.append_data(np.arange(100, dtype=np.float64), np.arange(100, dtype=np.float64))
+        settle(qtbot, hist)
+        assert _max_count(hist) == 10.0
+
+    def test_append_rejects_mismatched_sizes(self, plot):
+        hist = plot.add_histogram2d("bad", 10, 10)
+        with pytest.raises(Exception):
+            hist.append_data(np.zeros(3), np.zeros(4))
+
+
+class TestStreamWindow:
+    def test_window_drops_old_points(self, plot, qtbot):
+        hist = plot.add_histogram2d("stream", 20, 20)
+        hist.set_stream_window(10.0)
+        assert hist.stream_window() == 10.0
+        rng = np.random.default_rng(3)
+        t0 = 0.0
+        for _ in range(30):
+            t = t0 + np.sort(rng.uniform(0.0, 1.0, 1000))
+            hist.append_data(t, rng.normal(0.0, 1.0, t.size))
+            t0 += 1.0
+            settle(qtbot, hist)
+        x, y = (np.asarray(v) for v in hist.data())
+        assert x.min() >= x.max() - 10.0
+        assert x.size < 12_000
+        # the points that left the window were uncounted, the rest still are
+        _assert_grid_matches_numpy(hist, x, y)
+
+    def test_column_normalization_bounds_cells(self, plot, qtbot):
+        rng = np.random.default_rng(4)
+        hist = plot.add_histogram2d("norm", 16, 16)
+        hist.set_data(rng.normal(0, 1, 50_000), rng.normal(0, 1, 50_000))
+        hist.set_normalization(1)
+        settle(qtbot, hist)
+        assert 0.0 < _max_count(hist) <= 1.0
@@ -0,0 +1,113 @@
+"""Level-of-detail rendering of long line series.
+
+Past LodIndex::min_rows samples, a zoomed-out line graph hands the renderer
+the first/min/max/last rows of each pixel from a min/max pyramid built on a
+worker thread, and its y autoscale reads the pyramid instead of scanning.
+Neither may change what the user sees: spikes survive, the data the graph
+reports is untouched and autoscale bounds match an exact scan.
+"""
+import numpy as np
+
+from SciQLopPlots import SciQLopPlotRange
+from conftest import settle
+
+N = 2_000_000
+
+
+def _rescaled_y(plot):
+    plot.y_axis().rescale()
+    r = plot.y_axis().range()
+    return r.start(), r.stop()
+
+
+class TestLineLod:
+    def test_autoscale_keeps_single_sample_spike(self, plot, qtbot):
+        plot.show()
+        x = np.arange(N, dtype=np.float64)
+        y = np.sin(x * 1e-4)
+        y[1_234_567] = 42.0
+        y[987] = -17.0
+        g = plot.line(x, y)
+        plot.x_axis().set_range(SciQLopPlotRange(0.0, float(N - 1)))
+        settle(qtbot, g, plot=plot)
+        lo, hi = _rescaled_y(plot)
+        assert lo <= -17.0
+        assert hi >= 42.0
+        assert np.asarray(g.data()[0]).size == N
+
+    def test_autoscale_restricted_to_visible_keys(self, plot, qtbot):
+        plot.show()
+        x = np.arange(N, dtype=np.float64)
+        y = np.zeros((N, 2))
+        y[100, 0] = 1000.0
+        y[N // 2 + 1000, 1] = 5.0
+        y[N // 2 + 2000, 0] = -3.0
+        g = plot.line(x, y)
+        plot.x_axis().set_range(SciQLopPlotRange(float(N // 2), float(N - 1)))
+        settle(qtbot, g, plot=plot)
+        lo, hi = _rescaled_y(plot)
+        assert lo <= -3.0 and 5.0 <= hi
+        assert hi < 1000.0
+
+    def test_zoom_in_after_zoom_out_shows_raw_samples(self, plot, qtbot):
+        plot.show()
+        x = np.arange(N, dtype=np.float64)
+        y = np.cos(x * 1e-3)
+        g = plot.line(x, y)
+        plot.x_axis().set_range(SciQLopPlotRange(0.0, float(N - 1)))
+        settle(qtbot, g, plot=plot)
+        plot.x_axis().set_range(SciQLopPlotRange(1000.0, 1100.0))
+        settle(qtbot, g, plot=plot)
+        lo, hi = _rescaled_y(plot)
+        window = y[1000:1101]
+        assert lo <= window.min() and window.max() <= hi
+        np.testing.assert_array_equal(np.asarray(g.data()[1]), y)
+
+    def test_set_data_invalidates_pyramid(self, plot, qtbot):
+        plot.show()
+        x = np.arange(N, dtype=np.float64)
+        g = plot.line(x, np.zeros(N))
+        plot.x_axis().set_range(SciQLopPlotRange(0.0, float(N - 1)))
+        settle(qtbot, g, plot=plot)
+        y = np.zeros(N)
+        y[N - 10] = 7.0
+        g.set_data(x, y)
+        # Whether the new pyramid is ready yet or not, the bound is exact.
+        lo, hi = _rescaled_y(plot)
+        assert hi >= 7.0
+        settle(qtbot, g, plot=plot)
+        lo, hi = _rescaled_y(plot)
+        assert hi >= 7.0
+
+    def test_append_extends_pyramid(self, plot, qtbot):
+        plot.show()
+        x = np.arange(N, dtype=np.float64)
+        g = plot.line(x, np.sin(x * 1e-4))
+        plot.x_axis().set_range(SciQLopPlotRange(0.0, float(N + 999)))
+        settle(qtbot, g, plot=plot)
+        tail = np.zeros(1000)
+        tail[500] = 9.0
+        g.append_data(np.arange(N, N + 1000, dtype=np.float64), tail)
+        # The previous pyramid still serves the first N rows, the new ones are
+        # read raw until the extended pyramid is ready.
+        lo, hi = _rescaled_y(plot)
+        assert hi >= 9.0
+        settle(qtbot, g, plot=plot)
+        lo, hi = _rescaled_y(plot)
+        assert hi >= 9.0
+        assert np.asarray(g.data()[0]).size == N + 1000
+
+    def test_windowed_append_rebuilds_pyramid(self, plot, qtbot):
+        plot.show()
+        x = np.arange(N, dtype=np.float64)
+        y = np.zeros(N)
+        y[10] = 50.0
+        g = plot.line(x, y)
+        g.set_stream_window(float(N - 100))
+        plot.x_axis().set_range(SciQLopPlotRange(0.0, float(N + 999)))
+        settle(qtbot, g, plot=plot)
+        g.append_data(np.arange(N, N + 1000, dtype=np.float64), np.ones(1000))
+        # The spike's rows left the window: the pyramid may not report them.
+        settle(qtbot, g, plot=plot)
+        lo, hi = _rescaled_y(plot)
+        assert 1.0 <= hi < 50.0
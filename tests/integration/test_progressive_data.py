@@ -0,0 +1,85 @@
+"""Progressive (coarse-then-fine) data delivery.
+
+A callable written as a generator may yield ``(level, answer)`` previews before
+returning its full-resolution answer; level 0 is full resolution, larger is
+coarser. Remote channels push previews with ``set_preview(..., level)``. A
+coarser answer never replaces a finer one for the same range.
+"""
+import numpy as np
+from PySide6.QtWidgets import QApplication
+
+from SciQLopPlots import SciQLopPlotRange
+
+
+class TestGeneratorCallable:
+    def test_previews_then_full_answer(self, plot, qtbot):
+        def cb(start, stop):
+            x = np.linspace(start, stop, 8)
+            yield 2, (x, np.zeros_like(x))
+            x = np.linspace(start, stop, 1000)
+            return x, np.sin(x)
+
+        g = plot.line(cb)
+        g.set_range(SciQLopPlotRange(0.0, 10.0))
+        qtbot.waitUntil(lambda: np.asarray(g.data()[0]).size == 1000, timeout=5000)
+        for _ in range(10):
+            QApplication.processEvents()
+        assert g.data_level() == 0
+        assert np.asarray(g.data()[0]).size == 1000
+
+    def test_bare_yields_are_coarse_previews(self, plot, qtbot):
+        def cb(start, stop):
+            x = np.linspace(start, stop, 8)
+            yield x, np.zeros_like(x)
+            x = np.linspace(start, stop, 64)
+            yield 0, (x, np.cos(x))
+
+        g = plot.line(cb)
+        g.set_range(SciQLopPlotRange(0.0, 10.0))
+        qtbot.waitUntil(lambda: np.asarray(g.data()[0]).size == 64, timeout=5000)
+        assert g.data_level() == 0
+
+
+class TestRemotePreview:
+    def test_preview_keeps_graph_busy_until_full_answer(self, plot, qtbot):
+        g = plot.add_remote_line_graph(["B"])
+        QApplication.processEvents()
+        ch = g.remote_channel()
+        pending = {}
+        ch.data_requested.connect(lambda r: pending.setdefault("r", r))
+        levels = []
+        ch.new_data_level.connect(levels.append)
+
+        plot.x_axis().set_range(SciQLopPlotRange(10.0, 20.0))
+        qtbot.waitUntil(lambda: "r" in pending, timeout=2000)
+        coarse = np.linspace(10.0, 20.0, 4)
+        ch.set_preview(coarse, coarse, 1)
+        qtbot.waitUntil(lambda: 1 in levels, timeout=2000)
+        for _ in range(10):
+            QApplication.processEvents()
+        assert g.busy() is True
+        assert g.data_level() == 1
+
+        fine = np.linspace(10.0, 20.0, 100)
+        ch.set_data(fine, fine)
+        qtbot.waitUntil(lambda: g.busy() is False, timeout=2000)
+        assert g.data_level() == 0
+        assert np.asarray(g.data()[0]).size == 100
+
+    def test_late_preview_does_not_replace_full_answer(self, plot, qtbot):
+        g = plot.add_remote_line_graph(["B"])
+        QApplication.processEvents()
+        ch = g.remote_channel()
+        pending = {}
+        ch.data_requested.connect(lambda r: pending.setdefault("r", r))
+
+        plot.x_axis().set_range(SciQLopPlotRange(10.0, 20.0))
+        qtbot.waitUntil(lambda: "r" in pending, timeout=2000)
+        fine = np.linspace(10.0, 20.0, 100)
+        ch.set_data(fine, fine)
+        qtbot.waitUntil(lambda: g.busy() is False, timeout=2000)
+        coarse = np.linspace(10.0, 20.0, 4)
+        ch.set_preview(coarse, coarse, 1)
+        qtbot.wait(100)
+        assert np.asarray(g.data()[0]).size == 100
+        assert g.data_level() == 0
@@ -0,0 +1,81 @@
+"""Approximate percentile autoscale from per-block quantile sketches.
+
+Past a few million visible values, colormap z and value-axis percentile
+autoscale merge weighted samples of per-time-block sketches (built once per
+data set on a worker thread) instead of gathering every value. The cutoffs
+must stay within the configured rank error of the exact ones, and an error
+bound of 0 must give the exact answer.
+"""
+import numpy as np
+
+from SciQLopPlots import SciQLopPlotRange
+from conftest import settle
+
+TOLERANCE = 2e-3
+
+
+def _rank(sorted_values, v):
+    return np.searchsorted(sorted_values, v) / sorted_values.size
+
+
+class TestColorMapSketch:
+    def _colormap(self, plot):
+        nx, ny = 40_000, 128
+        x = np.arange(nx, dtype=np.float64)
+        y = np.arange(ny, dtype=np.float64)
+        z = np.random.default_rng(0).lognormal(0.0, 2.0, (nx, ny)).astype(np.float32)
+        cmap = plot.colormap(x, y, z)
+        return cmap, x, y, z
+
+    def test_error_setter_clamps(self, plot):
+        cmap, *_ = self._colormap(plot)
+        assert cmap.autoscale_percentile_error() == 1e-3
+        cmap.set_autoscale_percentile_error(-1.0)
+        assert cmap.autoscale_percentile_error() == 0.0
+        cmap.set_autoscale_percentile_error(float("nan"))
+        assert cmap.autoscale_percentile_error() == 0.0
+
+    def test_sketched_cutoffs_within_rank_error(self, plot, qtbot):
+        cmap, x, y, z = self._colormap(plot)
+        xr = SciQLopPlotRange(x[1234], x[-1])
+        yr = SciQLopPlotRange(y[0], y[-1])
+        cmap.z_percentile_range(xr, yr, 1.0, 99.0)  # schedules the sketch
+        assert cmap.lod_pending()
+        settle(qtbot, cmap)
+        r = cmap.z_percentile_range(xr, yr, 1.0, 99.0)
+        visible = np.sort(z[1234:].ravel().astype(np.float64))
+        assert abs(_rank(visible, r.start()) - 0.01) <= TOLERANCE
+        assert abs(_rank(visible, r.stop()) - 0.99) <= TOLERANCE
+
+    def test_zero_error_is_exact(self, plot, qtbot):
+        cmap, x, y, z = self._colormap(plot)
+        cmap.set_autoscale_percentile_error(0.0)
+        xr = SciQLopPlotRange(x[0], x[-1])
+        yr = SciQLopPlotRange(y[0], y[-1])
+        cmap.z_percentile_range(xr, yr, 1.0, 99.0)
+        settle(qtbot, cmap)
+        r = cmap.z_percentile_range(xr, yr, 1.0, 99.0)
+        visible = np.sort(z.ravel().astype(np.float64))
+        n = visible.size
+        assert r.start() == visible[int(round(0.01 * (n - 1)))]
+        assert r.stop() == visible[int(round(0.99 * (n - 1)))]
+
+
+class TestValueAxisSketch:
+    def test_sketched_cutoffs_within_rank_error(self, plot, qtbot):
+        plot.show()
+        n = 3_000_000
+        x = np.arange(n, dtype=np.float64)
+        y = np.random.default_rng(1).standard_normal(n)
+        g = plot.line(x, y)
+        plot.x_axis().set_range(SciQLopPlotRange(0.0, float(n - 1)))
+        ax = plot.y_axis()
+        ax.set_autoscale_percentile_low(1.0)
+        ax.set_autoscale_percentile_high(99.0)
+        ax.rescale()  # schedules the sketch
+        settle(qtbot, g)
+        ax.rescale()
+        r = ax.range()
+        s = np.sort(y)
+        assert abs(_rank(s, r.start()) - 0.01) <= TOLERANCE
+        assert abs(_rank(s, r.stop()) - 0.99) <= TOLERANCE
@@ -0,0 +1,163 @@
+"""Range tile cache of callable-backed graphs (DataProviderInterface).
+
+With a byte budget set, a pan only calls the Python callable for the part of
+the new range that was not fetched yet; the rest is stitched from the tiles
+kept from previous calls. invalidate_cache() drops the tiles.
+"""
+import numpy as np
+import pytest
+from conftest import process_events
+
+
+def _wait_calls(calls_list, target, qtbot, timeout=2000):
+    def done():
+        assert len(calls_list) >= target
+    qtbot.waitUntil(done, timeout=timeout)
+
+
+def _source(calls):
+    def cb(start, stop):
+        calls.append((start, stop))
+        x = np.arange(np.ceil(start * 10), np.floor(stop * 10) + 1) / 10.0
+        return x, np.column_stack([np.sin(x), np.cos(x)])
+    return cb
+
+
+def _wait_data(g, qtbot, lower, upper):
+    def done():
+        x = np.asarray(g.data()[0])
+        assert x.size and x[0] <= lower + 0.1 and x[-1] >= upper - 0.1
+    qtbot.waitUntil(done, timeout=2000)
+
+
+class TestRangeTileCache:
+    def test_disabled_by_default(self, plot):
+        g = plot.line(_source([]))
+        assert g.cache_budget() == 0
+
+    def test_pan_fetches_only_the_new_part(self, plot, qtbot):
+        from SciQLopPlots import SciQLopPlotRange
+        calls = []
+        g = plot.line(_source(calls))
+        g.set_cache_budget(64 << 20)
+        assert g.cache_budget() == 64 << 20
+
+        g.set_range(SciQLopPlotRange(0.0, 100.0))
+        _wait_data(g, qtbot, 0.0, 100.0)
+        n_before = len(calls)
+
+        g.set_range(SciQLopPlotRange(20.0, 120.0))
+        _wait_data(g, qtbot, 20.0, 120.0)
+        assert calls[n_before:] == [(100.0, 120.0)]
+
+        x = np.asarray(g.data()[0])
+        y = np.asarray(g.data()[1])
+        inside = (x >= 20.0) & (x <= 120.0)
+        expected = np.arange(200, 1201) / 10.0
+        np.testing.assert_array_equal(x[inside], expected)
+        np.testing.assert_array_equal(y[inside, 0], np.sin(expected))
+        assert np.all(np.diff(x) > 0), "shared tile boundary duplicated"
+
+    def test_covered_range_needs_no_call(self, plot, qtbot):
+        from SciQLopPlots import SciQLopPlotRange
+        calls = []
+        g = plot.line(_source(calls))
+        g.set_cache_budget(64 << 20)
+        g.set_range(SciQLopPlotRange(0.0, 100.0))
+        _wait_data(g, qtbot, 0.0, 100.0)
+        n_before = len(calls)
+
+        g.set_range(SciQLopPlotRange(10.0, 50.0))
+        qtbot.waitUntil(lambda: np.asarray(g.data()[0])[-1] <= 50.1, timeout=2000)
+        for _ in range(10):
+            process_events()
+        assert len(calls) == n_before
+
+    def test_invalidate_drops_tiles(self, plot, qtbot):
+        from SciQLopPlots import SciQLopPlotRange
+        calls = []
+        g = plot.line(_source(calls))
+        g.set_cache_budget(64 << 20)
+        g.set_range(SciQLopPlotRange(0.0, 100.0))
+        _wait_data(g, qtbot, 0.0, 100.0)
+        n_before = len(calls)
+
+        g.invalidate_cache()
+        g.set_range(SciQLopPlotRange(10.0, 50.0))
+        _wait_calls(calls, n_before + 1, qtbot)
+        assert calls[-1] == (10.0, 50.0)
+
+    def test_unsorted_keys_fall_back_to_whole_fetch(self, plot, qtbot):
+        from SciQLopPlots import SciQLopPlotRange
+        calls = []
+
+        def cb(start, stop):
+            calls.append((start, stop))
+            x = np.linspace(stop, start, 50)
+            return x, np.sin(x)
+
+        g = plot.line(cb)
+        g.set_cache_budget(64 << 20)
+        g.set_range(SciQLopPlotRange(0.0, 100.0))
+        qtbot.waitUntil(lambda: (0.0, 100.0) in calls, timeout=2000)
+        n_before = len(calls)
+        g.set_range(SciQLopPlotRange(20.0, 120.0))
+        _wait_calls(calls, n_before + 1, qtbot)
+        for _ in range(10):
+            process_events()
+        # The cache turned itself off: one whole-range call, no gap call.
+        assert calls[n_before:] == [(20.0, 120.0)]
+
+
+class TestPrefetch:
+    def test_disabled_by_default(self, plot):
+        g = plot.line(_source([]))
+        assert not g.prefetch_enabled()
+
+    def test_pan_into_prefetched_neighbour_needs_no_call(self, plot, qtbot):
+        from SciQLopPlots import SciQLopPlotRange
+        calls = []
+        g = plot.line(_source(calls))
+        g.set_cache_budget(64 << 20)
+        g.set_prefetch_enabled(True)
+        assert g.prefetch_enabled()
+
+        g.set_range(SciQLopPlotRange(0.0, 100.0))
+        # Served range, then the neighbourhood: up to 100 on either side.
+        qtbot.waitUntil(lambda: max(stop for _, stop in calls) >= 200.0
+                        and min(start for start, _ in calls) <= -100.0, timeout=3000)
+        for _ in range(10):
+            process_events()
+        n_before = len(calls)
+
+        g.set_range(SciQLopPlotRange(60.0, 160.0))
+        _wait_data(g, qtbot, 60.0, 160.0)
+        x = np.asarray(g.data()[0])
+        inside = (x >= 60.0) & (x <= 160.0)
+        np.testing.assert_array_equal(x[inside], np.arange(600, 1601) / 10.0)
+        # Every call after the pan is prefetch for the new neighbourhood,
+        # entirely outside the range that was just shown.
+        assert all(stop <= 60.0 or start >= 160.0 for start, stop in calls[n_before:])
+
+    def test_prefetch_under_tight_budget_keeps_the_view(self, plot, qtbot):
+        from SciQLopPlots import SciQLopPlotRange
+        calls = []
+        g = plot.line(_source(calls))
+        # Room for the shown tile (1001 rows x 3 doubles) and not much more:
+        # the neighbourhood fetched after it must be evicted first.
+        g.set_cache_budget(30_000)
+        g.set_prefetch_enabled(True)
+
+        g.set_range(SciQLopPlotRange(0.0, 100.0))
+        _wait_data(g, qtbot, 0.0, 100.0)
+        qtbot.waitUntil(lambda: max(stop for _, stop in calls) >= 200.0
+                        and min(start for start, _ in calls) <= -100.0, timeout=3000)
+        for _ in range(10):
+            process_events()
+        n_before = len(calls)
+
+        g.set_range(SciQLopPlotRange(10.0, 90.0))
+        qtbot.waitUntil(lambda: np.asarray(g.data()[0])[-1] <= 90.1, timeout=2000)
+        for _ in range(10):
+            process_events()
+        assert all(stop <= 10.0 or start >= 90.0 for start, stop in calls[n_before:])
@@ -0,0 +1,92 @@
+"""Shared-memory ring transport for remote channels.
+
+A SharedMemoryRingWriter stands in for the remote worker process: frames it
+writes are read in place by the channel it is attached to (no copy on the
+plotting side) and reach the graph like set_data would bring them.
+"""
+import os
+import sys
+
+import numpy as np
+import pytest
+from PySide6.QtWidgets import QApplication
+
+from SciQLopPlots import SciQLopPlotRange, SharedMemoryRingWriter
+
+pytestmark = pytest.mark.skipif(sys.platform == "win32",
+                                reason="POSIX shared memory only")
+
+
+def _ring(slots=4, slot_bytes=1 << 16):
+    writer = SharedMemoryRingWriter(f"sqp_test_{os.getpid()}_{id(object())}", slots, slot_bytes)
+    assert writer.is_open()
+    return writer
+
+
+def _channel(plot):
+    g = plot.add_remote_line_graph(["B"])
+    QApplication.processEvents()
+    return g, g.remote_channel()
+
+
+def test_frames_reach_the_graph(qtbot, plot):
+    g, ch = _channel(plot)
+    writer = _ring()
+    assert ch.attach_shared_memory(writer.name())
+    got = []
+    ch.new_data_2d.connect(lambda a, b: got.append((np.asarray(a).copy(), np.asarray(b).copy())))
+
+    x = np.linspace(10.0, 20.0, 100)
+    assert writer.write([x, np.sin(x)])
+    assert ch.consume_shared_memory() == 1
+    qtbot.waitUntil(lambda: len(got) > 0, timeout=2000)
+    assert np.allclose(got[-1][0], x)
+    assert np.allclose(got[-1][1], np.sin(x))
+    assert ch.consume_shared_memory() == 0
+
+
+def test_polling_consumes_without_calls(qtbot, plot):
+    g, ch = _channel(plot)
+    writer = _ring()
+    assert ch.attach_shared_memory(writer.name(), 5)
+    got = []
+    ch.new_data_2d.connect(lambda a, b: got.append(np.asarray(a).size))
+    x = np.arange(42.0)
+    assert writer.write([x, x])
+    qtbot.waitUntil(lambda: 42 in got, timeout=2000)
+
+
+def test_slots_are_reused(qtbot, plot):
+    g, ch = _channel(plot)
+    writer = _ring(slots=2)
+    assert ch.attach_shared_memory(writer.name())
+    got = []
+    ch.new_data_2d.connect(lambda a, b: got.append(float(np.asarray(a)[0])))
+    for i in range(20):
+        x = np.full(16, float(i))
+        assert writer.write([x, x])
+        ch.consume_shared_memory()
+        qtbot.waitUntil(lambda: got and got[-1] == float(i), timeout=2000)
+    assert writer.frames_written() == 20
+
+
+def test_unread_frames_are_overwritten_oldest_first(plot):
+    g, ch = _channel(plot)
+    writer = _ring(slots=2)
+    assert ch.attach_shared_memory(writer.name())
+    for i in range(5):
+        x = np.full(4, float(i))
+        assert writer.write([x, x])
+    assert writer.frames_dropped() == 3
+
+
+def test_oversized_frame_is_rejected():
+    writer = _ring(slots=2, slot_bytes=64)
+    x = np.zeros(1000)
+    assert not writer.write([x, x])
+
+
+def test_attach_to_missing_segment_fails(plot):
+    g, ch = _channel(plot)
+    assert not ch.attach_shared_memory(f"sqp_missing_{os.getpid()}")
+    assert not ch.shared_memory_attached()
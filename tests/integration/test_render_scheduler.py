@@ -0,0 +1,79 @@
+"""Panel RenderScheduler: queued replots of a panel's plots are deferred to one
+place, plots scrolled out of the viewport stay dirty until they come back into
+view, and hidden panels (exports, headless use) are never culled."""
+from SciQLopPlots import SciQLopMultiPlotPanel, SciQLopPlotRange
+
+N_PLOTS = 20
+
+
+def _tall_panel(qtbot, shown=True):
+    panel = SciQLopMultiPlotPanel(synchronize_x=True)
+    qtbot.addWidget(panel)
+    for _ in range(N_PLOTS):
+        panel.create_plot().setMinimumHeight(150)
+    panel.resize(600, 400)
+    if shown:
+        panel.show()
+        qtbot.waitExposed(panel)
+    qtbot.wait(50)
+    return panel
+
+
+def _scheduler(panel):
+    scheduler = panel.behavior("RenderScheduler")
+    assert scheduler is not None
+    return scheduler
+
+
+class TestRenderScheduler:
+
+    def test_panel_has_a_scheduler(self, qtbot):
+        panel = _tall_panel(qtbot, shown=False)
+        assert _scheduler(panel).frame_budget() > 0
+
+    def test_offscreen_plots_are_deferred(self, qtbot):
+        panel = _tall_panel(qtbot)
+        scheduler = _scheduler(panel)
+        panel.replot(True)
+        # the first plots fill the viewport, the bottom ones are culled
+        pending = scheduler.pending_count()
+        assert 0 < pending < N_PLOTS
+
+        panel.verticalScrollBar().setValue(panel.verticalScrollBar().maximum())
+        qtbot.waitUntil(lambda: scheduler.pending_count() < pending, timeout=2000)
+
+    def test_synced_pan_does_not_render_offscreen_siblings(self, qtbot):
+        panel = _tall_panel(qtbot)
+        scheduler = _scheduler(panel)
+        qtbot.wait(50)
+        panel.set_x_axis_range(SciQLopPlotRange(10.0, 20.0))
+        qtbot.waitUntil(lambda: 0 < scheduler.pending_count() < N_PLOTS, timeout=2000)
+        qtbot.wait(50)
+        assert 0 < scheduler.pending_count() < N_PLOTS
+
+    def test_hidden_panel_is_not_culled(self, qtbot):
+        panel = _tall_panel(qtbot, shown=False)
+        scheduler = _scheduler(panel)
+        panel.replot(False)
+        qtbot.waitUntil(lambda: scheduler.pending_count() == 0, timeout=2000)
+
+    def test_frame_budget_is_clamped(self, qtbot):
+        panel = _tall_panel(qtbot, shown=False)
+        scheduler = _scheduler(panel)
+        scheduler.set_frame_budget(0)
+        assert scheduler.frame_budget() == 1
+
+    def test_removed_scheduler_releases_its_plots(self, qtbot):
+        panel = _tall_panel(qtbot)
+        _scheduler(panel)
+        plots = [panel.plot_at(i) for i in range(N_PLOTS)]
+        panel.replot(True)
+        assert any(p.render_pending() for p in plots)
+
+        panel.remove_behavior("RenderScheduler")
+        assert panel.behavior("RenderScheduler") is None
+        # dirty plots went back to QCustomPlot's own queue
+        assert not any(p.render_pending() for p in plots)
+        # and queued replots are no longer held for a scheduler
+        plots[-1].replot(False)
+        assert not plots[-1].render_pending()
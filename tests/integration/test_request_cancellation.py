@@ -0,0 +1,121 @@
+"""Cancellation of obsolete data requests and adaptive rate limiting.
+
+A callable that takes a ``cancellation_token`` argument receives a function
+returning True once its answer is no longer wanted (the user moved to another
+range); its answer is then dropped. Remote channels emit request_cancelled for
+a request superseded before it was answered.
+"""
+import time
+
+import numpy as np
+import pytest
+from PySide6.QtWidgets import QApplication
+
+from SciQLopPlots import SciQLopPlotRange
+
+
+def _wait_data(g, qtbot, lower, upper):
+    def done():
+        x = np.asarray(g.data()[0])
+        assert x.size and x[0] == lower and x[-1] == upper
+    qtbot.waitUntil(done, timeout=5000)
+
+
+class TestCancellationToken:
+    def test_superseded_call_is_cancelled(self, plot, qtbot):
+        events = []
+
+        def cb(start, stop, cancellation_token):
+            events.append(("start", start))
+            if start == 100.0:
+                deadline = time.monotonic() + 5.0
+                while not cancellation_token() and time.monotonic() < deadline:
+                    time.sleep(0.005)
+                events.append(("cancelled" if cancellation_token() else "timeout", start))
+            x = np.linspace(start, stop, 32)
+            return x, np.sin(x)
+
+        g = plot.line(cb)
+        g.set_range(SciQLopPlotRange(100.0, 110.0))
+        qtbot.waitUntil(lambda: ("start", 100.0) in events, timeout=3000)
+        g.set_range(SciQLopPlotRange(200.0, 210.0))
+        _wait_data(g, qtbot, 200.0, 210.0)
+        assert ("cancelled", 100.0) in events
+        for _ in range(10):
+            QApplication.processEvents()
+        # The cancelled answer never reached the graph.
+        assert np.asarray(g.data()[0])[0] == 200.0
+
+    def test_overlapping_request_keeps_running_call(self, plot, qtbot):
+        events = []
+
+        def cb(start, stop, cancellation_token):
+            if start == 100.0:
+                time.sleep(0.3)
+                events.append(("cancelled" if cancellation_token() else "done", start))
+            x = np.linspace(start, stop, 32)
+            return x, np.sin(x)
+
+        g = plot.line(cb)
+        g.set_range(SciQLopPlotRange(100.0, 110.0))
+        time.sleep(0.1)
+        # a scrub step: the running answer still covers most of the new range
+        g.set_range(SciQLopPlotRange(101.0, 111.0))
+        qtbot.waitUntil(lambda: len(events) > 0, timeout=3000)
+        assert events == [("done", 100.0)]
+        _wait_data(g, qtbot, 101.0, 111.0)
+
+    def test_callable_without_token_still_served(self, plot, qtbot):
+        def cb(start, stop):
+            x = np.linspace(start, stop, 32)
+            return x, np.sin(x)
+
+        g = plot.line(cb)
+        g.set_range(SciQLopPlotRange(0.0, 10.0))
+        _wait_data(g, qtbot, 0.0, 10.0)
+
+
+class TestRemoteCancellation:
+    def test_superseded_request_emits_request_cancelled(self, plot, qtbot):
+        g = plot.add_remote_line_graph(["B"])
+        QApplication.processEvents()
+        ch = g.remote_channel()
+        requested, cancelled = [], []
+        ch.data_requested.connect(lambda r: requested.append((r.start(), r.stop())))
+        ch.request_cancelled.connect(lambda r: cancelled.append((r.start(), r.stop())))
+
+        plot.x_axis().set_range(SciQLopPlotRange(10.0, 20.0))
+        qtbot.waitUntil(lambda: (10.0, 20.0) in requested, timeout=2000)
+        plot.x_axis().set_range(SciQLopPlotRange(30.0, 40.0))
+        qtbot.waitUntil(lambda: (30.0, 40.0) in requested, timeout=2000)
+        assert (10.0, 20.0) in cancelled
+        assert (30.0, 40.0) not in cancelled
+
+    def test_answered_request_is_not_cancelled(self, plot, qtbot):
+        g = plot.add_remote_line_graph(["B"])
+        QApplication.processEvents()
+        ch = g.remote_channel()
+        cancelled = []
+        x = np.linspace(10.0, 20.0, 10)
+        ch.data_requested.connect(lambda r: ch.set_data(x, np.sin(x)))
+        ch.request_cancelled.connect(lambda r: cancelled.append((r.start(), r.stop())))
+        got = []
+        ch.new_data_2d.connect(lambda *b: got.append(b))
+
+        plot.x_axis().set_range(SciQLopPlotRange(10.0, 20.0))
+        qtbot.waitUntil(lambda: len(got) > 0, timeout=2000)
+        plot.x_axis().set_range(SciQLopPlotRange(30.0, 40.0))
+        qtbot.wait(100)
+        assert (10.0, 20.0) not in cancelled
+
+
+class TestAdaptiveRateLimit:
+    def test_on_by_default_and_settable(self, plot):
+        g = plot.line(lambda start, stop: (np.zeros(2), np.zeros(2)))
+        assert g.adaptive_rate_limit()
+        g.set_adaptive_rate_limit(False)
+        assert not g.adaptive_rate_limit()
+
+    def test_static_graph_has_no_rate_limit(self, plot):
+        g = plot.line(np.arange(4.0), np.arange(4.0))
+        assert not g.adaptive_rate_limit()
@@ -5,6 +5,9 @@ Run with: python tests/perf/bench_dsp.py
 Uses has_gaps=False to bypass gap detection overhead for fair comparison
 of pure computation speed against numpy/scipy.
 """
+import resource
+import subprocess
+import sys
 import time
 import numpy as np
 from scipy import signal as sp_signal
@@ -19,9 +22,17 @@ from SciQLopPlots.dsp import (
     sosfiltfilt,
     fft,
     spectrogram,
+    welch,
+    multitaper,
+    csd,
+    coherence,
     rolling_mean,
     rolling_std,
     reduce,
+    reduce_axes,
+    pipeline,
+    clear_fft_cache,
+    fft_cache_stats,
 )
 
 
@@ -252,8 +263,206 @@ def run_multicol_benchmarks():
         print(f"{name:<25} {tag:>6} {cpp_t*1000:>10.3f} {py_t*1000:>12.3f} {speedup:>7.1f}x")
 
 
+def run_particle_benchmarks():
+    """Benchmark 32x16x8 particle distributions: one segment, 4096 columns."""
+    shape = (32, 16, 8)
+    results = []
+    for n in [1_000, 10_000]:
+        tag = f"{n//1000}k"
+        t = np.arange(n, dtype=np.float64)
+        y = np.random.default_rng(42).normal(size=(n, int(np.prod(shape))))
+        cube = y.reshape(n, *shape)
+
+        cpp_time = bench(reduce_axes, t, y, shape, (1, 2), op='sum')
+        py_time = bench(cube.sum, axis=(2, 3))
+        results.append(("reduce_axes_energy", tag, cpp_time, py_time))
+
+        cpp_time = bench(rolling_mean, t, y, 11, **NO_GAPS)
+        py_time = bench(pd.DataFrame(y).rolling(11, center=True, min_periods=1).mean)
+        results.append(("rolling_mean_4096col", tag, cpp_time, py_time))
+
+    print(f"\n{'Function':<25} {'Size':>6} {'C++ (ms)':>10} {'Python (ms)':>12} {'Speedup':>8}")
+    print("-" * 65)
+    for name, tag, cpp_t, py_t in results:
+        speedup = py_t / cpp_t if cpp_t > 0 else float('inf')
+        print(f"{name:<25} {tag:>6} {cpp_t*1000:>10.3f} {py_t*1000:>12.3f} {speedup:>7.1f}x")
+
+
+def run_fir_crossover_benchmarks():
+    """Direct vs overlap-add FIR by tap count: sets Filter.hpp fir_fft_min_taps."""
+    n = 1_000_000
+    t, y, fs = make_signal(n, fs=100.0)
+    print(f"\n{'Taps':>6} {'direct (ms)':>12} {'fft (ms)':>10} {'scipy (ms)':>11} "
+          f"{'speedup':>11} {'max |diff|':>11}")
+    print("-" * 66)
+    for n_taps in [16, 32, 48, 64, 96, 128, 192, 256, 512, 1001, 4001]:
+        coeffs = sp_signal.firwin(n_taps, 10.0, fs=fs)
+        rounds = 3 if n_taps > 1000 else 10
+        direct_t = bench(fir_filter, t, y, coeffs, method='direct', rounds=rounds, **NO_GAPS)
+        fft_t = bench(fir_filter, t, y, coeffs, method='fft', rounds=rounds, **NO_GAPS)
+        scipy_t = bench(sp_signal.oaconvolve, y, coeffs, rounds=rounds)
+        diff = np.abs(fir_filter(t, y, coeffs, method='fft', **NO_GAPS)[1]
+                      - fir_filter(t, y, coeffs, method='direct', **NO_GAPS)[1]).max()
+        print(f"{n_taps:>6} {direct_t*1000:>12.2f} {fft_t*1000:>10.2f} {scipy_t*1000:>11.2f} "
+              f"{direct_t/fft_t:>10.1f}x {diff:>11.2e}")
+
+
+def run_dense_spectrogram_benchmarks():
+    """Dense spectrograms of 128 Hz search-coil-like data (one day = 11M samples)."""
+    fs = 128.0
+    print(f"\n{'Data':<8} {'Window':>7} {'Overlap':>8} {'C++ (ms)':>10} {'scipy (ms)':>11} "
+          f"{'Speedup':>8} {'Mwin/s':>7}")
+    print("-" * 65)
+    for hours in [1, 24]:
+        n = int(hours * 3600 * fs)
+        t = np.arange(n, dtype=np.float64) / fs
+        y = np.random.default_rng(8).normal(size=n)
+        for window_size, overlap in [(256, 128), (256, 224), (1024, 896)]:
+            rounds = 3 if hours > 1 else 10
+            cpp_time = bench(spectrogram, t, y, 0, window_size, overlap, rounds=rounds,
+                             **NO_GAPS)
+            py_time = bench(sp_signal.spectrogram, y, fs=fs, nperseg=window_size,
+                            noverlap=overlap, rounds=rounds)
+            n_windows = (n - window_size) // (window_size - overlap) + 1
+            print(f"{hours:>3} h    {window_size:>7} {overlap:>8} {cpp_time*1000:>10.1f} "
+                  f"{py_time*1000:>11.1f} {py_time/cpp_time:>7.1f}x "
+                  f"{n_windows/cpp_time/1e6:>7.2f}")
+
+
+def _scipy_multitaper(y, fs, nperseg, nw, k):
+    """Reference multitaper PSD from scipy's DPSS and numpy's rfft (scipy has no estimator)."""
+    tapers = sp_signal.windows.dpss(nperseg, nw, k)
+    hop = nperseg // 2
+    frames = np.lib.stride_tricks.sliding_window_view(y, nperseg)[::hop]
+    frames = frames - frames.mean(axis=1, keepdims=True)
+    acc = np.zeros(nperseg // 2 + 1)
+    for taper in tapers:
+        acc += (np.abs(np.fft.rfft(frames * taper, axis=1)) ** 2).sum(axis=0)
+    psd = acc / (fs * k * len(frames))
+    psd[1:-1] *= 2
+    return psd
+
+
+def run_averaged_spectra_benchmarks():
+    """Welch, multitaper, CSD and coherence of 3-axis 128 Hz data vs scipy."""
+    fs = 128.0
+    window_size = 1024
+    w = sp_signal.get_window("hann", window_size, fftbins=False)
+    print(f"\n{'Estimator':<12} {'Size':>5} {'C++ (ms)':>10} {'scipy (ms)':>11} {'Speedup':>8}")
+    print("-" * 50)
+    for n in [1_000_000, 10_000_000]:
+        t = np.arange(n, dtype=np.float64) / fs
+        y = np.random.default_rng(9).normal(size=(n, 3))
+        x0, x1 = y[:, 0].copy(), y[:, 1].copy()
+        rounds = 3 if n > 1_000_000 else 10
+        cases = [
+            ("welch", (welch, (t, y), dict(window_size=window_size)),
+             (sp_signal.welch, (y,), dict(fs=fs, window=w, axis=0))),
+            ("multitaper", (multitaper, (t, x0), dict(window_size=window_size, nw=4.0)),
+             (_scipy_multitaper, (x0, fs, window_size, 4.0, 7), {})),
+            ("csd", (csd, (t, y), dict(window_size=window_size)),
+             (sp_signal.csd, (x0, x1), dict(fs=fs, window=w))),
+            ("coherence", (coherence, (t, y), dict(window_size=window_size)),
+             (sp_signal.coherence, (x0, x1), dict(fs=fs, window=w))),
+        ]
+        for name, (fn, args, kwargs), (ref, ref_args, ref_kwargs) in cases:
+            cpp_time = bench(fn, *args, rounds=rounds, **kwargs, **NO_GAPS)
+            py_time = bench(ref, *ref_args, rounds=rounds, **ref_kwargs)
+            print(f"{name:<12} {n//1_000_000:>4}M {cpp_time*1000:>10.1f} {py_time*1000:>11.1f} "
+                  f"{py_time/cpp_time:>7.1f}x")
+
+
+def _cold(fn):
+    """fn with the FFT plan/window cache emptied before each call."""
+    def call(*args, **kwargs):
+        clear_fft_cache()
+        return fn(*args, **kwargs)
+    return call
+
+
+def run_fft_cache_benchmarks():
+    """Per-call latency of small transforms with a cold vs warm plan/window cache.
+
+    Models a spectrogram panel redrawing while panning: the same window size
+    and type are requested over and over on short slices.
+    """
+    print(f"\n{'Call':<24} {'Window':>7} {'cold (us)':>10} {'warm (us)':>10} {'Speedup':>8}")
+    print("-" * 63)
+    for window_size in [64, 128, 256, 1024]:
+        t, y, _ = make_signal(8 * window_size)
+        cases = [
+            ("spectrogram", spectrogram, (t, y), dict(window_size=window_size, **NO_GAPS)),
+            ("fft", fft, (t[:window_size], y[:window_size]), NO_GAPS),
+        ]
+        for name, fn, args, kwargs in cases:
+            cold_t = bench(_cold(fn), *args, rounds=200, **kwargs)
+            warm_t = bench(fn, *args, rounds=200, **kwargs)
+            print(f"{name:<24} {window_size:>7} {cold_t*1e6:>10.1f} {warm_t*1e6:>10.1f} "
+                  f"{cold_t/warm_t:>7.1f}x")
+    stats = fft_cache_stats()
+    print(f"cache: {stats['hits']} hits, {stats['misses']} misses, {stats['entries']} entries")
+
+
+def pipeline_stages(chain, fs=1000.0):
+    sos = sp_signal.butter(4, 40.0, fs=fs, output='sos')
+    coeffs = sp_signal.firwin(65, 20.0, fs=fs)
+    if chain == "streamable":
+        # Every stage has a block kernel: the whole chain runs as one fused pass
+        return [("fir_filter", coeffs), ("iir_sos", sos), ("rolling_mean", 25),
+                ("rolling_std", 51)]
+    # sosfiltfilt and resample need whole segments and split the chain into fused runs
+    return [("interpolate_nan", 2), ("sosfiltfilt", sos), ("resample", 2.0 / fs),
+            ("fir_filter", coeffs), ("rolling_std", 51)]
+
+
+def _pipeline_worker(chain, n, fused):
+    """Runs in a fresh interpreter so ru_maxrss only reflects this configuration."""
+    t, y = make_3col(n)
+    y[::997] = np.nan
+    stages = pipeline_stages(chain)
+    base_rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    elapsed = bench(pipeline, t, y, stages, fused=fused, warmup=1, rounds=5)
+    peak_rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    print(f"{elapsed} {(peak_rss - base_rss) / 1024.0}")
+
+
+def run_pipeline_benchmarks():
+    """Fused vs stage-by-stage pipeline: throughput and peak RSS above the input arrays."""
+    sizes = [1_000_000, 10_000_000]
+    print(f"\n{'Chain':<11} {'Mode':<8} {'Size':>5} {'ms':>9} {'Msamples/s':>11} "
+          f"{'peak RSS (MiB)':>15}")
+    print("-" * 64)
+    for chain in ("streamable", "mixed"):
+        for n in sizes:
+            tag = f"{n//1_000_000}M"
+            for fused in (False, True):
+                out = subprocess.run(
+                    [sys.executable, __file__, "--pipeline-worker", chain, str(n),
+                     str(int(fused))],
+                    check=True, capture_output=True, text=True).stdout.split()
+                elapsed, rss = float(out[0]), float(out[1])
+                mode = "fused" if fused else "unfused"
+                print(f"{chain:<11} {mode:<8} {tag:>5} {elapsed*1000:>9.1f} "
+                      f"{n/elapsed/1e6:>11.1f} {rss:>15.1f}")
+
+
 if __name__ == "__main__":
+    if len(sys.argv) == 5 and sys.argv[1] == "--pipeline-worker":
+        _pipeline_worker(sys.argv[2], int(sys.argv[3]), bool(int(sys.argv[4])))
+        sys.exit(0)
     print("=== Single column ===")
     run_benchmarks()
     print("\n=== 3 columns (vector product) ===")
     run_multicol_benchmarks()
+    print("\n=== Particle distribution (32x16x8) ===")
+    run_particle_benchmarks()
+    print("\n=== FIR direct vs overlap-add (1M samples) ===")
+    run_fir_crossover_benchmarks()
+    print("\n=== Dense spectrogram (128 Hz) ===")
+    run_dense_spectrogram_benchmarks()
+    print("\n=== Averaged spectra (welch / multitaper / csd / coherence) ===")
+    run_averaged_spectra_benchmarks()
+    print("\n=== FFT plan/window cache (small windows) ===")
+    run_fft_cache_benchmarks()
+    print("\n=== Fused pipeline ===")
+    run_pipeline_benchmarks()
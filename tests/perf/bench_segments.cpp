@@ -10,12 +10,12 @@ class BenchSegments : public QObject
     Q_OBJECT
 
 private:
-    std::vector<double> make_timestamps(std::size_t n, int n_gaps, double gap_size = 100.0)
+    std::vector<double> make_timestamps(std::size_t n, int n_gaps, double gap_size = 100.0,
+        double t0 = 0.0, double dt = 0.001)
     {
-        const double dt = 0.001;
         std::vector<double> t(n);
         for (std::size_t i = 0; i < n; ++i)
-            t[i] = static_cast<double>(i) * dt;
+            t[i] = t0 + static_cast<double>(i) * dt;
 
         std::mt19937 rng(42);
         std::uniform_int_distribution<std::size_t> dist(100, n - 100);
@@ -31,6 +31,13 @@ private:
         return t;
     }
 
+    // 128 Hz samples on epoch-seconds timestamps, as a day of search-coil data
+    // is delivered: dt is only regular to a few ulps of t.
+    std::vector<double> make_epoch_timestamps(std::size_t n, int n_gaps)
+    {
+        return make_timestamps(n, n_gaps, 100.0, 1.6e9, 1.0 / 128.0);
+    }
+
 private slots:
     void compute_median_dt_1M()
     {
@@ -96,6 +103,40 @@ private slots:
                 { t.data(), t.size() }, { y.data(), y.size() }, 1, 3.0);
         }
     }
+
+    // 10^8-point time axes (800 MB each): cadence and gaps are found without
+    // an n-sized copy of the differences.
+    void compute_median_dt_100M()
+    {
+        auto t = make_timestamps(100'000'000, 0);
+        std::span<const double> ts { t.data(), t.size() };
+        QBENCHMARK { auto m = sqp::dsp::detail::compute_median_dt(ts); }
+    }
+
+    void compute_median_dt_100M_epoch()
+    {
+        auto t = make_epoch_timestamps(100'000'000, 0);
+        std::span<const double> ts { t.data(), t.size() };
+        QBENCHMARK { auto m = sqp::dsp::detail::compute_median_dt(ts); }
+    }
+
+    void find_gap_indices_100M_50_gaps_epoch()
+    {
+        auto t = make_epoch_timestamps(100'000'000, 50);
+        std::span<const double> ts { t.data(), t.size() };
+        QBENCHMARK { auto g = sqp::dsp::detail::find_gap_indices(ts, 3.0); }
+    }
+
+    void split_segments_100M_5_gaps()
+    {
+        auto t = make_timestamps(100'000'000, 5);
+        std::vector<double> y(t.size(), 1.0);
+        QBENCHMARK
+        {
+            auto s = sqp::dsp::split_segments<double>(
+                { t.data(), t.size() }, { y.data(), y.size() }, 1, 3.0);
+        }
+    }
 };
 
 QTEST_GUILESS_MAIN(BenchSegments)
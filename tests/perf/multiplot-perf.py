@@ -0,0 +1,353 @@
+#!/usr/bin/env python3
+"""
+Headless perf scenarios for SciQLopPlots multi-plot (line graph) hot paths.
+
+Exercises stacked, axis-synchronized line plots through the full
+Python -> C++ path.
+
+Usage: multiplot-perf.py <scenario> [iterations] [--no-barrier]
+
+Scenarios:
+  synced_pan       — interactive pan of one plot propagated to the whole stack
+                     (several input events per frame, frame-coalesced sync)
+  y_zoom           — change Y-axis range on every plot
+  full_replot      — full replot of the multi-plot panel
+  panel_setup      — create panel + line graphs + populate with data
+  callable_pan     — programmatic time pan with callable pipelines
+  tall_pan         — synchronized pan of a 60-plot panel scrolled to the middle
+                     (offscreen plots are culled by the render scheduler)
+"""
+
+import os
+import signal
+import sys
+import time
+
+import numpy as np
+from PySide6.QtWidgets import QApplication
+
+from SciQLopPlots import (
+    SciQLopMultiPlotPanel,
+    SciQLopPlotRange,
+    GraphType,
+    PlotType,
+)
+
+# ── Barrier ────────────────────────────────────────────────────
+
+USE_BARRIER = True
+
+
+def wait_for_profiler():
+    if not USE_BARRIER:
+        return
+    sys.stderr.write("  [ready — waiting for SIGCONT]\n")
+    sys.stderr.flush()
+    os.kill(os.getpid(), signal.SIGSTOP)
+
+
+# ── Data generation ────────────────────────────────────────────
+
+DEFAULT_N = 1_000_000
+DEFAULT_COMPONENTS = 3
+DEFAULT_PLOTS = 8
+# Input events delivered between two event-loop passes, e.g. a high resolution
+# wheel or a touchpad flick emitting several range changes per frame.
+EVENTS_PER_FRAME = 4
+TALL_PLOTS = 60
+TALL_PLOT_HEIGHT = 150
+
+
+def make_line_data(n=DEFAULT_N, components=DEFAULT_COMPONENTS):
+    x = np.linspace(0, 100, n, dtype=np.float64)
+    phases = np.arange(components, dtype=np.float64)[None, :]
+    y = np.sin(x[:, None] * 0.5 + phases) + 0.1 * np.cos(x[:, None] * 17.0)
+    return x, np.ascontiguousarray(y)
+
+
+def make_callable_line(n=DEFAULT_N, components=DEFAULT_COMPONENTS):
+    """Return a callable (start, stop) -> (x, y)."""
+
+    def provider(start, stop):
+        if stop <= start:
+            return None
+        count = max(int((stop - start) * (n / 100.0)), 2)
+        x = np.linspace(start, stop, count, dtype=np.float64)
+        phases = np.arange(components, dtype=np.float64)[None, :]
+        y = np.sin(x[:, None] * 0.5 + phases)
+        return x, np.ascontiguousarray(y)
+
+    provider.__name__ = "line_provider"
+    return provider
+
+
+# ── Panel setup ────────────────────────────────────────────────
+
+
+def setup_static_panel(n_plots=DEFAULT_PLOTS, n=DEFAULT_N):
+    panel = SciQLopMultiPlotPanel(synchronize_x=True)
+    panel.resize(1920, 1080)
+
+    for _ in range(n_plots):
+        x, y = make_line_data(n)
+        panel.plot(x, y)
+
+    panel.show()
+    QApplication.processEvents()
+
+    deadline = time.monotonic() + 5
+    while time.monotonic() < deadline:
+        QApplication.processEvents()
+        time.sleep(0.05)
+
+    for i in range(n_plots):
+        panel.plot_at(i).replot(True)
+    QApplication.processEvents()
+
+    return panel
+
+
+def setup_callable_panel(n_plots=DEFAULT_PLOTS):
+    panel = SciQLopMultiPlotPanel(synchronize_x=False, synchronize_time=True)
+    panel.resize(1920, 1080)
+
+    for _ in range(n_plots):
+        panel.plot(
+            make_callable_line(),
+            graph_type=GraphType.Line,
+            plot_type=PlotType.TimeSeries,
+        )
+
+    panel.show()
+    QApplication.processEvents()
+
+    deadline = time.monotonic() + 10
+    while time.monotonic() < deadline:
+        QApplication.processEvents()
+        time.sleep(0.05)
+
+    return panel
+
+
+# ── Timer helper ───────────────────────────────────────────────
+
+class PerfTimer:
+    def __init__(self):
+        self._start = None
+
+    def start(self):
+        self._start = time.perf_counter_ns()
+
+    def elapsed_ms(self):
+        return (time.perf_counter_ns() - self._start) / 1e6
+
+
+# ── Scenarios ──────────────────────────────────────────────────
+
+
+def scenario_synced_pan(iters):
+    """Pans the first plot the way mouse/wheel interaction does (its own axis,
+    several times per frame) and measures the latency until the last plot of
+    the stack shows the final range, plus how many propagations it took."""
+    panel = setup_static_panel()
+    source = panel.plot_at(0)
+    last = panel.plot_at(DEFAULT_PLOTS - 1)
+    r = source.x_axis().range()
+    pan_step = r.size() * 0.005 / EVENTS_PER_FRAME
+
+    propagations = [0]
+    last.x_axis().range_changed.connect(lambda _r: propagations.__setitem__(0, propagations[0] + 1))
+
+    sys.stderr.write(
+        f"synced_pan: {DEFAULT_PLOTS} plots × {DEFAULT_N}x{DEFAULT_COMPONENTS}, "
+        f"{EVENTS_PER_FRAME} events/frame, {iters} iters\n"
+    )
+    wait_for_profiler()
+
+    latencies = []
+    timer = PerfTimer()
+    timer.start()
+    current = r
+    for _ in range(iters):
+        t0 = time.perf_counter_ns()
+        for _ in range(EVENTS_PER_FRAME):
+            current = SciQLopPlotRange(current.start() + pan_step, current.stop() + pan_step)
+            source.x_axis().set_range(current)
+        while last.x_axis().range().start() != current.start():
+            QApplication.processEvents()
+        latencies.append((time.perf_counter_ns() - t0) / 1e6)
+    QApplication.processEvents()
+    ms = timer.elapsed_ms()
+    latencies.sort()
+    sys.stderr.write(
+        f"  total: {ms:.1f} ms, per-iter: {ms / iters:.1f} ms, "
+        f"latency p50: {latencies[len(latencies) // 2]:.2f} ms, "
+        f"p95: {latencies[int(len(latencies) * 0.95)]:.2f} ms, "
+        f"propagations: {propagations[0]} for {iters * EVENTS_PER_FRAME} events\n"
+    )
+    panel.close()
+    panel.deleteLater()
+
+
+def scenario_y_zoom(iters):
+    panel = setup_static_panel()
+
+    sys.stderr.write(
+        f"y_zoom: {DEFAULT_PLOTS} plots × {DEFAULT_N}x{DEFAULT_COMPONENTS}, {iters} iters\n"
+    )
+    wait_for_profiler()
+
+    timer = PerfTimer()
+    timer.start()
+    for i in range(iters):
+        yr = SciQLopPlotRange(-0.5, 0.5) if i % 2 == 0 else SciQLopPlotRange(-1.5, 1.5)
+        for p in range(DEFAULT_PLOTS):
+            plot = panel.plot_at(p)
+            plot.y_axis().set_range(yr)
+            plot.replot(True)
+    ms = timer.elapsed_ms()
+    sys.stderr.write(f"  total: {ms:.1f} ms, per-iter: {ms / iters:.1f} ms\n")
+    panel.close()
+    panel.deleteLater()
+
+
+def scenario_full_replot(iters):
+    panel = setup_static_panel()
+
+    sys.stderr.write(
+        f"full_replot: {DEFAULT_PLOTS} plots × {DEFAULT_N}x{DEFAULT_COMPONENTS}, {iters} iters\n"
+    )
+    wait_for_profiler()
+
+    timer = PerfTimer()
+    timer.start()
+    for _ in range(iters):
+        for p in range(DEFAULT_PLOTS):
+            panel.plot_at(p).replot(True)
+    ms = timer.elapsed_ms()
+    sys.stderr.write(f"  total: {ms:.1f} ms, per-iter: {ms / iters:.1f} ms\n")
+    panel.close()
+    panel.deleteLater()
+
+
+def scenario_panel_setup(iters):
+    sys.stderr.write(
+        f"panel_setup: {DEFAULT_PLOTS} plots × {DEFAULT_N}x{DEFAULT_COMPONENTS}, {iters} iters\n"
+    )
+    wait_for_profiler()
+
+    timer = PerfTimer()
+    timer.start()
+    for _ in range(iters):
+        panel = setup_static_panel()
+        panel.close()
+        panel.deleteLater()
+        QApplication.processEvents()
+    ms = timer.elapsed_ms()
+    sys.stderr.write(f"  total: {ms:.1f} ms, per-iter: {ms / iters:.1f} ms\n")
+
+
+def scenario_callable_pan(iters):
+    panel = setup_callable_panel()
+    r = panel.plot_at(0).x_axis().range()
+    pan_step = r.size() * 0.005
+
+    sys.stderr.write(
+        f"callable_pan: {DEFAULT_PLOTS} plots × {DEFAULT_COMPONENTS} components, "
+        f"step={pan_step:.4f}, {iters} iters\n"
+    )
+    wait_for_profiler()
+
+    timer = PerfTimer()
+    timer.start()
+    current = r
+    for _ in range(iters):
+        current = SciQLopPlotRange(current.start() + pan_step, current.stop() + pan_step)
+        panel.set_time_axis_range(current)
+        for p in range(DEFAULT_PLOTS):
+            panel.plot_at(p).replot(False)
+        QApplication.processEvents()
+    ms = timer.elapsed_ms()
+    sys.stderr.write(f"  total: {ms:.1f} ms, per-iter: {ms / iters:.1f} ms\n")
+    panel.close()
+    panel.deleteLater()
+
+
+def scenario_tall_pan(iters):
+    panel = SciQLopMultiPlotPanel(synchronize_x=True)
+    panel.resize(1920, 1080)
+    x, y = make_line_data(DEFAULT_N // 10)
+    for _ in range(TALL_PLOTS):
+        plot, _graph = panel.plot(x, y)
+        plot.setMinimumHeight(TALL_PLOT_HEIGHT)
+    panel.show()
+    QApplication.processEvents()
+    bar = panel.verticalScrollBar()
+    bar.setValue(bar.maximum() // 2)
+    deadline = time.monotonic() + 5
+    while time.monotonic() < deadline:
+        QApplication.processEvents()
+        time.sleep(0.05)
+
+    r = panel.plot_at(0).x_axis().range()
+    pan_step = r.size() * 0.005
+
+    sys.stderr.write(
+        f"tall_pan: {TALL_PLOTS} plots × {DEFAULT_N // 10}x{DEFAULT_COMPONENTS}, "
+        f"{TALL_PLOT_HEIGHT}px each, step={pan_step:.4f}, {iters} iters\n"
+    )
+    wait_for_profiler()
+
+    timer = PerfTimer()
+    timer.start()
+    current = r
+    for _ in range(iters):
+        current = SciQLopPlotRange(current.start() + pan_step, current.stop() + pan_step)
+        panel.set_x_axis_range(current)
+        QApplication.processEvents()
+    ms = timer.elapsed_ms()
+    sys.stderr.write(f"  total: {ms:.1f} ms, per-iter: {ms / iters:.1f} ms\n")
+    panel.close()
+    panel.deleteLater()
+
+
+# ── Main ───────────────────────────────────────────────────────
+
+SCENARIOS = {
+    "synced_pan":    (scenario_synced_pan,    100),
+    "y_zoom":        (scenario_y_zoom,         50),
+    "full_replot":   (scenario_full_replot,     20),
+    "panel_setup":   (scenario_panel_setup,      3),
+    "callable_pan":  (scenario_callable_pan,    50),
+    "tall_pan":      (scenario_tall_pan,       100),
+}
+
+
+def main():
+    global USE_BARRIER
+
+    args = [a for a in sys.argv[1:] if a != "--no-barrier"]
+    if len(args) != len(sys.argv[1:]):
+        USE_BARRIER = False
+
+    if not args:
+        print(f"Usage: {sys.argv[0]} [--no-barrier] <scenario> [iterations]", file=sys.stderr)
+        print("Scenarios:", file=sys.stderr)
+        for name, (_, default_iters) in SCENARIOS.items():
+            print(f"  {name:<18s} (default {default_iters} iters)", file=sys.stderr)
+        sys.exit(1)
+
+    name = args[0]
+    iters = int(args[1]) if len(args) >= 2 else None
+
+    if name not in SCENARIOS:
+        print(f"Unknown scenario: {name}", file=sys.stderr)
+        sys.exit(1)
+
+    fn, default_iters = SCENARIOS[name]
+    fn(iters if iters and iters > 0 else default_iters)
+
+
+if __name__ == "__main__":
+    app = QApplication(sys.argv)
+    main()
@@ -43,3 +43,16 @@ def wait_for_render(panel, timeout_s=10):
     for i in range(panel.plot_count()):
         panel.plot_at(i).replot(True)
     QApplication.processEvents()
+
+
+def settle(qtbot, *plottables, plot=None, timeout=60000):
+    """Wait until the background builds of `plottables` (LOD pyramids,
+    quantile sketches) for their current data have landed. With `plot`, it is
+    rendered first, so the view requests what it needs, and again once the
+    results are in."""
+    if plot is not None:
+        plot.replot(True)
+    qtbot.waitUntil(lambda: not any(p.lod_pending() for p in plottables), timeout=timeout)
+    QApplication.processEvents()
+    if plot is not None:
+        plot.replot(True)
@@ -38,7 +38,8 @@ RESULTS_DIR = SCRIPT_DIR / "results"
 BENCHMARKS = {
     "multiplot": {
         "script": SCRIPT_DIR / "multiplot-perf.py",
-        "scenarios": ["synced_pan", "y_zoom", "full_replot", "panel_setup", "callable_pan"],
+        "scenarios": ["synced_pan", "y_zoom", "full_replot", "panel_setup", "callable_pan",
+                      "tall_pan"],
     },
     "colormap": {
         "script": SCRIPT_DIR / "colormap-perf.py",
@@ -61,6 +62,13 @@ for bname, binfo in BENCHMARKS.items():
             # Ambiguous — require prefix
             SCENARIO_LOOKUP[s] = None
 
+# Unprefixed names kept usable despite being shared between benchmarks
+SCENARIO_ALIASES = {
+    "synced_pan": "multiplot/synced_pan",
+}
+for alias, target in SCENARIO_ALIASES.items():
+    SCENARIO_LOOKUP[alias] = SCENARIO_LOOKUP[target]
+
 # Legacy flat list for --all
 SCENARIOS = list(ALL_SCENARIOS)
 
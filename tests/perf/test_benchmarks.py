@@ -13,7 +13,7 @@ from PySide6.QtWidgets import QApplication
 
 from SciQLopPlots import SciQLopMultiPlotPanel, SciQLopPlotRange, PlotType
 
-from perfutils import N_PLOTS, N_COLS, COLORS, make_static_data, make_data, wait_for_render
+from perfutils import N_PLOTS, N_COLS, COLORS, make_static_data, make_data, settle, wait_for_render
 
 
 def test_synced_pan(static_panel, perf_check):
@@ -91,3 +91,362 @@ def test_callable_pan(callable_panel, perf_check):
             for p in range(N_PLOTS):
                 panel.plot_at(p).replot(False)
             QApplication.processEvents()
+
+
+def _scrub_graph(qtbot, adaptive):
+    """A line graph fed by a 40 ms callable that honours its cancellation
+    token."""
+    import time
+    import numpy as np
+    from SciQLopPlots import SciQLopPlot
+
+    def slow_source(start, stop, cancellation_token):
+        deadline = time.perf_counter() + 0.04
+        while time.perf_counter() < deadline:
+            if cancellation_token():
+                return None
+            time.sleep(0.002)
+        x = np.linspace(start, stop, 10_000)
+        return x, np.sin(x)
+
+    plot = SciQLopPlot()
+    qtbot.addWidget(plot)
+    graph = plot.line(slow_source)
+    graph.set_adaptive_rate_limit(adaptive)
+    return graph
+
+
+def _scrub_time_to_fresh_data(qtbot, adaptive, rounds=5, steps=30):
+    """Mean ms from the last range change of a scrub to the graph showing it."""
+    import time
+    import numpy as np
+
+    graph = _scrub_graph(qtbot, adaptive)
+    total_ms = 0.0
+    start = 0.0
+    for _ in range(rounds):
+        for _ in range(steps):
+            start += 1.0
+            graph.set_range(SciQLopPlotRange(start, start + 100.0))
+            qtbot.wait(16)
+        t0 = time.perf_counter()
+
+        def fresh():
+            x = np.asarray(graph.data()[0])
+            assert x.size and x[0] == start
+
+        qtbot.waitUntil(fresh, timeout=5000)
+        total_ms += (time.perf_counter() - t0) * 1e3
+        qtbot.wait(200)  # let the gesture end
+    return total_ms
+
+
+def test_scrub_time_to_fresh_data(qtbot, perf_check):
+    rounds = 5
+    perf_check("scrub_fresh_data", rounds).record(
+        _scrub_time_to_fresh_data(qtbot, adaptive=True, rounds=rounds))
+
+
+def test_scrub_time_to_fresh_data_fixed_rate(qtbot, perf_check):
+    rounds = 5
+    perf_check("scrub_fresh_data_fixed_rate", rounds).record(
+        _scrub_time_to_fresh_data(qtbot, adaptive=False, rounds=rounds))
+
+
+def _scrub_ms_per_frame(qtbot, rounds=5, steps=30):
+    """Scrub wall time per answer shown while the range keeps moving (each
+    range overlapping the previous one): lower means more frames delivered
+    during the gesture, infinite if every call got cancelled."""
+    import time
+
+    graph = _scrub_graph(qtbot, adaptive=True)
+    frames = [0]
+    graph.data_changed.connect(lambda *_: frames.__setitem__(0, frames[0] + 1))
+
+    total_ms = 0.0
+    delivered = 0
+    start = 0.0
+    for _ in range(rounds):
+        frames[0] = 0
+        t0 = time.perf_counter()
+        for _ in range(steps):
+            start += 1.0
+            graph.set_range(SciQLopPlotRange(start, start + 100.0))
+            qtbot.wait(16)
+        total_ms += (time.perf_counter() - t0) * 1e3
+        delivered += frames[0]
+        qtbot.wait(200)  # let the gesture end
+    print(f"scrub: {delivered} frames delivered over {rounds * steps} range changes")
+    assert delivered > 0, "a scrub over overlapping ranges must deliver frames"
+    return total_ms / delivered * rounds
+
+
+def test_scrub_frames_delivered(qtbot, perf_check):
+    rounds = 5
+    perf_check("scrub_ms_per_frame", rounds).record(_scrub_ms_per_frame(qtbot, rounds=rounds))
+
+
+def _shm_producer(name, n_frames, n_points, ready, attached):
+    """Producer process for test_shm_ring_throughput."""
+    import numpy as np
+    from SciQLopPlots import SharedMemoryRingWriter
+
+    writer = SharedMemoryRingWriter(name, 8, 2 * n_points * 8)
+    ready.set()
+    # The segment is unlinked when the writer goes away.
+    attached.wait(30)
+    x = np.linspace(0.0, 1.0, n_points)
+    y = np.sin(x)
+    for i in range(n_frames):
+        x[0] = i
+        while not writer.write([x, y]):
+            pass
+
+
+def test_shm_ring_throughput(qtbot, perf_check):
+    """Two processes: a SharedMemoryRingWriter producer and a remote channel
+    consuming in place. Records ms per frame of 2 x 1M float64 delivered."""
+    import multiprocessing
+    import os
+    import sys
+    import time
+    import numpy as np
+    import pytest
+    from SciQLopPlots import SciQLopPlot
+
+    if sys.platform == "win32":
+        pytest.skip("POSIX shared memory only")
+    n_frames, n_points = 200, 1_000_000
+    name = f"sqp_perf_{os.getpid()}"
+    ctx = multiprocessing.get_context("spawn")
+    ready, attached = ctx.Event(), ctx.Event()
+    producer = ctx.Process(target=_shm_producer,
+                           args=(name, n_frames, n_points, ready, attached))
+    producer.start()
+    try:
+        assert ready.wait(30)
+        plot = SciQLopPlot()
+        qtbot.addWidget(plot)
+        ch = plot.add_remote_line_graph(["B"]).remote_channel()
+        assert ch.attach_shared_memory(name)
+        attached.set()
+        last = []
+        ch.new_data_2d.connect(lambda x, y: last.append(float(np.asarray(x)[0])))
+        consumed = 0
+        start = time.perf_counter()
+        deadline = start + 30
+        while (not last or last[-1] < n_frames - 1) and time.perf_counter() < deadline:
+            consumed += ch.consume_shared_memory()
+            QApplication.processEvents()
+        elapsed_ms = (time.perf_counter() - start) * 1000
+        assert last and last[-1] == n_frames - 1
+        perf_check("shm_ring_throughput", max(consumed, 1)).record(elapsed_ms)
+    finally:
+        producer.join(10)
+        if producer.is_alive():
+            producer.terminate()
+
+
+def test_line_append(qtbot, perf_check):
+    """100 ms updates of a 10 kHz stream onto 5M samples of history: each
+    append_data copies only the new chunk."""
+    import numpy as np
+    from SciQLopPlots import SciQLopPlot
+
+    plot = SciQLopPlot()
+    qtbot.addWidget(plot)
+    x, y = make_static_data(n_cols=1)
+    g = plot.line(x, y[:, 0].copy())
+    t = x[-1]
+    n = 100
+    with perf_check("line_append", n):
+        for _ in range(n):
+            chunk = t + (np.arange(1000) + 1) * 1e-4
+            g.append_data(chunk, np.sin(chunk))
+            t = chunk[-1]
+            plot.replot(False)
+            QApplication.processEvents()
+
+
+def _zoomed_out_lod_plot(qtbot):
+    from SciQLopPlots import SciQLopPlot
+
+    plot = SciQLopPlot()
+    qtbot.addWidget(plot)
+    plot.show()
+    x, y = make_static_data()
+    graph = plot.line(x, y)
+    plot.x_axis().set_range(SciQLopPlotRange(x[0], x[-1]))
+    settle(qtbot, graph, plot=plot)
+    return plot
+
+
+def test_zoomed_out_pan(qtbot, perf_check):
+    """Panning a fully zoomed-out 5M x 3 line graph: the renderer gets a few
+    rows per pixel from the LOD pyramid instead of every sample."""
+    plot = _zoomed_out_lod_plot(qtbot)
+    r = plot.x_axis().range()
+    step = r.size() * 0.005
+    n = 100
+    with perf_check("zoomed_out_pan", n):
+        current = r
+        for _ in range(n):
+            current = SciQLopPlotRange(current.start() + step, current.stop() + step)
+            plot.x_axis().set_range(current)
+            plot.replot(True)
+
+
+def test_rescale_axes_zoomed_out(qtbot, perf_check):
+    """Y autoscale over a fully visible 5M x 3 line graph, bounded by the LOD
+    pyramid in O(log n) per column."""
+    plot = _zoomed_out_lod_plot(qtbot)
+    n = 50
+    with perf_check("rescale_axes_zoomed_out", n):
+        for _ in range(n):
+            plot.y_axis().rescale()
+
+
+def test_colormap_zoomed_out_pan(qtbot, perf_check):
+    """Panning a fully zoomed-out 4M x 128 spectrogram (three weeks at 0.5 s)
+    with the mean LOD pyramid: the resampler reads a level with a few columns
+    per pixel instead of the full plane."""
+    import numpy as np
+    from SciQLopPlots import SciQLopPlot, ColorMapLod
+
+    plot = SciQLopPlot()
+    qtbot.addWidget(plot)
+    plot.show()
+    nx, ny = 4_000_000, 128
+    x = np.arange(nx, dtype=np.float64) * 0.5
+    y = np.logspace(0, 3, ny)
+    z = np.random.default_rng(0).random((nx, ny), dtype=np.float32)
+    cmap = plot.colormap(x, y, z)
+    cmap.set_lod(ColorMapLod.Mean)
+    plot.x_axis().set_range(SciQLopPlotRange(x[0], x[-1]))
+    settle(qtbot, cmap, plot=plot)
+
+    r = plot.x_axis().range()
+    step = r.size() * 0.005
+    n = 50
+    with perf_check("colormap_zoomed_out_pan", n):
+        current = r
+        for _ in range(n):
+            current = SciQLopPlotRange(current.start() + step, current.stop() + step)
+            plot.x_axis().set_range(current)
+            plot.replot(True)
+            QApplication.processEvents()
+
+
+def test_orbit_curve_pan(qtbot, perf_check):
+    """Panning a 20M-point float32 parametric curve (orbit-sized): the curve
+    resampler reads the buffers in place and QCPCurve only gets the points
+    that survive the pixel-space simplification."""
+    import numpy as np
+    from SciQLopPlots import SciQLopPlot
+
+    plot = SciQLopPlot()
+    qtbot.addWidget(plot)
+    plot.show()
+    n_points = 20_000_000
+    t = np.linspace(0.0, 2000.0, n_points)
+    x = (np.cos(t) * (1.0 + 1e-3 * t)).astype(np.float32)
+    y = (np.sin(t) * (1.0 + 1e-3 * t)).astype(np.float32)
+    g = plot.parametric_curve(x, y, labels=["orbit"])
+    qtbot.waitUntil(lambda: not g.busy(), timeout=60000)
+    plot.replot(True)
+    QApplication.processEvents()
+
+    r = plot.x_axis().range()
+    step = r.size() * 0.005
+    n = 50
+    with perf_check("orbit_curve_pan", n):
+        current = r
+        for _ in range(n):
+            current = SciQLopPlotRange(current.start() + step, current.stop() + step)
+            plot.x_axis().set_range(current)
+            plot.replot(True)
+            QApplication.processEvents()
+
+
+def test_colormap_percentile_autoscale(qtbot, perf_check):
+    """1/99 percentile colour autoscale over a fully visible 2M x 64
+    spectrogram: full time blocks come from the quantile sketch instead of a
+    128M-value gather and nth_element."""
+    import numpy as np
+    from SciQLopPlots import SciQLopPlot
+
+    plot = SciQLopPlot()
+    qtbot.addWidget(plot)
+    plot.show()
+    nx, ny = 2_000_000, 64
+    x = np.arange(nx, dtype=np.float64)
+    y = np.arange(ny, dtype=np.float64)
+    z = np.random.default_rng(0).random((nx, ny), dtype=np.float32)
+    cmap = plot.colormap(x, y, z)
+    cmap.set_autoscale_percentile_low(1.0)
+    cmap.set_autoscale_percentile_high(99.0)
+    plot.x_axis().set_range(SciQLopPlotRange(x[0], x[-1]))
+    plot.y_axis().set_range(SciQLopPlotRange(y[0], y[-1]))
+    cmap.z_axis().rescale()
+    settle(qtbot, cmap)
+
+    n = 20
+    with perf_check("colormap_percentile_autoscale", n):
+        for _ in range(n):
+            cmap.z_axis().rescale()
+
+
+def test_colormap_exact_percentile_autoscale(qtbot, perf_check):
+    """Exact 1/99 percentile colour autoscale over a 20k x 512 float32
+    spectrogram with half the channels visible: the z gather stays in float32,
+    runs across the DSP pool, and feeds a radix selection."""
+    import numpy as np
+    from SciQLopPlots import SciQLopPlot
+
+    plot = SciQLopPlot()
+    qtbot.addWidget(plot)
+    plot.show()
+    nx, ny = 20_000, 512
+    x = np.arange(nx, dtype=np.float64)
+    y = np.arange(ny, dtype=np.float64)
+    z = np.random.default_rng(0).random((nx, ny), dtype=np.float32)
+    cmap = plot.colormap(x, y, z)
+    cmap.set_autoscale_percentile_low(1.0)
+    cmap.set_autoscale_percentile_high(99.0)
+    cmap.set_autoscale_percentile_error(0.0)
+    plot.x_axis().set_range(SciQLopPlotRange(x[0], x[-1]))
+    plot.y_axis().set_range(SciQLopPlotRange(128.0, 383.0))
+    QApplication.processEvents()
+
+    n = 20
+    with perf_check("colormap_exact_percentile_autoscale", n):
+        for _ in range(n):
+            cmap.z_axis().rescale()
+
+
+def test_histogram2d_append(qtbot, perf_check):
+    """Streaming 10k-point chunks into a 20M-point density plot: each append
+    only bins the new chunk into the existing counts."""
+    import numpy as np
+    from SciQLopPlots import SciQLopPlot
+
+    plot = SciQLopPlot()
+    qtbot.addWidget(plot)
+    plot.show()
+    rng = np.random.default_rng(0)
+    n_points = 20_000_000
+    x = rng.uniform(0.0, 1.0, n_points)
+    y = rng.normal(0.0, 1.0, n_points)
+    hist = plot.add_histogram2d("density", 200, 200)
+    hist.set_data(x, y)
+    qtbot.waitUntil(lambda: not hist.busy(), timeout=60000)
+
+    chunks = [(rng.uniform(0.0, 1.0, 10_000), rng.normal(0.0, 1.0, 10_000).clip(-3, 3))
+              for _ in range(50)]
+    n = len(chunks)
+    with perf_check("histogram2d_append", n):
+        for cx, cy in chunks:
+            hist.append_data(cx, cy)
+            qtbot.waitUntil(lambda: not hist.busy(), timeout=10000)
+            plot.replot(True)
+            QApplication.processEvents()
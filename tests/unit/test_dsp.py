@@ -3,6 +3,8 @@
 All tests use contiguous data (no gaps) so we compare pure algorithm output.
 Requires scipy — skipped in CI environments where it's not installed.
 """
+from concurrent.futures import ThreadPoolExecutor
+
 import pytest
 import numpy as np
 from numpy.testing import assert_allclose, assert_array_equal
@@ -19,11 +21,21 @@ from SciQLopPlots.dsp import (
     sosfiltfilt,
     fft,
     spectrogram,
+    welch,
+    multitaper,
+    csd,
+    coherence,
     rolling_mean,
     rolling_std,
     reduce,
     reduce_axes,
+    pipeline,
+    StreamingFilter,
+    fft_cache_stats,
+    clear_fft_cache,
+    set_fft_cache_capacity,
 )
+from SciQLopPlots import dsp as dsp_module
 
 
 # ── Fixtures ──────────────────────────────────────────────────────────────────
@@ -77,6 +89,90 @@ class TestSplitSegments:
         assert len(segs) == 3
 
 
+# ── cadence (median dt and gaps) ──────────────────────────────────────────────
+
+def _reference_cadence(t, gap_factor=3.0):
+    """Upper median of the finite steps (np.partition is nth_element) and the
+    gap indices split_segments must cut at."""
+    d = np.diff(t)
+    with np.errstate(invalid="ignore"):
+        finite = d[np.isfinite(d)]
+        if finite.size == 0:
+            return 0.0, []
+        k = finite.size // 2
+        median = float(np.partition(finite, k)[k])
+        gaps = (np.nonzero(d > gap_factor * median)[0] + 1).tolist() if median > 0 else []
+    return median, gaps
+
+
+def _median_dt(t):
+    # The streaming filter takes the median step of its first chunk.
+    flt = StreamingFilter("fir_filter", np.ones(1))
+    flt.push(t, np.zeros_like(t))
+    return flt.median_dt
+
+
+def _gap_indices(t):
+    return [b for b, _ in split_segments(t, np.zeros_like(t))[1:]]
+
+
+class TestCadence:
+    """The median step is found by narrowing histograms around a sampled
+    window and gaps by a SIMD scan; both must match a plain sort exactly."""
+
+    def _check(self, t):
+        median, gaps = _reference_cadence(t)
+        assert _median_dt(t) == median
+        assert _gap_indices(t) == gaps
+
+    def test_irregular_cadence(self):
+        rng = np.random.default_rng(30)
+        dt = rng.lognormal(mean=-4.0, sigma=0.7, size=200_001)
+        dt[rng.random(size=dt.size) < 0.001] *= 50.0
+        self._check(np.concatenate([[0.0], np.cumsum(dt)]))
+
+    def test_nan_and_inf_keys(self):
+        rng = np.random.default_rng(31)
+        t = np.arange(100_003, dtype=np.float64) * 0.01 + rng.normal(scale=1e-4, size=100_003)
+        t[rng.choice(t.size, 300, replace=False)] = np.nan
+        t[rng.choice(t.size, 50, replace=False)] = np.inf
+        t[rng.choice(t.size, 50, replace=False)] = -np.inf
+        t[60_000:] += 5.0
+        self._check(t)
+
+    def test_duplicate_timestamps(self):
+        rng = np.random.default_rng(32)
+        t = np.repeat(np.arange(60_001, dtype=np.float64) * 0.5, rng.integers(1, 3, 60_001))
+        t[t.size // 3:] += 20.0
+        self._check(t)
+        # mostly duplicates: the median step is 0 and nothing is a gap
+        self._check(np.repeat(np.arange(1_001, dtype=np.float64), 7))
+
+    def test_median_outside_sampled_window(self):
+        # Every sampled step (stride n / 1024) is long, the others short: the
+        # sample's interquartile window misses the median entirely.
+        n = 1024 * 97
+        dt = np.full(n, 0.01)
+        dt[::97] = 0.5
+        dt[5] = 0.05
+        self._check(np.concatenate([[0.0], np.cumsum(dt)]))
+
+    def test_epoch_second_offsets(self):
+        # 1/128 s steps on epoch seconds: the differences round to a few
+        # distinct values a few ulps apart.
+        rng = np.random.default_rng(33)
+        n = 300_007
+        t = 1.7e9 + np.arange(n, dtype=np.float64) / 128.0
+        t += rng.normal(scale=2e-6, size=n)
+        t[123_456:] += 60.0
+        t[250_000:] += 3600.0
+        self._check(t)
+
+    def test_short_inputs(self):
+        for n in (0, 1, 2, 3, 7, 4097):
+            self._check(np.arange(n, dtype=np.float64) * 0.25)
+
+
 # ── interpolate_nan ───────────────────────────────────────────────────────────
 
 class TestInterpolateNan:
@@ -288,6 +384,76 @@ class TestFiltfilt:
         assert_allclose(y_cpp, y_ref, atol=1e-14)
 
 
+# ── FIR overlap-add (FFT) path ───────────────────────────────────────────────
+
+class TestFirFftPath:
+    """method='fft' must match the direct path within the documented tolerance:
+    1e-12 * sum|h| * max|x| for float64, float rounding for float32."""
+
+    @staticmethod
+    def _tol(coeffs, y, eps=1e-12):
+        return eps * np.abs(coeffs).sum() * np.abs(y).max()
+
+    @pytest.mark.parametrize("n_taps", [1, 17, 65, 301])
+    def test_fir_fft_matches_direct(self, sine_100hz, n_taps):
+        t, y, fs = sine_100hz
+        coeffs = sp_signal.firwin(n_taps, 10.0, fs=fs) if n_taps > 1 else np.array([0.5])
+        _, y_fft = fir_filter(t, y, coeffs, method='fft')
+        _, y_direct = fir_filter(t, y, coeffs, method='direct')
+        assert_allclose(y_fft, y_direct, rtol=0, atol=self._tol(coeffs, y))
+
+    def test_auto_switches_to_fft_and_matches_lfilter(self, sine_100hz):
+        t, y, fs = sine_100hz
+        coeffs = sp_signal.firwin(401, 10.0, fs=fs)
+        _, y_auto = fir_filter(t, y, coeffs, has_gaps=False)
+        assert_allclose(y_auto, sp_signal.lfilter(coeffs, 1.0, y), rtol=0,
+                        atol=self._tol(coeffs, y))
+
+    def test_filtfilt_fft_matches_scipy(self, sine_100hz):
+        t, y, fs = sine_100hz
+        y3 = np.column_stack([y, 0.5 * y, 0.3 * y])
+        coeffs = sp_signal.firwin(129, 10.0, fs=fs)
+        _, y_fft = filtfilt(t, y3, coeffs, has_gaps=False, method='fft')
+        assert_allclose(y_fft, sp_signal.filtfilt(coeffs, 1.0, y3, axis=0), rtol=0,
+                        atol=self._tol(coeffs, y3))
+
+    def test_row_blocks_and_gaps(self):
+        n = 200_000
+        t = np.arange(n, dtype=np.float64) * 0.001
+        t[120_000:] += 1.0
+        y = np.random.default_rng(6).normal(size=(n, 2))
+        coeffs = sp_signal.firwin(33, 50.0, fs=1000.0)
+        _, y_fft = fir_filter(t, y, coeffs, method='fft')
+        _, y_direct = fir_filter(t, y, coeffs, method='direct')
+        assert_allclose(y_fft, y_direct, rtol=0, atol=self._tol(coeffs, y))
+
+    def test_float32_rounds_once(self, sine_100hz):
+        t, y, fs = sine_100hz
+        coeffs = sp_signal.firwin(129, 10.0, fs=fs)
+        _, y_f = fir_filter(t, y.astype(np.float32), coeffs.astype(np.float32), method='fft')
+        assert y_f.dtype == np.float32
+        assert_allclose(y_f, sp_signal.lfilter(coeffs, 1.0, y), rtol=0,
+                        atol=self._tol(coeffs, y, eps=1e-6))
+
+    def test_int32_always_direct(self):
+        t = np.arange(500, dtype=np.float64)
+        y = np.arange(500, dtype=np.int32) % 7
+        coeffs = np.ones(200, dtype=np.int32)
+        _, y_fft = fir_filter(t, y, coeffs, method='fft')
+        _, y_direct = fir_filter(t, y, coeffs, method='direct')
+        assert_array_equal(y_fft, y_direct)
+
+    def test_pipeline_long_fir_fused_matches_unfused(self, sine_100hz):
+        t, y, fs = sine_100hz
+        stages = [("fir_filter", sp_signal.firwin(257, 10.0, fs=fs)), ("rolling_mean", 5)]
+        assert_array_equal(pipeline(t, y, stages)[1], pipeline(t, y, stages, fused=False)[1])
+
+    def test_invalid_method_raises(self, sine_100hz):
+        t, y, fs = sine_100hz
+        with pytest.raises(ValueError):
+            fir_filter(t, y, np.ones(3) / 3, method='overlap')
+
+
 # ── sosfiltfilt (zero-phase IIR) ─────────────────────────────────────────────
 
 class TestSosfiltfilt:
@@ -382,6 +548,77 @@ class TestFFT:
         assert mag.dtype == np.float32
 
 
+class TestFFTCache:
+    """Plans and windows are cached per (size, window, dtype); results must not change."""
+
+    @pytest.fixture(autouse=True)
+    def fresh_cache(self):
+        clear_fft_cache()
+        yield
+        set_fft_cache_capacity(64)
+        clear_fft_cache()
+
+    def test_repeat_calls_hit(self, sine_100hz):
+        t, y, fs = sine_100hz
+        cold = spectrogram(t, y, window_size=64)[0][2]
+        assert fft_cache_stats()["misses"] == 1
+        for _ in range(5):
+            assert_array_equal(spectrogram(t, y, window_size=64)[0][2], cold)
+        stats = fft_cache_stats()
+        assert stats["hits"] == 5 and stats["misses"] == 1 and stats["entries"] == 1
+
+    def test_key_includes_window_and_dtype(self, sine_100hz):
+        t, y, fs = sine_100hz
+        fft(t, y, window='hann')
+        fft(t, y, window='hamming')
+        fft(t, y.astype(np.float32), window='hann')
+        fft(t, y, window='hann')
+        stats = fft_cache_stats()
+        assert stats["misses"] == 3 and stats["hits"] == 1
+
+    def test_lru_eviction(self, sine_100hz):
+        t, y, fs = sine_100hz
+        set_fft_cache_capacity(2)
+        for window_size in (32, 64, 128, 32):
+            spectrogram(t, y, window_size=window_size)
+        stats = fft_cache_stats()
+        assert stats["entries"] == 2 and stats["misses"] == 4
+
+    def test_segments_of_same_length_share_entry(self):
+        t = np.concatenate([np.arange(256) * 0.001 + 10.0 * k for k in range(6)])
+        y = np.sin(2 * np.pi * 50 * t)
+        results = fft(t, y)
+        assert len(results) == 6
+        stats = fft_cache_stats()
+        assert stats["misses"] == 1 and stats["hits"] == 5
+
+    def test_concurrent_sizes_match_serial(self):
+        t = np.arange(4096, dtype=np.float64) * 0.001
+        y = np.random.default_rng(12).normal(size=4096)
+        sizes = [32, 48, 64, 100, 128]
+        expected = {n: spectrogram(t, y, window_size=n)[0][2] for n in sizes}
+        set_fft_cache_capacity(2)  # forces evictions while other threads hold entries
+
+        def worker(k):
+            n = sizes[k % len(sizes)]
+            return n, spectrogram(t, y, window_size=n)[0][2]
+
+        with ThreadPoolExecutor(max_workers=6) as ex:
+            for n, out in ex.map(worker, range(60)):
+                assert_array_equal(out, expected[n])
+
+    def test_counters_reach_sink(self, sine_100hz):
+        t, y, fs = sine_100hz
+        seen = {}
+        dsp_module._set_counter_sink(lambda name, value, cat: seen.__setitem__(name, value))
+        try:
+            fft(t, y)
+            fft(t, y)
+        finally:
+            dsp_module._install_tracing_counters()
+        assert seen == {"dsp.fft_cache.hits": 1.0, "dsp.fft_cache.misses": 1.0}
+
+
 # ── spectrogram ───────────────────────────────────────────────────────────────
 
 class TestSpectrogram:
@@ -427,6 +664,138 @@ class TestSpectrogram:
         _, _, power = results[0]
         assert power.dtype == np.float32
 
+    @staticmethod
+    def _numpy_power(y, window_size, hop):
+        n_windows = (len(y) - window_size) // hop + 1
+        frames = np.stack([y[w * hop:w * hop + window_size] for w in range(n_windows)])
+        return np.abs(np.fft.rfft(frames * np.hanning(window_size), axis=1) / window_size) ** 2
+
+    @pytest.mark.parametrize("window_size,overlap", [(64, 16), (45, 0), (128, 120)])
+    def test_power_matches_numpy_across_batches(self, window_size, overlap):
+        # Enough windows to span several batched transforms and row tiles
+        t = np.arange(40_000, dtype=np.float64) * 0.001
+        y = np.random.default_rng(13).normal(size=(len(t), 2))
+        hop = window_size - overlap if overlap else window_size // 2
+        _, _, power = spectrogram(t, y, col=1, window_size=window_size, overlap=overlap,
+                                  has_gaps=False)[0]
+        assert_allclose(power, self._numpy_power(y[:, 1], window_size, hop), rtol=1e-9,
+                        atol=1e-15)
+
+    def test_float32_power_matches_numpy(self):
+        t = np.arange(20_000, dtype=np.float64) * 0.001
+        y = np.random.default_rng(14).normal(size=len(t)).astype(np.float32)
+        _, _, power = spectrogram(t, y, window_size=64, has_gaps=False)[0]
+        ref = self._numpy_power(y.astype(np.float64), 64, 32)
+        assert_allclose(power, ref, rtol=1e-5, atol=1e-9)
+
+
+# ── welch / multitaper / csd / coherence ──────────────────────────────────────
+
+class TestAveragedSpectra:
+    FS = 32.0
+
+    @pytest.fixture
+    def coupled(self):
+        t = np.arange(8000, dtype=np.float64) / self.FS
+        y = np.random.default_rng(21).normal(size=(len(t), 3))
+        y[:, 1] += 0.7 * y[:, 0]
+        return t, y
+
+    @staticmethod
+    def _sym(window, n):
+        # sqp::dsp windows are symmetric; scipy's named windows are periodic
+        return sp_signal.get_window(window, n, fftbins=False)
+
+    @pytest.mark.parametrize("window_size,overlap,window", [
+        (64, 0, "hann"), (65, 20, "hamming"), (256, 224, "blackman")])
+    def test_welch_matches_scipy(self, coupled, window_size, overlap, window):
+        t, y = coupled
+        f, psd = welch(t, y, window_size=window_size, overlap=overlap, window=window)
+        hop = window_size - overlap if overlap else window_size // 2
+        f_ref, psd_ref = sp_signal.welch(y, fs=self.FS, window=self._sym(window, window_size),
+                                         noverlap=window_size - hop, axis=0)
+        assert psd.shape == (window_size // 2 + 1, 3)
+        assert_allclose(f, f_ref)
+        assert_allclose(psd, psd_ref, rtol=1e-9, atol=1e-15)
+
+    def test_welch_no_detrend_float32(self, coupled):
+        t, y = coupled
+        f, psd = welch(t, y[:, 2].astype(np.float32), window_size=128, detrend=False)
+        _, psd_ref = sp_signal.welch(y[:, 2].astype(np.float32).astype(np.float64), fs=self.FS,
+                                     window=self._sym("hann", 128), detrend=False)
+        assert psd.dtype == np.float64 and psd.ndim == 1
+        # float32 data gets the float32 window (as fft/spectrogram), accumulated in float64
+        assert_allclose(psd, psd_ref, rtol=1e-6)
+
+    def test_welch_pools_windows_across_gaps(self, coupled):
+        t, y = coupled
+        t = t.copy()
+        t[3000:] += 100.0
+        _, psd = welch(t, y[:, 0], window_size=64)
+        w = self._sym("hann", 64)
+        _, a = sp_signal.welch(y[:3000, 0], fs=self.FS, window=w)
+        _, b = sp_signal.welch(y[3000:, 0], fs=self.FS, window=w)
+        na, nb = (3000 - 64) // 32 + 1, (5000 - 64) // 32 + 1
+        assert_allclose(psd, (na * a + nb * b) / (na + nb), rtol=1e-9)
+
+    def test_multitaper_matches_dpss_reference(self, coupled):
+        t, y = coupled
+        window_size, nw, k = 128, 3.0, 5
+        tapers = sp_signal.windows.dpss(window_size, nw, k)
+        frames = np.stack([y[s:s + window_size, 1]
+                           for s in range(0, len(y) - window_size + 1, window_size // 2)])
+        frames = frames - frames.mean(axis=1, keepdims=True)
+        spectra = np.fft.rfft(frames[:, None, :] * tapers[None], axis=2)
+        ref = (np.abs(spectra) ** 2).mean(axis=(0, 1)) / self.FS
+        ref[1:-1] *= 2
+        f, psd = multitaper(t, y[:, 1], window_size=window_size, nw=nw, n_tapers=k)
+        assert_allclose(f, np.fft.rfftfreq(window_size, 1 / self.FS))
+        assert_allclose(psd, ref, rtol=1e-9)
+
+    def test_multitaper_white_noise_level(self, coupled):
+        t, y = coupled
+        _, psd = multitaper(t, y[:, 2], window_size=256)  # nw=4, 7 tapers
+        # Unit-variance white noise: one-sided density 2 / fs
+        assert abs(np.median(psd[5:-5]) * self.FS / 2 - 1.0) < 0.1
+
+    def test_csd_matches_scipy(self, coupled):
+        t, y = coupled
+        f, pxy = csd(t, y, col_a=0, col_b=1, window_size=64, overlap=48)
+        f_ref, pxy_ref = sp_signal.csd(y[:, 0], y[:, 1], fs=self.FS,
+                                       window=self._sym("hann", 64), noverlap=48)
+        assert pxy.dtype == np.complex128
+        assert_allclose(f, f_ref)
+        assert_allclose(pxy, pxy_ref, rtol=1e-9, atol=1e-15)
+
+    def test_coherence_matches_scipy(self, coupled):
+        t, y = coupled
+        _, cxy = coherence(t, y, col_a=1, col_b=0, window_size=128)
+        _, ref = sp_signal.coherence(y[:, 1], y[:, 0], fs=self.FS, window=self._sym("hann", 128))
+        assert_allclose(cxy, ref, rtol=1e-9, atol=1e-12)
+        assert np.mean(cxy) > 0.2
+
+    def test_dpss_setup_is_cached(self, coupled):
+        t, y = coupled
+        clear_fft_cache()
+        multitaper(t, y[:, 0], window_size=64, nw=2.5)
+        multitaper(t, y[:, 0], window_size=64, nw=2.5)
+        stats = fft_cache_stats()
+        assert stats["misses"] == 1 and stats["hits"] == 1
+
+    def test_no_full_window_raises(self):
+        t = np.arange(50, dtype=np.float64)
+        with pytest.raises(ValueError, match="full window"):
+            welch(t, np.zeros(50), window_size=64)
+
+    def test_bad_arguments_raise(self, coupled):
+        t, y = coupled
+        with pytest.raises(ValueError):
+            csd(t, y, col_b=3)
+        with pytest.raises(ValueError):
+            welch(t, y, window_size=64, overlap=64)
+        with pytest.raises(ValueError):
+            multitaper(t, y, window_size=64, nw=40.0)
+
 
 # ── rolling_mean ──────────────────────────────────────────────────────────────
 
@@ -489,6 +858,61 @@ class TestRollingStd:
         margin = window
         assert_allclose(y_cpp[margin:-margin], y_ref[margin:-margin], atol=1e-10)
 
+    def test_large_offset_no_cancellation(self):
+        n = 20_000
+        t = np.arange(n, dtype=np.float64) * 0.01
+        y = 1e9 + np.random.default_rng(3).normal(size=n)
+
+        window = 15
+        _, y_cpp = rolling_std(t, y, window)
+
+        y_ref = np.lib.stride_tricks.sliding_window_view(y, window).std(axis=1, ddof=1)
+        half = window // 2
+        assert_allclose(y_cpp[half:-half], y_ref, rtol=1e-6)
+
+    def test_multicolumn_nan_matches_reference(self):
+        # Long enough to cross several internal restart points.
+        n, ncols, window = 9_000, 5, 31
+        t = np.arange(n, dtype=np.float64) * 0.01
+        rng = np.random.default_rng(11)
+        y = rng.normal(size=(n, ncols)) + np.arange(n)[:, None] * 1e-3
+        y[rng.random(size=(n, ncols)) < 0.05] = np.nan
+
+        _, m_cpp = rolling_mean(t, y, window)
+        _, s_cpp = rolling_std(t, y, window)
+
+        half = window // 2
+        padded = np.pad(y, ((half, half), (0, 0)), constant_values=np.nan)
+        views = np.lib.stride_tricks.sliding_window_view(padded, window, axis=0)
+        counts = np.sum(~np.isnan(views), axis=-1)
+        with np.errstate(invalid="ignore", divide="ignore"):
+            m_ref = np.where(counts > 0, np.nansum(views, axis=-1) / counts, 0.0)
+            s_ref = np.where(counts > 1, np.nanstd(views, axis=-1, ddof=1), 0.0)
+        assert_allclose(m_cpp, m_ref, atol=1e-10)
+        assert_allclose(s_cpp, s_ref, atol=1e-10)
+
+    def test_single_column_nan_large_offset_matches_reference(self):
+        # One column is split into row-chunk lanes, some with NaN and some
+        # without; the offset and the restarts must still keep it exact enough.
+        n, window = 9_000, 31
+        t = np.arange(n, dtype=np.float64) * 0.01
+        rng = np.random.default_rng(12)
+        y = 1e6 + rng.normal(size=n) + np.arange(n) * 1e-3
+        y[rng.random(size=n) < 0.05] = np.nan
+
+        _, m_cpp = rolling_mean(t, y, window)
+        _, s_cpp = rolling_std(t, y, window)
+
+        half = window // 2
+        padded = np.pad(y, (half, half), constant_values=np.nan)
+        views = np.lib.stride_tricks.sliding_window_view(padded, window)
+        counts = np.sum(~np.isnan(views), axis=-1)
+        with np.errstate(invalid="ignore", divide="ignore"):
+            m_ref = np.where(counts > 0, np.nansum(views, axis=-1) / counts, 0.0)
+            s_ref = np.where(counts > 1, np.nanstd(views, axis=-1, ddof=1), 0.0)
+        assert_allclose(m_cpp, m_ref, rtol=1e-12)
+        assert_allclose(s_cpp, s_ref, atol=1e-8)
+
 
 # ── reduce ────────────────────────────────────────────────────────────────────
 
@@ -588,6 +1012,293 @@ class TestReduceAxes:
             reduce_axes(t, y, (10, 10), (0,))  # 100 != actual n_cols
 
 
+# ── Tiled scheduling tests ───────────────────────────────────────────────────
+
+class TestTiledScheduling:
+    """Inputs large enough to be cut into (segment x column x row block) tiles."""
+
+    @pytest.fixture
+    def long_3col(self):
+        n = 200_000
+        t = np.arange(n, dtype=np.float64) * 0.001
+        t[120_000:] += 1.0
+        rng = np.random.default_rng(3)
+        return t, rng.normal(size=(n, 3))
+
+    def test_fir_row_blocks_match_lfilter(self, long_3col):
+        t, y = long_3col
+        coeffs = sp_signal.firwin(65, 50.0, fs=1000.0)
+        _, y_out = fir_filter(t, y, coeffs, has_gaps=False)
+        assert_allclose(y_out, sp_signal.lfilter(coeffs, 1.0, y, axis=0), atol=1e-12)
+
+    def test_fir_gappy_matches_per_segment(self, long_3col):
+        t, y = long_3col
+        coeffs = sp_signal.firwin(33, 50.0, fs=1000.0)
+        _, y_out = fir_filter(t, y, coeffs)
+        ref = np.concatenate([sp_signal.lfilter(coeffs, 1.0, y[:120_000], axis=0),
+                              np.full((1, 3), np.nan),
+                              sp_signal.lfilter(coeffs, 1.0, y[120_000:], axis=0)])
+        assert_allclose(y_out, ref, atol=1e-12)
+
+    def test_resample_row_blocks_match_interp(self):
+        n = 200_000
+        rng = np.random.default_rng(4)
+        t = np.sort(np.arange(n) * 0.001 + rng.uniform(-2e-4, 2e-4, n))
+        y = np.column_stack([np.sin(t), np.cos(3 * t)])
+        x_out, y_out = resample(t, y, target_dt=0.0007, has_gaps=False)
+        for c in range(2):
+            assert_allclose(y_out[:, c], np.interp(x_out, t, y[:, c]), atol=1e-12)
+
+    def test_reduce_axes_many_columns(self):
+        rng = np.random.default_rng(5)
+        y = rng.normal(size=(2000, 32 * 16 * 8))
+        t = np.arange(2000, dtype=np.float64)
+        _, y_r = reduce_axes(t, y, (32, 16, 8), (1, 2), op='sum')
+        assert_allclose(y_r, y.reshape(2000, 32, 16, 8).sum(axis=(2, 3)), atol=1e-10)
+
+    def test_spectrogram_many_segments(self):
+        # 40 short segments: their windows are scheduled together
+        t = np.concatenate([np.arange(2048) * 0.001 + 10.0 * k for k in range(40)])
+        y = np.sin(2 * np.pi * 50 * t)
+        results = spectrogram(t, y, window_size=128)
+        ref = spectrogram(t[:2048], y[:2048], window_size=128)[0]
+        assert len(results) == 40
+        assert_allclose(results[0][2], ref[2])
+        assert all(r[2].shape == ref[2].shape for r in results)
+
+
+class TestConcurrentCallers:
+    """Python threads share the DSP pool: each call only waits for its own work."""
+
+    def test_concurrent_calls_match_serial(self):
+        n = 100_000
+        t = np.arange(n, dtype=np.float64) * 0.001
+        t[60_000:] += 2.0
+        rng = np.random.default_rng(11)
+        y = rng.normal(size=(n, 4))
+        coeffs = sp_signal.firwin(33, 50.0, fs=1000.0)
+        sos = sp_signal.butter(4, 40.0, fs=1000.0, output='sos')
+        calls = [
+            lambda: fir_filter(t, y, coeffs)[1],
+            lambda: sosfiltfilt(t, y, sos)[1],
+            lambda: rolling_std(t, y, window=31)[1],
+            lambda: resample(t, y, target_dt=0.0013)[1],
+            lambda: reduce(t, y, 'norm', has_gaps=False)[1],
+            lambda: pipeline(t, y, [("iir_sos", sos), ("rolling_mean", 9)])[1],
+        ]
+        expected = [call() for call in calls]
+
+        def worker(k):
+            i = k % len(calls)
+            return i, calls[i]()
+
+        with ThreadPoolExecutor(max_workers=8) as ex:
+            for i, out in ex.map(worker, range(96)):
+                assert_array_equal(out, expected[i])
+
+    def test_concurrent_errors_do_not_leak(self):
+        t = np.arange(50_000, dtype=np.float64)
+        y = np.ones(50_000)
+
+        def worker(k):
+            if k % 2:
+                with pytest.raises(ValueError):
+                    rolling_mean(t, y, window=0)
+                return None
+            return rolling_mean(t, y, window=5)[1]
+
+        with ThreadPoolExecutor(max_workers=6) as ex:
+            for out in ex.map(worker, range(48)):
+                if out is not None:
+                    assert_allclose(out, 1.0)
+
+
+# ── pipeline() tests ─────────────────────────────────────────────────────────
+
+class TestPipeline:
+    """The fused executor must be bit-identical to stage-by-stage execution."""
+
+    @pytest.fixture
+    def gapped_3col(self):
+        t = np.arange(6000, dtype=np.float64) * 0.001
+        t[2000:] += 1.0
+        t[4000:] += 2.5
+        rng = np.random.default_rng(7)
+        y = np.column_stack([np.sin(2 * np.pi * 3 * t), rng.normal(size=len(t)),
+                             np.cos(2 * np.pi * 7 * t)])
+        return t, y
+
+    def _chains(self):
+        fs = 1000.0
+        coeffs = sp_signal.firwin(33, 50.0, fs=fs)
+        sos = sp_signal.butter(4, 40.0, fs=fs, output='sos')
+        return [
+            [("fir_filter", coeffs), ("rolling_mean", 11)],
+            [("iir_sos", sos), ("rolling_std", 15), ("reduce", "norm")],
+            [("interpolate_nan", 2), ("sosfiltfilt", sos), ("resample", 0.002),
+             ("rolling_std", 9)],
+            [("fir_filter", coeffs), ("filtfilt", coeffs), ("iir_sos", sos)],
+        ]
+
+    @pytest.mark.parametrize("chain_idx", range(4))
+    def test_fused_matches_unfused(self, gapped_3col, chain_idx):
+        t, y = gapped_3col
+        stages = self._chains()[chain_idx]
+        x_f, y_f = pipeline(t, y, stages)
+        x_u, y_u = pipeline(t, y, stages, fused=False)
+        assert_array_equal(x_f, x_u)
+        assert_array_equal(y_f, y_u)
+
+    def test_matches_individual_calls(self, sine_100hz):
+        t, y, fs = sine_100hz
+        coeffs = sp_signal.firwin(33, 50.0, fs=fs)
+        x_p, y_p = pipeline(t, y, [("fir_filter", coeffs), ("rolling_mean", 11)])
+        x_1, y_1 = fir_filter(t, y, coeffs)
+        x_2, y_2 = rolling_mean(x_1, y_1, window=11)
+        assert_array_equal(x_p, x_2)
+        assert_array_equal(y_p, y_2)
+
+    def test_gaps_are_nan_separated(self, gapped_3col):
+        t, y = gapped_3col
+        x_p, y_p = pipeline(t, y, [("rolling_mean", 5)])
+        assert len(x_p) == len(t) + 2
+        assert np.all(np.isnan(y_p[2000]))
+        assert np.all(np.isnan(y_p[4001]))
+
+    def test_float32(self, gapped_3col):
+        t, y = gapped_3col
+        y = y.astype(np.float32)
+        sos = sp_signal.butter(2, 40.0, fs=1000.0, output='sos').astype(np.float32)
+        stages = [("iir_sos", sos), ("rolling_mean", 7)]
+        _, y_f = pipeline(t, y, stages)
+        _, y_u = pipeline(t, y, stages, fused=False)
+        assert y_f.dtype == np.float32
+        assert_array_equal(y_f, y_u)
+
+    def test_empty_stages_returns_input(self, sine_100hz):
+        t, y, _ = sine_100hz
+        x_p, y_p = pipeline(t, y, [])
+        assert_array_equal(x_p, t)
+        assert_array_equal(y_p, y)
+
+    def test_unknown_stage_raises(self, sine_100hz):
+        t, y, _ = sine_100hz
+        with pytest.raises(ValueError, match="unknown stage"):
+            pipeline(t, y, [("median", 3)])
+
+    def test_bad_window_raises(self, sine_100hz):
+        t, y, _ = sine_100hz
+        with pytest.raises(ValueError, match="must be > 0"):
+            pipeline(t, y, [("rolling_mean", 0)])
+
+    def test_bad_stage_shape_raises(self, sine_100hz):
+        t, y, _ = sine_100hz
+        with pytest.raises(TypeError, match="tuple"):
+            pipeline(t, y, ["rolling_mean"])
+
+    def test_coeff_dtype_mismatch_raises(self, sine_100hz):
+        t, y, _ = sine_100hz
+        with pytest.raises(TypeError, match="match y dtype"):
+            pipeline(t, y.astype(np.float32), [("fir_filter", np.ones(3))])
+
+
+# ── StreamingFilter tests ────────────────────────────────────────────────────
+
+class TestStreamingFilter:
+    """Chunked filtering must match filtering the whole series at once."""
+
+    @pytest.fixture
+    def telemetry(self):
+        n = 5000
+        t = np.arange(n, dtype=np.float64) * 0.01
+        t[3100:] += 4.0  # gap inside a chunk
+        t[4000:] += 2.0  # gap exactly at a chunk boundary (see chunk_edges)
+        rng = np.random.default_rng(21)
+        y = np.column_stack([np.sin(2 * np.pi * 0.7 * t), rng.normal(size=n)])
+        return t, y
+
+    chunk_edges = [0, 1, 17, 500, 1999, 2000, 3500, 4000, 4003, 5000]
+
+    def _push_all(self, flt, t, y):
+        e = self.chunk_edges
+        return np.concatenate([flt.push(t[a:b], y[a:b]) for a, b in zip(e[:-1], e[1:])])
+
+    def _per_segment(self, fn, y):
+        bounds = [0, 3100, 4000, len(y)]
+        return np.concatenate([fn(y[a:b]) for a, b in zip(bounds[:-1], bounds[1:])])
+
+    def test_sos_matches_per_segment_sosfilt(self, telemetry):
+        t, y = telemetry
+        sos = sp_signal.butter(4, 5.0, fs=100.0, output='sos')
+        out = self._push_all(StreamingFilter("iir_sos", sos, n_cols=2), t, y)
+        ref = self._per_segment(lambda s: sp_signal.sosfilt(sos, s, axis=0), y)
+        assert_allclose(out, ref, atol=1e-12)
+
+    def test_fir_matches_per_segment_lfilter(self, telemetry):
+        t, y = telemetry
+        coeffs = sp_signal.firwin(41, 5.0, fs=100.0)
+        out = self._push_all(StreamingFilter("fir_filter", coeffs, n_cols=2), t, y)
+        ref = self._per_segment(lambda s: sp_signal.lfilter(coeffs, 1.0, s, axis=0), y)
+        assert_allclose(out, ref, atol=1e-12)
+
+    def test_chunked_equals_single_push(self, telemetry):
+        t, y = telemetry
+        sos = sp_signal.butter(2, 5.0, fs=100.0, output='sos')
+        chunked = self._push_all(StreamingFilter("iir_sos", sos, n_cols=2), t, y)
+        whole = StreamingFilter("iir_sos", sos, n_cols=2).push(t, y)
+        assert_array_equal(chunked, whole)
+
+    def test_matches_iir_sos_without_separators(self, telemetry):
+        t, y = telemetry
+        sos = sp_signal.butter(2, 5.0, fs=100.0, output='sos')
+        whole = StreamingFilter("iir_sos", sos, n_cols=2).push(t, y)
+        _, y_ref = iir_sos(t, y, sos)
+        assert_array_equal(whole, np.delete(y_ref, [3100, 4001], axis=0))
+
+    def test_reset(self, telemetry):
+        t, y = telemetry
+        coeffs = sp_signal.firwin(11, 5.0, fs=100.0)
+        flt = StreamingFilter("fir_filter", coeffs, n_cols=2)
+        first = flt.push(t[:100], y[:100])
+        flt.push(t[100:200], y[100:200])
+        flt.reset()
+        assert flt.median_dt == 0.0
+        assert_array_equal(flt.push(t[:100], y[:100]), first)
+
+    def test_1d_float32(self):
+        t = np.arange(1000, dtype=np.float64)
+        y = np.sin(t / 10).astype(np.float32)
+        sos = sp_signal.butter(2, 0.1, output='sos').astype(np.float32)
+        flt = StreamingFilter("iir_sos", sos)
+        out = np.concatenate([flt.push(t[i:i + 7], y[i:i + 7]) for i in range(0, 1000, 7)])
+        assert out.dtype == np.float32 and out.shape == (1000,)
+        assert_allclose(out, sp_signal.sosfilt(sos, y), rtol=1e-4, atol=1e-5)
+        assert flt.median_dt == 1.0
+
+    def test_bad_kind_raises(self):
+        with pytest.raises(ValueError, match="fir_filter' or 'iir_sos"):
+            StreamingFilter("rolling_mean", np.ones(3))
+
+    def test_column_mismatch_raises(self):
+        flt = StreamingFilter("fir_filter", np.ones(3), n_cols=2)
+        with pytest.raises(ValueError, match="columns"):
+            flt.push(np.arange(5.0), np.ones(5))
+
+    def test_coeffs_follow_first_push_dtype(self):
+        t = np.arange(1000, dtype=np.float64)
+        y = np.sin(t / 10).astype(np.float32)
+        sos = sp_signal.butter(2, 0.1, output='sos')
+        out = StreamingFilter("iir_sos", sos).push(t, y)
+        assert out.dtype == np.float32
+        assert_allclose(out, sp_signal.sosfilt(sos.astype(np.float32), y), rtol=1e-4, atol=1e-5)
+
+    def test_dtype_change_after_first_push_raises(self):
+        flt = StreamingFilter("fir_filter", np.ones(3))
+        flt.push(np.arange(5.0), np.ones(5, dtype=np.float32))
+        with pytest.raises(TypeError, match="dtype"):
+            flt.push(np.arange(5.0, 10.0), np.ones(5))
+
+
 # ── Input validation tests ───────────────────────────────────────────────────
 
 class TestInputValidation: